@@ -0,0 +1,386 @@
+/**
+ @file    bench.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Cycle-count microbenchmarks of the driver APIs
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include <stdio.h>
+#include "common.h"
+#include "bench.h"
+#include "led.h"
+#include "button.h"
+#include "binding.h"
+#include "systime.h"
+#include "defer.h"
+#include "delay.h"
+#include "trace.h"
+#ifdef BENCH_HOST
+#include <time.h>
+#endif
+
+
+/* SECTION 2: Private macros                                       */
+
+/**
+ @brief Time base of the measurements
+*/
+#ifdef BENCH_HOST
+#define BENCH_NOW()    _benchNanoseconds()
+#define BENCH_UNIT     "ns"
+#else
+#define BENCH_NOW()    CYCLES_NOW()
+#define BENCH_UNIT     "cycles"
+#endif
+
+/**
+ @brief DCO frequencies measured, and the one restored for the report (reset value)
+*/
+#define BENCH_NUM_CLOCKS   6
+#define BENCH_RESET_CLOCK  3 //12 MHz, set by SystemInit
+
+/**
+ @brief Storm protection of BUTTON1 in the port interrupt case (see buttonStormSet)
+*/
+#define BENCH_HOLDOFF_MS   20
+#define BENCH_RATE_LIMIT   20
+
+
+/* SECTION 3: Private types                                        */
+
+/**
+ @brief Benchmark case: one call of the API measured
+*/
+struct bench_case_s {
+   const char *name;     /**< Name printed in the report                  */
+   void (*run)(void);    /**< Wrapper calling the API                     */
+   void (*setup)(void);  /**< Run before each sample, not measured (or 0) */
+};
+
+/**
+ @brief Short alias "bench_case_t" for the data type "struct bench_case_s"
+*/
+typedef struct bench_case_s bench_case_t;
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+static uint32_t _benchSamples [BENCH_SAMPLES];
+
+#if defined(BENCHMARK_BUILD) && !defined(BENCH_HOST)
+/**
+ @brief DCO settings measured, from the slowest
+*/
+static const uint32_t _benchDco [BENCH_NUM_CLOCKS] = {
+     CS_DCO_FREQUENCY_1_5, CS_DCO_FREQUENCY_3, CS_DCO_FREQUENCY_6,
+     CS_DCO_FREQUENCY_12, CS_DCO_FREQUENCY_24, CS_DCO_FREQUENCY_48
+};
+
+/**
+ @brief Results of every case at every clock, left in RAM for the debugger
+*/
+static bench_result_t _benchResults [BENCH_NUM_CLOCKS][BENCH_NUM_CASES];
+#endif
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static uint32_t _benchMeasure(const bench_case_t *bench, bench_result_t *result); //Sample a case, fill its result, returns its fastest sample
+
+static void _benchEmpty(void);        //Measurement overhead
+static void _benchLedOn(void);
+static void _benchLedToggle(void);
+static void _benchLedGet(void);
+static void _benchButtonState(void);
+static void _benchButtonPressed(void);
+static void _benchLedsInit(void);
+static void _benchButtonsInit(void);
+static void _benchDelayUs0(void);    //Fixed cost of a spinning delay (DELAY_OVERHEAD_CYCLES)
+static void _benchPort1Isr(void);     //Interrupt of BUTTON1 (P1.4), handler called directly
+static void _benchPort1Rearm(void);   //BUTTON1 protected but out of its holdoff, so that each sample delivers an event
+static void _benchPort1Bind(void);    //As _benchPort1Rearm, with both edges of BUTTON1 bound to LED1_RED
+
+static void _benchPutc(char c); //Output of the report
+
+#ifdef BENCH_HOST
+static uint32_t _benchNanoseconds(void); //Monotonic clock of the host
+#elif defined(BENCHMARK_BUILD)
+static void _benchSetClock(int clock); //Switch MCLK and SMCLK to a DCO frequency of _benchDco
+#endif
+
+extern void PORT1_IRQHandler(void);
+
+/**
+ @brief Cases, in report order
+*/
+static const bench_case_t _benchCases [BENCH_NUM_CASES] = {
+     { "ledOn",            _benchLedOn },
+     { "ledToggle",        _benchLedToggle },
+     { "ledGet",           _benchLedGet },
+     { "buttonState",      _benchButtonState },
+     { "buttonPressed",    _benchButtonPressed },
+     { "ledsInit",         _benchLedsInit },
+     { "buttonsInit",      _benchButtonsInit },
+     { "delayUs(0)",       _benchDelayUs0 },
+     { "PORT1_IRQHandler", _benchPort1Isr, _benchPort1Rearm },
+     { "PORT1 bound",      _benchPort1Isr, _benchPort1Bind }
+};
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+#ifdef BENCHMARK_BUILD
+int main(void)
+{
+#ifdef BENCH_HOST
+    bench_result_t results [BENCH_NUM_CASES];
+
+    deferInit();
+    systimeInit();
+    ledsInit();
+    buttonsInit();
+
+    benchRunCases(results);
+    benchPrint(results, BENCH_NUM_CASES);
+
+    return 0;
+#else
+    int clock;
+
+    MAP_WDT_A_holdTimer();
+
+    deferInit();
+    systimeInit();
+    ledsInit();
+    buttonsInit();
+    Interrupt_enableMaster();
+
+    for(clock = 0; clock < BENCH_NUM_CLOCKS; clock++)
+    {
+        _benchSetClock(clock);
+        benchRunCases(_benchResults[clock]);
+    }
+
+    /* The UART baud rate is computed for the current SMCLK */
+    _benchSetClock(BENCH_RESET_CLOCK);
+    traceInit();
+    benchPrint(&_benchResults[0][0], BENCH_NUM_CLOCKS * BENCH_NUM_CASES);
+
+    while(1);
+#endif
+}
+#endif
+
+int benchRunCases(bench_result_t *results)
+{
+    static const bench_case_t empty = { "", _benchEmpty };
+    bench_result_t overhead;
+    uint32_t base;
+    int i;
+
+    if(results == 0)
+        return -1;
+
+    /* Timer reads and the indirect call are part of every sample */
+    base = _benchMeasure(&empty, &overhead);
+
+    for(i = 0; i < BENCH_NUM_CASES; i++)
+    {
+        _benchMeasure(&_benchCases[i], &results[i]);
+        results[i].name = _benchCases[i].name;
+        results[i].min = results[i].min > base ? results[i].min - base : 0;
+        results[i].median = results[i].median > base ? results[i].median - base : 0;
+        results[i].max = results[i].max > base ? results[i].max - base : 0;
+    }
+
+    return BENCH_NUM_CASES;
+}
+
+void benchPrint(const bench_result_t *results, int count)
+{
+    char line[96];
+    int i, k;
+
+    for(i = 0; i < count; i++)
+    {
+        snprintf(line, sizeof(line), "bench,%lu,%s,%d,%lu,%lu,%lu," BENCH_UNIT "\r\n",
+                 (unsigned long)results[i].clock_hz, results[i].name, BENCH_SAMPLES,
+                 (unsigned long)results[i].min, (unsigned long)results[i].median,
+                 (unsigned long)results[i].max);
+
+        for(k = 0; line[k] != 0; k++)
+            _benchPutc(line[k]);
+    }
+}
+
+static uint32_t _benchMeasure(const bench_case_t *bench, bench_result_t *result)
+{
+    uint32_t start, sample;
+    int i, j;
+    bool state;
+
+    for(i = 0; i < BENCH_SAMPLES; i++)
+    {
+        if(bench->setup != 0)
+            bench->setup();
+
+        CRITICAL_ENTER(state);
+        start = BENCH_NOW();
+        bench->run();
+        sample = BENCH_NOW() - start;
+
+        /* The interrupt raised by the PORT1 case is already served */
+        Interrupt_unpendInterrupt(INT_PORT1);
+        CRITICAL_EXIT(state);
+
+#ifdef BENCH_HOST
+        deferRun(); //No PendSV on the host
+#endif
+
+        /* Insertion sort, samples are few */
+        for(j = i; j > 0 && _benchSamples[j-1] > sample; j--)
+            _benchSamples[j] = _benchSamples[j-1];
+        _benchSamples[j] = sample;
+    }
+
+#ifdef BENCH_HOST
+    result->clock_hz = 0;
+#else
+    result->clock_hz = SystemCoreClock;
+#endif
+    result->min = _benchSamples[0];
+    result->median = _benchSamples[BENCH_SAMPLES / 2];
+    result->max = _benchSamples[BENCH_SAMPLES - 1];
+
+    return result->min;
+}
+
+static void _benchEmpty(void)
+{
+}
+
+static void _benchLedOn(void)
+{
+    ledOn(LED1_RED);
+}
+
+static void _benchLedToggle(void)
+{
+    ledToggle(LED1_RED);
+}
+
+static void _benchLedGet(void)
+{
+    ledGet(LED1_RED);
+}
+
+static void _benchButtonState(void)
+{
+    buttonState(BUTTON0);
+}
+
+static void _benchButtonPressed(void)
+{
+    buttonPressed(BUTTON1);
+}
+
+static void _benchLedsInit(void)
+{
+    ledsInit();
+}
+
+static void _benchButtonsInit(void)
+{
+    buttonsInit();
+}
+
+static void _benchDelayUs0(void)
+{
+    delayUs(0);
+}
+
+static void _benchPort1Isr(void)
+{
+    /* Software edge on BUTTON1: includes the holdoff filter and the event post */
+    P1->IFG = P1->IFG | BIT4;
+    PORT1_IRQHandler();
+}
+
+static void _benchPort1Rearm(void)
+{
+    /* The protection is off by default: the measured path includes it. Otherwise
+       the holdoff of the previous sample masks the pin, and the handler only
+       finds IFG & IE == 0 */
+    buttonStormSet(BUTTON1, BENCH_HOLDOFF_MS, BENCH_RATE_LIMIT);
+    buttonStormRearm(BUTTON1);
+    bindingsInit(0, 0);
+}
+
+static void _benchPort1Bind(void)
+{
+    /* The reaction of the binding (one port write) is part of the measured ISR */
+    static const binding_rule_t rules[] = {
+        { BUTTON1, BUTTON_EVENT_PRESS,   LED1_RED, BINDING_ACTION_TOGGLE },
+        { BUTTON1, BUTTON_EVENT_RELEASE, LED1_RED, BINDING_ACTION_TOGGLE }
+    };
+
+    _benchPort1Rearm();
+    bindingsInit(rules, sizeof(rules) / sizeof(rules[0]));
+}
+
+static void _benchPutc(char c)
+{
+#ifdef BENCH_HOST
+    putchar(c);
+#else
+    /* Blocking write: the trace DMA is idle while the report is sent */
+    while((EUSCI_A0->IFG & EUSCI_A_IFG_TXIFG) == 0);
+    EUSCI_A0->TXBUF = c;
+#endif
+}
+
+#ifdef BENCH_HOST
+static uint32_t _benchNanoseconds(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint32_t)now.tv_sec * 1000000000u + (uint32_t)now.tv_nsec;
+}
+
+#elif defined(BENCHMARK_BUILD)
+static void _benchSetClock(int clock)
+{
+    /* 48 MHz needs the higher core voltage and one flash wait state */
+    if(_benchDco[clock] == CS_DCO_FREQUENCY_48)
+    {
+        PCM_setCoreVoltageLevel(PCM_VCORE1);
+        FlashCtl_setWaitState(FLASH_BANK0, 1);
+        FlashCtl_setWaitState(FLASH_BANK1, 1);
+    }
+
+    CS_setDCOCenteredFrequency(_benchDco[clock]);
+
+    if(_benchDco[clock] != CS_DCO_FREQUENCY_48)
+    {
+        FlashCtl_setWaitState(FLASH_BANK0, 0);
+        FlashCtl_setWaitState(FLASH_BANK1, 0);
+        PCM_setCoreVoltageLevel(PCM_VCORE0);
+    }
+
+    SystemCoreClockUpdate();
+}
+#endif
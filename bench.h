@@ -0,0 +1,76 @@
+/**
+ @file    bench.h
+
+ @brief   Cycle-count microbenchmarks of the driver APIs
+
+ The benchmark is a separate application: building with BENCHMARK_BUILD defined
+ (--define=BENCHMARK_BUILD in a dedicated build configuration) replaces the main
+ function of lab4.c with the one of bench.c. It runs every case BENCH_SAMPLES
+ times at each DCO frequency, measuring one call per sample with the DWT cycle
+ counter and interrupts masked, and reports one CSV line per case and clock:
+
+    bench,<clock_hz>,<case>,<samples>,<min>,<median>,<max>,<unit>
+
+ The lines are sent on the backchannel UART (see trace.h) once the clock is back
+ to the 12 MHz set by SystemInit, and the results stay in RAM for the debugger.
+ Cases that change the state they measure (the holdoff of the port interrupt
+ case) restore it before each sample, outside of the measurement.
+ Defining BENCH_HOST as well builds the same suite on the host (make -C host
+ bench), against the simulated registers of host/sim.c, timed with the
+ monotonic clock in nanoseconds and printed on the standard output.
+
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+*/
+
+// Do not write above this line (except comments)!
+#ifndef BENCH_H
+#define BENCH_H
+
+/* SECTION 1: Included header files required to compile this file  */
+#include <stdint.h>
+
+
+/* SECTION 2: Public macros                                        */
+
+/**
+ @brief Measurements of each case (odd, so that the median is a sample)
+*/
+#define BENCH_SAMPLES    101
+
+#define BENCH_NUM_CASES  10
+
+
+/* SECTION 3: Public types                                         */
+
+/**
+ @brief Result of a case at a clock frequency, overhead of the measurement removed
+*/
+struct bench_result_s {
+   const char *name;    /**< Case name, as printed                      */
+   uint32_t clock_hz;   /**< MCLK frequency (0 on the host)             */
+   uint32_t min;        /**< Fastest sample, in cycles (ns on the host) */
+   uint32_t median;     /**< Median sample                              */
+   uint32_t max;        /**< Slowest sample                             */
+};
+
+/**
+ @brief Short alias "bench_result_t" for the data type "struct bench_result_s"
+*/
+typedef struct bench_result_s bench_result_t;
+
+
+/* SECTION 4: Public variables :: declarations, extern mandatory   */
+
+
+/* SECTION 5: Public functions :: declarations, extern optional
+   Rule exception (callbacks)  :: declarations, extern recommended */
+
+int benchRunCases(bench_result_t *results); //Run every case at the current clock, fills BENCH_NUM_CASES results
+
+void benchPrint(const bench_result_t *results, int count); //Report results as CSV lines
+
+
+#endif //BENCH_H
+// Do not write below this line!
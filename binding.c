@@ -0,0 +1,264 @@
+/**
+ @file    binding.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Input-to-output binding rules applied in the interrupt of the input
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "binding.h"
+#include "button.h"
+#include "led.h"
+#include "systime.h"
+
+
+/* SECTION 2: Private macros                                       */
+
+/**
+ @brief Buttons that can be bound (physical and virtual)
+*/
+#define BINDING_MAX_BUTTONS  32
+
+/**
+ @brief Entries of the index of the operations, one per button and event
+*/
+#define BINDING_NUM_KEYS     (BINDING_MAX_BUTTONS * BUTTON_NUM_EVENTS)
+
+
+/* SECTION 3: Private types                                        */
+
+/**
+ @brief Compiled operation, applied to the LEDs on an event
+*/
+struct binding_op_s {
+   led_op_t op;       /**< Change of the LEDs of a port             */
+   int8_t   pulse;    /**< Pulse ended by an alarm (-1 if none)     */
+};
+
+/**
+ @brief Short alias "binding_op_t" for the data type "struct binding_op_s"
+*/
+typedef struct binding_op_s binding_op_t;
+
+/**
+ @brief Pulse of a LED, switched off by its alarm
+*/
+struct binding_pulse_s {
+   led_op_t        off;      /**< Operation ending the pulse  */
+   systime_t       ticks;    /**< Length of the pulse         */
+   systime_alarm_t alarm;
+};
+
+/**
+ @brief Short alias "binding_pulse_t" for the data type "struct binding_pulse_s"
+*/
+typedef struct binding_pulse_s binding_pulse_t;
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+static binding_op_t _bindingOps [BINDING_MAX_OPS];
+static binding_pulse_t _bindingPulses [BINDING_MAX_PULSES];
+static int _bindingNumPulses = 0;
+
+/**
+ @brief Operations of each button and event: from _bindingFirst[key] to
+ _bindingFirst[key + 1], key being button * BUTTON_NUM_EVENTS + event
+*/
+static volatile uint8_t _bindingFirst [BINDING_NUM_KEYS + 1];
+
+/**
+ @brief Subscriptions making the button module follow the release of the bound buttons
+*/
+static button_subscriber_t _bindingRelease [BINDING_MAX_BUTTONS];
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static int _bindingCheck(const binding_rule_t *rule); //1 if a rule is valid
+
+static int _bindingCompile(const binding_rule_t *rule, int first, int num_ops); //Add a rule to the operations of its event, returns the number of operations (-1 if full)
+
+static void _bindingFollow(int which_button, int event, void *context); //Subscriber of the bound releases, nothing to do
+
+static void _bindingPulseEnd(void *context); //Alarm callback ending a pulse
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+int bindingsInit(const binding_rule_t *rules, int num_rules)
+{
+    uint8_t first [BINDING_NUM_KEYS + 1];
+    int i, key, num_ops;
+    bool state;
+
+    if(num_rules < 0 || (rules == 0 && num_rules > 0))
+        return -1;
+
+    for(i = 0; i < num_rules; i++)
+    {
+        if(!_bindingCheck(&rules[i]))
+            return -1;
+    }
+
+    /* The ISRs see no rule while the table is rebuilt */
+    CRITICAL_ENTER(state);
+    for(key = 0; key < BINDING_NUM_KEYS + 1; key++)
+        _bindingFirst[key] = 0;
+    CRITICAL_EXIT(state);
+
+    for(i = 0; i < _bindingNumPulses; i++)
+        systimeAlarmCancel(&_bindingPulses[i].alarm);
+    _bindingNumPulses = 0;
+
+    for(i = 0; i < BINDING_MAX_BUTTONS; i++)
+        buttonUnsubscribe(&_bindingRelease[i]);
+
+    /* Grouped by button and event, in the order of the table */
+    num_ops = 0;
+    for(key = 0; key < BINDING_NUM_KEYS; key++)
+    {
+        first[key] = num_ops;
+
+        for(i = 0; i < num_rules; i++)
+        {
+            if(rules[i].button * BUTTON_NUM_EVENTS + rules[i].event != key)
+                continue;
+
+            num_ops = _bindingCompile(&rules[i], first[key], num_ops);
+            if(num_ops < 0)
+                return -1;
+
+            if(rules[i].event == BUTTON_EVENT_RELEASE
+               && buttonSubscribe(&_bindingRelease[rules[i].button], rules[i].button,
+                                  BUTTON_EVENT_RELEASE, _bindingFollow, 0) < 0)
+                return -1;
+        }
+    }
+    first[BINDING_NUM_KEYS] = num_ops;
+
+    CRITICAL_ENTER(state);
+    for(key = 0; key < BINDING_NUM_KEYS + 1; key++)
+        _bindingFirst[key] = first[key];
+    CRITICAL_EXIT(state);
+
+    return num_ops;
+}
+
+int bindingsGetNum(void)
+{
+    return _bindingFirst[BINDING_NUM_KEYS];
+}
+
+void bindingApply(int which_button, int event)
+{
+    const binding_op_t *op;
+    binding_pulse_t *pulse;
+    int key, i;
+
+    if(which_button < 0 || which_button >= BINDING_MAX_BUTTONS || event < 0 || event >= BUTTON_NUM_EVENTS)
+        return;
+
+    key = which_button * BUTTON_NUM_EVENTS + event;
+
+    for(i = _bindingFirst[key]; i < _bindingFirst[key + 1]; i++)
+    {
+        op = &_bindingOps[i];
+        ledOpApply(&op->op);
+
+        if(op->pulse >= 0)
+        {
+            pulse = &_bindingPulses[op->pulse];
+            systimeAlarmStart(&pulse->alarm, systimeNow() + pulse->ticks, _bindingPulseEnd, pulse);
+        }
+    }
+}
+
+static int _bindingCheck(const binding_rule_t *rule)
+{
+    led_op_t op = {0};
+
+    if(rule->button < 0 || rule->button >= BINDING_MAX_BUTTONS)
+        return 0;
+
+    if(rule->event < 0 || rule->event >= BUTTON_NUM_EVENTS)
+        return 0;
+
+    /* Only the LEDs on pins have port operations */
+    if(ledOpAdd(&op, rule->led, LED_OP_ON) < 0)
+        return 0;
+
+    if(rule->action < BINDING_ACTION_ON || rule->action > BINDING_ACTION_PULSE)
+        return 0;
+
+    if(rule->action == BINDING_ACTION_PULSE && rule->pulse_ms == 0)
+        return 0;
+
+    return 1;
+}
+
+static int _bindingCompile(const binding_rule_t *rule, int first, int num_ops)
+{
+    binding_pulse_t *pulse;
+    int i;
+
+    /* A pulse has its own operation, ended by its own alarm */
+    if(rule->action == BINDING_ACTION_PULSE)
+    {
+        if(num_ops >= BINDING_MAX_OPS || _bindingNumPulses >= BINDING_MAX_PULSES)
+            return -1;
+
+        pulse = &_bindingPulses[_bindingNumPulses];
+        pulse->off.set = pulse->off.clear = pulse->off.toggle = 0;
+        ledOpAdd(&pulse->off, rule->led, LED_OP_OFF);
+        pulse->ticks = systimeMsToTicks(rule->pulse_ms);
+
+        _bindingOps[num_ops].op.set = _bindingOps[num_ops].op.clear = _bindingOps[num_ops].op.toggle = 0;
+        ledOpAdd(&_bindingOps[num_ops].op, rule->led, LED_OP_ON);
+        _bindingOps[num_ops].pulse = _bindingNumPulses;
+        _bindingNumPulses++;
+
+        return num_ops + 1;
+    }
+
+    /* Merged with an operation of the same event on the same port, if any */
+    for(i = first; i < num_ops; i++)
+    {
+        if(_bindingOps[i].pulse < 0 && ledOpAdd(&_bindingOps[i].op, rule->led, rule->action) > 0)
+            return num_ops;
+    }
+
+    if(num_ops >= BINDING_MAX_OPS)
+        return -1;
+
+    /* BINDING_ACTION_x and LED_OP_x match, pulses apart */
+    _bindingOps[num_ops].op.set = _bindingOps[num_ops].op.clear = _bindingOps[num_ops].op.toggle = 0;
+    ledOpAdd(&_bindingOps[num_ops].op, rule->led, rule->action);
+    _bindingOps[num_ops].pulse = -1;
+
+    return num_ops + 1;
+}
+
+static void _bindingFollow(int which_button, int event, void *context)
+{
+    /* The rules were applied by the ISR */
+}
+
+static void _bindingPulseEnd(void *context)
+{
+    binding_pulse_t *pulse = (binding_pulse_t *)context;
+
+    ledOpApply(&pulse->off);
+}
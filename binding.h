@@ -0,0 +1,84 @@
+/**
+ @file    binding.h
+
+ @brief   Input-to-output binding rules applied in the interrupt of the input
+
+ A binding rule ties an event of a button to an action on a LED: switch it on,
+ off, toggle it, or switch it on for a pulse of some milliseconds. The table of
+ rules is compiled by @ref bindingsInit into LED port operations (see ledOpAdd),
+ rules of the same event on the same port merged into one, and indexed by
+ button and event. The button module applies them as soon as it accepts an
+ event, in the ISR, before the event is posted to the subscribers: the reaction
+ does not wait for the deferred callbacks and takes a fixed number of cycles.
+
+ Only events raised by the button module are seen: polled buttons have none,
+ and the release of a button is followed only if a rule or a subscriber uses it.
+ The bound LEDs must be on MCU pins, not on the shift register chain, and
+ should not blink: a binding does not stop the blinking.
+
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+*/
+
+// Do not write above this line (except comments)!
+#ifndef BINDING_H
+#define BINDING_H
+
+/* SECTION 1: Included header files required to compile this file  */
+#include <stdint.h>
+
+
+/* SECTION 2: Public macros                                        */
+
+/**
+ @brief Set to 0 to remove the bindings from the button ISRs
+*/
+#define BINDING_ENABLED  1
+
+/**
+ @brief Compiled operations and pulse rules at most
+*/
+#define BINDING_MAX_OPS     16
+#define BINDING_MAX_PULSES  4
+
+#define BINDING_ACTION_ON      0
+#define BINDING_ACTION_OFF     1
+#define BINDING_ACTION_TOGGLE  2
+#define BINDING_ACTION_PULSE   3 //On, then off after pulse_ms (restarted by each event)
+
+
+/* SECTION 3: Public types                                         */
+
+/**
+ @brief Binding rule: input event -> output action
+*/
+struct binding_rule_s {
+   int8_t   button;    /**< Button (BUTTONx), also virtual         */
+   int8_t   event;     /**< Event (BUTTON_EVENT_x)                 */
+   int8_t   led;       /**< LED (LEDx)                             */
+   int8_t   action;    /**< Action (BINDING_ACTION_x)              */
+   uint16_t pulse_ms;  /**< Length of a pulse, in milliseconds     */
+};
+
+/**
+ @brief Short alias "binding_rule_t" for the data type "struct binding_rule_s"
+*/
+typedef struct binding_rule_s binding_rule_t;
+
+
+/* SECTION 4: Public variables :: declarations, extern mandatory   */
+
+
+/* SECTION 5: Public functions :: declarations, extern optional
+   Rule exception (callbacks)  :: declarations, extern recommended */
+
+int bindingsInit(const binding_rule_t *rules, int num_rules); //Compile a table of rules (replacing the previous one), after ledsInit and buttonsInit: number of operations, -1 if invalid
+
+int bindingsGetNum(void); //Get the number of compiled operations
+
+void bindingApply(int which_button, int event); //Apply the rules of an event, called by the button module
+
+
+#endif //BINDING_H
+// Do not write below this line!
@@ -0,0 +1,248 @@
+/**
+ @file    binding_test.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Host test of the binding rules: compilation, reaction in the ISR, pulses
+
+ Built by host/Makefile. The tables are checked for the operations they
+ compile to (rules of an event on one port merged, pulses apart, the limits of
+ binding.h), then BUTTON1 is pressed and released: the bound LEDs must have
+ changed when the subscribers run, while the LED bookkeeping (the saved state)
+ waits for the deferred work. A pulse must end after its length, counted from
+ the last event, and a new table must drop the rules and pulses of the old one.
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "binding.h"
+#include "button.h"
+#include "led.h"
+#include "defer.h"
+#include "persist.h"
+#include "systime.h"
+#include "sim.h"
+
+/* The whole file belongs to the host build (see host/Makefile) */
+#ifdef BENCH_HOST
+
+
+/* SECTION 2: Private macros                                       */
+
+#define TEST_PULSE_MS   100
+#define TEST_LED_PORTS  3     //Ports of the LEDs on pins: P1, P2 and P5 (see led.c)
+
+
+/* SECTION 3: Private types                                        */
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+static button_subscriber_t _testSub;
+static int _testSeen = -1;    /**< State of LED1_RED seen by the subscriber (-1 if not called) */
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static void _testStart(void); //Reset the simulation and the modules, as after a cold reset
+
+static void _testHandler(int which_button, int event, void *context); //Subscriber: record the state of LED1_RED
+
+static void _testCompile(void);
+
+static void _testReaction(void);
+
+static void _testPulse(void);
+
+static void _testRebuild(void);
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+int main(void)
+{
+    _testCompile();
+    _testReaction();
+    _testPulse();
+    _testRebuild();
+
+    return simReport("binding_test");
+}
+
+static void _testStart(void)
+{
+    persistInvalidate();
+    simReset();
+    deferInit();
+    systimeInit();
+    ledsInit();
+    buttonsInit();
+    Interrupt_enableMaster();
+
+    _testSeen = -1;
+}
+
+static void _testHandler(int which_button, int event, void *context)
+{
+    _testSeen = ledGet(LED1_RED);
+}
+
+static void _testCompile(void)
+{
+    binding_rule_t rules [BINDING_MAX_OPS + 1];
+    int i;
+
+    static const binding_rule_t merged[] = {
+        { BUTTON1, BUTTON_EVENT_PRESS,   LED1_RED,   BINDING_ACTION_ON },
+        { BUTTON1, BUTTON_EVENT_PRESS,   LED1_GREEN, BINDING_ACTION_TOGGLE },
+        { BUTTON1, BUTTON_EVENT_PRESS,   LED0,       BINDING_ACTION_ON },
+        { BUTTON1, BUTTON_EVENT_PRESS,   LED1_BLUE,  BINDING_ACTION_OFF },
+        { BUTTON1, BUTTON_EVENT_RELEASE, LED1_RED,   BINDING_ACTION_OFF },
+        { BUTTON2, BUTTON_EVENT_PRESS,   LED1_RED,   BINDING_ACTION_PULSE, TEST_PULSE_MS }
+    };
+
+    static const binding_rule_t invalid[] = {
+        { -1,      BUTTON_EVENT_PRESS, LED0,         BINDING_ACTION_ON },
+        { BUTTON1, BUTTON_NUM_EVENTS,  LED0,         BINDING_ACTION_ON },
+        { BUTTON1, BUTTON_EVENT_PRESS, LED_CHAIN(0), BINDING_ACTION_ON },
+        { BUTTON1, BUTTON_EVENT_PRESS, LED0,         BINDING_ACTION_PULSE + 1 },
+        { BUTTON1, BUTTON_EVENT_PRESS, LED0,         BINDING_ACTION_PULSE, 0 }
+    };
+
+    _testStart();
+
+    /* The press rules on P2 in one operation, LED0 (P1) in another, release and pulse apart */
+    SIM_CHECK(bindingsInit(merged, 6) == 4 && bindingsGetNum() == 4);
+
+    /* An invalid rule rejects the table */
+    for(i = 0; i < 5; i++)
+        SIM_CHECK(bindingsInit(&invalid[i], 1) == -1);
+    SIM_CHECK(bindingsInit(0, 1) == -1 && bindingsInit(merged, -1) == -1);
+
+    /* One operation per event past the limit, one pulse past its own */
+    for(i = 0; i < BINDING_MAX_OPS + 1; i++)
+    {
+        rules[i].button = BUTTON_VIRTUAL(i / BUTTON_NUM_EVENTS);
+        rules[i].event = i % BUTTON_NUM_EVENTS;
+        rules[i].led = LED0;
+        rules[i].action = BINDING_ACTION_PULSE;
+        rules[i].pulse_ms = TEST_PULSE_MS;
+    }
+    SIM_CHECK(bindingsInit(rules, BINDING_MAX_PULSES) == BINDING_MAX_PULSES);
+    SIM_CHECK(bindingsInit(rules, BINDING_MAX_PULSES + 1) == -1);
+
+    for(i = 0; i < BINDING_MAX_OPS + 1; i++)
+        rules[i].action = BINDING_ACTION_TOGGLE;
+    SIM_CHECK(bindingsInit(rules, BINDING_MAX_OPS) == BINDING_MAX_OPS);
+    SIM_CHECK(bindingsInit(rules, BINDING_MAX_OPS + 1) == -1);
+
+    /* Emptied */
+    SIM_CHECK(bindingsInit(0, 0) == 0 && bindingsGetNum() == 0);
+}
+
+static void _testReaction(void)
+{
+    uint8_t saved [TEST_LED_PORTS];
+    bool state;
+
+    static const binding_rule_t rules[] = {
+        { BUTTON1, BUTTON_EVENT_PRESS,   LED1_RED,   BINDING_ACTION_ON },
+        { BUTTON1, BUTTON_EVENT_PRESS,   LED1_GREEN, BINDING_ACTION_ON },
+        { BUTTON1, BUTTON_EVENT_RELEASE, LED1_RED,   BINDING_ACTION_OFF }
+    };
+
+    _testStart();
+    SIM_CHECK(bindingsInit(rules, 3) == 2);
+    SIM_CHECK(buttonSubscribe(&_testSub, BUTTON1, BUTTON_EVENT_PRESS, _testHandler, 0) == 1);
+
+    /* Written by the ISR, even in deferred mode, before the subscriber runs */
+    ledSetDeferred(1);
+    simPinSet(1, BIT4, 0);
+    SIM_CHECK(_testSeen == 1);
+    SIM_CHECK((P2->OUT & (BIT0 | BIT1)) == (BIT0 | BIT1));
+
+    /* The release only switches LED1_RED off */
+    simPinSet(1, BIT4, 1);
+    SIM_CHECK((P2->OUT & (BIT0 | BIT1)) == BIT1);
+    ledSetDeferred(0);
+    buttonUnsubscribe(&_testSub);
+
+    /* The port is written at once, the state is saved by the deferred work */
+    _testStart();
+    SIM_CHECK(bindingsInit(rules, 3) == 2);
+    state = Interrupt_disableMaster();
+    bindingApply(BUTTON1, BUTTON_EVENT_PRESS);
+    SIM_CHECK((P2->OUT & (BIT0 | BIT1)) == (BIT0 | BIT1));
+    SIM_CHECK(persistLoad(PERSIST_SLOT_LEDS, saved, TEST_LED_PORTS) == 0);
+    if(!state)
+        Interrupt_enableMaster();
+    SIM_CHECK(persistLoad(PERSIST_SLOT_LEDS, saved, TEST_LED_PORTS) == 1);
+
+    /* Events without rules and invalid ones change nothing */
+    bindingApply(BUTTON2, BUTTON_EVENT_PRESS);
+    bindingApply(-1, BUTTON_EVENT_PRESS);
+    bindingApply(BUTTON1, BUTTON_NUM_EVENTS);
+    SIM_CHECK((P2->OUT & (BIT0 | BIT1)) == (BIT0 | BIT1) && (P1->OUT & BIT0) == 0);
+}
+
+static void _testPulse(void)
+{
+    static const binding_rule_t rules[] = {
+        { BUTTON2, BUTTON_EVENT_PRESS, LED0, BINDING_ACTION_PULSE, TEST_PULSE_MS }
+    };
+
+    _testStart();
+    SIM_CHECK(bindingsInit(rules, 1) == 1);
+
+    bindingApply(BUTTON2, BUTTON_EVENT_PRESS);
+    SIM_CHECK(ledGet(LED0) == 1 && (P1->OUT & BIT0) != 0);
+
+    /* Restarted by a second event halfway */
+    simAdvanceUs(TEST_PULSE_MS * 500);
+    bindingApply(BUTTON2, BUTTON_EVENT_PRESS);
+    simAdvanceUs(TEST_PULSE_MS * 800);
+    SIM_CHECK(ledGet(LED0) == 1);
+
+    /* Off one pulse after the last event, within a tick */
+    simAdvanceUs(TEST_PULSE_MS * 200 + 100);
+    SIM_CHECK(ledGet(LED0) == 0 && (P1->OUT & BIT0) == 0);
+}
+
+static void _testRebuild(void)
+{
+    static const binding_rule_t first[] = {
+        { BUTTON2, BUTTON_EVENT_PRESS, LED0,     BINDING_ACTION_PULSE, TEST_PULSE_MS },
+        { BUTTON1, BUTTON_EVENT_PRESS, LED1_RED, BINDING_ACTION_TOGGLE }
+    };
+
+    static const binding_rule_t second[] = {
+        { BUTTON1, BUTTON_EVENT_PRESS, LED2_BLUE, BINDING_ACTION_ON }
+    };
+
+    _testStart();
+    SIM_CHECK(bindingsInit(first, 2) == 2);
+
+    /* A pulse running when the table changes is left on, its alarm cancelled */
+    bindingApply(BUTTON2, BUTTON_EVENT_PRESS);
+    SIM_CHECK(bindingsInit(second, 1) == 1);
+    simAdvanceUs(TEST_PULSE_MS * 2000);
+    SIM_CHECK(ledGet(LED0) == 1);
+
+    /* Only the rules of the new table apply */
+    bindingApply(BUTTON1, BUTTON_EVENT_PRESS);
+    bindingApply(BUTTON2, BUTTON_EVENT_PRESS);
+    SIM_CHECK(ledGet(LED1_RED) == 0 && ledGet(LED2_BLUE) == 1);
+    SIM_CHECK(ledGet(LED0) == 1);
+}
+
+#endif //BENCH_HOST
@@ -0,0 +1,79 @@
+/**
+ @file    bootprof.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Boot time profiling, from reset to application ready
+
+ @remark The functions in this file run before the C initialization routine, so they
+ must not depend on initialized data.
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "bootprof.h"
+
+
+/* SECTION 2: Private macros                                       */
+
+
+/* SECTION 3: Private types                                        */
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+/**
+ @brief Cycle counter value at each boot stage
+ @remark Not initialized by .cinit: written before it runs
+*/
+#pragma NOINIT(_bootprofStamps)
+static uint32_t _bootprofStamps[BOOT_NUM_STAGES];
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+void bootprofStart(void)
+{
+    CoreDebug->DEMCR = CoreDebug->DEMCR | CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL = DWT->CTRL | DWT_CTRL_CYCCNTENA_Msk;
+
+    _bootprofStamps[BOOT_STAGE_RESET] = 0;
+}
+
+void bootprofStamp(int stage)
+{
+    if(stage < 0 || stage > BOOT_NUM_STAGES-1)
+        return;
+
+    _bootprofStamps[stage] = CYCLES_NOW();
+}
+
+int32_t bootprofCycles(int stage)
+{
+    if(stage < 0 || stage > BOOT_NUM_STAGES-1)
+        return -1;
+
+    return (int32_t)_bootprofStamps[stage];
+}
+
+int32_t bootprofStageCycles(int stage)
+{
+    if(stage < 1 || stage > BOOT_NUM_STAGES-1)
+        return -1;
+
+    return (int32_t)(_bootprofStamps[stage] - _bootprofStamps[stage-1]);
+}
@@ -0,0 +1,54 @@
+/**
+ @file    bootprof.h
+
+ @brief   Boot time profiling, from reset to application ready
+
+ Each boot stage records the DWT cycle counter, which is started by the reset
+ handler before anything else runs. The stamps live in a no-init RAM section,
+ so the C initialization routine does not clear the early ones.
+
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+*/
+
+// Do not write above this line (except comments)!
+#ifndef BOOTPROF_H
+#define BOOTPROF_H
+
+/* SECTION 1: Included header files required to compile this file  */
+#include <stdint.h>
+
+
+/* SECTION 2: Public macros                                        */
+
+#define BOOT_STAGE_RESET    0 //Reset handler entry
+#define BOOT_STAGE_SYSINIT  1 //SystemInit done (clock, WDT, SRAM banks)
+#define BOOT_STAGE_MAIN     2 //main entry, C initialization (.cinit) done
+#define BOOT_STAGE_LEDS     3 //ledsInit done
+#define BOOT_STAGE_BUTTONS  4 //buttonsInit done
+#define BOOT_STAGE_READY    5 //Application ready, superloop entry
+
+#define BOOT_NUM_STAGES     6
+
+
+/* SECTION 3: Public types                                         */
+
+
+/* SECTION 4: Public variables :: declarations, extern mandatory   */
+
+
+/* SECTION 5: Public functions :: declarations, extern optional
+   Rule exception (callbacks)  :: declarations, extern recommended */
+
+void bootprofStart(void); //Enable and reset the cycle counter, called first thing from the reset handler
+
+void bootprofStamp(int stage); //Record the cycle counter for a boot stage
+
+int32_t bootprofCycles(int stage); //Cycles from reset to a boot stage, -1 if invalid
+
+int32_t bootprofStageCycles(int stage); //Cycles spent between the previous stage and this one, -1 if invalid
+
+
+#endif //BOOTPROF_H
+// Do not write below this line!
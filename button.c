@@ -13,6 +13,15 @@
 #include "button.h"
 #include "common.h"
 #include "ti/devices/msp432p4xx/driverlib/driverlib.h"
+#include "inputtrace.h"
+#include "systime.h"
+#include "defer.h"
+#include "persist.h"
+#include "trace.h"
+#include "binding.h"
+#include "stackmon.h"
+#include "cpuload.h"
+#include "rtos.h"
 
 
 /* SECTION 2: Private macros
@@ -23,30 +32,96 @@
 */
 #define NUM_BUTTONS (sizeof(_pinrefs) / sizeof(input_ref_t))
 
+/**
+@brief Timer used to timestamp the edges of the buttons with use_capture == 1
+@note It runs from SMCLK in continuous mode; CCR0 is reserved for overflow handling.
+ Changing it also requires renaming the TA2 ISRs and @ref BUTTON_CAPTURE_INT_0 / _N
+*/
+#define BUTTON_CAPTURE_TIMER  TIMER_A2
+#define BUTTON_CAPTURE_INT_0  INT_TA2_0
+#define BUTTON_CAPTURE_INT_N  INT_TA2_N
+
+/**
+@brief Number of capture channels of @ref BUTTON_CAPTURE_TIMER, CCR0 included
+*/
+#define BUTTON_CAPTURE_CCRS   5
+
+/**
+@brief Value of the TAxIV register for the overflow flag (TAIFG)
+*/
+#define BUTTON_CAPTURE_IV_WRAP 0x0E
+
+/**
+@brief Window over which the rate_limit of a pin is applied
+*/
+#define BUTTON_RATE_WINDOW_MS  1000
+
+/**
+@brief Number of interruptible ports (P1 to P6)
+*/
+#define BUTTON_NUM_PORTS       6
+
 
 /**
 @brief Private array of pin references for buttons on the board
 */
-static input_ref_t _pinrefs [] = {
+static const input_ref_t _pinrefs [] = {
      { .mask = BIT1 , .port_is_odd = 1, .odd = P1 , // BUTTON0 P1 .1
        .use_pullup = 1,                             // Internal pull -up
        .int_num = INT_PORT1 , .use_interrupt = 0 // Polling
      },
      { .mask = BIT4 , .port_is_odd = 1, .odd = P1 , // BUTTON1 P1 .4
        .use_pullup = 1,                             // Internal pull -up
-       .int_num = INT_PORT1 , .use_interrupt = 1    // Interrupts
+       .int_num = INT_PORT1 , .use_interrupt = 1,   // Interrupts
+       .int_priority = 2,                           // Priority
+       .holdoff_ms = 0 , .rate_limit = 0            // No storm protection (see buttonStormSet)
      },
      { .mask = BIT1 , .port_is_odd = 1, .odd = P5 , // BUTTON2 P5 .1
        .use_pullup = 0,                             // No internal pull -up
-       .int_num = INT_PORT5 , .use_interrupt = 1    // Interrupts
+       .int_num = INT_PORT5 , .use_interrupt = 1,   // Interrupts
+       .int_priority = 2,                           // Priority
+       .holdoff_ms = 0 , .rate_limit = 0            // No storm protection (see buttonStormSet)
      },
      { .mask = BIT5 , .port_is_odd = 1, .odd = P3 , // BUTTON3 P3 .5
        .use_pullup = 0,                             // No internal pull -up
        .int_num = INT_PORT3 , .use_interrupt = 0    // Polling
+     },
+     { .mask = BIT7 , .port_is_odd = 1, .odd = P5 , // BUTTON4 P5 .7 (TA2 .2)
+       .use_pullup = 1,                             // Internal pull -up
+       .int_num = INT_PORT5 , .use_interrupt = 0,   // No port interrupt
+       .use_capture = 1 , .capture_ccr = 2,         // Capture channel
+       .int_priority = 2                            // Priority of the timer
      }
 };
+
+/**
+ @brief Compile-time check: BUTTON_NUM_PINS (button.h) must count the entries of @ref _pinrefs,
+ and the virtual buttons must fit the 32 bits of the button masks
+*/
+typedef char _buttonNumPinsCheck [(NUM_BUTTONS == BUTTON_NUM_PINS && BUTTON_VIRTUAL(BUTTON_NUM_VIRTUAL) <= 32) ? 1 : -1];
 /* SECTION 3: Private types                                        */
 
+/**
+ @brief Datatype used to initialize all the buttons of a port at once
+*/
+struct button_port_s {
+   uint8_t  mask;          /**< Pins of the port used by buttons           */
+   uint8_t  pullup_mask;   /**< Pins requiring the internal pull-up        */
+   uint8_t  int_mask;      /**< Pins managed using interrupts              */
+   uint8_t  port_is_odd;   /**< Flag (0/1) to know which pointer to use    */
+   uint8_t  int_priority;  /**< NVIC priority of the port (0 to 7)         */
+   uint16_t int_num;       /**< Interrupt number of the port               */
+   union {
+      DIO_PORT_Odd_Interruptable_Type  *odd;  /**< Odd port: P1, P3, ...   */
+      DIO_PORT_Even_Interruptable_Type *even; /**< Even port: P2, P4, ...  */
+   };
+};
+
+/**
+ @brief Short alias "button_port_t" for the data type "struct button_port_s"
+*/
+typedef struct button_port_s button_port_t;
+
 
 /* SECTION 4: Public variables  :: definitions, no extern 
    (must match declarations in header file)                        */
@@ -55,15 +130,109 @@ static input_ref_t _pinrefs [] = {
 /* SECTION 5: Private variables :: definitions, static mandatory 
   (no need to declare, definitions include declarations)           */
 
+/**
+@brief Number of half periods of @ref BUTTON_CAPTURE_TIMER handled by its ISRs
+*/
+static volatile uint32_t _buttonCaptureHalves = 0;
+
+/**
+@brief Button associated to each capture channel (-1 if none)
+*/
+static int8_t _buttonCaptureOf [BUTTON_CAPTURE_CCRS] = {-1, -1, -1, -1, -1};
+
+/**
+@brief Timestamp of the last captured edge of each button, in SMCLK cycles
+*/
+static uint64_t _buttonEdgeTime [NUM_BUTTONS];
+
+/**
+@brief Alarms re-enabling the pin interrupts at the end of the holdoff
+*/
+static systime_alarm_t _buttonHoldoff [NUM_BUTTONS];
+
+/**
+@brief Start of the current rate limiting window of each button
+*/
+static systime_t _buttonWindowStart [NUM_BUTTONS];
+
+/**
+@brief Events delivered in the current rate limiting window of each button
+*/
+static uint16_t _buttonWindowCount [NUM_BUTTONS];
+
+/**
+@brief Storm counters of each button
+*/
+static button_storm_t _buttonStorm [NUM_BUTTONS];
+
+/**
+@brief Storm protection of each button, from _pinrefs or @ref buttonStormSet
+*/
+static uint16_t _buttonHoldoffMs [NUM_BUTTONS];
+static uint16_t _buttonRateLimit [NUM_BUTTONS];
+
+/**
+@brief Button of each interrupt pin, indexed by port (0 for P1) and pin number (-1 if none)
+*/
+static int8_t _buttonOfPin [BUTTON_NUM_PORTS][8];
+
+/**
+@brief Subscribers of each event of each button
+*/
+static button_subscriber_t *_buttonSubscribers [NUM_BUTTONS + BUTTON_NUM_VIRTUAL][BUTTON_NUM_EVENTS];
+
+/**
+@brief Current state and press latch (for buttonPressed) of the virtual buttons, one bit each
+*/
+static volatile uint32_t _buttonVirtualState = 0;
+static volatile uint32_t _buttonVirtualPressed = 0;
+
+/**
+@brief Pins of each port following both edges because their release is subscribed
+*/
+static uint8_t _buttonBothEdges [BUTTON_NUM_PORTS];
+
+/**
+@brief Handlers of the port interrupt pins owned by other modules (see buttonPinHook)
+*/
+static button_pin_hook_t _buttonHook [BUTTON_NUM_PORTS];
+static void *_buttonHookContext [BUTTON_NUM_PORTS];
+static uint8_t _buttonHookMask [BUTTON_NUM_PORTS];
+
 
 /* SECTION 6: Private functions :: declarations, static mandatory
    Rule exception (ISRs)        :: declarations, no static         */
-static void _buttonInit(input_ref_t *ref); //Initialization function for a single button
+static void _buttonInit(const button_port_t *port); //Initialization function for the buttons of a port
 
+static int _buttonPortLookup(button_port_t *ports, int num_ports, const input_ref_t *ref); //Find or add the entry for the port of a pin
+
+
+static void _buttonCaptureInit(void); //Route the capture pins to the timer and start it
+
+static uint64_t _buttonCaptureTimestamp(uint16_t captured); //Extend a captured 16-bit value to 64 bits
+
+static void _buttonPortIsr(uint16_t int_num , uint8_t in , uint8_t flag); //Common part of the port ISRs, once the flags are acknowledged
 
 static void _buttonProcessFlags(uint16_t int_num , uint8_t flag);
 
-static int _buttonInverseLookup(uint16_t int_num , uint8_t mask);
+static void _buttonDispatch(int arg); //Deliver an event (button | event << 8) to the application
+
+static void _buttonPost(int button, int event); //Deliver an event now or from PendSV
+
+static int _buttonEdgeEvent(int button); //Event of the edge that raised the flag of a pin, re-arms the opposite edge
+
+static int _buttonTrackLevel(const input_ref_t *ref); //Select the edge leaving the current level, 1 if pressed
+
+static void _buttonPersist(void); //Save the state of the virtual buttons for a warm reset
+
+static int _buttonAdmit(int button); //Apply the holdoff and rate limit of a button to an edge, 1 if it must be delivered
+
+static void _buttonRearm(void *context); //Alarm callback at the end of a holdoff
+
+void TA2_0_IRQHandler(void);
+
+void TA2_N_IRQHandler(void);
+
 /* SECTION 7: Private functions :: definitions, static mandatory
    Rule exception (ISRs)        :: definitions, no static 
    Public functions             :: definitions, no extern
@@ -77,49 +246,130 @@ void buttonCallback(int which_button)
 void PORT1_IRQHandler(void)
 {
     uint8_t filtered_buttons;
+    STACKMON_ISR_ENTER(STACKMON_ISR_PORT1);
+    CPULOAD_ISR_ENTER(CPULOAD_ISR_PORT1);
     filtered_buttons = P1->IFG & P1->IE;
     P1->IFG &= ~filtered_buttons;
-    _buttonProcessFlags(INT_PORT1 , filtered_buttons);
+    _buttonPortIsr(INT_PORT1 , P1->IN , filtered_buttons);
+    CPULOAD_ISR_EXIT(CPULOAD_ISR_PORT1);
+    STACKMON_ISR_EXIT(STACKMON_ISR_PORT1);
 }
 void PORT2_IRQHandler(void)
 {
     uint8_t filtered_buttons;
+    STACKMON_ISR_ENTER(STACKMON_ISR_PORT2);
+    CPULOAD_ISR_ENTER(CPULOAD_ISR_PORT2);
     filtered_buttons = P2->IFG & P2->IE;
     P2->IFG &= ~filtered_buttons;
-    _buttonProcessFlags(INT_PORT2 , filtered_buttons);
+    _buttonPortIsr(INT_PORT2 , P2->IN , filtered_buttons);
+    CPULOAD_ISR_EXIT(CPULOAD_ISR_PORT2);
+    STACKMON_ISR_EXIT(STACKMON_ISR_PORT2);
 }
 void PORT3_IRQHandler(void)
 {
     uint8_t filtered_buttons;
+    STACKMON_ISR_ENTER(STACKMON_ISR_PORT3);
+    CPULOAD_ISR_ENTER(CPULOAD_ISR_PORT3);
     filtered_buttons = P3->IFG & P3->IE;
     P3->IFG &= ~filtered_buttons;
-    _buttonProcessFlags(INT_PORT3 , filtered_buttons);
+    _buttonPortIsr(INT_PORT3 , P3->IN , filtered_buttons);
+    CPULOAD_ISR_EXIT(CPULOAD_ISR_PORT3);
+    STACKMON_ISR_EXIT(STACKMON_ISR_PORT3);
 }
 void PORT4_IRQHandler(void)
 {
     uint8_t filtered_buttons;
+    STACKMON_ISR_ENTER(STACKMON_ISR_PORT4);
+    CPULOAD_ISR_ENTER(CPULOAD_ISR_PORT4);
     filtered_buttons = P4->IFG & P4->IE;
     P4->IFG &= ~filtered_buttons;
-    _buttonProcessFlags(INT_PORT4 , filtered_buttons);
+    _buttonPortIsr(INT_PORT4 , P4->IN , filtered_buttons);
+    CPULOAD_ISR_EXIT(CPULOAD_ISR_PORT4);
+    STACKMON_ISR_EXIT(STACKMON_ISR_PORT4);
 }
 void PORT5_IRQHandler(void)
 {
     uint8_t filtered_buttons;
+    STACKMON_ISR_ENTER(STACKMON_ISR_PORT5);
+    CPULOAD_ISR_ENTER(CPULOAD_ISR_PORT5);
     filtered_buttons = P5->IFG & P5->IE;
     P5->IFG &= ~filtered_buttons;
-    _buttonProcessFlags(INT_PORT5 , filtered_buttons);
+    _buttonPortIsr(INT_PORT5 , P5->IN , filtered_buttons);
+    CPULOAD_ISR_EXIT(CPULOAD_ISR_PORT5);
+    STACKMON_ISR_EXIT(STACKMON_ISR_PORT5);
 }
 void PORT6_IRQHandler(void)
 {
     uint8_t filtered_buttons;
+    STACKMON_ISR_ENTER(STACKMON_ISR_PORT6);
+    CPULOAD_ISR_ENTER(CPULOAD_ISR_PORT6);
     filtered_buttons = P6->IFG & P6->IE;
     P6->IFG &= ~filtered_buttons;
-    _buttonProcessFlags(INT_PORT6 , filtered_buttons);
+    _buttonPortIsr(INT_PORT6 , P6->IN , filtered_buttons);
+    CPULOAD_ISR_EXIT(CPULOAD_ISR_PORT6);
+    STACKMON_ISR_EXIT(STACKMON_ISR_PORT6);
+}
+
+void TA2_0_IRQHandler(void)
+{
+    STACKMON_ISR_ENTER(STACKMON_ISR_CAPTURE);
+    CPULOAD_ISR_ENTER(CPULOAD_ISR_CAPTURE);
+    /* CCR0 at 0x8000, its flag is cleared when the interrupt is serviced */
+    _buttonCaptureHalves++;
+    CPULOAD_ISR_EXIT(CPULOAD_ISR_CAPTURE);
+    STACKMON_ISR_EXIT(STACKMON_ISR_CAPTURE);
+}
+
+void TA2_N_IRQHandler(void)
+{
+    uint16_t iv;
+    int button;
+    STACKMON_ISR_ENTER(STACKMON_ISR_CAPTURE);
+    CPULOAD_ISR_ENTER(CPULOAD_ISR_CAPTURE);
+
+    /* Reading TAxIV clears the highest priority pending flag, captures first */
+    while((iv = BUTTON_CAPTURE_TIMER->IV) != 0)
+    {
+        if(iv == BUTTON_CAPTURE_IV_WRAP)
+        {
+            _buttonCaptureHalves++;
+        }
+
+        else if((iv >> 1) < BUTTON_CAPTURE_CCRS)
+        {
+            button = _buttonCaptureOf[iv >> 1];
+            if(button >= 0)
+            {
+                _buttonEdgeTime[button] = _buttonCaptureTimestamp(BUTTON_CAPTURE_TIMER->CCR[iv >> 1]);
+                _buttonProcessFlags(_pinrefs[button].int_num, _pinrefs[button].mask);
+            }
+        }
+    }
+    CPULOAD_ISR_EXIT(CPULOAD_ISR_CAPTURE);
+    STACKMON_ISR_EXIT(STACKMON_ISR_CAPTURE);
+}
+
+static void _buttonPortIsr(uint16_t int_num , uint8_t in , uint8_t flag)
+{
+    int port = int_num - INT_PORT1;
+
+    TRACE(TRACE_EV_PORT_ISR, port + 1, (in << 8) | flag);
+
+#if INPUTTRACE_ENABLED
+    inputtracePort(port + 1, in, flag);
+#endif
+
+    /* Pins owned by another module first, they may have tighter deadlines */
+    if((flag & _buttonHookMask[port]) != 0)
+        _buttonHook[port](port + 1, in, flag & _buttonHookMask[port], _buttonHookContext[port]);
+
+    _buttonProcessFlags(int_num , flag & ~_buttonHookMask[port]);
 }
 
 static void _buttonProcessFlags(uint16_t int_num , uint8_t flag)
 {
-    int i,mask,button;
+    const int8_t *buttons = _buttonOfPin[int_num - INT_PORT1];
+    int i,mask,button,event,admitted;
 
     i = 0; mask = BIT0;
 
@@ -127,10 +377,15 @@ static void _buttonProcessFlags(uint16_t int_num , uint8_t flag)
     {
         if((flag & mask) != 0)
         {
-            button = _buttonInverseLookup(int_num , mask);
+            button = buttons[i];
             if(button >= 0)
             {
-                buttonCallback(button);
+                event = _buttonEdgeEvent(button);
+                admitted = _buttonAdmit(button);
+                TRACE(TRACE_EV_BUTTON_EDGE, button, event | (admitted << 8));
+
+                if(admitted)
+                    _buttonPost(button, event);
             }
 
         }
@@ -140,111 +395,678 @@ static void _buttonProcessFlags(uint16_t int_num , uint8_t flag)
     }
 }
 
+static void _buttonPost(int button, int event)
+{
+#if BINDING_ENABLED
+    /* Bound outputs react here, before any subscriber runs */
+    bindingApply(button, event);
+#endif
 
-static int _buttonInverseLookup(uint16_t int_num , uint8_t mask)
+#ifdef RTOS_BUILD
+    /* Waiting tasks are woken now, the subscribers run later in the deferred work task */
+    rtosButtonEvent(button, event);
+#endif
+
+#if BUTTON_DEFER_CALLBACKS
+    deferPost(_buttonDispatch, button | (event << 8));
+#else
+    _buttonDispatch(button | (event << 8));
+#endif
+}
+
+static void _buttonDispatch(int arg)
 {
-    int i;
-    i = 0;
+    button_subscriber_t *sub;
+    int button = arg & 0xFF;
+    int event = arg >> 8;
+
+#if INPUTTRACE_ENABLED
+    /* Captured edges do not go through the port ISRs, the replay could not raise them */
+    if(button < NUM_BUTTONS && !_pinrefs[button].use_capture)
+        inputtraceCallback(button);
+#endif
 
-    while(i < NUM_BUTTONS)
+    TRACE(TRACE_EV_BUTTON_DISPATCH, button, event);
+
+    /* Subscribers unlinked meanwhile keep their next pointer, the walk stays valid */
+    for(sub = _buttonSubscribers[button][event]; sub != 0; sub = sub->next)
+        sub->handler(button, event, sub->context);
+
+    if(event == BUTTON_EVENT_PRESS)
+        buttonCallback(button);
+
+    TRACE(TRACE_EV_BUTTON_DONE, button, event);
+}
+
+static int _buttonEdgeEvent(int button)
+{
+    const input_ref_t *ref = &_pinrefs[button];
+    uint8_t ies;
+
+    if((_buttonBothEdges[ref->int_num - INT_PORT1] & ref->mask) == 0)
+        return BUTTON_EVENT_PRESS;
+
+    if(ref->port_is_odd)
+        ies = ref->odd->IES & ref->mask;
+    else
+        ies = ref->even->IES & ref->mask;
+
+    _buttonTrackLevel(ref);
+
+    /* The flag was raised by the edge selected before */
+    return ies ? BUTTON_EVENT_PRESS : BUTTON_EVENT_RELEASE;
+}
+
+static int _buttonTrackLevel(const input_ref_t *ref)
+{
+    int pressed;
+
+    /* Changing IES can raise the flag by itself, so it is cleared afterwards */
+    if(ref->port_is_odd)
     {
-        if((_pinrefs[i].mask == mask) && _pinrefs[i].int_num == int_num)
-            return i;
+        pressed = (ref->odd->IN & ref->mask) == 0;
+        if(pressed)
+            ref->odd->IES = ref->odd->IES & ~(ref->mask);
         else
-            i++;
-
+            ref->odd->IES = ref->odd->IES | ref->mask;
+        ref->odd->IFG = ref->odd->IFG & ~(ref->mask);
+    }
 
+    else
+    {
+        pressed = (ref->even->IN & ref->mask) == 0;
+        if(pressed)
+            ref->even->IES = ref->even->IES & ~(ref->mask);
+        else
+            ref->even->IES = ref->even->IES | ref->mask;
+        ref->even->IFG = ref->even->IFG & ~(ref->mask);
     }
-    return -1;
+
+    return pressed;
 }
 
-static void _buttonInit(input_ref_t *ref)
+int buttonSubscribe(button_subscriber_t *sub, int which_button, int event, button_handler_t handler, void *context)
 {
-    if(ref->use_interrupt)
+    const input_ref_t *ref;
+    bool state;
+
+    if(sub == 0 || handler == 0 || which_button < 0 || which_button >= NUM_BUTTONS + BUTTON_NUM_VIRTUAL
+       || event < 0 || event >= BUTTON_NUM_EVENTS)
+        return -1;
+
+    /* Polled pins raise no events, capture channels only see falling edges */
+    ref = (which_button < NUM_BUTTONS) ? &_pinrefs[which_button] : 0;
+    if(ref != 0 && ((!ref->use_interrupt && !ref->use_capture) || (ref->use_capture && event != BUTTON_EVENT_PRESS)))
+        return -1;
+
+    buttonUnsubscribe(sub);
+
+    sub->handler = handler;
+    sub->context = context;
+    sub->button = which_button;
+    sub->event = event;
+
+    CRITICAL_ENTER(state);
+
+    sub->next = _buttonSubscribers[which_button][event];
+    _buttonSubscribers[which_button][event] = sub;
+
+    if(ref != 0 && event == BUTTON_EVENT_RELEASE)
     {
-        Interrupt_enableInterrupt(ref->int_num);
+        _buttonBothEdges[ref->int_num - INT_PORT1] |= ref->mask;
+        _buttonTrackLevel(ref);
     }
 
-    if(ref->port_is_odd)
+    CRITICAL_EXIT(state);
+
+    return 1;
+}
+
+int buttonUnsubscribe(button_subscriber_t *sub)
+{
+    const input_ref_t *ref;
+    button_subscriber_t **link;
+    int res;
+    bool state;
+
+    if(sub == 0)
+        return -1;
+
+    res = 0;
+
+    CRITICAL_ENTER(state);
+
+    if(sub->button >= 0 && sub->button < NUM_BUTTONS + BUTTON_NUM_VIRTUAL && sub->event >= 0 && sub->event < BUTTON_NUM_EVENTS)
     {
-        DIO_PORT_Odd_Interruptable_Type *odd_port = ref->odd;
-        odd_port->DIR = odd_port->DIR & ~(ref->mask);
-        odd_port->SEL0 = odd_port->SEL0 & ~(ref->mask);
-        odd_port->SEL1 = odd_port->SEL1 & ~(ref->mask);
+        link = &_buttonSubscribers[sub->button][sub->event];
+        while(*link != 0 && *link != sub)
+            link = &((*link)->next);
 
-        if(ref->use_pullup)
+        if(*link == sub)
         {
-            odd_port->REN = odd_port->REN | (ref->mask);
-            odd_port->OUT = odd_port->OUT | (ref->mask);
+            *link = sub->next;
+            res = 1;
+
+            /* Back to falling edges only once nobody follows the release */
+            if(sub->button < NUM_BUTTONS && sub->event == BUTTON_EVENT_RELEASE
+               && _buttonSubscribers[sub->button][sub->event] == 0)
+            {
+                ref = &_pinrefs[sub->button];
+                _buttonBothEdges[ref->int_num - INT_PORT1] &= ~(ref->mask);
+
+                if(ref->port_is_odd)
+                {
+                    ref->odd->IES = ref->odd->IES | ref->mask;
+                    ref->odd->IFG = ref->odd->IFG & ~(ref->mask);
+                }
+
+                else
+                {
+                    ref->even->IES = ref->even->IES | ref->mask;
+                    ref->even->IFG = ref->even->IFG & ~(ref->mask);
+                }
+            }
         }
+    }
 
-        else
+    sub->button = -1;
+
+    CRITICAL_EXIT(state);
+
+    return res;
+}
+
+static int _buttonAdmit(int button)
+{
+    const input_ref_t *ref = &_pinrefs[button];
+    systime_t now, until;
+    int deliver;
+
+    if(!ref->use_interrupt || ref->use_capture || (_buttonHoldoffMs[button] == 0 && _buttonRateLimit[button] == 0))
+    {
+        _buttonStorm[button].delivered++;
+        return 1;
+    }
+
+    now = systimeNow();
+    until = now + systimeMsToTicks(_buttonHoldoffMs[button]);
+    deliver = 1;
+
+    if(_buttonRateLimit[button])
+    {
+        if(now - _buttonWindowStart[button] >= systimeMsToTicks(BUTTON_RATE_WINDOW_MS))
         {
-            odd_port->REN = odd_port->REN & ~(ref->mask);
+            _buttonWindowStart[button] = now;
+            _buttonWindowCount[button] = 0;
         }
 
-        odd_port->IES = odd_port->IES | ref->mask;
-
-        if(ref->use_interrupt)
+        if(_buttonWindowCount[button] >= _buttonRateLimit[button])
         {
-            odd_port->IE = odd_port->IE | ref->mask;
+            /* Over the limit: drop the event and stay masked until the window ends */
+            if(_buttonWindowCount[button] == _buttonRateLimit[button])
+                _buttonStorm[button].storms++;
+
+            _buttonWindowCount[button] = _buttonRateLimit[button] + 1;
+            _buttonStorm[button].rate_limited++;
+            until = _buttonWindowStart[button] + systimeMsToTicks(BUTTON_RATE_WINDOW_MS);
+            deliver = 0;
         }
 
         else
         {
-            odd_port->IES = odd_port->IES & ~(ref->mask);
+            _buttonWindowCount[button]++;
         }
     }
 
-    else
+    if(deliver)
+        _buttonStorm[button].delivered++;
+
+    /* Mask the pin: further edges only set its flag until the alarm re-arms it */
+    if(until > now)
     {
-        DIO_PORT_Even_Interruptable_Type *even_port = ref->even;
-        even_port->DIR = even_port->DIR & ~(ref->mask);
-        even_port->SEL0 = even_port->SEL0 & ~(ref->mask);
-        even_port->SEL1 = even_port->SEL1 & ~(ref->mask);
+        if(ref->port_is_odd)
+            ref->odd->IE = ref->odd->IE & ~(ref->mask);
+        else
+            ref->even->IE = ref->even->IE & ~(ref->mask);
 
-        if(ref->use_pullup)
-        {
-            even_port->REN = even_port->REN | (ref->mask);
-            even_port->OUT = even_port->OUT | (ref->mask);
-        }
+        systimeAlarmStart(&_buttonHoldoff[button], until, _buttonRearm, (void *)(uintptr_t)button);
+    }
 
+    return deliver;
+}
+
+static void _buttonRearm(void *context)
+{
+    int button = (int)(uintptr_t)context;
+    const input_ref_t *ref = &_pinrefs[button];
+    uint8_t ies;
+    int pressed;
+
+    /* Pins following both edges may have changed level while masked: resynchronize
+       the edge and report the transition that would otherwise be lost */
+    if(_buttonBothEdges[ref->int_num - INT_PORT1] & ref->mask)
+    {
+        if(ref->port_is_odd)
+            ies = ref->odd->IES & ref->mask;
         else
+            ies = ref->even->IES & ref->mask;
+
+        pressed = _buttonTrackLevel(ref);
+        if((ies != 0) == pressed)
+            _buttonPost(button, pressed ? BUTTON_EVENT_PRESS : BUTTON_EVENT_RELEASE);
+    }
+
+    if(ref->port_is_odd)
+    {
+        if(ref->odd->IFG & ref->mask)
+            _buttonStorm[button].suppressed++;
+
+        ref->odd->IFG = ref->odd->IFG & ~(ref->mask);
+        ref->odd->IE = ref->odd->IE | ref->mask;
+    }
+
+    else
+    {
+        if(ref->even->IFG & ref->mask)
+            _buttonStorm[button].suppressed++;
+
+        ref->even->IFG = ref->even->IFG & ~(ref->mask);
+        ref->even->IE = ref->even->IE | ref->mask;
+    }
+}
+
+int buttonReportState(int which_button, int pressed)
+{
+    uint32_t bit, was;
+    bool state;
+
+    if(which_button < NUM_BUTTONS || which_button >= NUM_BUTTONS + BUTTON_NUM_VIRTUAL)
+        return -1;
+
+    bit = (uint32_t)1 << (which_button - NUM_BUTTONS);
+
+    CRITICAL_ENTER(state);
+
+    was = _buttonVirtualState & bit;
+    if(pressed)
+    {
+        _buttonVirtualState |= bit;
+        if(!was)
+            _buttonVirtualPressed |= bit;
+    }
+
+    else
+    {
+        _buttonVirtualState &= ~bit;
+    }
+
+    CRITICAL_EXIT(state);
+
+    if((was != 0) == (pressed != 0))
+        return 0;
+
+    _buttonPersist();
+
+    _buttonPost(which_button, pressed ? BUTTON_EVENT_PRESS : BUTTON_EVENT_RELEASE);
+
+    return 1;
+}
+
+static void _buttonPersist(void)
+{
+#if BUTTON_PERSIST
+    uint32_t saved[2];
+    bool state;
+
+    CRITICAL_ENTER(state);
+    saved[0] = _buttonVirtualState;
+    saved[1] = _buttonVirtualPressed;
+    persistStore(PERSIST_SLOT_BUTTONS, saved, sizeof(saved));
+    CRITICAL_EXIT(state);
+#endif
+}
+
+int buttonPinHook(int port, uint8_t mask, int priority, button_pin_hook_t hook, void *context)
+{
+    uint32_t int_num;
+    int i;
+    bool state;
+
+    if(port < 1 || port > BUTTON_NUM_PORTS || priority < 0 || priority > 7 || (hook == 0 && mask != 0))
+        return -1;
+
+#ifdef RTOS_BUILD
+    /* The port ISR reaches the FromISR API (rtosButtonEvent): never above the kernel's ceiling */
+    if((priority << 5) < configMAX_SYSCALL_INTERRUPT_PRIORITY)
+        return -1;
+#endif
+
+    /* The pins of the buttons, polled or interrupt-driven, stay with the button module */
+    int_num = INT_PORT1 + port - 1;
+    for(i = 0; i < NUM_BUTTONS; i++)
+    {
+        if(_pinrefs[i].int_num == int_num && (_pinrefs[i].mask & mask) != 0)
+            return -1;
+    }
+
+    CRITICAL_ENTER(state);
+
+    /* One hook per port: another module's cannot be replaced (mask 0 releases it) */
+    if(mask != 0 && _buttonHook[port-1] != 0 && (_buttonHook[port-1] != hook || _buttonHookContext[port-1] != context))
+    {
+        CRITICAL_EXIT(state);
+        return -1;
+    }
+
+    _buttonHook[port-1] = (mask != 0) ? hook : 0;
+    _buttonHookContext[port-1] = context;
+    _buttonHookMask[port-1] = mask;
+    CRITICAL_EXIT(state);
+
+    if(mask == 0)
+        return 1;
+
+    /* The port ISR runs at the most urgent priority requested for its pins */
+    if(!Interrupt_isEnabled(int_num) || Interrupt_getPriority(int_num) > (priority << 5))
+        Interrupt_setPriority(int_num, priority << 5);
+    Interrupt_enableInterrupt(int_num);
+
+    return 1;
+}
+
+int buttonStormStats(int which_button, button_storm_t *stats)
+{
+    bool state;
+
+    if(which_button < 0 || which_button >= NUM_BUTTONS || stats == 0)
+        return -1;
+
+    CRITICAL_ENTER(state);
+    *stats = _buttonStorm[which_button];
+    CRITICAL_EXIT(state);
+
+    return 1;
+}
+
+static void _buttonInit(const button_port_t *port)
+{
+    if(port->int_mask)
+    {
+        Interrupt_setPriority(port->int_num, (port->int_priority & 0x07) << 5);
+        Interrupt_enableInterrupt(port->int_num);
+    }
+
+    /* Each register is written once for all the buttons of the port.
+       Interrupt pins trigger on falling edges, polled pins on rising edges */
+    if(port->port_is_odd)
+    {
+        DIO_PORT_Odd_Interruptable_Type *odd_port = port->odd;
+        odd_port->DIR = odd_port->DIR & ~(port->mask);
+        odd_port->SEL0 = odd_port->SEL0 & ~(port->mask);
+        odd_port->SEL1 = odd_port->SEL1 & ~(port->mask);
+        odd_port->REN = (odd_port->REN & ~(port->mask)) | port->pullup_mask;
+        odd_port->OUT = odd_port->OUT | port->pullup_mask;
+        odd_port->IES = (odd_port->IES & ~(port->mask)) | port->int_mask;
+        odd_port->IFG = odd_port->IFG & ~(port->mask);
+        odd_port->IE = odd_port->IE | port->int_mask;
+    }
+
+    else
+    {
+        DIO_PORT_Even_Interruptable_Type *even_port = port->even;
+        even_port->DIR = even_port->DIR & ~(port->mask);
+        even_port->SEL0 = even_port->SEL0 & ~(port->mask);
+        even_port->SEL1 = even_port->SEL1 & ~(port->mask);
+        even_port->REN = (even_port->REN & ~(port->mask)) | port->pullup_mask;
+        even_port->OUT = even_port->OUT | port->pullup_mask;
+        even_port->IES = (even_port->IES & ~(port->mask)) | port->int_mask;
+        even_port->IFG = even_port->IFG & ~(port->mask);
+        even_port->IE = even_port->IE | port->int_mask;
+    }
+
+}
+
+static int _buttonPortLookup(button_port_t *ports, int num_ports, const input_ref_t *ref)
+{
+    int i;
+
+    for(i = 0; i < num_ports; i++)
+    {
+        if(ports[i].port_is_odd == ref->port_is_odd && ports[i].odd == ref->odd)
+            return i;
+    }
+
+    ports[i].mask = 0;
+    ports[i].pullup_mask = 0;
+    ports[i].int_mask = 0;
+    ports[i].port_is_odd = ref->port_is_odd;
+    ports[i].int_num = ref->int_num;
+    ports[i].int_priority = 7; //Lowered by the first interrupt pin
+    ports[i].odd = ref->odd; //Same storage as the even pointer
+
+    return i;
+}
+
+
+void buttonsInit(void)
+{
+    button_port_t ports[NUM_BUTTONS];
+    int i, pin, port, num_ports;
+#if BUTTON_PERSIST
+    uint32_t saved[2];
+
+    /* Warm reset: virtual buttons keep their state and unread presses */
+    if(persistLoad(PERSIST_SLOT_BUTTONS, saved, sizeof(saved)) > 0)
+    {
+        _buttonVirtualState = saved[0];
+        _buttonVirtualPressed = saved[1];
+    }
+
+    else
+#endif
+    {
+        _buttonVirtualState = 0;
+        _buttonVirtualPressed = 0;
+    }
+
+    /* Index of the button behind each interrupt pin, for the ISRs */
+    for (port=0; port < BUTTON_NUM_PORTS ; port++)
+    {
+        _buttonBothEdges[port] = 0;
+        _buttonHook[port] = 0;
+        _buttonHookMask[port] = 0;
+        for (pin=0; pin < 8 ; pin++)
+            _buttonOfPin[port][pin] = -1;
+    }
+
+    for (i=0; i < NUM_BUTTONS ; i++)
+    {
+        _buttonHoldoffMs[i] = _pinrefs[i].holdoff_ms;
+        _buttonRateLimit[i] = _pinrefs[i].rate_limit;
+
+        if(!_pinrefs[i].use_interrupt && !_pinrefs[i].use_capture)
+            continue;
+
+        for (pin=0; (_pinrefs[i].mask >> pin) > 1 ; pin++);
+        _buttonOfPin[_pinrefs[i].int_num - INT_PORT1][pin] = i;
+    }
+
+    /* Group the pins per port */
+    num_ports = 0;
+    for (i=0; i < NUM_BUTTONS ; i++)
+    {
+        port = _buttonPortLookup(ports, num_ports, &_pinrefs[i]);
+        if(port == num_ports)
+            num_ports++;
+
+        ports[port].mask = ports[port].mask | _pinrefs[i].mask;
+
+        if(_pinrefs[i].use_pullup)
+            ports[port].pullup_mask = ports[port].pullup_mask | _pinrefs[i].mask;
+
+        if(_pinrefs[i].use_interrupt && !_pinrefs[i].use_capture)
         {
-            even_port->REN = even_port->REN & ~(ref->mask);
+            ports[port].int_mask = ports[port].int_mask | _pinrefs[i].mask;
+
+            if(_pinrefs[i].int_priority < ports[port].int_priority)
+                ports[port].int_priority = _pinrefs[i].int_priority;
         }
+    }
+
+    for (i=0; i < num_ports ; i++)
+    {
+        _buttonInit (& ports [i]);
+    }
+
+    _buttonCaptureInit();
+}
+
+int buttonStormSet(int which_button, uint16_t holdoff_ms, uint16_t rate_limit)
+{
+    bool state;
+
+    if(which_button < 0 || which_button >= NUM_BUTTONS || !_pinrefs[which_button].use_interrupt
+       || _pinrefs[which_button].use_capture)
+        return -1;
+
+    /* Applied from the next edge; a holdoff running ends as programmed */
+    CRITICAL_ENTER(state);
+    _buttonHoldoffMs[which_button] = holdoff_ms;
+    _buttonRateLimit[which_button] = rate_limit;
+    CRITICAL_EXIT(state);
+
+    return 1;
+}
+
+int buttonStormRearm(int which_button)
+{
+    const input_ref_t *ref;
+    bool state;
+
+    if(which_button < 0 || which_button >= NUM_BUTTONS || !_pinrefs[which_button].use_interrupt
+       || _pinrefs[which_button].use_capture)
+        return -1;
+
+    ref = &_pinrefs[which_button];
 
-        even_port->IES = even_port->IES | ref->mask;
+    CRITICAL_ENTER(state);
 
-        if(ref->use_interrupt)
+    systimeAlarmCancel(&_buttonHoldoff[which_button]);
+    _buttonWindowStart[which_button] = systimeNow();
+    _buttonWindowCount[which_button] = 0;
+
+    if(ref->port_is_odd)
+    {
+        ref->odd->IFG = ref->odd->IFG & ~(ref->mask);
+        ref->odd->IE = ref->odd->IE | ref->mask;
+    }
+
+    else
+    {
+        ref->even->IFG = ref->even->IFG & ~(ref->mask);
+        ref->even->IE = ref->even->IE | ref->mask;
+    }
+
+    CRITICAL_EXIT(state);
+
+    return 1;
+}
+
+uint64_t buttonEdgeTime(int which_button)
+{
+    uint64_t res;
+    bool state;
+
+    if(which_button < 0 || which_button >= NUM_BUTTONS || !_pinrefs[which_button].use_capture)
+        return 0;
+
+    /* 64-bit value written by the capture ISR */
+    CRITICAL_ENTER(state);
+    res = _buttonEdgeTime[which_button];
+    CRITICAL_EXIT(state);
+
+    return res;
+}
+
+static void _buttonCaptureInit(void)
+{
+    int i, used;
+    uint8_t ccr, priority;
+
+    used = 0;
+    priority = 7; //Lowered by the first capture pin
+    for (i=0; i < NUM_BUTTONS ; i++)
+    {
+        ccr = _pinrefs[i].capture_ccr;
+        if(!_pinrefs[i].use_capture || ccr < 1 || ccr > BUTTON_CAPTURE_CCRS-1)
+            continue;
+
+        /* Primary module function: the pin drives CCIxA of the channel */
+        if(_pinrefs[i].port_is_odd)
         {
-            even_port->IE = even_port->IE | ref->mask;
+            _pinrefs[i].odd->SEL1 = _pinrefs[i].odd->SEL1 & ~(_pinrefs[i].mask);
+            _pinrefs[i].odd->SEL0 = _pinrefs[i].odd->SEL0 | _pinrefs[i].mask;
         }
 
         else
         {
-            even_port->IES = even_port->IES & ~(ref->mask);
+            _pinrefs[i].even->SEL1 = _pinrefs[i].even->SEL1 & ~(_pinrefs[i].mask);
+            _pinrefs[i].even->SEL0 = _pinrefs[i].even->SEL0 | _pinrefs[i].mask;
         }
+
+        BUTTON_CAPTURE_TIMER->CCTL[ccr] = TIMER_A_CCTLN_CM__FALLING | TIMER_A_CCTLN_CCIS__CCIA
+                                        | TIMER_A_CCTLN_SCS | TIMER_A_CCTLN_CAP | TIMER_A_CCTLN_CCIE;
+        _buttonCaptureOf[ccr] = i;
+        used = 1;
+
+        if(_pinrefs[i].int_priority < priority)
+            priority = _pinrefs[i].int_priority;
     }
 
-}
+    if(!used)
+        return;
 
+    _buttonCaptureHalves = 0;
+    BUTTON_CAPTURE_TIMER->CCR[0] = 0x8000;
+    BUTTON_CAPTURE_TIMER->CCTL[0] = TIMER_A_CCTLN_CCIE;
 
-void buttonsInit(void)
+    /* Both ISRs at the most urgent priority of the capture pins, as a port ISR */
+    Interrupt_setPriority(BUTTON_CAPTURE_INT_0, (priority & 0x07) << 5);
+    Interrupt_setPriority(BUTTON_CAPTURE_INT_N, (priority & 0x07) << 5);
+    Interrupt_enableInterrupt(BUTTON_CAPTURE_INT_0);
+    Interrupt_enableInterrupt(BUTTON_CAPTURE_INT_N);
+
+    BUTTON_CAPTURE_TIMER->CTL = TIMER_A_CTL_SSEL__SMCLK | TIMER_A_CTL_ID__1 | TIMER_A_CTL_CLR
+                              | TIMER_A_CTL_MC__CONTINUOUS | TIMER_A_CTL_IE;
+}
+
+static uint64_t _buttonCaptureTimestamp(uint16_t captured)
 {
-    int i;
-    for (i=0; i < NUM_BUTTONS ; i++)
-    {
-        _buttonInit (& _pinrefs [i]);
-    }
+    uint32_t halves;
+    uint16_t now;
+    uint64_t now_ext;
+
+    /* Extend the current counter value (same scheme as systime.c), then go back
+       by the age of the capture, which is always shorter than one timer period */
+    halves = _buttonCaptureHalves;
+    now = BUTTON_CAPTURE_TIMER->R;
+    if((halves & 1) != (now >> 15))
+        halves++;
+
+    now_ext = ((uint64_t)(halves >> 1) << 16) | now;
+
+    return now_ext - (uint16_t)(now - captured);
 }
 int buttonState(int which_button)
 {
     int res, val;
 
-    if(which_button >= NUM_BUTTONS)
+    if(which_button >= NUM_BUTTONS + BUTTON_NUM_VIRTUAL)
         res = -1;
 
+    else if(which_button >= NUM_BUTTONS)
+        res = (_buttonVirtualState >> (which_button - NUM_BUTTONS)) & 1;
+
     else
     {
         uint8_t mask = _pinrefs[which_button].mask;
@@ -271,10 +1093,24 @@ int buttonState(int which_button)
 int buttonPressed(int which_button)
 {
     int res, val;
+    bool state;
 
-    if(which_button >= NUM_BUTTONS)
+    if(which_button >= NUM_BUTTONS + BUTTON_NUM_VIRTUAL)
         res = -1;
 
+        else if(which_button >= NUM_BUTTONS)
+        {
+            val = 1 << (which_button - NUM_BUTTONS);
+
+            CRITICAL_ENTER(state);
+            res = (_buttonVirtualPressed & val) != 0;
+            _buttonVirtualPressed &= ~val;
+            CRITICAL_EXIT(state);
+
+            if(res)
+                _buttonPersist();
+        }
+
         else
         {
             uint8_t mask = _pinrefs[which_button].mask;
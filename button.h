@@ -13,16 +13,96 @@
 #define BUTTON_H
 
 /* SECTION 1: Included header files required to compile this file  */
+#include <stdint.h>
 
 
 /* SECTION 2: Public macros                                        */
+
+/**
+ @brief Set to 1 to run the event handlers and buttonCallback at the lowest priority
+ (PendSV, see defer.h) instead of inside the port ISR, which then only acknowledges
+ and queues the events
+*/
+#define BUTTON_DEFER_CALLBACKS 1
+
+/**
+ @brief Set to 1 to keep the state of the virtual buttons across warm resets (see persist.h)
+*/
+#define BUTTON_PERSIST 1
+
 #define BUTTON0 0
 #define BUTTON1 1
 #define BUTTON2 2
 #define BUTTON3 3
+#define BUTTON4 4 //Edges timestamped by a capture channel (see buttonEdgeTime)
+
+/**
+ @brief Number of buttons on pins, the ones above (checked against the pin table of button.c)
+*/
+#define BUTTON_NUM_PINS 5
+
+/**
+ @brief Virtual buttons, whose state is reported by other modules, at most 32 with
+ the buttons on pins. Each module exports the range it reports (LADDER_FIRST_BUTTON,
+ CAPTOUCH_FIRST_BUTTON, EXPANDER_FIRST_BUTTON)
+*/
+#define BUTTON_NUM_VIRTUAL 22
+
+/**
+ @brief Virtual button n (from 0 to BUTTON_NUM_VIRTUAL - 1), after the buttons on pins
+*/
+#define BUTTON_VIRTUAL(n) (BUTTON_NUM_PINS + (n))
+
+#define BUTTON_EVENT_PRESS   0 //Falling edge of an active-low button
+#define BUTTON_EVENT_RELEASE 1 //Rising edge, reported only while someone is subscribed to it
+#define BUTTON_NUM_EVENTS    2
 
 /* SECTION 3: Public types                                         */
 
+/**
+ @brief Interrupt storm counters of a button
+*/
+struct button_storm_s {
+   uint32_t delivered;     /**< Events passed to the application                       */
+   uint32_t suppressed;    /**< Holdoffs that ended with edges pending (lower bound)   */
+   uint32_t rate_limited;  /**< Events dropped because of the rate limit               */
+   uint32_t storms;        /**< Windows in which the rate limit was reached            */
+};
+
+/**
+ @brief Short alias "button_storm_t" for the data type "struct button_storm_s"
+*/
+typedef struct button_storm_s button_storm_t;
+
+/**
+ @brief Event handler, called with the button, the event and the context given at subscription
+*/
+typedef void (*button_handler_t)(int which_button, int event, void *context);
+
+/**
+ @brief Handler of port interrupt pins owned by another module, called from the port
+ ISR with the port number (1..6), its IN register and the acknowledged flags of the pins
+*/
+typedef void (*button_pin_hook_t)(int port, uint8_t in, uint8_t flags, void *context);
+
+/**
+ @brief Subscription of a handler to an event of a button
+ @remark The storage is provided by the caller and must stay valid until it is
+ unsubscribed; the fields are private to the button module.
+*/
+struct button_subscriber_s {
+   button_handler_t handler;            /**< Function called on the event           */
+   void *context;                       /**< Argument passed to the handler         */
+   struct button_subscriber_s *next;    /**< Next subscriber of the same event      */
+   int8_t button;                       /**< Button subscribed to, -1 if unlinked   */
+   int8_t event;                        /**< Event subscribed to                    */
+};
+
+/**
+ @brief Short alias "button_subscriber_t" for the data type "struct button_subscriber_s"
+*/
+typedef struct button_subscriber_s button_subscriber_t;
+
 
 /* SECTION 4: Public variables :: declarations, extern mandatory   */
 
@@ -35,7 +115,23 @@ int buttonState(int which_button);   //Get the current button state
 
 int buttonPressed(int which_button); //Determine if the button has been pressed since the last time this function was called
 
-extern void buttonCallback(int which_button);
+int buttonStormStats(int which_button, button_storm_t *stats); //Retrieve the interrupt storm counters of a button
+
+int buttonStormSet(int which_button, uint16_t holdoff_ms, uint16_t rate_limit); //Change the storm protection of an interrupt button (0 to disable each), edges during a holdoff are dropped
+
+int buttonStormRearm(int which_button); //End the holdoff and the rate window of a button now, its interrupt enabled again (counters kept)
+
+uint64_t buttonEdgeTime(int which_button); //Timestamp (SMCLK cycles) of the last edge of a button with use_capture == 1, 0 otherwise
+
+int buttonReportState(int which_button, int pressed); //Update a virtual button, 1 if an event was raised, 0 if unchanged
+
+int buttonSubscribe(button_subscriber_t *sub, int which_button, int event, button_handler_t handler, void *context); //Add a handler for an event of an interrupt-driven button
+
+int buttonUnsubscribe(button_subscriber_t *sub); //Remove a handler, 0 if it was not subscribed
+
+int buttonPinHook(int port, uint8_t mask, int priority, button_pin_hook_t hook, void *context); //Route the interrupts of other pins of a port to a handler, after buttonsInit, -1 if a pin is a button's, the port has another hook or (RTOS_BUILD) the priority is above configMAX_SYSCALL_INTERRUPT_PRIORITY
+
+extern void buttonCallback(int which_button); //Called on every BUTTON_EVENT_PRESS, after the subscribers
 
 #endif // BUTTON_H
 // Do not write below this line!
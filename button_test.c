@@ -0,0 +1,299 @@
+/**
+ @file    button_test.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Host test of the button module: interrupt storm protection, edge capture
+
+ Built by host/Makefile. A 10 kHz square wave (a broken contact, a noisy line)
+ is applied for a few seconds to BUTTON1, given a holdoff and a rate limit,
+ and to an unprotected pin of the same port routed to a pin hook. The port
+ interrupts run for each is counted and turned into a share of the CPU with
+ the cost of one port interrupt, TEST_ISR_CYCLES: the host cannot measure it,
+ use the PORT1_IRQHandler case of the bench suite (bench.h) for the figure
+ of the target.
+ One line per pin is printed:
+   storm,<pin>,<edges>,<interrupts>,<CPU share in 1/10000>
+ The edges of BUTTON4 are timestamped by TA2, which counts the cycles the
+ simulated CPU runs: the difference between two timestamps must be the cycles
+ elapsed, also when the capture ISR only runs after a half period or a wrap.
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "button.h"
+#include "defer.h"
+#include "persist.h"
+#include "systime.h"
+#include "sim.h"
+
+/* The whole file belongs to the host build (see host/Makefile) */
+#ifdef BENCH_HOST
+
+
+/* SECTION 2: Private macros                                       */
+
+#define TEST_STORM_HZ      10000
+#define TEST_STORM_S       3
+
+/**
+ @brief Cycles of a port interrupt delivering an event, entry and exit included
+ (order of magnitude of the bench figure at 12 MHz)
+*/
+#define TEST_ISR_CYCLES    400
+
+/**
+ @brief Storm protection given to BUTTON1 (none by default, see _pinrefs in button.c)
+*/
+#define TEST_HOLDOFF_MS    20
+#define TEST_RATE_LIMIT    20
+
+#define TEST_HOOK_PIN      BIT5  //Free pin of P1, routed to the hook without protection
+
+#define TEST_CAPTURE_PIN   BIT7  //BUTTON4, P5.7 (TA2.2)
+#define TEST_CAPTURE_LATE  64    //Cycles the capture ISR is kept waiting
+
+
+/* SECTION 3: Private types                                        */
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+static uint32_t _testHookEdges = 0;     /**< Edges seen by the pin hook */
+static uint32_t _testCallbacks = 0;     /**< Presses of BUTTON1 delivered */
+static uint32_t _testCaptures = 0;      /**< Presses of BUTTON4 delivered */
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static void _testHook(int port, uint8_t in, uint8_t flags, void *context); //Pin hook counting its edges
+
+static void _testStart(void); //Reset the simulation and the modules, as after a cold reset
+
+static uint32_t _testStorm(uint8_t mask); //Apply the square wave to pins of P1, interrupts run
+
+static uint32_t _testShare(uint32_t interrupts); //CPU share of some port interrupts over the storm, in 1/10000
+
+static void _testStormProtected(void);
+
+static void _testStormUnprotected(void);
+
+static void _testStormDefault(void);
+
+static void _testCapture(void);
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+int main(void)
+{
+    _testStormProtected();
+    _testStormUnprotected();
+    _testStormDefault();
+    _testCapture();
+
+    return simReport("button_test");
+}
+
+void buttonCallback(int which_button)
+{
+    if(which_button == BUTTON1)
+        _testCallbacks++;
+    if(which_button == BUTTON4)
+        _testCaptures++;
+}
+
+static void _testHook(int port, uint8_t in, uint8_t flags, void *context)
+{
+    _testHookEdges++;
+}
+
+static void _testStart(void)
+{
+    persistInvalidate();
+    simReset();
+    deferInit();
+    systimeInit();
+    buttonsInit();
+    Interrupt_enableMaster();
+
+    _testHookEdges = 0;
+    _testCallbacks = 0;
+    _testCaptures = 0;
+}
+
+static uint32_t _testStorm(uint8_t mask)
+{
+    uint32_t before = simIsrCount(INT_PORT1);
+    int i;
+
+    for(i = 0; i < TEST_STORM_HZ * TEST_STORM_S; i++)
+    {
+        simPinSet(1, mask, 0);
+        simAdvanceUs(1000000 / TEST_STORM_HZ / 2);
+        simPinSet(1, mask, 1);
+        simAdvanceUs(1000000 / TEST_STORM_HZ / 2);
+    }
+
+    return simIsrCount(INT_PORT1) - before;
+}
+
+static uint32_t _testShare(uint32_t interrupts)
+{
+    return (uint32_t)(((uint64_t)interrupts * TEST_ISR_CYCLES * 10000) / ((uint64_t)SystemCoreClock * TEST_STORM_S));
+}
+
+static void _testStormProtected(void)
+{
+    button_storm_t stats;
+    uint32_t interrupts;
+
+    _testStart();
+    SIM_CHECK(buttonStormSet(BUTTON1, TEST_HOLDOFF_MS, TEST_RATE_LIMIT) == 1);
+    interrupts = _testStorm(BIT4);
+    SIM_CHECK(buttonStormStats(BUTTON1, &stats) == 1);
+
+    /* At most the rate limit per window, plus the edge that finds it reached */
+    SIM_CHECK(interrupts <= (TEST_RATE_LIMIT + 1) * (TEST_STORM_S + 1));
+    SIM_CHECK(stats.delivered <= TEST_RATE_LIMIT * (TEST_STORM_S + 1));
+    SIM_CHECK(stats.delivered == _testCallbacks);
+    SIM_CHECK(stats.storms >= TEST_STORM_S - 1 && stats.rate_limited >= stats.storms);
+    SIM_CHECK(stats.suppressed > 0);
+
+    /* The port interrupt is enabled again once the storm is over */
+    simAdvanceUs(1000000);
+    SIM_CHECK((P1->IE & BIT4) != 0);
+    simPinSet(1, BIT4, 0);
+    simAdvanceUs(100);
+    SIM_CHECK(_testCallbacks == stats.delivered + 1);
+    simPinSet(1, BIT4, 1);
+
+    /* The protection can be ended at once (a press masks the pin for the holdoff) */
+    simPinSet(1, BIT4, 0);
+    SIM_CHECK((P1->IE & BIT4) == 0);
+    SIM_CHECK(buttonStormRearm(BUTTON1) == 1 && (P1->IE & BIT4) != 0);
+    simPinSet(1, BIT4, 1);
+    SIM_CHECK(buttonStormRearm(BUTTON0) == -1);
+
+    printf("storm,BUTTON1,%d,%u,%u\n", TEST_STORM_HZ * TEST_STORM_S, (unsigned)interrupts, (unsigned)_testShare(interrupts));
+
+    /* Below 0.1% of the CPU for the assumed cost of an interrupt */
+    SIM_CHECK(_testShare(interrupts) < 10);
+}
+
+static void _testStormUnprotected(void)
+{
+    uint32_t interrupts;
+
+    _testStart();
+    SIM_CHECK(buttonPinHook(1, TEST_HOOK_PIN, 2, _testHook, 0) == 1);
+    P1->IES = P1->IES | TEST_HOOK_PIN;
+    P1->IFG = P1->IFG & ~TEST_HOOK_PIN;
+    P1->IE = P1->IE | TEST_HOOK_PIN;
+
+    /* Every falling edge interrupts the CPU */
+    interrupts = _testStorm(TEST_HOOK_PIN);
+    SIM_CHECK(interrupts == TEST_STORM_HZ * TEST_STORM_S);
+    SIM_CHECK(_testHookEdges == interrupts);
+    SIM_CHECK(_testCallbacks == 0);
+
+    printf("storm,hook,%d,%u,%u\n", TEST_STORM_HZ * TEST_STORM_S, (unsigned)interrupts, (unsigned)_testShare(interrupts));
+}
+
+static void _testStormDefault(void)
+{
+    button_storm_t stats, after;
+
+    _testStart();
+    SIM_CHECK(buttonStormStats(BUTTON1, &stats) == 1);
+
+    /* No protection by default: presses 1 ms apart are all delivered */
+    simPinSet(1, BIT4, 0);
+    simAdvanceUs(500);
+    simPinSet(1, BIT4, 1);
+    simAdvanceUs(500);
+    simPinSet(1, BIT4, 0);
+    simAdvanceUs(500);
+    simPinSet(1, BIT4, 1);
+    SIM_CHECK(_testCallbacks == 2 && (P1->IE & BIT4) != 0);
+
+    /* A holdoff drops the press within it, the protection can be removed again */
+    SIM_CHECK(buttonStormSet(BUTTON1, TEST_HOLDOFF_MS, 0) == 1);
+    simPinSet(1, BIT4, 0);
+    simAdvanceUs(500);
+    simPinSet(1, BIT4, 1);
+    simAdvanceUs(500);
+    simPinSet(1, BIT4, 0);
+    simAdvanceUs(TEST_HOLDOFF_MS * 1000);
+    simPinSet(1, BIT4, 1);
+    SIM_CHECK(_testCallbacks == 3);
+    SIM_CHECK(buttonStormStats(BUTTON1, &after) == 1 && after.suppressed == stats.suppressed + 1);
+
+    SIM_CHECK(buttonStormSet(BUTTON1, 0, 0) == 1);
+    simPinSet(1, BIT4, 0);
+    simPinSet(1, BIT4, 1);
+    simPinSet(1, BIT4, 0);
+    simPinSet(1, BIT4, 1);
+    SIM_CHECK(_testCallbacks == 5);
+
+    /* Polled and captured pins have no protection */
+    SIM_CHECK(buttonStormSet(BUTTON0, TEST_HOLDOFF_MS, 0) == -1 && buttonStormSet(BUTTON4, 0, 0) == -1);
+    SIM_CHECK(buttonStormSet(-1, 0, 0) == -1 && buttonStormSet(BUTTON_NUM_PINS, 0, 0) == -1);
+}
+
+static void _testCapture(void)
+{
+    static const uint16_t before [] = { 0x7FF0, 0xFFF0 };   //Counter at the late edges
+    uint64_t first, stamp;
+    uint32_t start;
+    int i;
+
+    _testStart();
+
+    /* The timer ISRs run at the priority of the capture pin, the other pins have no timestamp */
+    SIM_CHECK(Interrupt_getPriority(INT_TA2_0) == (2 << 5) && Interrupt_getPriority(INT_TA2_N) == (2 << 5));
+    SIM_CHECK(buttonEdgeTime(BUTTON1) == 0 && buttonEdgeTime(BUTTON_NUM_PINS) == 0);
+
+    /* Reference edge, served at once */
+    start = DWT->CYCCNT;
+    simPinSet(5, TEST_CAPTURE_PIN, 0);
+    first = buttonEdgeTime(BUTTON4);
+    simPinSet(5, TEST_CAPTURE_PIN, 1);
+    SIM_CHECK(_testCaptures == 1);
+
+    /* A few wraps later */
+    simAdvanceCycles(3 * 0x10000 + 1234);
+    stamp = first + (DWT->CYCCNT - start);
+    simPinSet(5, TEST_CAPTURE_PIN, 0);
+    SIM_CHECK(buttonEdgeTime(BUTTON4) == stamp);
+    simPinSet(5, TEST_CAPTURE_PIN, 1);
+
+    /* Edges just before a half period and a wrap, captured ISRs run after them */
+    for(i = 0; i < 2; i++)
+    {
+        simAdvanceCycles((uint16_t)(before[i] - TIMER_A2->R));
+        Interrupt_disableMaster();
+        simPinSet(5, TEST_CAPTURE_PIN, 0);
+        stamp = first + (DWT->CYCCNT - start);
+        simAdvanceCycles(TEST_CAPTURE_LATE);
+        SIM_CHECK(TIMER_A2->R == (uint16_t)(before[i] + TEST_CAPTURE_LATE));
+        Interrupt_enableMaster();
+        SIM_CHECK(buttonEdgeTime(BUTTON4) == stamp);
+        simPinSet(5, TEST_CAPTURE_PIN, 1);
+    }
+
+    /* Captures only see the falling edges: one press each */
+    SIM_CHECK(_testCaptures == 4);
+}
+
+#endif //BENCH_HOST
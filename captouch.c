@@ -0,0 +1,260 @@
+/**
+ @file    captouch.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Capacitive touch pads reported as buttons
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "captouch.h"
+#include "button.h"
+#include "systime.h"
+
+
+/* SECTION 2: Private macros                                       */
+
+/**
+ @brief Number of entries in the @sa _touchRefs array
+ @note This value is automatically calculated , do not edit
+*/
+#define NUM_PADS (sizeof(_touchRefs) / sizeof(touch_ref_t))
+
+/**
+ @brief Capacitive touch I/O and the timer counting its oscillations (INCLK)
+*/
+#define CAPTOUCH_IO     CAPTIO1
+#define CAPTOUCH_TIMER  TIMER_A3
+
+/**
+ @brief Fractional bits of the baseline
+*/
+#define CAPTOUCH_FRAC   4
+
+
+/**
+@brief Private array of references for the touch pads on the board
+*/
+static const touch_ref_t _touchRefs [] = {
+     { .mask = BIT4 , .port_is_odd = 0, .even = P4 , .port_num = 4, // P4 .4
+       .button = CAPTOUCH_FIRST_BUTTON , .threshold = 40
+     },
+     { .mask = BIT5 , .port_is_odd = 0, .even = P4 , .port_num = 4, // P4 .5
+       .button = CAPTOUCH_FIRST_BUTTON + 1 , .threshold = 40
+     }
+};
+
+/**
+ @brief Compile-time check: the pad buttons must be virtual buttons
+*/
+typedef char _captouchButtonsCheck [(CAPTOUCH_FIRST_BUTTON + CAPTOUCH_NUM_BUTTONS <= BUTTON_VIRTUAL(BUTTON_NUM_VIRTUAL)) ? 1 : -1];
+
+
+/* SECTION 3: Private types                                        */
+
+/**
+ @brief Tracking state of a pad
+*/
+struct captouch_pad_s {
+   uint32_t baseline;       /**< Untouched count, with CAPTOUCH_FRAC fractional bits */
+   int32_t  delta;          /**< Drop of the last count below the baseline           */
+   uint16_t samples;        /**< Measurements taken, up to CAPTOUCH_CAL_SAMPLES      */
+   uint16_t held;           /**< Measurements since the touch started                */
+   uint8_t  touched;        /**< Flag (0/1) reported to the button module            */
+   uint32_t recalibrations; /**< Touches ended by a recalibration                    */
+};
+
+/**
+ @brief Short alias "captouch_pad_t" for the data type "struct captouch_pad_s"
+*/
+typedef struct captouch_pad_s captouch_pad_t;
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+static captouch_pad_t _captouchPads [NUM_PADS];
+
+static systime_alarm_t _captouchGate;   /**< End of the current gate time */
+static uint8_t _captouchCurrent = 0;    /**< Pad being measured            */
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static void _captouchStart(int pad); //Connect a pad to the oscillator and open the gate
+
+static uint16_t _captouchStop(void); //Close the gate, returns the oscillations counted
+
+static void _captouchScan(void *context); //Alarm callback: measure a pad and start the next one
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+void captouchInit(void)
+{
+    int i;
+
+    for(i = 0; i < NUM_PADS; i++)
+    {
+        _captouchPads[i].baseline = 0;
+        _captouchPads[i].delta = 0;
+        _captouchPads[i].samples = 0;
+        _captouchPads[i].held = 0;
+        _captouchPads[i].touched = (buttonState(_touchRefs[i].button) == 1); //Released after calibration if no longer touched
+        _captouchPads[i].recalibrations = 0;
+
+        /* Plain digital input without pull resistor, CAPTIO drives it when selected */
+        if(_touchRefs[i].port_is_odd)
+        {
+            _touchRefs[i].odd->DIR = _touchRefs[i].odd->DIR & ~(_touchRefs[i].mask);
+            _touchRefs[i].odd->SEL0 = _touchRefs[i].odd->SEL0 & ~(_touchRefs[i].mask);
+            _touchRefs[i].odd->SEL1 = _touchRefs[i].odd->SEL1 & ~(_touchRefs[i].mask);
+            _touchRefs[i].odd->REN = _touchRefs[i].odd->REN & ~(_touchRefs[i].mask);
+        }
+
+        else
+        {
+            _touchRefs[i].even->DIR = _touchRefs[i].even->DIR & ~(_touchRefs[i].mask);
+            _touchRefs[i].even->SEL0 = _touchRefs[i].even->SEL0 & ~(_touchRefs[i].mask);
+            _touchRefs[i].even->SEL1 = _touchRefs[i].even->SEL1 & ~(_touchRefs[i].mask);
+            _touchRefs[i].even->REN = _touchRefs[i].even->REN & ~(_touchRefs[i].mask);
+        }
+    }
+
+    _captouchCurrent = 0;
+    _captouchStart(_captouchCurrent);
+
+    systimeAlarmStart(&_captouchGate, systimeNow() + CAPTOUCH_GATE_TICKS, _captouchScan, 0);
+}
+
+int captouchProcess(int pad, uint16_t count)
+{
+    captouch_pad_t *st;
+    const touch_ref_t *ref;
+    int32_t diff;
+
+    if(pad < 0 || pad >= NUM_PADS)
+        return -1;
+
+    st = &_captouchPads[pad];
+    ref = &_touchRefs[pad];
+
+    /* Calibration: running mean of the first measurements */
+    if(st->samples < CAPTOUCH_CAL_SAMPLES)
+    {
+        st->samples++;
+        diff = ((int32_t)count << CAPTOUCH_FRAC) - (int32_t)st->baseline;
+        st->baseline = st->baseline + diff / st->samples;
+        st->delta = 0;
+        return 0;
+    }
+
+    st->delta = (int32_t)(st->baseline >> CAPTOUCH_FRAC) - count;
+
+    if(!st->touched)
+    {
+        if(st->delta >= ref->threshold)
+        {
+            st->touched = 1;
+            st->held = 0;
+            buttonReportState(ref->button, 1);
+        }
+
+        else
+        {
+            /* Drift compensation, the baseline is frozen while touched */
+            diff = ((int32_t)count << CAPTOUCH_FRAC) - (int32_t)st->baseline;
+            if(diff > 0)
+                st->baseline = st->baseline + diff / (1 << CAPTOUCH_RISE_SHIFT);
+            else
+                st->baseline = st->baseline + diff / (1 << CAPTOUCH_DRIFT_SHIFT);
+        }
+    }
+
+    else
+    {
+        if(st->delta < ref->threshold - ref->threshold / 4)
+        {
+            st->touched = 0;
+            buttonReportState(ref->button, 0);
+        }
+
+        else if(++st->held >= CAPTOUCH_STUCK_SAMPLES)
+        {
+            /* Nobody touches a pad that long: the environment changed */
+            st->baseline = (uint32_t)count << CAPTOUCH_FRAC;
+            st->delta = 0;
+            st->touched = 0;
+            st->recalibrations++;
+            buttonReportState(ref->button, 0);
+        }
+    }
+
+    return st->touched;
+}
+
+int32_t captouchDelta(int pad)
+{
+    if(pad < 0 || pad >= NUM_PADS)
+        return 0;
+
+    return _captouchPads[pad].delta;
+}
+
+uint32_t captouchRecalibrations(int pad)
+{
+    if(pad < 0 || pad >= NUM_PADS)
+        return 0;
+
+    return _captouchPads[pad].recalibrations;
+}
+
+static void _captouchStart(int pad)
+{
+    uint8_t pin;
+
+    for (pin=0; (_touchRefs[pad].mask >> pin) > 1 ; pin++);
+
+    CAPTOUCH_TIMER->CTL = TIMER_A_CTL_SSEL__INCLK | TIMER_A_CTL_ID__1 | TIMER_A_CTL_MC__STOP | TIMER_A_CTL_CLR;
+    CAPTOUCH_TIMER->CTL = TIMER_A_CTL_SSEL__INCLK | TIMER_A_CTL_ID__1 | TIMER_A_CTL_MC__CONTINUOUS;
+
+    CAPTOUCH_IO->CTL = CAPTIO_CTL_EN | (_touchRefs[pad].port_num << CAPTIO_CTL_POSEL_OFS)
+                     | (pin << CAPTIO_CTL_PISEL_OFS);
+}
+
+static uint16_t _captouchStop(void)
+{
+    /* Without the oscillator the counter stops and can be read safely */
+    CAPTOUCH_IO->CTL = 0;
+    CAPTOUCH_TIMER->CTL = TIMER_A_CTL_SSEL__INCLK | TIMER_A_CTL_MC__STOP;
+
+    return CAPTOUCH_TIMER->R;
+}
+
+static void _captouchScan(void *context)
+{
+    uint16_t count;
+    int pad;
+
+    count = _captouchStop();
+
+    /* Pipelined: the next pad is measured while this one is processed */
+    pad = _captouchCurrent;
+    _captouchCurrent = (pad + 1 < NUM_PADS) ? pad + 1 : 0;
+    _captouchStart(_captouchCurrent);
+
+    /* Gates open and close at the same latency after a tick, so they all last the same */
+    systimeAlarmStart(&_captouchGate, systimeNow() + CAPTOUCH_GATE_TICKS, _captouchScan, 0);
+
+    captouchProcess(pad, count);
+}
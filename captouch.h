@@ -0,0 +1,82 @@
+/**
+ @file    captouch.h
+
+ @brief   Capacitive touch pads reported as buttons
+
+ Each pad is measured by oscillator counting: the pin is connected to the
+ capacitive touch I/O (CAPTIO1), whose oscillation clocks TA3 through its INCLK
+ input, during a gate time measured by a systime alarm. The pads are scanned
+ round robin: the alarm that closes the gate of one pad opens the gate of the
+ next, so the scan runs entirely in the background.
+
+ A touch adds capacitance and lowers the count. Each pad keeps a baseline,
+ calibrated at start-up and then following the untouched counts (quickly when
+ they rise, slowly when they fall) to compensate for drift. A touch is detected
+ when the count drops below the baseline by the threshold of the pad, and ends
+ when the drop falls under 3/4 of it; a touch lasting too long is taken as a
+ baseline shift and recalibrated.
+
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+*/
+
+// Do not write above this line (except comments)!
+#ifndef CAPTOUCH_H
+#define CAPTOUCH_H
+
+/* SECTION 1: Included header files required to compile this file  */
+#include <stdint.h>
+#include "button.h"
+
+
+/* SECTION 2: Public macros                                        */
+
+/**
+ @brief Virtual buttons reported by the pads (P4.4 and P4.5), after the ones of the ladder
+*/
+#define CAPTOUCH_FIRST_BUTTON  BUTTON_VIRTUAL(4)
+#define CAPTOUCH_NUM_BUTTONS   2
+
+/**
+ @brief Gate time of each measurement, in systime ticks (about 0.5 ms)
+*/
+#define CAPTOUCH_GATE_TICKS     16
+
+/**
+ @brief Measurements averaged into the initial baseline of a pad
+*/
+#define CAPTOUCH_CAL_SAMPLES    16
+
+/**
+ @brief Baseline tracking speed (the baseline moves by 1/2^shift of the difference)
+*/
+#define CAPTOUCH_DRIFT_SHIFT    6 //Count below the baseline: slow, may be an approaching finger
+#define CAPTOUCH_RISE_SHIFT     2 //Count above the baseline: fast, nothing touches the pad
+
+/**
+ @brief Measurements of a continuous touch after which the baseline is recalibrated
+*/
+#define CAPTOUCH_STUCK_SAMPLES  10000
+
+
+/* SECTION 3: Public types                                         */
+
+
+/* SECTION 4: Public variables :: declarations, extern mandatory   */
+
+
+/* SECTION 5: Public functions :: declarations, extern optional
+   Rule exception (callbacks)  :: declarations, extern recommended */
+
+void captouchInit(void); //Initialization function, starts the background scan (call after buttonsInit)
+
+int captouchProcess(int pad, uint16_t count); //Feed a measurement of a pad, returns 1 if touched, 0 if not, -1 if invalid
+
+int32_t captouchDelta(int pad); //Drop of the last count below the baseline of a pad, for tuning the thresholds
+
+uint32_t captouchRecalibrations(int pad); //Number of touches of a pad ended by a recalibration
+
+
+#endif //CAPTOUCH_H
+// Do not write below this line!
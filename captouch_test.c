@@ -0,0 +1,201 @@
+/**
+ @file    captouch_test.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Host test of the capacitive touch pads
+
+ Built by host/Makefile. Traces of oscillation counts are fed to the tracking
+ of a pad (calibration, touch threshold and hysteresis, drift compensation,
+ recalibration of a stuck pad), then the background scan is run on the
+ simulated timer: the host does not model the oscillator, so the test leaves
+ the count of each gate in the counter register before the gate closes.
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "captouch.h"
+#include "button.h"
+#include "defer.h"
+#include "persist.h"
+#include "systime.h"
+#include "sim.h"
+
+/* The whole file belongs to the host build (see host/Makefile) */
+#ifdef BENCH_HOST
+
+
+/* SECTION 2: Private macros                                       */
+
+#define TEST_PAD        0
+#define TEST_BUTTON     CAPTOUCH_FIRST_BUTTON //Button of pad 0 (see captouch.c)
+#define TEST_THRESHOLD  40          //Touch threshold of pad 0
+#define TEST_BASE       1000        //Untouched count of the traces
+
+
+/* SECTION 3: Private types                                        */
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static void _testStart(void); //Reset the simulation and the modules, as after a cold reset
+
+static int _testFeed(uint16_t count, int times); //Feed a count to pad 0 some times, returns the last result
+
+static void _testThreshold(void);
+
+static void _testDrift(void);
+
+static void _testStuck(void);
+
+static void _testScan(void);
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+int main(void)
+{
+    _testThreshold();
+    _testDrift();
+    _testStuck();
+    _testScan();
+
+    return simReport("captouch_test");
+}
+
+static void _testStart(void)
+{
+    persistInvalidate();
+    simReset();
+    deferInit();
+    systimeInit();
+    buttonsInit();
+    captouchInit();
+    Interrupt_enableMaster();
+}
+
+static int _testFeed(uint16_t count, int times)
+{
+    int touched = -1;
+
+    while(times-- > 0)
+        touched = captouchProcess(TEST_PAD, count);
+
+    return touched;
+}
+
+static void _testThreshold(void)
+{
+    _testStart();
+
+    /* Calibration: nothing is reported */
+    SIM_CHECK(_testFeed(TEST_BASE, CAPTOUCH_CAL_SAMPLES) == 0);
+    SIM_CHECK(captouchDelta(TEST_PAD) == 0);
+
+    /* On the threshold */
+    SIM_CHECK(_testFeed(TEST_BASE - TEST_THRESHOLD, 1) == 1);
+    SIM_CHECK(captouchDelta(TEST_PAD) == TEST_THRESHOLD);
+    SIM_CHECK(buttonState(TEST_BUTTON) == 1);
+
+    /* Hysteresis: released below 3/4 of the threshold only */
+    SIM_CHECK(_testFeed(TEST_BASE - TEST_THRESHOLD * 3 / 4, 1) == 1);
+    SIM_CHECK(_testFeed(TEST_BASE - TEST_THRESHOLD * 3 / 4 + 1, 1) == 0);
+    SIM_CHECK(buttonState(TEST_BUTTON) == 0);
+
+    /* One count short of it (after a new calibration: a count below the
+       baseline that is not a touch drags the baseline down) */
+    _testStart();
+    _testFeed(TEST_BASE, CAPTOUCH_CAL_SAMPLES);
+    SIM_CHECK(_testFeed(TEST_BASE - TEST_THRESHOLD + 1, 1) == 0);
+    SIM_CHECK(buttonState(TEST_BUTTON) == 0);
+
+    SIM_CHECK(captouchProcess(-1, TEST_BASE) == -1);
+    SIM_CHECK(captouchProcess(2, TEST_BASE) == -1);
+}
+
+static void _testDrift(void)
+{
+    int i, touches;
+
+    _testStart();
+    _testFeed(TEST_BASE, CAPTOUCH_CAL_SAMPLES);
+
+    /* Slow drop (temperature, humidity) of 200 counts: followed, never a touch */
+    touches = 0;
+    for(i = 0; i < 200 * 50; i++)
+        touches += _testFeed(TEST_BASE - i / 50, 1);
+    SIM_CHECK(touches == 0);
+    SIM_CHECK(captouchDelta(TEST_PAD) < TEST_THRESHOLD / 4);
+
+    /* The count comes back up at once: the baseline follows within a few samples
+       (to within the fraction of a count the last steps truncate) */
+    _testFeed(TEST_BASE, 20);
+    SIM_CHECK(captouchDelta(TEST_PAD) >= -1 && captouchDelta(TEST_PAD) <= 0);
+
+    /* And a touch from there is seen */
+    SIM_CHECK(_testFeed(TEST_BASE - TEST_THRESHOLD - 5, 1) == 1);
+}
+
+static void _testStuck(void)
+{
+    _testStart();
+    _testFeed(TEST_BASE, CAPTOUCH_CAL_SAMPLES);
+
+    /* Touched for CAPTOUCH_STUCK_SAMPLES: recalibrated on the touched count */
+    SIM_CHECK(_testFeed(TEST_BASE - 100, 1) == 1);
+    SIM_CHECK(_testFeed(TEST_BASE - 100, CAPTOUCH_STUCK_SAMPLES - 1) == 1);
+    SIM_CHECK(_testFeed(TEST_BASE - 100, 1) == 0);
+    SIM_CHECK(captouchRecalibrations(TEST_PAD) == 1 && buttonState(TEST_BUTTON) == 0);
+
+    /* The new baseline holds */
+    SIM_CHECK(_testFeed(TEST_BASE - 100, 10) == 0 && captouchDelta(TEST_PAD) == 0);
+    SIM_CHECK(_testFeed(TEST_BASE - 100 - TEST_THRESHOLD, 1) == 1);
+}
+
+static void _testScan(void)
+{
+    int gate, pin, selected[2];
+
+    _testStart();
+
+    /* Pads measured in turn, one gate each: pad 0 on P4.4, pad 1 on P4.5 */
+    selected[0] = selected[1] = 0;
+    for(gate = 0; gate < 2 * (CAPTOUCH_CAL_SAMPLES + 4); gate++)
+    {
+        pin = (CAPTIO1->CTL >> CAPTIO_CTL_PISEL_OFS) & 0x7;
+        SIM_CHECK((CAPTIO1->CTL & CAPTIO_CTL_EN) != 0 && ((CAPTIO1->CTL >> CAPTIO_CTL_POSEL_OFS) & 0xF) == 4);
+        SIM_CHECK(pin == ((gate & 1) ? 5 : 4));
+        selected[pin - 4]++;
+
+        /* Count of the gate, read when the gate closes */
+        TIMER_A3->R = (pin == 4) ? TEST_BASE : 2 * TEST_BASE;
+        simAdvanceTicks(CAPTOUCH_GATE_TICKS);
+    }
+    SIM_CHECK(selected[0] == selected[1]);
+    SIM_CHECK(buttonState(TEST_BUTTON) == 0 && buttonState(TEST_BUTTON + 1) == 0);
+
+    /* A finger on pad 1 only */
+    for(gate = 0; gate < 4; gate++)
+    {
+        pin = (CAPTIO1->CTL >> CAPTIO_CTL_PISEL_OFS) & 0x7;
+        TIMER_A3->R = (pin == 4) ? TEST_BASE : 2 * TEST_BASE - 200;
+        simAdvanceTicks(CAPTOUCH_GATE_TICKS);
+    }
+    SIM_CHECK(buttonState(TEST_BUTTON) == 0 && buttonState(TEST_BUTTON + 1) == 1);
+    SIM_CHECK(captouchDelta(1) == 200 && captouchDelta(0) == 0);
+}
+
+#endif //BENCH_HOST
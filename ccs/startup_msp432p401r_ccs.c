@@ -35,6 +35,8 @@
 *****************************************************************************/
 
 #include <stdint.h>
+#include "../bootprof.h"
+#include "../stackmon.h"
 
 /* Linker variable that marks the top of the stack. */
 extern unsigned long __STACK_END;
@@ -180,8 +182,15 @@ void (* const interruptVectors[])(void) =
 /* application.                                                                */
 void Reset_Handler(void)
 {
+    bootprofStart();
+
     SystemInit();
 
+    bootprofStamp(BOOT_STAGE_SYSINIT);
+
+    /* The SRAM banks of the stack are enabled: mark its free part */
+    stackmonPaint();
+
     /* Jump to the CCS C Initialization Routine. */
     __asm("    .global _c_int00\n"
           "    b.w     _c_int00");
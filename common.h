@@ -22,9 +22,51 @@
 /* SECTION 1: Included header files required to compile this file  */
 #include <stdint.h>
 #include "ti/devices/msp432p4xx/inc/msp.h"
+#include "ti/devices/msp432p4xx/driverlib/driverlib.h"
+#ifdef RTOS_BUILD
+#include "FreeRTOS.h"
+#include "task.h"
+#endif
 
 /* SECTION 2: Public macros                                        */
 
+/**
+ @brief Enter a critical section, saving the previous interrupt state in @p state
+ @note  Sections can be nested, since the interrupts are only re-enabled by
+        the outermost @ref CRITICAL_EXIT. @p state must be a bool variable.
+*/
+#if !defined(RTOS_BUILD)
+#define CRITICAL_ENTER(state)  do { (state) = Interrupt_disableMaster(); } while(0)
+#elif !defined(BENCH_HOST)
+/* Under the RTOS (see rtos.h) only the interrupts allowed to use its API are masked */
+#define CRITICAL_ENTER(state)  do { (state) = (__get_BASEPRI() != 0); \
+                                    __set_BASEPRI_MAX(configMAX_SYSCALL_INTERRUPT_PRIORITY); \
+                                    __DSB(); __ISB(); } while(0)
+#else
+/* POSIX port of the kernel: its critical sections nest by themselves */
+#define CRITICAL_ENTER(state)  do { taskENTER_CRITICAL(); (state) = 0; } while(0)
+#endif
+
+/**
+ @brief Leave a critical section opened with @ref CRITICAL_ENTER
+*/
+#if !defined(RTOS_BUILD)
+#define CRITICAL_EXIT(state)   do { if(!(state)) Interrupt_enableMaster(); } while(0)
+#elif !defined(BENCH_HOST)
+#define CRITICAL_EXIT(state)   do { if(!(state)) __set_BASEPRI(0); } while(0)
+#else
+#define CRITICAL_EXIT(state)   do { (void)(state); taskEXIT_CRITICAL(); } while(0)
+#endif
+
+/**
+ @brief Current value of the DWT cycle counter
+ @note  The counter is enabled right after reset by bootprofStart(). Host builds
+        may define their own simulated counter before including this file.
+*/
+#ifndef CYCLES_NOW
+#define CYCLES_NOW()           (DWT->CYCCNT)
+#endif
+
 /* SECTION 3: Public types                                         */
 
 /**
@@ -53,6 +95,10 @@ typedef struct output_ref_s output_ref_t;
     - whether an internal pull-up resistor is required in the configuration (use_pullup field).
 	- whether interrupts are used or not (use_interrupt field).
     - the interupt number (int_num field).
+    - whether edges are hardware-timestamped by a timer capture channel
+      (use_capture and capture_ccr fields).
+    - the interrupt priority of its port (int_priority field).
+    - the interrupt storm protection settings (holdoff_ms and rate_limit fields).
  @note Only values INT_PORT1 to INT_PORT6 (declared in driverlib's interrupt.h header file)
  are expected to be used in the int_num field.
  @remarks Only one the the odd and even pointers can be used per pin reference 
@@ -67,6 +113,25 @@ struct input_ref_s {
                                 managed using polling or interrupts         */
    uint16_t int_num;       /**< Interrupt number (INT_PORT1 to INT_PORT6), 
                                 used only if use_interrupt == 1.            */
+   uint8_t  use_capture;   /**< Flag (0/1) to know if the falling edges are
+                                timestamped by a Timer_A capture channel.
+                                The pin must be the fixed CCIxA input of
+                                that channel (e.g. P5.7 for TA2.2).         */
+   uint8_t  capture_ccr;   /**< Capture channel (1 to 4), 
+                                used only if use_capture == 1.              */
+   uint8_t  int_priority;  /**< NVIC priority of the port interrupt, 0 
+                                (highest) to 7 (lowest). The highest
+                                priority among the pins of a port is used,
+                                and among the pins with use_capture == 1
+                                for the capture timer.                      */
+   uint16_t holdoff_ms;    /**< Time the pin interrupt stays masked after
+                                an edge (0 to disable), only for pins with
+                                use_interrupt == 1. The edges meanwhile are
+                                dropped, a press included: see
+                                buttonStormSet to change it at run time.    */
+   uint16_t rate_limit;    /**< Maximum events delivered per second
+                                (0 for no limit), only for pins with
+                                use_interrupt == 1.                         */
    union {
       DIO_PORT_Odd_Interruptable_Type  *odd;  /**< Use this in case the port 
                                                    has an odd number: 
@@ -82,6 +147,120 @@ struct input_ref_s {
 */
 typedef struct input_ref_s input_ref_t;
 
+/**
+ @brief Datatype used to reference an analog input shared by several buttons
+ The buttons pull the pin to different voltages through a resistor ladder, so
+ at most one of them is seen pressed at a time. The reference contains
+    - the pin, as in an output pin (mask, port_is_odd and odd/even fields).
+    - the ADC14 input channel of the pin (adc_input field).
+    - the button indices it reports (first_button and num_buttons fields).
+    - the decoding table (thresholds field): button k is pressed when the sample
+      is below thresholds[k] and not below thresholds[k-1]; samples not below
+      thresholds[num_buttons-1] mean that no button is pressed.
+*/
+struct analog_ref_s {
+   uint8_t  mask;          /**< Bitmask of the associated pin                */
+   uint8_t  port_is_odd;   /**< Flag (0/1) to know which pointer to use     */
+   uint8_t  adc_input;     /**< ADC14 input channel (0 for A0 to 23 for A23) */
+   uint8_t  first_button;  /**< Button index of the lowest voltage button    */
+   uint8_t  num_buttons;   /**< Number of buttons on the ladder              */
+   const uint16_t *thresholds; /**< Increasing upper bounds, one per button  */
+   union {
+      DIO_PORT_Odd_Interruptable_Type  *odd;  /**< Odd port: P1, P3, ...   */
+      DIO_PORT_Even_Interruptable_Type *even; /**< Even port: P2, P4, ...  */
+   };
+};
+
+/**
+ @brief Short alias "analog_ref_t" for the data type "struct analog_ref_s"
+*/
+typedef struct analog_ref_s analog_ref_t;
+
+/**
+ @brief Datatype used to reference a capacitive touch pad
+ The pad is made part of the capacitive touch I/O oscillator, whose frequency
+ drops when it is touched. The reference contains
+    - the pin, as in an output pin (mask, port_is_odd and odd/even fields).
+    - the port number used to select the pin in CAPTIO (port_num field).
+    - the button index it reports (button field).
+    - the drop of the oscillation count below the baseline that means a touch
+      (threshold field).
+*/
+struct touch_ref_s {
+   uint8_t  mask;          /**< Bitmask of the associated pin                */
+   uint8_t  port_is_odd;   /**< Flag (0/1) to know which pointer to use     */
+   uint8_t  port_num;      /**< Port number (1 for P1 to 10 for P10)         */
+   uint8_t  button;        /**< Button index reported by the pad            */
+   uint16_t threshold;     /**< Count drop of a touch, in oscillator cycles  */
+   union {
+      DIO_PORT_Odd_Interruptable_Type  *odd;  /**< Odd port: P1, P3, ...   */
+      DIO_PORT_Even_Interruptable_Type *even; /**< Even port: P2, P4, ...  */
+   };
+};
+
+/**
+ @brief Short alias "touch_ref_t" for the data type "struct touch_ref_s"
+*/
+typedef struct touch_ref_s touch_ref_t;
+
+/**
+ @brief Datatype used to reference a quadrature rotary encoder
+ The two contacts of the encoder are pins of the same port, interrupting on
+ both edges through the port ISR of the button module. The reference contains
+    - the pins (mask_a, mask_b, port_is_odd and odd/even fields).
+    - the port interrupt and its priority (int_num and int_priority fields).
+    - if the internal pull-up resistors are required (use_pullup field).
+    - the transitions between two detents of the knob (detent field, 1, 2 or 4).
+*/
+struct encoder_ref_s {
+   uint8_t  mask_a;        /**< Bitmask of contact A                         */
+   uint8_t  mask_b;        /**< Bitmask of contact B                         */
+   uint8_t  port_is_odd;   /**< Flag (0/1) to know which pointer to use     */
+   uint8_t  use_pullup;    /**< Flag (0/1) for the internal pull-up resistors */
+   uint16_t int_num;       /**< Interrupt number (INT_PORT1 to INT_PORT6)    */
+   uint8_t  int_priority;  /**< NVIC priority of the port (0 most urgent, 7) */
+   uint8_t  detent;        /**< Transitions per detent                       */
+   union {
+      DIO_PORT_Odd_Interruptable_Type  *odd;  /**< Odd port: P1, P3, ...   */
+      DIO_PORT_Even_Interruptable_Type *even; /**< Even port: P2, P4, ...  */
+   };
+};
+
+/**
+ @brief Short alias "encoder_ref_t" for the data type "struct encoder_ref_s"
+*/
+typedef struct encoder_ref_s encoder_ref_t;
+
+/**
+ @brief Datatype used to reference an I2C GPIO expander whose inputs are buttons
+ The expander pulls its open-drain INT line low when an input changes, and
+ releases it once its input registers are read. The reference contains
+    - the I2C address of the expander (address field).
+    - the pin of the INT line, as in an input pin (int_mask, port_is_odd, use_pullup
+      and odd/even fields), and its port interrupt (int_num and int_priority fields).
+    - the button indices it reports (first_button and num_buttons fields), input 0
+      being the first one. Inputs are active low, as the buttons on the board.
+*/
+struct expander_ref_s {
+   uint8_t  address;       /**< 7-bit I2C address                            */
+   uint8_t  int_mask;      /**< Bitmask of the INT pin                       */
+   uint8_t  port_is_odd;   /**< Flag (0/1) to know which pointer to use     */
+   uint8_t  use_pullup;    /**< Flag (0/1) for the internal pull-up resistor */
+   uint16_t int_num;       /**< Interrupt number (INT_PORT1 to INT_PORT6)    */
+   uint8_t  int_priority;  /**< NVIC priority of the port (0 most urgent, 7) */
+   uint8_t  first_button;  /**< Button index of input 0                      */
+   uint8_t  num_buttons;   /**< Number of inputs used (1 to 16)              */
+   union {
+      DIO_PORT_Odd_Interruptable_Type  *odd;  /**< Odd port: P1, P3, ...   */
+      DIO_PORT_Even_Interruptable_Type *even; /**< Even port: P2, P4, ...  */
+   };
+};
+
+/**
+ @brief Short alias "expander_ref_t" for the data type "struct expander_ref_s"
+*/
+typedef struct expander_ref_s expander_ref_t;
+
 /* SECTION 4: Public variables :: declarations, extern mandatory   */
 
 /* SECTION 5: Public functions :: declarations, extern optional
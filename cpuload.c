@@ -0,0 +1,214 @@
+/**
+ @file    cpuload.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   CPU load over sliding windows and time spent in the port ISRs
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "cpuload.h"
+#include "systime.h"
+
+
+/* SECTION 2: Private macros                                       */
+
+/**
+ @brief Seconds kept, the longest window
+*/
+#define CPULOAD_NUM_SLOTS  60
+
+
+/* SECTION 3: Private types                                        */
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+static const uint8_t _cpuloadWindows [CPULOAD_NUM_WINDOWS] = { 1, 10, 60 }; /**< Seconds of each window */
+
+static uint16_t _cpuloadSlots [CPULOAD_NUM_SLOTS];  /**< Idle ticks of each of the last seconds      */
+static uint8_t _cpuloadSlot = 0;                    /**< Slot of the next second closed              */
+static uint8_t _cpuloadFilled = 0;                  /**< Slots holding a complete second             */
+
+static volatile uint8_t _cpuloadIdle = 0;           /**< Flag (0/1) set while the CPU sleeps         */
+static systime_t _cpuloadIdleSince = 0;             /**< Start of the sleep, or of the second        */
+static uint32_t _cpuloadIdleTicks = 0;              /**< Idle ticks of the current second            */
+
+static uint32_t _cpuloadIsrCycles [CPULOAD_NUM_ISRS];  /**< Cycles of each ISR in the current second  */
+static uint32_t _cpuloadIsrLast [CPULOAD_NUM_ISRS];    /**< Cycles of each ISR in the last second     */
+static uint32_t _cpuloadIsrDone = 0;                   /**< Cycles of the ISRs exited so far, each one
+                                                            with the ones nested in it (wrapping)      */
+
+static systime_t _cpuloadNext = 0;
+static systime_alarm_t _cpuloadAlarm;
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static void _cpuloadIdleEnd(systime_t now); //Add the sleep up to now to the current second
+
+static void _cpuloadTick(void *context); //Alarm callback closing a second
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+void cpuloadInit(void)
+{
+    int i;
+
+    for(i = 0; i < CPULOAD_NUM_ISRS; i++)
+    {
+        _cpuloadIsrCycles[i] = 0;
+        _cpuloadIsrLast[i] = 0;
+    }
+
+    _cpuloadSlot = 0;
+    _cpuloadFilled = 0;
+    _cpuloadIdle = 0;
+    _cpuloadIdleTicks = 0;
+    _cpuloadIsrDone = 0;
+
+    _cpuloadNext = systimeNow() + SYSTIME_TICKS_PER_SECOND;
+    systimeAlarmStart(&_cpuloadAlarm, _cpuloadNext, _cpuloadTick, 0);
+}
+
+int32_t cpuloadGet(int window)
+{
+    uint32_t idle = 0;
+    int i, n, slot;
+    bool state;
+
+    if(window < 0 || window > CPULOAD_NUM_WINDOWS-1)
+        return -1;
+
+    CRITICAL_ENTER(state);
+
+    /* A window longer than the time since the initialization covers what there is */
+    n = _cpuloadWindows[window];
+    if(n > _cpuloadFilled)
+        n = _cpuloadFilled;
+
+    slot = _cpuloadSlot;
+    for(i = 0; i < n; i++)
+    {
+        slot = (slot == 0) ? CPULOAD_NUM_SLOTS-1 : slot-1;
+        idle += _cpuloadSlots[slot];
+    }
+
+    CRITICAL_EXIT(state);
+
+    if(n == 0)
+        return 0;
+
+    return 10000 - (int32_t)(((uint64_t)idle * 10000) / ((uint32_t)n * SYSTIME_TICKS_PER_SECOND));
+}
+
+int32_t cpuloadIsr(int which_isr)
+{
+    if(which_isr < 0 || which_isr > CPULOAD_NUM_ISRS-1 || SystemCoreClock == 0)
+        return -1;
+
+    return (int32_t)(((uint64_t)_cpuloadIsrLast[which_isr] * 10000) / SystemCoreClock);
+}
+
+void cpuloadIdleEnter(void)
+{
+    bool state;
+
+    CRITICAL_ENTER(state);
+    _cpuloadIdleSince = systimeNow();
+    _cpuloadIdle = 1;
+    CRITICAL_EXIT(state);
+}
+
+void cpuloadIdleExit(void)
+{
+    bool state;
+
+    CRITICAL_ENTER(state);
+    if(_cpuloadIdle)
+        _cpuloadIdleEnd(systimeNow());
+    CRITICAL_EXIT(state);
+}
+
+uint32_t cpuloadIsrEnter(void)
+{
+    uint32_t now;
+
+    /* The ISR woke the CPU up: the sleep ends here, not when the idle path resumes */
+    if(_cpuloadIdle)
+        _cpuloadIdleEnd(systimeNow());
+
+    /* Relative to the cycles of the ISRs exited so far, so that the exit can
+       take out the ones nested in this ISR */
+    now = CYCLES_NOW();
+    return now - _cpuloadIsrDone;
+}
+
+void cpuloadIsrExit(int which_isr, uint32_t start)
+{
+    uint32_t now;
+    bool state;
+
+    CRITICAL_ENTER(state);
+    now = CYCLES_NOW();
+
+    /* The cycles since the entry, less the ones of the nested ISRs */
+    _cpuloadIsrCycles[which_isr] += now - _cpuloadIsrDone - start;
+
+    /* For the ISR this one interrupted, the nested ISRs are this one as a whole */
+    _cpuloadIsrDone = now - start;
+
+    CRITICAL_EXIT(state);
+}
+
+static void _cpuloadIdleEnd(systime_t now)
+{
+    _cpuloadIdleTicks += (uint32_t)(now - _cpuloadIdleSince);
+    _cpuloadIdle = 0;
+}
+
+static void _cpuloadTick(void *context)
+{
+    int i;
+    bool state;
+
+    CRITICAL_ENTER(state);
+
+    /* A sleep in progress is split at the boundary of the second (unless it
+       started after it, the alarm being served late) */
+    if(_cpuloadIdle && _cpuloadIdleSince < _cpuloadNext)
+    {
+        _cpuloadIdleTicks += (uint32_t)(_cpuloadNext - _cpuloadIdleSince);
+        _cpuloadIdleSince = _cpuloadNext;
+    }
+
+    _cpuloadSlots[_cpuloadSlot] = (_cpuloadIdleTicks < SYSTIME_TICKS_PER_SECOND) ? _cpuloadIdleTicks : SYSTIME_TICKS_PER_SECOND;
+    _cpuloadSlot = (_cpuloadSlot == CPULOAD_NUM_SLOTS-1) ? 0 : _cpuloadSlot+1;
+    if(_cpuloadFilled < CPULOAD_NUM_SLOTS)
+        _cpuloadFilled++;
+    _cpuloadIdleTicks = 0;
+
+    for(i = 0; i < CPULOAD_NUM_ISRS; i++)
+    {
+        _cpuloadIsrLast[i] = _cpuloadIsrCycles[i];
+        _cpuloadIsrCycles[i] = 0;
+    }
+
+    CRITICAL_EXIT(state);
+
+    /* Re-armed from the previous deadline, so the seconds do not drift */
+    _cpuloadNext = _cpuloadNext + SYSTIME_TICKS_PER_SECOND;
+    systimeAlarmStart(&_cpuloadAlarm, _cpuloadNext, _cpuloadTick, 0);
+}
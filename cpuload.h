@@ -0,0 +1,105 @@
+/**
+ @file    cpuload.h
+
+ @brief   CPU load over sliding windows and time spent in the port ISRs
+
+ The idle path (powerSleep, see power.h) marks the time the CPU sleeps, read
+ from the systime time base, which keeps counting in the low-power modes.
+ Once per second a systime alarm closes the second: its idle time goes into a
+ ring of the last 60 seconds, from which the load over 1, 10 and 60 seconds is
+ computed when asked for. Everything that is not sleeping counts as load, so
+ an application that never sleeps reads 100%.
+
+ The ISRs instrumented with CPULOAD_ISR_ENTER/CPULOAD_ISR_EXIT add their cycles
+ (DWT counter) to their source, and end the idle time when they interrupt a
+ sleep. Their share of the last complete second is reported against
+ SystemCoreClock. An instrumented ISR nested in another one (a port of higher
+ priority) counts in its own share only: its cycles are taken out of the one
+ it interrupted. The other ISRs (time base, DMA...) are not instrumented, and
+ count in the share of the port ISR they interrupt.
+
+ The results are in hundredths of a percent (0 to 10000). The cost is a few
+ stores per sleep and per instrumented ISR, plus one alarm per second.
+
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+*/
+
+// Do not write above this line (except comments)!
+#ifndef CPULOAD_H
+#define CPULOAD_H
+
+/* SECTION 1: Included header files required to compile this file  */
+#include <stdint.h>
+
+
+/* SECTION 2: Public macros                                        */
+
+/**
+ @brief Set to 1 to compile the accounting hooks into the power module and the ISRs
+ (--define=CPULOAD_ENABLED=1 in a debug build configuration); off by default,
+ when no idle time is seen and the load reads 100%
+*/
+#ifndef CPULOAD_ENABLED
+#define CPULOAD_ENABLED      0
+#endif
+
+#define CPULOAD_WINDOW_1S    0
+#define CPULOAD_WINDOW_10S   1
+#define CPULOAD_WINDOW_60S   2
+
+#define CPULOAD_NUM_WINDOWS  3
+
+/**
+ @brief Instrumented ISRs
+*/
+#define CPULOAD_ISR_PORT1    0
+#define CPULOAD_ISR_PORT2    1
+#define CPULOAD_ISR_PORT3    2
+#define CPULOAD_ISR_PORT4    3
+#define CPULOAD_ISR_PORT5    4
+#define CPULOAD_ISR_PORT6    5
+#define CPULOAD_ISR_CAPTURE  6 //TA2_0_IRQHandler and TA2_N_IRQHandler, the captured button edges
+
+#define CPULOAD_NUM_ISRS     7
+
+/**
+ @brief First and last statement of an instrumented ISR (no return in between),
+ left out of host builds, which call the functions with their own counter
+*/
+#if CPULOAD_ENABLED && !defined(BENCH_HOST)
+#define CPULOAD_ISR_ENTER(id)  uint32_t _cpuloadStart = cpuloadIsrEnter()
+#define CPULOAD_ISR_EXIT(id)   cpuloadIsrExit((id), _cpuloadStart)
+#else
+#define CPULOAD_ISR_ENTER(id)
+#define CPULOAD_ISR_EXIT(id)   ((void)0)
+#endif
+
+
+/* SECTION 3: Public types                                         */
+
+
+/* SECTION 4: Public variables :: declarations, extern mandatory   */
+
+
+/* SECTION 5: Public functions :: declarations, extern optional
+   Rule exception (callbacks)  :: declarations, extern recommended */
+
+void cpuloadInit(void); //Initialization function, after systimeInit: start the one-second windows
+
+int32_t cpuloadGet(int window); //Load over a window (CPULOAD_WINDOW_x) in hundredths of a percent, -1 if invalid
+
+int32_t cpuloadIsr(int which_isr); //Share of the last second spent in an ISR (CPULOAD_ISR_x) in hundredths of a percent, -1 if invalid
+
+void cpuloadIdleEnter(void); //Hook: the idle path is about to sleep
+
+void cpuloadIdleExit(void); //Hook: the idle path woke up
+
+uint32_t cpuloadIsrEnter(void); //Start accounting an ISR, use CPULOAD_ISR_ENTER
+
+void cpuloadIsrExit(int which_isr, uint32_t start); //Add the cycles of an ISR to its source, use CPULOAD_ISR_EXIT
+
+
+#endif //CPULOAD_H
+// Do not write below this line!
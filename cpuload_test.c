@@ -0,0 +1,176 @@
+/**
+ @file    cpuload_test.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Host test of the CPU load and of the share of the port ISRs
+
+ Built by host/Makefile. The application alternates spinning (simAdvanceUs)
+ and sleeping through delayMs, as the superloop of lab4.c, and the load over
+ each window must follow the time it did not sleep. The instrumented ISRs are
+ entered and exited by hand, since the host build leaves the macros out: the
+ test nests them and checks that each cycle counts in one share only, and that
+ an ISR waking the CPU ends the sleep.
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "cpuload.h"
+#include "delay.h"
+#include "defer.h"
+#include "persist.h"
+#include "systime.h"
+#include "sim.h"
+
+/* The whole file belongs to the host build (see host/Makefile) */
+#ifdef BENCH_HOST
+
+
+/* SECTION 2: Private macros                                       */
+
+#define TEST_TOLERANCE  50   //Error allowed on a load, in hundredths of a percent
+
+
+/* SECTION 3: Private types                                        */
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static void _testStart(void); //Reset the simulation and the time base, start the windows
+
+static int _testNear(int32_t load, int32_t expected); //1 if a load is within TEST_TOLERANCE of the expected one
+
+static void _testWindows(void);
+
+static void _testIsr(void);
+
+static void _testWake(void);
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+int main(void)
+{
+    _testWindows();
+    _testIsr();
+    _testWake();
+
+    return simReport("cpuload_test");
+}
+
+static void _testStart(void)
+{
+    persistInvalidate();
+    simReset();
+    deferInit();
+    systimeInit();
+    cpuloadInit();
+    Interrupt_enableMaster();
+}
+
+static int _testNear(int32_t load, int32_t expected)
+{
+    return load >= expected - TEST_TOLERANCE && load <= expected + TEST_TOLERANCE;
+}
+
+static void _testWindows(void)
+{
+    int i;
+
+    _testStart();
+
+    /* No second closed yet */
+    SIM_CHECK(cpuloadGet(CPULOAD_WINDOW_1S) == 0 && cpuloadGet(CPULOAD_WINDOW_60S) == 0);
+
+    /* A loop that never sleeps */
+    simAdvanceUs(1000100);
+    SIM_CHECK(cpuloadGet(CPULOAD_WINDOW_1S) == 10000 && cpuloadGet(CPULOAD_WINDOW_60S) == 10000);
+
+    /* Busy 3/4 of each period, asleep in delayMs for the rest */
+    for(i = 0; i < 10; i++)
+    {
+        delayMs(250);
+        simAdvanceUs(750000);
+    }
+    SIM_CHECK(_testNear(cpuloadGet(CPULOAD_WINDOW_1S), 7500));
+    SIM_CHECK(_testNear(cpuloadGet(CPULOAD_WINDOW_10S), 7500));
+
+    /* The longest window holds the busy second too */
+    SIM_CHECK(_testNear(cpuloadGet(CPULOAD_WINDOW_60S), (10000 + 10 * 7500) / 11));
+
+    /* Asleep for a whole minute: the time base wakes the CPU up once per second only */
+    delayMs(60000);
+    SIM_CHECK(cpuloadGet(CPULOAD_WINDOW_1S) <= 1 && cpuloadGet(CPULOAD_WINDOW_60S) <= 1);
+
+    SIM_CHECK(cpuloadGet(-1) == -1 && cpuloadGet(CPULOAD_NUM_WINDOWS) == -1);
+}
+
+static void _testIsr(void)
+{
+    uint32_t outer, inner, innermost;
+
+    _testStart();
+
+    /* PORT1 interrupted by PORT2, itself interrupted by PORT3: 15 ms, 5 ms, 5 ms */
+    outer = cpuloadIsrEnter();
+    simAdvanceCycles(120000);
+    inner = cpuloadIsrEnter();
+    simAdvanceCycles(30000);
+    innermost = cpuloadIsrEnter();
+    simAdvanceCycles(60000);
+    cpuloadIsrExit(CPULOAD_ISR_PORT3, innermost);
+    simAdvanceCycles(30000);
+    cpuloadIsrExit(CPULOAD_ISR_PORT2, inner);
+    simAdvanceCycles(60000);
+    cpuloadIsrExit(CPULOAD_ISR_PORT1, outer);
+
+    /* PORT1 again on its own, 10 ms */
+    outer = cpuloadIsrEnter();
+    simAdvanceCycles(120000);
+    cpuloadIsrExit(CPULOAD_ISR_PORT1, outer);
+
+    /* Shares of the second: 300000, 60000 and 60000 cycles at 12 MHz */
+    simAdvanceUs(1000100);
+    SIM_CHECK(cpuloadIsr(CPULOAD_ISR_PORT1) >= 249 && cpuloadIsr(CPULOAD_ISR_PORT1) <= 250);
+    SIM_CHECK(cpuloadIsr(CPULOAD_ISR_PORT2) >= 49 && cpuloadIsr(CPULOAD_ISR_PORT2) <= 50);
+    SIM_CHECK(cpuloadIsr(CPULOAD_ISR_PORT3) >= 49 && cpuloadIsr(CPULOAD_ISR_PORT3) <= 50);
+    SIM_CHECK(cpuloadIsr(CPULOAD_ISR_PORT4) == 0);
+
+    /* A second without interrupts */
+    simAdvanceUs(1000000);
+    SIM_CHECK(cpuloadIsr(CPULOAD_ISR_PORT1) == 0 && cpuloadIsr(CPULOAD_ISR_PORT2) == 0);
+
+    SIM_CHECK(cpuloadIsr(-1) == -1 && cpuloadIsr(CPULOAD_NUM_ISRS) == -1);
+}
+
+static void _testWake(void)
+{
+    uint32_t start;
+
+    _testStart();
+
+    /* An ISR ends the sleep at 0.4 s; the idle path resumes at the end of the second only */
+    cpuloadIdleEnter();
+    simAdvanceUs(400000);
+    start = cpuloadIsrEnter();
+    cpuloadIsrExit(CPULOAD_ISR_PORT4, start);
+    simAdvanceUs(600100);
+    cpuloadIdleExit();
+
+    SIM_CHECK(_testNear(cpuloadGet(CPULOAD_WINDOW_1S), 6000));
+}
+
+#endif //BENCH_HOST
@@ -0,0 +1,142 @@
+/**
+ @file    defer.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Deferred execution of work at the lowest interrupt priority (PendSV)
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "defer.h"
+#include "rtos.h"
+
+
+/* SECTION 2: Private macros                                       */
+
+/**
+ @brief Lowest priority of the 3 NVIC priority bits implemented in the MSP432
+*/
+#define DEFER_PRIORITY  0xE0
+
+
+/* SECTION 3: Private types                                        */
+
+/**
+ @brief Queued work item
+*/
+struct defer_item_s {
+   defer_fn_t fn;   /**< Function to call           */
+   int        arg;  /**< Argument passed to it      */
+};
+
+/**
+ @brief Short alias "defer_item_t" for the data type "struct defer_item_s"
+*/
+typedef struct defer_item_s defer_item_t;
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+static defer_item_t _deferQueue [DEFER_QUEUE_SIZE];
+
+static volatile uint32_t _deferHead = 0;    /**< Next item to run, free-running    */
+static volatile uint32_t _deferTail = 0;    /**< Next free slot, free-running      */
+static volatile uint32_t _deferDropped = 0; /**< Items lost because of a full queue */
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+#ifndef RTOS_BUILD
+void PendSV_Handler(void);
+#endif
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+void deferInit(void)
+{
+    _deferHead = 0;
+    _deferTail = 0;
+    _deferDropped = 0;
+
+    /* Under the RTOS, PendSV is the context switch: the work runs in a task (see rtos.h) */
+#ifndef RTOS_BUILD
+    Interrupt_setPriority(FAULT_PENDSV, DEFER_PRIORITY);
+#endif
+}
+
+int deferPost(defer_fn_t fn, int arg)
+{
+    bool state;
+    int res;
+
+    if(fn == 0)
+        return -1;
+
+    /* Producers are ISRs of any priority: reserve and fill the slot atomically */
+    CRITICAL_ENTER(state);
+
+    if(_deferTail - _deferHead >= DEFER_QUEUE_SIZE)
+    {
+        _deferDropped++;
+        res = -1;
+    }
+
+    else
+    {
+        _deferQueue[_deferTail & (DEFER_QUEUE_SIZE-1)].fn = fn;
+        _deferQueue[_deferTail & (DEFER_QUEUE_SIZE-1)].arg = arg;
+        _deferTail++;
+        res = 1;
+    }
+
+    CRITICAL_EXIT(state);
+
+    if(res > 0)
+    {
+#ifdef RTOS_BUILD
+        rtosDeferSignal();
+#else
+        SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+#endif
+    }
+
+    return res;
+}
+
+void deferRun(void)
+{
+    defer_item_t item;
+
+    /* Single consumer: only the head index is written here */
+    while(_deferHead != _deferTail)
+    {
+        item = _deferQueue[_deferHead & (DEFER_QUEUE_SIZE-1)];
+        _deferHead++;
+
+        item.fn(item.arg);
+    }
+}
+
+uint32_t deferDropped(void)
+{
+    return _deferDropped;
+}
+
+#ifndef RTOS_BUILD
+void PendSV_Handler(void)
+{
+    deferRun();
+}
+#endif
@@ -0,0 +1,56 @@
+/**
+ @file    defer.h
+
+ @brief   Deferred execution of work at the lowest interrupt priority (PendSV)
+
+ Interrupt handlers post short work items and return; the items run later, in
+ posting order, from the PendSV exception configured at the lowest priority.
+ Deferred work can therefore be preempted by any interrupt. In the RTOS build
+ (see rtos.h) PendSV belongs to the kernel, and the items run in a task instead.
+
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+*/
+
+// Do not write above this line (except comments)!
+#ifndef DEFER_H
+#define DEFER_H
+
+/* SECTION 1: Included header files required to compile this file  */
+#include <stdint.h>
+
+
+/* SECTION 2: Public macros                                        */
+
+/**
+ @brief Capacity of the queue of pending work items (power of two)
+*/
+#define DEFER_QUEUE_SIZE  16
+
+
+/* SECTION 3: Public types                                         */
+
+/**
+ @brief Deferred function, called with the argument given to @ref deferPost
+*/
+typedef void (*defer_fn_t)(int arg);
+
+
+/* SECTION 4: Public variables :: declarations, extern mandatory   */
+
+
+/* SECTION 5: Public functions :: declarations, extern optional
+   Rule exception (callbacks)  :: declarations, extern recommended */
+
+void deferInit(void); //Initialization function, sets PendSV to the lowest priority
+
+int deferPost(defer_fn_t fn, int arg); //Queue a work item and pend PendSV, -1 if the queue is full
+
+void deferRun(void); //Run every queued work item (called from PendSV_Handler, or from a task under the RTOS)
+
+uint32_t deferDropped(void); //Number of work items lost because the queue was full
+
+
+#endif //DEFER_H
+// Do not write below this line!
@@ -0,0 +1,179 @@
+/**
+ @file    defer_test.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Host test of the deferred work queue
+
+ Built by host/Makefile. Work items must run in PendSV at the lowest priority,
+ after the interrupt that posted them has returned, in the order they were
+ posted, and the items that do not fit in the queue must be counted.
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "defer.h"
+#include "systime.h"
+#include "sim.h"
+
+/* The whole file belongs to the host build (see host/Makefile) */
+#ifdef BENCH_HOST
+
+
+/* SECTION 2: Private macros                                       */
+
+#define TEST_LOG_SIZE  64
+
+
+/* SECTION 3: Private types                                        */
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+static int _testLog [TEST_LOG_SIZE];        /**< Arguments of the items, in the order they ran */
+static int _testLogPriority [TEST_LOG_SIZE];/**< Priority each item ran at                      */
+static int _testLogged = 0;
+
+static systime_alarm_t _testAlarm;
+static int _testIsrDone = -1;               /**< Log position when the posting ISR returned     */
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static void _testItem(int arg); //Work item: log its argument and priority
+
+static void _testChain(int arg); //Work item posting another one
+
+static void _testPostFromIsr(void *context); //Alarm callback posting items
+
+static void _testStart(void); //Reset the simulation, the queue and the log
+
+static void _testThread(void);
+
+static void _testFromIsr(void);
+
+static void _testFull(void);
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+int main(void)
+{
+    _testThread();
+    _testFromIsr();
+    _testFull();
+
+    return simReport("defer_test");
+}
+
+static void _testItem(int arg)
+{
+    if(_testLogged < TEST_LOG_SIZE)
+    {
+        _testLog[_testLogged] = arg;
+        _testLogPriority[_testLogged] = simPriority();
+        _testLogged++;
+    }
+}
+
+static void _testChain(int arg)
+{
+    _testItem(arg);
+    deferPost(_testItem, arg + 1);
+}
+
+static void _testPostFromIsr(void *context)
+{
+    deferPost(_testItem, 10);
+    deferPost(_testItem, 11);
+    _testIsrDone = _testLogged;
+}
+
+static void _testStart(void)
+{
+    simReset();
+    deferInit();
+    systimeInit();
+    Interrupt_enableMaster();
+
+    _testLogged = 0;
+    _testIsrDone = -1;
+}
+
+static void _testThread(void)
+{
+    bool state;
+
+    _testStart();
+
+    /* From thread mode, PendSV runs as soon as it is pended, at priority 7 */
+    SIM_CHECK(deferPost(_testItem, 1) == 1);
+    simServe();
+    SIM_CHECK(_testLogged == 1 && _testLog[0] == 1 && _testLogPriority[0] == 7);
+
+    /* Masked: queued in order, run when unmasked */
+    state = Interrupt_disableMaster();
+    deferPost(_testItem, 2);
+    deferPost(_testItem, 3);
+    deferPost(_testChain, 4);
+    simAdvanceCycles(1000);
+    SIM_CHECK(_testLogged == 1);
+    if(!state)
+        Interrupt_enableMaster();
+    SIM_CHECK(_testLogged == 5);
+    SIM_CHECK(_testLog[1] == 2 && _testLog[2] == 3 && _testLog[3] == 4 && _testLog[4] == 5);
+
+    /* The item posted by an item runs in the same pass, the PendSV it pends finds the queue empty */
+    SIM_CHECK(simIsrCount(FAULT_PENDSV) == 3);
+
+    SIM_CHECK(deferPost(0, 0) == -1);
+}
+
+static void _testFromIsr(void)
+{
+    _testStart();
+
+    /* Posted by an interrupt: run after it returns, still in PendSV */
+    systimeAlarmStart(&_testAlarm, systimeNow() + 10, _testPostFromIsr, 0);
+    simAdvanceTicks(20);
+    SIM_CHECK(_testIsrDone == 0);
+    SIM_CHECK(_testLogged == 2 && _testLog[0] == 10 && _testLog[1] == 11);
+    SIM_CHECK(_testLogPriority[0] == 7 && _testLogPriority[1] == 7);
+    SIM_CHECK(simIsrCount(FAULT_PENDSV) == 1);
+}
+
+static void _testFull(void)
+{
+    bool state;
+    int i, posted;
+
+    _testStart();
+
+    /* One more than the capacity: the last one is dropped and counted */
+    state = Interrupt_disableMaster();
+    posted = 0;
+    for(i = 0; i < DEFER_QUEUE_SIZE + 1; i++)
+        posted += (deferPost(_testItem, i) == 1);
+    if(!state)
+        Interrupt_enableMaster();
+
+    SIM_CHECK(posted == DEFER_QUEUE_SIZE && deferDropped() == 1);
+    SIM_CHECK(_testLogged == DEFER_QUEUE_SIZE && _testLog[DEFER_QUEUE_SIZE-1] == DEFER_QUEUE_SIZE-1);
+
+    /* The queue is usable again, the counter stays */
+    SIM_CHECK(deferPost(_testItem, 100) == 1);
+    simServe();
+    SIM_CHECK(_testLog[DEFER_QUEUE_SIZE] == 100 && deferDropped() == 1);
+}
+
+#endif //BENCH_HOST
@@ -0,0 +1,185 @@
+/**
+ @file    delay.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Busy-wait delays and non-blocking timeouts independent of the CPU clock
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "delay.h"
+#include "power.h"
+
+
+/* SECTION 2: Private macros                                       */
+
+
+/* SECTION 3: Private types                                        */
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static void _delaySpin(uint32_t start, uint32_t ms, uint32_t us); //Count cycles from start for ms milliseconds plus us microseconds
+
+static void _delaySleep(uint32_t start, systime_t ticks, uint32_t ms, uint32_t us); //Sleep until a systime alarm, or spin if interrupts are masked
+
+static void _delayWake(void *context); //Alarm callback ending a sleep
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+void delayUs(uint32_t us)
+{
+    uint32_t start;
+
+    start = CYCLES_NOW(); //The conversions below are part of the delay
+
+    if(us < DELAY_SLEEP_US)
+        _delaySpin(start, 0, us);
+
+    else
+        _delaySleep(start, systimeUsToTicks(us), us / 1000, us % 1000);
+}
+
+void delayMs(uint32_t ms)
+{
+    uint32_t start;
+
+    start = CYCLES_NOW();
+
+    if(ms < DELAY_SLEEP_US / 1000)
+        _delaySpin(start, 0, ms * 1000);
+
+    else
+        _delaySleep(start, systimeMsToTicks(ms), ms, 0);
+}
+
+int delayTimeoutStart(delay_timeout_t *timeout, uint32_t ms)
+{
+    if(timeout == 0)
+        return -1;
+
+    timeout->deadline = systimeNow() + systimeMsToTicks(ms);
+
+    return 1;
+}
+
+int delayTimeoutExpired(const delay_timeout_t *timeout)
+{
+    if(timeout == 0)
+        return -1;
+
+    return systimeNow() >= timeout->deadline;
+}
+
+uint32_t delayTimeoutRemainingMs(const delay_timeout_t *timeout)
+{
+    systime_t now;
+
+    if(timeout == 0)
+        return 0;
+
+    now = systimeNow();
+    if(now >= timeout->deadline)
+        return 0;
+
+    return (uint32_t)(((timeout->deadline - now) * 1000 + SYSTIME_TICKS_PER_SECOND - 1) / SYSTIME_TICKS_PER_SECOND);
+}
+
+static void _delaySpin(uint32_t start, uint32_t ms, uint32_t us)
+{
+    uint32_t cycles;
+
+    /* Whole milliseconds one at a time, so that the counter never wraps during a wait */
+    cycles = SystemCoreClock / 1000;
+    while(ms > 0)
+    {
+        while(CYCLES_NOW() - start < cycles);
+        start = start + cycles;
+        ms--;
+    }
+
+    /* SystemCoreClock/32 is exact for every DCO frequency (1.5 MHz is 46875 x 32,
+       the others multiples of it), and the product stays in 32 bits for the us
+       below DELAY_SLEEP_US that reach this point at 48 MHz (1999 x 1.5 M).
+       Rounded up, so that the delay is never short */
+    cycles = (us * (SystemCoreClock >> 5) + (1000000 >> 5) - 1) / (1000000 >> 5);
+
+    /* The call itself takes DELAY_OVERHEAD_CYCLES: shorter delays last that long */
+    if(cycles <= DELAY_OVERHEAD_CYCLES)
+        return;
+
+    cycles = cycles - DELAY_OVERHEAD_CYCLES;
+    while(CYCLES_NOW() - start < cycles);
+}
+
+static void _delaySleep(uint32_t start, systime_t ticks, uint32_t ms, uint32_t us)
+{
+    systime_alarm_t alarm = {0};
+    volatile uint8_t done = 0;
+    bool state;
+#ifdef RTOS_BUILD
+    systime_t deadline;
+#endif
+
+    CRITICAL_ENTER(state);
+
+    /* With interrupts masked by the caller, or from an interrupt handler that may
+       outrank the time base, the alarm might never be served */
+    if(state || (SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk) != 0)
+    {
+        CRITICAL_EXIT(state);
+        _delaySpin(start, ms, us);
+        return;
+    }
+
+#ifdef RTOS_BUILD
+    /* Under the scheduler the task blocks for the whole kernel ticks of the delay
+       (vTaskDelay(n) lasts at most n of them), then spins on the time base for the
+       rest, as late as the alarm below would wake it up. Before the scheduler,
+       the critical section (BASEPRI) would keep the alarm from waking WFI */
+    CRITICAL_EXIT(state);
+    if(xTaskGetSchedulerState() == taskSCHEDULER_RUNNING)
+    {
+        deadline = systimeNow() + ticks + 1;
+        vTaskDelay(pdMS_TO_TICKS(ms));
+        while(systimeNow() < deadline);
+    }
+    else
+        _delaySpin(start, ms, us);
+    return;
+#endif
+
+    /* One more tick for the current one, partly gone: the delay is never short */
+    systimeAlarmStart(&alarm, systimeNow() + ticks + 1, _delayWake, (void *)&done);
+
+    /* The wake-up interrupt stays pending while masked, so it cannot be missed
+       between the test and the sleep; it is served right after */
+    while(!done)
+    {
+        powerSleep(POWER_MODE_LPM0);
+        CRITICAL_EXIT(state);
+        CRITICAL_ENTER(state);
+    }
+
+    CRITICAL_EXIT(state);
+}
+
+static void _delayWake(void *context)
+{
+    *(volatile uint8_t *)context = 1;
+}
@@ -0,0 +1,95 @@
+/**
+ @file    delay.h
+
+ @brief   Busy-wait delays and non-blocking timeouts independent of the CPU clock
+
+ Short delays count DWT cycles, converted from the value of SystemCoreClock at
+ the time of the call, so they follow clock changes as long as
+ SystemCoreClockUpdate() is called after them. The cycles of the call itself
+ are part of the delay, which is within DELAY_SPIN_PPM of its length from
+ DELAY_MIN_US(MCLK) on: 68 us at 1.5 MHz, 9 us at 12 MHz, 3 us at 48 MHz.
+ Shorter delays are never shorter than asked, and at most that long.
+ Longer delays sleep in LPM0 until a systime alarm, which does not depend on
+ the CPU clock at all, so they are late by less than two systime ticks (about
+ 61 us). In the RTOS build the task blocks for the whole kernel ticks the delay
+ holds and spins on systime for the rest, less than one kernel tick. Timeouts
+ are also based on systime, and keep counting while the CPU sleeps.
+
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+*/
+
+// Do not write above this line (except comments)!
+#ifndef DELAY_H
+#define DELAY_H
+
+/* SECTION 1: Included header files required to compile this file  */
+#include <stdint.h>
+#include "systime.h"
+
+
+/* SECTION 2: Public macros                                        */
+
+/**
+ @brief Delays from this length on sleep instead of spinning (late by less than
+ two ACLK ticks, 61 us, 3.1 % at 2 ms)
+*/
+#define DELAY_SLEEP_US  2000
+
+/**
+ @brief Cycles from the call of a spinning delay to its first read of the cycle
+ counter plus from its last read to the return, subtracted from the delay, and
+ cycles of one iteration of its loop, by which it may end late
+*/
+#ifdef BENCH_HOST
+#define DELAY_OVERHEAD_CYCLES  4   //One read of the simulated counter (SIM_CYCLES_PER_READ)
+#define DELAY_LOOP_CYCLES      4
+#else
+#define DELAY_OVERHEAD_CYCLES  30  //Call, conversion and return, 0 wait states (bench case delayUs(0))
+#define DELAY_LOOP_CYCLES      6
+#endif
+
+/**
+ @brief Error bound of the spinning delays, in ppm, from the shortest accurate
+ delay on: DELAY_MIN_CYCLES cycles of MCLK, DELAY_MIN_US(hz) microseconds at hz
+*/
+#define DELAY_SPIN_PPM    60000
+#define DELAY_MIN_CYCLES  (DELAY_LOOP_CYCLES * (1000000 / DELAY_SPIN_PPM + 1))
+#define DELAY_MIN_US(hz)  ((DELAY_MIN_CYCLES * 1000000u + (hz) - 1) / (hz))
+
+
+/* SECTION 3: Public types                                         */
+
+/**
+ @brief Non-blocking timeout. The storage is provided by the caller.
+*/
+struct delay_timeout_s {
+   systime_t deadline;   /**< Expiration time, in systime ticks */
+};
+
+/**
+ @brief Short alias "delay_timeout_t" for the data type "struct delay_timeout_s"
+*/
+typedef struct delay_timeout_s delay_timeout_t;
+
+
+/* SECTION 4: Public variables :: declarations, extern mandatory   */
+
+
+/* SECTION 5: Public functions :: declarations, extern optional
+   Rule exception (callbacks)  :: declarations, extern recommended */
+
+void delayUs(uint32_t us); //Wait for a number of microseconds
+
+void delayMs(uint32_t ms); //Wait for a number of milliseconds
+
+int delayTimeoutStart(delay_timeout_t *timeout, uint32_t ms); //Start a timeout of a number of milliseconds
+
+int delayTimeoutExpired(const delay_timeout_t *timeout); //1 if the timeout has expired, 0 if not, -1 if invalid
+
+uint32_t delayTimeoutRemainingMs(const delay_timeout_t *timeout); //Milliseconds left before the timeout expires (0 if expired)
+
+
+#endif //DELAY_H
+// Do not write below this line!
@@ -0,0 +1,199 @@
+/**
+ @file    delay_test.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Host test of the delays and timeouts at every DCO frequency
+
+ Built by host/Makefile. Each delay is timed on the simulated clock, where a
+ read of the cycle counter costs SIM_CYCLES_PER_READ cycles and sleeping
+ stops the counter, at MCLK from 1.5 to 48 MHz. The error of the spinning
+ delays from DELAY_MIN_US on and of the sleeping ones is checked against the
+ bounds of delay.h, the shorter delays against DELAY_MIN_US itself, and one
+ line per clock and length is printed:
+   delay,<clock_hz>,<us>,<measured ns>,<error in ppm>
+ The host does not count the cycles of the code itself, only the reads of the
+ counter, which make its DELAY_OVERHEAD_CYCLES.
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "delay.h"
+#include "systime.h"
+#include "sim.h"
+
+/* The whole file belongs to the host build (see host/Makefile) */
+#ifdef BENCH_HOST
+
+
+/* SECTION 2: Private macros                                       */
+
+#define TEST_NUM_CLOCKS   6     //CS_DCO_FREQUENCY_1_5 to CS_DCO_FREQUENCY_48
+
+/**
+ @brief Bound of the error of the sleeping delays, in ppm: two ACLK ticks in 2 ms
+ (see DELAY_SLEEP_US); the spinning ones are bound by DELAY_SPIN_PPM
+*/
+#define TEST_SLEEP_PPM    31000
+
+
+/* SECTION 3: Private types                                        */
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+static const uint32_t _testLengths [] = { 1, 3, 10, 50, 100, 500, 1000, 1999, 2000, 5000, 20000, 100000 };
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static void _testStart(int dco); //Reset the simulation with MCLK from a DCO frequency (CS_DCO_FREQUENCY_x)
+
+static int32_t _testError(uint32_t us, uint64_t ns); //Error of a delay, in ppm of its length
+
+static void _testDelays(void);
+
+static void _testMasked(void);
+
+static void _testTimeouts(void);
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+int main(void)
+{
+    _testDelays();
+    _testMasked();
+    _testTimeouts();
+
+    return simReport("delay_test");
+}
+
+static void _testStart(int dco)
+{
+    simReset();
+    CS_setDCOCenteredFrequency(dco);
+    SystemCoreClockUpdate();
+    systimeInit();
+    Interrupt_enableMaster();
+}
+
+static int32_t _testError(uint32_t us, uint64_t ns)
+{
+    return (int32_t)((((int64_t)ns - (int64_t)us * 1000) * 1000) / (int64_t)us);
+}
+
+static void _testDelays(void)
+{
+    uint64_t start, ns;
+    int32_t error, worst_spin, worst_sleep;
+    uint32_t min_us, cycles;
+    int dco, i;
+
+    worst_spin = 0;
+    worst_sleep = 0;
+
+    for(dco = 0; dco < TEST_NUM_CLOCKS; dco++)
+    {
+        _testStart(dco);
+        min_us = DELAY_MIN_US(SystemCoreClock);
+
+        /* Both sides of the sleep threshold, from several phases of the ACLK tick */
+        for(i = 0; i < sizeof(_testLengths) / sizeof(_testLengths[0]); i++)
+        {
+            simAdvanceUs(7 * i);
+            start = simNowNs();
+            cycles = DWT->CYCCNT;
+            delayUs(_testLengths[i]);
+            cycles = DWT->CYCCNT - cycles;
+            ns = simNowNs() - start;
+            error = _testError(_testLengths[i], ns);
+
+            /* Never shorter than asked: in cycles while spinning, simNowNs rounding both ends down */
+            if(_testLengths[i] < DELAY_SLEEP_US)
+                SIM_CHECK((uint64_t)cycles * 1000000 >= (uint64_t)_testLengths[i] * SystemCoreClock);
+            else
+                SIM_CHECK(ns >= (uint64_t)_testLengths[i] * 1000);
+
+            /* Below the shortest accurate delay, at most as long as it */
+            if(_testLengths[i] < min_us)
+                SIM_CHECK(ns <= (uint64_t)min_us * 1000);
+
+            else if(_testLengths[i] < DELAY_SLEEP_US)
+            {
+                if(error > worst_spin)
+                    worst_spin = error;
+            }
+
+            else if(error > worst_sleep)
+                worst_sleep = error;
+
+            printf("delay,%u,%u,%llu,%d\n", (unsigned)SystemCoreClock, (unsigned)_testLengths[i],
+                   (unsigned long long)ns, (int)error);
+        }
+
+        /* Milliseconds: spinning below 2, sleeping from 2 */
+        start = simNowNs();
+        delayMs(1);
+        SIM_CHECK(_testError(1000, simNowNs() - start) < DELAY_SPIN_PPM);
+        start = simNowNs();
+        delayMs(20);
+        SIM_CHECK(_testError(20000, simNowNs() - start) < TEST_SLEEP_PPM);
+    }
+
+    printf("delay: worst error %d ppm spinning from DELAY_MIN_US, %d ppm sleeping\n", (int)worst_spin, (int)worst_sleep);
+    SIM_CHECK(worst_spin < DELAY_SPIN_PPM);
+    SIM_CHECK(worst_sleep < TEST_SLEEP_PPM);
+}
+
+static void _testMasked(void)
+{
+    uint64_t start, ns;
+    bool state;
+
+    _testStart(CS_DCO_FREQUENCY_48);
+
+    /* Interrupts masked: the sleeping delay spins, the counter never wraps */
+    state = Interrupt_disableMaster();
+    start = simNowNs();
+    delayMs(200);
+    ns = simNowNs() - start;
+    if(!state)
+        Interrupt_enableMaster();
+
+    SIM_CHECK(ns >= 200000000ull && _testError(200000, ns) < 1000);
+}
+
+static void _testTimeouts(void)
+{
+    delay_timeout_t timeout;
+
+    _testStart(CS_DCO_FREQUENCY_12);
+
+    SIM_CHECK(delayTimeoutStart(&timeout, 50) == 1);
+    SIM_CHECK(delayTimeoutExpired(&timeout) == 0);
+    /* Both conversions round up: never less than asked, at most 1 ms more */
+    SIM_CHECK(delayTimeoutRemainingMs(&timeout) >= 50 && delayTimeoutRemainingMs(&timeout) <= 51);
+
+    simAdvanceUs(30000);
+    SIM_CHECK(delayTimeoutRemainingMs(&timeout) >= 20 && delayTimeoutRemainingMs(&timeout) <= 21);
+
+    /* Sleeping does not stop the time base */
+    delayMs(25);
+    SIM_CHECK(delayTimeoutExpired(&timeout) == 1 && delayTimeoutRemainingMs(&timeout) == 0);
+
+    SIM_CHECK(delayTimeoutStart(0, 10) == -1);
+    SIM_CHECK(delayTimeoutExpired(0) == -1);
+}
+
+#endif //BENCH_HOST
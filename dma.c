@@ -0,0 +1,103 @@
+/**
+ @file    dma.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Shared uDMA controller: control table and completion interrupts
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "dma.h"
+#include "stackmon.h"
+
+
+/* SECTION 2: Private macros                                       */
+
+
+/* SECTION 3: Private types                                        */
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+/**
+ @brief Primary and alternate control structures of every channel
+ @remark The controller requires the table to be aligned to its size
+*/
+#pragma DATA_ALIGN(_dmaControlTable, 256)
+static DMA_ControlTable _dmaControlTable [2 * DMA_CHANNEL_COUNT];
+
+static uint8_t _dmaReady = 0;
+
+static dma_callback_t _dmaCallback [DMA_CHANNEL_COUNT];
+static void *_dmaContext [DMA_CHANNEL_COUNT];
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+void DMA_INT0_IRQHandler(void);
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+void dmaInit(void)
+{
+    if(_dmaReady)
+        return;
+
+    DMA_enableModule();
+    DMA_setControlBase(_dmaControlTable);
+
+    _dmaReady = 1;
+}
+
+int dmaChannelCallback(int channel, dma_callback_t callback, void *context)
+{
+    bool state;
+
+    if(channel < 0 || channel > DMA_CHANNEL_COUNT-1)
+        return -1;
+
+    CRITICAL_ENTER(state);
+    _dmaCallback[channel] = callback;
+    _dmaContext[channel] = context;
+    CRITICAL_EXIT(state);
+
+    if(callback != 0)
+        Interrupt_enableInterrupt(INT_DMA_INT0);
+
+    return 1;
+}
+
+void DMA_INT0_IRQHandler(void)
+{
+    uint32_t status;
+    int channel;
+    STACKMON_ISR_ENTER(STACKMON_ISR_DMA);
+
+    /* Completions of every channel not routed to DMA_INT1..3 */
+    status = DMA_getInterruptStatus();
+
+    for(channel = 0; channel < DMA_CHANNEL_COUNT; channel++)
+    {
+        if((status & (1u << channel)) == 0)
+            continue;
+
+        DMA_clearInterruptFlag(channel);
+
+        if(_dmaCallback[channel] != 0)
+            _dmaCallback[channel](channel, _dmaContext[channel]);
+    }
+
+    STACKMON_ISR_EXIT(STACKMON_ISR_DMA);
+}
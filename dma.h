@@ -0,0 +1,51 @@
+/**
+ @file    dma.h
+
+ @brief   Shared uDMA controller: control table and completion interrupts
+
+ The modules using DMA configure their own channels with the driverlib DMA
+ functions; this module owns what they share: the control table, the module
+ enable and the DMA_INT0 interrupt, which is dispatched to a callback per channel.
+
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+*/
+
+// Do not write above this line (except comments)!
+#ifndef DMA_H
+#define DMA_H
+
+/* SECTION 1: Included header files required to compile this file  */
+#include <stdint.h>
+
+
+/* SECTION 2: Public macros                                        */
+
+/**
+ @brief Number of uDMA channels of the msp432p401r
+*/
+#define DMA_CHANNEL_COUNT  8
+
+
+/* SECTION 3: Public types                                         */
+
+/**
+ @brief Completion callback, called from the DMA interrupt with the channel and its context
+*/
+typedef void (*dma_callback_t)(int channel, void *context);
+
+
+/* SECTION 4: Public variables :: declarations, extern mandatory   */
+
+
+/* SECTION 5: Public functions :: declarations, extern optional
+   Rule exception (callbacks)  :: declarations, extern recommended */
+
+void dmaInit(void); //Initialization function, can be called by every module using DMA
+
+int dmaChannelCallback(int channel, dma_callback_t callback, void *context); //Set the function called when a channel completes (0 to disable)
+
+
+#endif //DMA_H
+// Do not write below this line!
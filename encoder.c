@@ -0,0 +1,344 @@
+/**
+ @file    encoder.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Quadrature rotary encoders decoded in the port interrupts
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "encoder.h"
+#include "button.h"
+#include "systime.h"
+
+
+/* SECTION 2: Private macros                                       */
+
+/**
+ @brief Number of entries in the @sa _encoderRefs array
+ @note This value is automatically calculated , do not edit
+*/
+#define NUM_ENCODERS (sizeof(_encoderRefs) / sizeof(encoder_ref_t))
+
+/**
+ @brief Marker of the transitions where both contacts changed in @sa _encoderTable
+*/
+#define ENCODER_MISSED  2
+
+/**
+@brief Private array of references for the encoders on the board
+*/
+static const encoder_ref_t _encoderRefs [] = {
+     { .mask_a = BIT4 , .mask_b = BIT5 , .port_is_odd = 1, .odd = P5 , // P5 .4 (A) and P5 .5 (B)
+       .use_pullup = 1 ,
+       .int_num = INT_PORT5 , .int_priority = 2 , // As BUTTON2, within the RTOS ceiling (see rtos.h)
+       .detent = 4
+     }
+};
+
+/**
+ @brief Transitions counted, indexed by previous state << 2 | current state,
+ a state being A << 1 | B. Clockwise: 00 -> 10 -> 11 -> 01 -> 00
+*/
+static const int8_t _encoderTable [16] = {
+      0, -1, +1, ENCODER_MISSED,    // From 00
+     +1,  0, ENCODER_MISSED, -1,    // From 01
+     -1, ENCODER_MISSED,  0, +1,    // From 10
+     ENCODER_MISSED, +1, -1,  0     // From 11
+};
+
+
+/* SECTION 3: Private types                                        */
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+static uint8_t _encoderState [NUM_ENCODERS];            /**< Last decoded state (A << 1 | B)  */
+static int8_t _encoderDirection [NUM_ENCODERS];         /**< Direction of the last step       */
+static volatile int32_t _encoderCount [NUM_ENCODERS];   /**< Transitions, written by the ISR  */
+static volatile uint32_t _encoderErrors [NUM_ENCODERS]; /**< Transitions with a missed edge   */
+static int32_t _encoderTaken [NUM_ENCODERS];            /**< Position returned by encoderSteps */
+
+/**
+ @brief Velocity measurement, shared by all the encoders
+*/
+static systime_alarm_t _encoderWindow;
+static volatile uint8_t _encoderWindowOn = 0;          /**< Flag (0/1) set while the alarm runs */
+static systime_t _encoderWindowEnd;                    /**< Deadline of the current window      */
+static int32_t _encoderWindowCount [NUM_ENCODERS];     /**< Transitions at the window start     */
+static volatile int32_t _encoderVelocity [NUM_ENCODERS];
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static void _encoderPortIsr(int port, uint8_t in, uint8_t flags, void *context); //Hook of the port ISR for the encoder pins
+
+static uint8_t _encoderStateOf(const encoder_ref_t *ref, uint8_t in); //State of the contacts in a port IN value
+
+static int32_t _encoderDetents(int which_encoder); //Transitions rounded to the nearest detent
+
+static void _encoderWindowTick(void *context); //Alarm callback closing a velocity window
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+void encodersInit(void)
+{
+    const encoder_ref_t *ref;
+    uint8_t port_mask [6] = {0};
+    uint8_t port_priority [6] = {7, 7, 7, 7, 7, 7};
+    uint8_t pins, in;
+    int i, port;
+
+    /* No velocity window yet (the first transition starts one) */
+    _encoderWindowOn = 0;
+
+    for(i = 0; i < NUM_ENCODERS; i++)
+    {
+        ref = &_encoderRefs[i];
+        pins = ref->mask_a | ref->mask_b;
+
+        /* Inputs waiting for the edge leaving their current level */
+        if(ref->port_is_odd)
+        {
+            ref->odd->DIR = ref->odd->DIR & ~pins;
+            ref->odd->SEL0 = ref->odd->SEL0 & ~pins;
+            ref->odd->SEL1 = ref->odd->SEL1 & ~pins;
+            ref->odd->REN = (ref->odd->REN & ~pins) | (ref->use_pullup ? pins : 0);
+            ref->odd->OUT = ref->odd->OUT | (ref->use_pullup ? pins : 0);
+            in = ref->odd->IN;
+            ref->odd->IES = (ref->odd->IES & ~pins) | (in & pins);
+            ref->odd->IFG = ref->odd->IFG & ~pins;
+            ref->odd->IE = ref->odd->IE | pins;
+        }
+
+        else
+        {
+            ref->even->DIR = ref->even->DIR & ~pins;
+            ref->even->SEL0 = ref->even->SEL0 & ~pins;
+            ref->even->SEL1 = ref->even->SEL1 & ~pins;
+            ref->even->REN = (ref->even->REN & ~pins) | (ref->use_pullup ? pins : 0);
+            ref->even->OUT = ref->even->OUT | (ref->use_pullup ? pins : 0);
+            in = ref->even->IN;
+            ref->even->IES = (ref->even->IES & ~pins) | (in & pins);
+            ref->even->IFG = ref->even->IFG & ~pins;
+            ref->even->IE = ref->even->IE | pins;
+        }
+
+        _encoderState[i] = _encoderStateOf(ref, in);
+        _encoderDirection[i] = 0;
+        _encoderCount[i] = 0;
+        _encoderErrors[i] = 0;
+        _encoderTaken[i] = 0;
+        _encoderWindowCount[i] = 0;
+        _encoderVelocity[i] = 0;
+
+        port = ref->int_num - INT_PORT1;
+        port_mask[port] = port_mask[port] | pins;
+        if(ref->int_priority < port_priority[port])
+            port_priority[port] = ref->int_priority;
+    }
+
+    /* One hook per port, shared by the encoders on it */
+    for(port = 0; port < 6; port++)
+    {
+        if(port_mask[port] != 0 && buttonPinHook(port + 1, port_mask[port], port_priority[port], _encoderPortIsr, 0) < 0)
+            port_mask[port] = 0;
+    }
+
+    /* Pins of a button, or on a port hooked by another module: left without interrupts */
+    for(i = 0; i < NUM_ENCODERS; i++)
+    {
+        ref = &_encoderRefs[i];
+        pins = ref->mask_a | ref->mask_b;
+
+        if(port_mask[ref->int_num - INT_PORT1] != 0)
+            continue;
+
+        if(ref->port_is_odd)
+            ref->odd->IE = ref->odd->IE & ~pins;
+
+        else
+            ref->even->IE = ref->even->IE & ~pins;
+    }
+}
+
+int encodersGetNum(void)
+{
+    return NUM_ENCODERS;
+}
+
+int32_t encoderPosition(int which_encoder)
+{
+    if(which_encoder < 0 || which_encoder > NUM_ENCODERS-1)
+        return 0;
+
+    return _encoderDetents(which_encoder);
+}
+
+int32_t encoderSteps(int which_encoder)
+{
+    int32_t position, steps;
+
+    if(which_encoder < 0 || which_encoder > NUM_ENCODERS-1)
+        return 0;
+
+    position = _encoderDetents(which_encoder);
+    steps = position - _encoderTaken[which_encoder];
+    _encoderTaken[which_encoder] = position;
+
+    return steps;
+}
+
+int32_t encoderVelocity(int which_encoder)
+{
+    if(which_encoder < 0 || which_encoder > NUM_ENCODERS-1)
+        return 0;
+
+    return _encoderVelocity[which_encoder];
+}
+
+uint32_t encoderErrors(int which_encoder)
+{
+    if(which_encoder < 0 || which_encoder > NUM_ENCODERS-1)
+        return 0;
+
+    return _encoderErrors[which_encoder];
+}
+
+int encoderProcess(int which_encoder, uint8_t state)
+{
+    int step;
+
+    if(which_encoder < 0 || which_encoder > NUM_ENCODERS-1)
+        return 0;
+
+    state = state & 0x03;
+    step = _encoderTable[(_encoderState[which_encoder] << 2) | state];
+    _encoderState[which_encoder] = state;
+
+    if(step == 0)
+        return 0;
+
+    /* Both contacts changed: at speed, two steps in the same direction as before */
+    if(step == ENCODER_MISSED)
+    {
+        _encoderErrors[which_encoder]++;
+        step = 2 * _encoderDirection[which_encoder];
+    }
+
+    else
+        _encoderDirection[which_encoder] = step;
+
+    /* Single writer: one 32-bit store, read atomically by the main loop */
+    _encoderCount[which_encoder] = _encoderCount[which_encoder] + step;
+
+    if(!_encoderWindowOn)
+    {
+        _encoderWindowOn = 1;
+        _encoderWindowEnd = systimeNow() + systimeMsToTicks(ENCODER_VELOCITY_MS);
+        systimeAlarmStart(&_encoderWindow, _encoderWindowEnd, _encoderWindowTick, 0);
+    }
+
+    return step;
+}
+
+static void _encoderPortIsr(int port, uint8_t in, uint8_t flags, void *context)
+{
+    const encoder_ref_t *ref;
+    uint8_t pins, now;
+    int i;
+
+    for(i = 0; i < NUM_ENCODERS; i++)
+    {
+        ref = &_encoderRefs[i];
+        pins = ref->mask_a | ref->mask_b;
+        if(ref->int_num - INT_PORT1 + 1 != port || (flags & pins) == 0)
+            continue;
+
+        encoderProcess(i, _encoderStateOf(ref, in));
+
+        /* Wait for the edges leaving the levels just decoded. A contact that moved
+           meanwhile raised no flag: raise it by software, the ISR runs again */
+        if(ref->port_is_odd)
+        {
+            ref->odd->IES = (ref->odd->IES & ~pins) | (in & pins);
+            now = ref->odd->IN;
+            ref->odd->IFG = ref->odd->IFG | ((now ^ in) & pins);
+        }
+
+        else
+        {
+            ref->even->IES = (ref->even->IES & ~pins) | (in & pins);
+            now = ref->even->IN;
+            ref->even->IFG = ref->even->IFG | ((now ^ in) & pins);
+        }
+    }
+}
+
+static uint8_t _encoderStateOf(const encoder_ref_t *ref, uint8_t in)
+{
+    return (((in & ref->mask_a) != 0) << 1) | ((in & ref->mask_b) != 0);
+}
+
+static int32_t _encoderDetents(int which_encoder)
+{
+    int32_t count, detent;
+
+    /* Rounded to the nearest detent, so a contact bouncing at rest does not move it */
+    count = _encoderCount[which_encoder];
+    detent = _encoderRefs[which_encoder].detent;
+    count = count + detent / 2;
+
+    if(count >= 0)
+        return count / detent;
+
+    return -((-count + detent - 1) / detent);
+}
+
+static void _encoderWindowTick(void *context)
+{
+    int32_t count, moved;
+    int i, active;
+    bool state;
+
+    /* Atomic with respect to the port ISR, which restarts the alarm when stopped */
+    CRITICAL_ENTER(state);
+
+    active = 0;
+
+    for(i = 0; i < NUM_ENCODERS; i++)
+    {
+        count = _encoderCount[i];
+        moved = count - _encoderWindowCount[i];
+        _encoderWindowCount[i] = count;
+
+        /* Averaged with the previous window, decays to 0 once the knob stops */
+        _encoderVelocity[i] = (_encoderVelocity[i] + moved * (1000 / ENCODER_VELOCITY_MS)) / 2;
+
+        if(moved != 0 || _encoderVelocity[i] != 0)
+            active = 1;
+    }
+
+    if(active)
+    {
+        _encoderWindowEnd = _encoderWindowEnd + systimeMsToTicks(ENCODER_VELOCITY_MS);
+        systimeAlarmStart(&_encoderWindow, _encoderWindowEnd, _encoderWindowTick, 0);
+    }
+
+    else
+        _encoderWindowOn = 0;
+
+    CRITICAL_EXIT(state);
+}
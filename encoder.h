@@ -0,0 +1,66 @@
+/**
+ @file    encoder.h
+
+ @brief   Quadrature rotary encoders decoded in the port interrupts
+
+ Both contacts of an encoder interrupt on every edge: the port ISR of the button
+ module hands their flags to this module (see buttonPinHook), which re-arms the
+ edge opposite to the level just read and decodes the transition of the two
+ contacts with a 16-entry table indexed by the previous and current state.
+ A bouncing contact produces steps back and forth that cancel out. A transition
+ where both contacts changed means an edge was missed: it is counted as two
+ steps in the last direction, and as an error.
+
+ The transition counter is a 32-bit variable written only by the ISR, so the
+ main loop reads it atomically. The velocity is measured over windows of
+ ENCODER_VELOCITY_MS, by a systime alarm running only while the knob moves.
+
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+*/
+
+// Do not write above this line (except comments)!
+#ifndef ENCODER_H
+#define ENCODER_H
+
+/* SECTION 1: Included header files required to compile this file  */
+#include <stdint.h>
+
+
+/* SECTION 2: Public macros                                        */
+
+#define ENCODER0 0
+
+/**
+ @brief Length of the velocity measurement window, in milliseconds
+*/
+#define ENCODER_VELOCITY_MS  20
+
+
+/* SECTION 3: Public types                                         */
+
+
+/* SECTION 4: Public variables :: declarations, extern mandatory   */
+
+
+/* SECTION 5: Public functions :: declarations, extern optional
+   Rule exception (callbacks)  :: declarations, extern recommended */
+
+void encodersInit(void); //Initialization function, after buttonsInit
+
+int encodersGetNum(void); //Get the number of encoders
+
+int32_t encoderPosition(int which_encoder); //Position in detents since the initialization (0 if invalid)
+
+int32_t encoderSteps(int which_encoder); //Detents moved since the last call (0 if invalid)
+
+int32_t encoderVelocity(int which_encoder); //Signed velocity in transitions per second (0 if invalid)
+
+uint32_t encoderErrors(int which_encoder); //Transitions where both contacts changed (0 if invalid)
+
+int encoderProcess(int which_encoder, uint8_t state); //Decode a new state (A << 1 | B) of the contacts, returns the transitions counted
+
+
+#endif //ENCODER_H
+// Do not write below this line!
@@ -0,0 +1,285 @@
+/**
+ @file    encoder_test.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Host test of the quadrature rotary encoders
+
+ Built by host/Makefile. The contacts of ENCODER0 (P5.4 and P5.5) are driven
+ through full turns with bouncing edges, and with edges coming while the port
+ interrupt is masked; the position, the errors and the velocity are checked,
+ as well as the ownership of the port pins shared with BUTTON2.
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "encoder.h"
+#include "button.h"
+#include "defer.h"
+#include "persist.h"
+#include "systime.h"
+#include "sim.h"
+
+/* The whole file belongs to the host build (see host/Makefile) */
+#ifdef BENCH_HOST
+
+
+/* SECTION 2: Private macros                                       */
+
+#define TEST_PORT      5
+#define TEST_A         BIT4      //Contacts of ENCODER0 (see encoder.c)
+#define TEST_B         BIT5
+#define TEST_DETENT    4         //Transitions per detent of ENCODER0
+#define TEST_BOUNCES   5         //Extra pairs of edges at each change of a contact
+#define TEST_BOUNCE_US 30        //Length of a bounce
+
+
+/* SECTION 3: Private types                                        */
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+static uint32_t _testButton2 = 0;   /**< Presses of BUTTON2 delivered */
+
+/**
+ @brief Levels of A and B through one clockwise detent, from both high (state 11)
+*/
+static const uint8_t _testCw [TEST_DETENT] = { TEST_B, 0, TEST_A, TEST_A | TEST_B };
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static void _testStart(void); //Reset the simulation and the modules, as after a cold reset
+
+static void _testHook(int port, uint8_t in, uint8_t flags, void *context); //Pin hook of another module
+
+static void _testLevels(uint8_t levels, int bounces); //Drive A and B, bouncing the contact that changes
+
+static void _testTurn(int detents, int bounces, uint32_t step_us); //Turn by some detents (negative: counterclockwise)
+
+static void _testSpeed(void); //Turn by ten detents, missing one state out of ten
+
+static void _testBounce(void);
+
+static void _testMasked(void);
+
+static void _testVelocity(void);
+
+static void _testPins(void);
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+int main(void)
+{
+    _testBounce();
+    _testMasked();
+    _testVelocity();
+    _testPins();
+
+    return simReport("encoder_test");
+}
+
+void buttonCallback(int which_button)
+{
+    if(which_button == BUTTON2)
+        _testButton2++;
+}
+
+static void _testStart(void)
+{
+    persistInvalidate();
+    simReset();
+    deferInit();
+    systimeInit();
+    buttonsInit();
+    encodersInit();
+    Interrupt_enableMaster();
+
+    _testButton2 = 0;
+}
+
+static void _testHook(int port, uint8_t in, uint8_t flags, void *context)
+{
+}
+
+static void _testLevels(uint8_t levels, int bounces)
+{
+    uint8_t changed;
+    int i;
+
+    changed = (P5->IN ^ levels) & (TEST_A | TEST_B);
+
+    simPinSet(TEST_PORT, changed, (levels & changed) != 0);
+    for(i = 0; i < bounces; i++)
+    {
+        simAdvanceUs(TEST_BOUNCE_US);
+        simPinSet(TEST_PORT, changed, (levels & changed) == 0);
+        simAdvanceUs(TEST_BOUNCE_US);
+        simPinSet(TEST_PORT, changed, (levels & changed) != 0);
+    }
+}
+
+static void _testTurn(int detents, int bounces, uint32_t step_us)
+{
+    int i, k;
+
+    for(i = 0; i < (detents < 0 ? -detents : detents); i++)
+    {
+        for(k = 0; k < TEST_DETENT; k++)
+        {
+            /* Counterclockwise: the same levels backwards, from the end */
+            _testLevels(detents > 0 ? _testCw[k] : _testCw[(2 * TEST_DETENT - 2 - k) % TEST_DETENT], bounces);
+            simAdvanceUs(step_us);
+        }
+    }
+}
+
+static void _testSpeed(void)
+{
+    bool state;
+    int k;
+
+    for(k = 0; k < 10 * TEST_DETENT; k++)
+    {
+        /* Two states in a row while the interrupt is masked */
+        if(k % 10 == 8)
+        {
+            state = Interrupt_disableMaster();
+            _testLevels(_testCw[k % TEST_DETENT], 0);
+            k++;
+            _testLevels(_testCw[k % TEST_DETENT], 0);
+            if(!state)
+                Interrupt_enableMaster();
+        }
+
+        else
+            _testLevels(_testCw[k % TEST_DETENT], 0);
+
+        simAdvanceUs(100);
+    }
+}
+
+static void _testBounce(void)
+{
+    _testStart();
+    SIM_CHECK(encoderPosition(ENCODER0) == 0);
+
+    /* Every bounce is decoded as a step back and forth */
+    _testTurn(10, TEST_BOUNCES, 1000);
+    SIM_CHECK(encoderPosition(ENCODER0) == 10);
+    SIM_CHECK(encoderSteps(ENCODER0) == 10 && encoderSteps(ENCODER0) == 0);
+
+    _testTurn(-13, TEST_BOUNCES, 1000);
+    SIM_CHECK(encoderPosition(ENCODER0) == -3);
+    SIM_CHECK(encoderSteps(ENCODER0) == -13);
+    SIM_CHECK(encoderErrors(ENCODER0) == 0);
+
+    /* A contact bouncing at rest, at the detent, does not move the position */
+    _testLevels(TEST_B, 0);
+    _testLevels(TEST_A | TEST_B, TEST_BOUNCES);
+    _testLevels(TEST_A, 0);
+    _testLevels(TEST_A | TEST_B, TEST_BOUNCES);
+    SIM_CHECK(encoderPosition(ENCODER0) == -3);
+
+    /* Each edge of every bounce ran the port ISR */
+    SIM_CHECK(simIsrCount(INT_PORT5) >= 23 * TEST_DETENT * (1 + 2 * TEST_BOUNCES));
+}
+
+static void _testMasked(void)
+{
+    bool state;
+
+    _testStart();
+
+    /* A bounce over while masked: the flag stays, the level is unchanged, no step */
+    state = Interrupt_disableMaster();
+    simPinSet(TEST_PORT, TEST_A, 0);
+    simPinSet(TEST_PORT, TEST_A, 1);
+    if(!state)
+        Interrupt_enableMaster();
+    SIM_CHECK(encoderPosition(ENCODER0) == 0 && encoderErrors(ENCODER0) == 0);
+
+    /* One step done, then both contacts moved while masked: counted twice, as an error */
+    _testLevels(_testCw[0], 0);
+    state = Interrupt_disableMaster();
+    simPinSet(TEST_PORT, TEST_B, 0);
+    simPinSet(TEST_PORT, TEST_A, 1);
+    if(!state)
+        Interrupt_enableMaster();
+    SIM_CHECK(encoderErrors(ENCODER0) == 1);
+    _testLevels(_testCw[3], 0);
+    SIM_CHECK(encoderPosition(ENCODER0) == 1);
+
+    /* At speed, one state out of ten missed: each one counted twice, as an error */
+    _testSpeed();
+    SIM_CHECK(encoderErrors(ENCODER0) == 1 + 10 * TEST_DETENT / 10);
+    SIM_CHECK(encoderPosition(ENCODER0) == 11);
+
+    /* A contact moving after the ISR read IN raises its own flag: nothing lost */
+    _testTurn(5, 1, 200);
+    SIM_CHECK(encoderPosition(ENCODER0) == 16);
+}
+
+static void _testVelocity(void)
+{
+    int32_t velocity;
+
+    _testStart();
+
+    /* One transition every 500 us: 2000 transitions per second clockwise,
+       reached within a few percent after six windows of averaging */
+    _testTurn(60, 0, 500);
+    velocity = encoderVelocity(ENCODER0);
+    SIM_CHECK(velocity >= 1850 && velocity <= 2000);
+
+    _testTurn(-60, 0, 500);
+    velocity = encoderVelocity(ENCODER0);
+    SIM_CHECK(velocity <= -1850 && velocity >= -2000);
+
+    /* Stopped: decays to 0 and the window alarm stops */
+    simAdvanceUs(20 * ENCODER_VELOCITY_MS * 1000);
+    SIM_CHECK(encoderVelocity(ENCODER0) == 0);
+}
+
+static void _testPins(void)
+{
+    _testStart();
+
+    /* The encoder pins are taken: neither another module nor a button's */
+    SIM_CHECK(buttonPinHook(TEST_PORT, TEST_A, 2, _testHook, 0) == -1);
+    SIM_CHECK(buttonPinHook(TEST_PORT, BIT7, 2, _testHook, 0) == -1);
+
+    /* Pins of the buttons, interrupt-driven or polled */
+    SIM_CHECK(buttonPinHook(5, BIT1, 2, _testHook, 0) == -1);
+    SIM_CHECK(buttonPinHook(1, BIT4, 2, _testHook, 0) == -1);
+    SIM_CHECK(buttonPinHook(1, BIT1, 2, _testHook, 0) == -1);
+    SIM_CHECK(buttonPinHook(3, BIT5, 2, _testHook, 0) == -1);
+
+    /* A free port: owned by the first hook until released */
+    SIM_CHECK(buttonPinHook(2, BIT3, 2, _testHook, 0) == 1);
+    SIM_CHECK(buttonPinHook(2, BIT3 | BIT7, 2, _testHook, 0) == 1);
+    SIM_CHECK(buttonPinHook(2, BIT5, 2, _testHook, (void *)1) == -1);
+    SIM_CHECK(buttonPinHook(2, 0, 2, 0, 0) == 1);
+    SIM_CHECK(buttonPinHook(2, BIT5, 2, _testHook, (void *)1) == 1);
+
+    /* BUTTON2 shares the port with the encoder: both keep working */
+    _testTurn(2, TEST_BOUNCES, 1000);
+    simPinSet(TEST_PORT, BIT1, 0);
+    simAdvanceUs(1000);
+    simPinSet(TEST_PORT, BIT1, 1);
+    _testTurn(1, TEST_BOUNCES, 1000);
+    SIM_CHECK(_testButton2 == 1 && encoderPosition(ENCODER0) == 3);
+}
+
+#endif //BENCH_HOST
@@ -0,0 +1,205 @@
+/**
+ @file    energy.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Estimated charge consumption of the LEDs and the CPU
+
+ State changes only add the elapsed time to an accumulator, the multiplication
+ by the currents is left to @ref energyReport.
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "energy.h"
+#include "systime.h"
+
+
+/* SECTION 2: Private macros                                       */
+
+
+/* SECTION 3: Private types                                        */
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+/**
+ @brief Current drawn by each LED when on, in nA, indexed like the LEDs in led.h
+
+ @remark This is the element that should be adapted to the series resistors
+ and supply voltage of the board.
+*/
+static const uint32_t _energyLedCurrent [ENERGY_NUM_LEDS] = {
+                                      5000000, // LED0
+                                      4000000, // LED1_RED
+                                      2000000, // LED1_GREEN
+                                      2000000, // LED1_BLUE
+                                      4000000, // LED2_RED
+                                      2000000, // LED2_GREEN
+                                      2000000  // LED2_BLUE
+};
+
+/**
+ @brief Current drawn by the CPU in each power mode, in nA (datasheet typical
+ values at 12 MHz, LDO, VCORE0)
+*/
+static const uint32_t _energyCpuCurrent [POWER_NUM_MODES] = {
+                                      1100000, // POWER_MODE_ACTIVE
+                                       800000, // POWER_MODE_LPM0
+                                          850  // POWER_MODE_LPM3
+};
+
+static uint8_t   _energyLedDuty [ENERGY_NUM_LEDS];       /**< Share of the time LED i is on, in %   */
+static systime_t _energyLedSince [ENERGY_NUM_LEDS];      /**< Time LED i last changed its duty      */
+static uint32_t  _energyLedTicks [ENERGY_NUM_LEDS];      /**< On-time accumulated in this interval  */
+
+static int       _energyMode = POWER_MODE_ACTIVE;        /**< Current CPU mode                      */
+static systime_t _energyModeSince = 0;                   /**< Time the current CPU mode was entered */
+static uint32_t  _energyModeTicks [POWER_NUM_MODES];     /**< Time accumulated in this interval     */
+
+static systime_t _energyIntervalStart = 0;               /**< Start of the current interval         */
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static uint64_t _energyCharge(uint32_t ticks, uint32_t current); //Charge in nC for a current (nA) during some ticks
+
+static void _energyLedClose(int which_led, systime_t now); //Add the on-time of a LED up to now
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+void energyInit(void)
+{
+    int i;
+    bool state;
+
+    CRITICAL_ENTER(state);
+
+    _energyIntervalStart = systimeNow();
+    _energyModeSince = _energyIntervalStart;
+    _energyMode = POWER_MODE_ACTIVE;
+
+    for(i = 0; i < ENERGY_NUM_LEDS; i++)
+    {
+        _energyLedDuty[i] = 0;
+        _energyLedTicks[i] = 0;
+    }
+
+    for(i = 0; i < POWER_NUM_MODES; i++)
+        _energyModeTicks[i] = 0;
+
+    CRITICAL_EXIT(state);
+}
+
+void energyLedSet(int which_led, int on)
+{
+    energyLedDuty(which_led, on ? 100 : 0);
+}
+
+void energyLedDuty(int which_led, uint32_t duty)
+{
+    systime_t now;
+    bool state;
+
+    if(which_led < 0 || which_led > ENERGY_NUM_LEDS-1 || duty > 100)
+        return;
+
+    /* Nothing to integrate if the LED keeps its state */
+    if(_energyLedDuty[which_led] == duty)
+        return;
+
+    CRITICAL_ENTER(state);
+
+    now = systimeNow();
+    _energyLedClose(which_led, now);
+    _energyLedDuty[which_led] = duty;
+
+    CRITICAL_EXIT(state);
+}
+
+void energyCpuMode(int mode)
+{
+    systime_t now;
+    bool state;
+
+    if(mode < 0 || mode > POWER_NUM_MODES-1)
+        return;
+
+    CRITICAL_ENTER(state);
+
+    now = systimeNow();
+    _energyModeTicks[_energyMode] += (uint32_t)(now - _energyModeSince);
+    _energyModeSince = now;
+    _energyMode = mode;
+
+    CRITICAL_EXIT(state);
+}
+
+int energyReport(energy_report_t *report)
+{
+    systime_t now;
+    int i;
+    bool state;
+
+    if(report == 0)
+        return -1;
+
+    CRITICAL_ENTER(state);
+
+    /* Close the running periods at the end of the interval */
+    now = systimeNow();
+    for(i = 0; i < ENERGY_NUM_LEDS; i++)
+    {
+        _energyLedClose(i, now);
+
+        report->led_on_ticks[i] = _energyLedTicks[i];
+        _energyLedTicks[i] = 0;
+    }
+
+    _energyModeTicks[_energyMode] += (uint32_t)(now - _energyModeSince);
+    _energyModeSince = now;
+    for(i = 0; i < POWER_NUM_MODES; i++)
+    {
+        report->cpu_ticks[i] = _energyModeTicks[i];
+        _energyModeTicks[i] = 0;
+    }
+
+    report->interval_ticks = (uint32_t)(now - _energyIntervalStart);
+    _energyIntervalStart = now;
+
+    CRITICAL_EXIT(state);
+
+    report->led_charge_nC = 0;
+    for(i = 0; i < ENERGY_NUM_LEDS; i++)
+        report->led_charge_nC += _energyCharge(report->led_on_ticks[i], _energyLedCurrent[i]);
+
+    report->cpu_charge_nC = 0;
+    for(i = 0; i < POWER_NUM_MODES; i++)
+        report->cpu_charge_nC += _energyCharge(report->cpu_ticks[i], _energyCpuCurrent[i]);
+
+    return 1;
+}
+
+static uint64_t _energyCharge(uint32_t ticks, uint32_t current)
+{
+    return ((uint64_t)ticks * current) / SYSTIME_TICKS_PER_SECOND;
+}
+
+static void _energyLedClose(int which_led, systime_t now)
+{
+    if(_energyLedDuty[which_led] != 0)
+        _energyLedTicks[which_led] += (uint32_t)(((now - _energyLedSince[which_led]) * _energyLedDuty[which_led]) / 100);
+
+    _energyLedSince[which_led] = now;
+}
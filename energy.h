@@ -0,0 +1,78 @@
+/**
+ @file    energy.h
+
+ @brief   Estimated charge consumption of the LEDs and the CPU
+
+ The model integrates the time each LED is on and the time the CPU spends in
+ each power mode (see power.h), and weights them with the configured currents.
+ Times come from the systime module, so the same code runs on the host against
+ a simulated counter.
+ Accumulators are 32-bit tick counts: @ref energyReport must be called at least
+ once every 36 hours.
+
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+*/
+
+// Do not write above this line (except comments)!
+#ifndef ENERGY_H
+#define ENERGY_H
+
+/* SECTION 1: Included header files required to compile this file  */
+#include <stdint.h>
+#include "power.h"
+#include "led.h"
+
+
+/* SECTION 2: Public macros                                        */
+
+/**
+ @brief Set to 0 to remove the accounting hooks from the led and power modules
+*/
+#define ENERGY_ACCOUNTING  1
+
+/**
+ @brief Number of LEDs accounted for: the LEDs on pins of led.h
+*/
+#define ENERGY_NUM_LEDS    LED_NUM_PINS
+
+
+/* SECTION 3: Public types                                         */
+
+/**
+ @brief Consumption over one reporting interval
+*/
+struct energy_report_s {
+   uint32_t interval_ticks;                  /**< Length of the interval, in systime ticks  */
+   uint32_t led_on_ticks[ENERGY_NUM_LEDS];   /**< Time each LED was on, in systime ticks (weighted by the duty while blinking) */
+   uint32_t cpu_ticks[POWER_NUM_MODES];      /**< Time spent in each CPU mode, in ticks     */
+   uint64_t led_charge_nC;                   /**< Estimated charge used by the LEDs         */
+   uint64_t cpu_charge_nC;                   /**< Estimated charge used by the CPU          */
+};
+
+/**
+ @brief Short alias "energy_report_t" for the data type "struct energy_report_s"
+*/
+typedef struct energy_report_s energy_report_t;
+
+
+/* SECTION 4: Public variables :: declarations, extern mandatory   */
+
+
+/* SECTION 5: Public functions :: declarations, extern optional
+   Rule exception (callbacks)  :: declarations, extern recommended */
+
+void energyInit(void); //Initialization function, all LEDs off and CPU active
+
+void energyLedSet(int which_led, int on); //Hook: a LED has been switched on (1) or off (0)
+
+void energyLedDuty(int which_led, uint32_t duty); //Hook: a LED is on for a fraction of the time (duty in %), as when blinked by a timer output
+
+void energyCpuMode(int mode); //Hook: the CPU enters a power mode
+
+int energyReport(energy_report_t *report); //Fill in the consumption since the previous report and start a new interval
+
+
+#endif //ENERGY_H
+// Do not write below this line!
@@ -0,0 +1,247 @@
+/**
+ @file    energy_test.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Host test of the charge estimate: the same LED duty driven in three ways
+
+ Built by host/Makefile. A LED is kept on for half of a 10 s window by the
+ application (ledOn/ledOff), by a timer output (ledBlink, hardware) and by
+ timer wakeups (ledBlink on a pin without port mapping), while the CPU sleeps
+ between the interrupts in the last two. The on time accounted must be the
+ same in the three cases (the last one blinks LED0, whose current differs);
+ the wakeup case is run again in deferred mode, where the blinking must still
+ reach the pin. One line per case is printed so that CI can compare the
+ estimates across commits:
+   energy,<case>,<led on ticks>,<led charge nC>,<cpu charge nC>
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "energy.h"
+#include "defer.h"
+#include "led.h"
+#include "persist.h"
+#include "power.h"
+#include "systime.h"
+#include "sim.h"
+
+/* The whole file belongs to the host build (see host/Makefile) */
+#ifdef BENCH_HOST
+
+
+/* SECTION 2: Private macros                                       */
+
+#define TEST_WINDOW_TICKS  (10 * SYSTIME_TICKS_PER_SECOND)   //Length of each case
+#define TEST_PERIOD_MS     100
+#define TEST_DUTY          50
+#define TEST_HALF_TICKS    2048                              //Half period of the software case, divides the window
+
+/**
+ @brief Tolerance on the on time, in ticks: the wakeup case rounds its half periods to whole ticks
+*/
+#define TEST_TOLERANCE     (TEST_WINDOW_TICKS / 500)
+
+
+/* SECTION 3: Private types                                        */
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+static systime_alarm_t _testEnd;    /**< Wakes the CPU up at the end of a case */
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static void _testWake(void *context); //Alarm callback, only wakes the CPU up
+
+static void _testStart(void); //Reset the simulation, the LEDs and the accounting
+
+static void _testSleepUntil(systime_t end); //Idle path of the application until a time
+
+static void _testCheck(const char *name, int which_led); //Report a case and check the on time of its LED
+
+static void _testSoftware(void);
+
+static void _testHardware(void);
+
+static void _testWakeups(void);
+
+static void _testDeferred(void);
+
+static void _testBounds(void);
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+int main(void)
+{
+    _testSoftware();
+    _testHardware();
+    _testWakeups();
+    _testDeferred();
+    _testBounds();
+
+    return simReport("energy_test");
+}
+
+static void _testWake(void *context)
+{
+}
+
+static void _testStart(void)
+{
+    energy_report_t report;
+
+    /* Cold start: the LEDs left on by the previous case are not restored */
+    persistInvalidate();
+    simReset();
+    deferInit();
+    systimeInit();
+    energyInit();
+    ledsInit();
+    Interrupt_enableMaster();
+
+    energyReport(&report);
+}
+
+static void _testSleepUntil(systime_t end)
+{
+    systimeAlarmStart(&_testEnd, end, _testWake, 0);
+
+    while(systimeNow() < end)
+        powerSleep(POWER_MODE_LPM3);
+}
+
+static void _testCheck(const char *name, int which_led)
+{
+    energy_report_t report;
+    uint32_t expected;
+    int i;
+
+    SIM_CHECK(energyReport(&report) == 1);
+    SIM_CHECK(report.interval_ticks == TEST_WINDOW_TICKS);
+
+    expected = (uint32_t)(((uint64_t)TEST_WINDOW_TICKS * TEST_DUTY) / 100);
+    SIM_CHECK(report.led_on_ticks[which_led] + TEST_TOLERANCE >= expected);
+    SIM_CHECK(report.led_on_ticks[which_led] <= expected + TEST_TOLERANCE);
+
+    for(i = 0; i < ENERGY_NUM_LEDS; i++)
+        SIM_CHECK(i == which_led || report.led_on_ticks[i] == 0);
+
+    printf("energy,%s,%u,%llu,%llu\n", name, (unsigned)report.led_on_ticks[which_led],
+           (unsigned long long)report.led_charge_nC, (unsigned long long)report.cpu_charge_nC);
+}
+
+static void _testSoftware(void)
+{
+    int i;
+
+    _testStart();
+
+    /* The application switches the LED itself, awake all the time */
+    for(i = 0; i < TEST_WINDOW_TICKS / (2 * TEST_HALF_TICKS); i++)
+    {
+        ledOn(LED1_RED);
+        simAdvanceTicks(TEST_HALF_TICKS);
+        ledOff(LED1_RED);
+        simAdvanceTicks(TEST_HALF_TICKS);
+    }
+
+    _testCheck("software", LED1_RED);
+}
+
+static void _testHardware(void)
+{
+    systime_t start;
+    energy_report_t report;
+
+    _testStart();
+    start = systimeNow();
+
+    /* A timer output: the CPU never sees the LED change */
+    SIM_CHECK(ledBlink(LED1_RED, TEST_PERIOD_MS, TEST_DUTY) == 1);
+    _testSleepUntil(start + TEST_WINDOW_TICKS);
+    _testCheck("hardware", LED1_RED);
+
+    /* Stopped with the LED off: no more on time */
+    SIM_CHECK(ledOff(LED1_RED) == 1);
+    simAdvanceTicks(SYSTIME_TICKS_PER_SECOND);
+    SIM_CHECK(energyReport(&report) == 1);
+    SIM_CHECK(report.led_on_ticks[LED1_RED] == 0);
+
+    /* Stopped with the LED on: accounted as steadily on again */
+    SIM_CHECK(ledBlink(LED1_RED, TEST_PERIOD_MS, TEST_DUTY) == 1);
+    SIM_CHECK(ledOn(LED1_RED) == 1);
+    simAdvanceTicks(SYSTIME_TICKS_PER_SECOND);
+    SIM_CHECK(energyReport(&report) == 1);
+    SIM_CHECK(report.led_on_ticks[LED1_RED] == SYSTIME_TICKS_PER_SECOND);
+}
+
+static void _testWakeups(void)
+{
+    systime_t start;
+
+    _testStart();
+    start = systimeNow();
+
+    /* P1 has no port mapping: the CPU wakes up at each change */
+    SIM_CHECK(ledBlink(LED0, TEST_PERIOD_MS, TEST_DUTY) == 2);
+    _testSleepUntil(start + TEST_WINDOW_TICKS);
+    _testCheck("wakeups", LED0);
+    SIM_CHECK(ledBlink(LED0, 0, 0) == 1);
+}
+
+static void _testDeferred(void)
+{
+    systime_t start;
+
+    _testStart();
+    start = systimeNow();
+
+    /* Deferred mode without automatic commit: the blinking goes on, the other changes wait */
+    ledSetDeferred(1);
+    SIM_CHECK(ledOn(LED1_RED) == 1);
+    SIM_CHECK(ledBlink(LED0, TEST_PERIOD_MS, TEST_DUTY) == 2);
+    SIM_CHECK((P1->OUT & BIT0) != 0);
+    _testSleepUntil(start + TEST_WINDOW_TICKS);
+    _testCheck("deferred", LED0);
+    SIM_CHECK((P2->OUT & BIT0) == 0 && ledGet(LED1_RED) == 1);
+
+    SIM_CHECK(ledCommit() == 1);
+    SIM_CHECK((P2->OUT & BIT0) != 0);
+    SIM_CHECK(ledBlink(LED0, 0, 0) == 1);
+    ledSetDeferred(0);
+}
+
+static void _testBounds(void)
+{
+    energy_report_t report;
+
+    _testStart();
+
+    /* Invalid LEDs and duties are ignored */
+    energyLedSet(-1, 1);
+    energyLedSet(ENERGY_NUM_LEDS, 1);
+    energyLedDuty(LED0, 101);
+    simAdvanceTicks(100);
+
+    SIM_CHECK(energyReport(&report) == 1);
+    SIM_CHECK(report.led_on_ticks[LED0] == 0 && report.led_charge_nC == 0);
+    SIM_CHECK(energyReport(0) == -1);
+
+    /* The accounting covers exactly the LEDs on pins */
+    SIM_CHECK(ENERGY_NUM_LEDS == LED_NUM_PINS && LED_CHAIN(0) == LED_NUM_PINS);
+}
+
+#endif //BENCH_HOST
@@ -0,0 +1,467 @@
+/**
+ @file    expander.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Buttons on I2C GPIO expanders, read in one interrupt-driven burst
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "expander.h"
+#include "button.h"
+#include "systime.h"
+
+
+/* SECTION 2: Private macros                                       */
+
+/**
+ @brief Number of entries in the @sa _expanderRefs array
+ @note This value is automatically calculated , do not edit
+*/
+#define NUM_EXPANDERS (sizeof(_expanderRefs) / sizeof(expander_ref_t))
+
+/**
+ @brief I2C peripheral and pins (P6.4 SDA, P6.5 SCL)
+*/
+#define EXPANDER_I2C       EUSCI_B1
+#define EXPANDER_I2C_INT   INT_EUSCIB1
+#define EXPANDER_I2C_PORT  P6
+#define EXPANDER_I2C_PINS  (BIT4 | BIT5)
+
+/**
+ @brief First input register of the expander, and number of input registers read
+*/
+#define EXPANDER_REG_INPUT  0x00
+#define EXPANDER_NUM_REGS   2
+
+/**
+ @brief Steps of a read transaction
+*/
+#define EXPANDER_PHASE_REGISTER  0 //Sending the register pointer
+#define EXPANDER_PHASE_RESTART   1 //Pointer sent, repeated start as a receiver
+#define EXPANDER_PHASE_READ      2 //Receiving the input registers
+#define EXPANDER_PHASE_STOP      3 //Waiting for the stop condition, the bus is then free
+
+/**
+@brief Private array of references for the expanders on the board
+*/
+static const expander_ref_t _expanderRefs [] = {
+     { .address = 0x20 ,                                     // A2 = A1 = A0 = 0
+       .int_mask = BIT6 , .port_is_odd = 0, .even = P4 ,     // INT on P4 .6
+       .use_pullup = 1 ,                                     // Internal pull -up
+       .int_num = INT_PORT4 , .int_priority = 2 ,            // Priority
+       .first_button = EXPANDER_FIRST_BUTTON ,               // All its inputs
+       .num_buttons = EXPANDER_NUM_BUTTONS
+     }
+};
+
+/**
+ @brief Compile-time check: the expander buttons must be virtual buttons
+*/
+typedef char _expanderButtonsCheck [(EXPANDER_FIRST_BUTTON + EXPANDER_NUM_BUTTONS <= BUTTON_VIRTUAL(BUTTON_NUM_VIRTUAL)) ? 1 : -1];
+
+
+/* SECTION 3: Private types                                        */
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+static uint16_t _expanderInputs [NUM_EXPANDERS];            /**< Last inputs reported          */
+static volatile uint32_t _expanderReads [NUM_EXPANDERS];
+static volatile uint32_t _expanderErrors [NUM_EXPANDERS];
+
+/**
+ @brief Holdoff after a change or a failed read: flag of each expander (one bit
+ each) and alarms
+*/
+static volatile uint8_t _expanderHeld = 0;
+static systime_alarm_t _expanderHoldoff [NUM_EXPANDERS];
+
+static uint8_t _expanderFailures [NUM_EXPANDERS];   /**< Failed reads in a row, for the retry backoff */
+
+/**
+ @brief Bus transaction: expanders waiting to be read (one bit each), expander
+ being read (-1 if the bus is idle), step and bytes received
+*/
+static volatile uint8_t _expanderPending = 0;
+static volatile int8_t _expanderCurrent = -1;
+static uint8_t _expanderPhase = 0;
+static uint8_t _expanderCount = 0;
+static int8_t _expanderChanged = 0;            /**< Result of the transaction, for _expanderEnd */
+static uint8_t _expanderData [EXPANDER_NUM_REGS];
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static void _expanderPortIsr(int port, uint8_t in, uint8_t flags, void *context); //Hook of the port ISR for the INT pins
+
+static void _expanderRequest(int which_expander); //Queue a read, started at once if the bus is idle
+
+static void _expanderNext(void); //Start the read of the next queued expander, if any
+
+static void _expanderEnd(int changed); //End of the current transaction (changed -1 if it failed), holdoff or retry scheduled
+
+static int _expanderIntActive(const expander_ref_t *ref); //1 if the INT line of an expander is low
+
+static void _expanderRelease(void *context); //Alarm callback at the end of a holdoff or of the wait before a retry
+
+void EUSCIB1_IRQHandler(void);
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+void expandersInit(void)
+{
+    const expander_ref_t *ref;
+    uint8_t port_mask [6] = {0};
+    uint8_t port_priority [6] = {7, 7, 7, 7, 7, 7};
+    uint8_t priority;
+    uint32_t n;
+    int i, k, port;
+
+    _expanderPending = 0;
+    _expanderCurrent = -1;
+    _expanderHeld = 0;
+
+    /* I2C master, 7-bit addresses */
+    EXPANDER_I2C->CTLW0 = EUSCI_B_CTLW0_SWRST;
+    EXPANDER_I2C->CTLW0 = EUSCI_B_CTLW0_SWRST | EUSCI_B_CTLW0_MODE_3 | EUSCI_B_CTLW0_MST
+                        | EUSCI_B_CTLW0_SYNC | EUSCI_B_CTLW0_SSEL__SMCLK;
+    n = (CS_getSMCLK() + EXPANDER_I2C_HZ - 1) / EXPANDER_I2C_HZ;
+    EXPANDER_I2C->BRW = n > 4 ? n : 4;
+    EXPANDER_I2C_PORT->SEL0 = EXPANDER_I2C_PORT->SEL0 | EXPANDER_I2C_PINS;
+    EXPANDER_I2C_PORT->SEL1 = EXPANDER_I2C_PORT->SEL1 & ~EXPANDER_I2C_PINS;
+    EXPANDER_I2C->CTLW0 = EXPANDER_I2C->CTLW0 & ~EUSCI_B_CTLW0_SWRST;
+    EXPANDER_I2C->IE = EUSCI_B_IE_TXIE0 | EUSCI_B_IE_RXIE0 | EUSCI_B_IE_NACKIE | EUSCI_B_IE_STPIE;
+
+    priority = 7;
+
+    for(i = 0; i < NUM_EXPANDERS; i++)
+    {
+        ref = &_expanderRefs[i];
+
+        /* INT: open drain, active low */
+        if(ref->port_is_odd)
+        {
+            ref->odd->DIR = ref->odd->DIR & ~ref->int_mask;
+            ref->odd->SEL0 = ref->odd->SEL0 & ~ref->int_mask;
+            ref->odd->SEL1 = ref->odd->SEL1 & ~ref->int_mask;
+            ref->odd->REN = (ref->odd->REN & ~ref->int_mask) | (ref->use_pullup ? ref->int_mask : 0);
+            ref->odd->OUT = ref->odd->OUT | (ref->use_pullup ? ref->int_mask : 0);
+            ref->odd->IES = ref->odd->IES | ref->int_mask;
+            ref->odd->IFG = ref->odd->IFG & ~ref->int_mask;
+            ref->odd->IE = ref->odd->IE | ref->int_mask;
+        }
+
+        else
+        {
+            ref->even->DIR = ref->even->DIR & ~ref->int_mask;
+            ref->even->SEL0 = ref->even->SEL0 & ~ref->int_mask;
+            ref->even->SEL1 = ref->even->SEL1 & ~ref->int_mask;
+            ref->even->REN = (ref->even->REN & ~ref->int_mask) | (ref->use_pullup ? ref->int_mask : 0);
+            ref->even->OUT = ref->even->OUT | (ref->use_pullup ? ref->int_mask : 0);
+            ref->even->IES = ref->even->IES | ref->int_mask;
+            ref->even->IFG = ref->even->IFG & ~ref->int_mask;
+            ref->even->IE = ref->even->IE | ref->int_mask;
+        }
+
+        /* Starts from the buttons as they are (kept across a warm reset) */
+        _expanderInputs[i] = 0xFFFF;
+        for(k = 0; k < ref->num_buttons; k++)
+        {
+            if(buttonState(ref->first_button + k) == 1)
+                _expanderInputs[i] = _expanderInputs[i] & ~(1 << k);
+        }
+
+        _expanderReads[i] = 0;
+        _expanderErrors[i] = 0;
+        _expanderFailures[i] = 0;
+
+        port = ref->int_num - INT_PORT1;
+        port_mask[port] = port_mask[port] | ref->int_mask;
+        if(ref->int_priority < port_priority[port])
+            port_priority[port] = ref->int_priority;
+        if(ref->int_priority < priority)
+            priority = ref->int_priority;
+    }
+
+    /* As urgent as the most urgent INT pin */
+    Interrupt_setPriority(EXPANDER_I2C_INT, priority << 5);
+    Interrupt_enableInterrupt(EXPANDER_I2C_INT);
+
+    for(port = 0; port < 6; port++)
+    {
+        if(port_mask[port] != 0 && buttonPinHook(port + 1, port_mask[port], port_priority[port], _expanderPortIsr, 0) < 0)
+            port_mask[port] = 0;
+    }
+
+    /* INT pins of a button, or on a port hooked by another module: left without interrupts */
+    for(i = 0; i < NUM_EXPANDERS; i++)
+    {
+        ref = &_expanderRefs[i];
+
+        if(port_mask[ref->int_num - INT_PORT1] != 0)
+            continue;
+
+        if(ref->port_is_odd)
+            ref->odd->IE = ref->odd->IE & ~ref->int_mask;
+
+        else
+            ref->even->IE = ref->even->IE & ~ref->int_mask;
+    }
+
+    /* The inputs may have changed before the INT edges were enabled */
+    for(i = 0; i < NUM_EXPANDERS; i++)
+        expanderUpdate(i);
+}
+
+int expandersGetNum(void)
+{
+    return NUM_EXPANDERS;
+}
+
+int expanderUpdate(int which_expander)
+{
+    bool state;
+
+    if(which_expander < 0 || which_expander > NUM_EXPANDERS-1)
+        return -1;
+
+    CRITICAL_ENTER(state);
+    _expanderRequest(which_expander);
+    CRITICAL_EXIT(state);
+
+    return 1;
+}
+
+int expanderProcess(int which_expander, uint16_t inputs)
+{
+    const expander_ref_t *ref;
+    uint16_t changed;
+    int k, num;
+
+    if(which_expander < 0 || which_expander > NUM_EXPANDERS-1)
+        return -1;
+
+    ref = &_expanderRefs[which_expander];
+    changed = (inputs ^ _expanderInputs[which_expander]) & (uint16_t)((1UL << ref->num_buttons) - 1);
+    _expanderInputs[which_expander] = inputs;
+
+    num = 0;
+    for(k = 0; k < ref->num_buttons; k++)
+    {
+        if(changed & (1 << k))
+        {
+            buttonReportState(ref->first_button + k, (inputs & (1 << k)) == 0);
+            num++;
+        }
+    }
+
+    return num;
+}
+
+uint32_t expanderReads(int which_expander)
+{
+    if(which_expander < 0 || which_expander > NUM_EXPANDERS-1)
+        return 0;
+
+    return _expanderReads[which_expander];
+}
+
+uint32_t expanderErrors(int which_expander)
+{
+    if(which_expander < 0 || which_expander > NUM_EXPANDERS-1)
+        return 0;
+
+    return _expanderErrors[which_expander];
+}
+
+void EUSCIB1_IRQHandler(void)
+{
+    uint16_t flags;
+
+    flags = EXPANDER_I2C->IFG & EXPANDER_I2C->IE;
+
+    if(_expanderCurrent < 0)
+    {
+        EXPANDER_I2C->IFG = EXPANDER_I2C->IFG & ~flags;
+        return;
+    }
+
+    /* No acknowledge of the address: stop, _expanderEnd schedules a retry */
+    if(flags & EUSCI_B_IFG_NACKIFG)
+    {
+        EXPANDER_I2C->IFG = EXPANDER_I2C->IFG & ~(EUSCI_B_IFG_NACKIFG | EUSCI_B_IFG_TXIFG0);
+        EXPANDER_I2C->CTLW0 = EXPANDER_I2C->CTLW0 | EUSCI_B_CTLW0_TXSTP;
+        _expanderErrors[_expanderCurrent]++;
+        _expanderChanged = -1;
+        _expanderPhase = EXPANDER_PHASE_STOP;
+    }
+
+    else if(flags & EUSCI_B_IFG_TXIFG0)
+    {
+        if(_expanderPhase == EXPANDER_PHASE_REGISTER)
+        {
+            EXPANDER_I2C->TXBUF = EXPANDER_REG_INPUT;
+            _expanderPhase = EXPANDER_PHASE_RESTART;
+        }
+
+        else
+        {
+            /* The pointer is in the shift register: turn around after it */
+            EXPANDER_I2C->IFG = EXPANDER_I2C->IFG & ~EUSCI_B_IFG_TXIFG0;
+            EXPANDER_I2C->CTLW0 = (EXPANDER_I2C->CTLW0 & ~EUSCI_B_CTLW0_TR) | EUSCI_B_CTLW0_TXSTT;
+            _expanderPhase = EXPANDER_PHASE_READ;
+        }
+    }
+
+    if(flags & EUSCI_B_IFG_RXIFG0)
+    {
+        /* The stop follows the byte being received when the one before is read */
+        if(_expanderCount == EXPANDER_NUM_REGS - 2)
+            EXPANDER_I2C->CTLW0 = EXPANDER_I2C->CTLW0 | EUSCI_B_CTLW0_TXSTP;
+
+        _expanderData[_expanderCount] = EXPANDER_I2C->RXBUF;
+        _expanderCount++;
+
+        if(_expanderCount == EXPANDER_NUM_REGS)
+        {
+            _expanderReads[_expanderCurrent]++;
+            _expanderChanged = expanderProcess(_expanderCurrent, _expanderData[0] | (_expanderData[1] << 8));
+            _expanderPhase = EXPANDER_PHASE_STOP;
+        }
+    }
+
+    /* The next read starts once the bus is released */
+    if(flags & EUSCI_B_IFG_STPIFG)
+    {
+        EXPANDER_I2C->IFG = EXPANDER_I2C->IFG & ~EUSCI_B_IFG_STPIFG;
+        if(_expanderPhase == EXPANDER_PHASE_STOP)
+            _expanderEnd(_expanderChanged);
+    }
+}
+
+static void _expanderPortIsr(int port, uint8_t in, uint8_t flags, void *context)
+{
+    const expander_ref_t *ref;
+    int i;
+    bool state;
+
+    /* The port may preempt the bus interrupt, if more urgent for its other pins */
+    CRITICAL_ENTER(state);
+
+    for(i = 0; i < NUM_EXPANDERS; i++)
+    {
+        ref = &_expanderRefs[i];
+        if(ref->int_num - INT_PORT1 + 1 == port && (flags & ref->int_mask) != 0)
+            _expanderRequest(i);
+    }
+
+    CRITICAL_EXIT(state);
+}
+
+static void _expanderRequest(int which_expander)
+{
+    /* Edges during a holdoff are read at its end */
+    if(_expanderHeld & (1 << which_expander))
+        return;
+
+    _expanderPending = _expanderPending | (1 << which_expander);
+
+    if(_expanderCurrent < 0)
+        _expanderNext();
+}
+
+static void _expanderNext(void)
+{
+    int i;
+
+    for(i = 0; i < NUM_EXPANDERS; i++)
+    {
+        if(_expanderPending & (1 << i))
+            break;
+    }
+
+    if(i == NUM_EXPANDERS)
+    {
+        _expanderCurrent = -1;
+        return;
+    }
+
+    _expanderPending = _expanderPending & ~(1 << i);
+    _expanderCurrent = i;
+    _expanderPhase = EXPANDER_PHASE_REGISTER;
+    _expanderCount = 0;
+
+    /* Start as a transmitter, TXIFG0 asks for the register pointer */
+    EXPANDER_I2C->I2CSA = _expanderRefs[i].address;
+    EXPANDER_I2C->CTLW0 = EXPANDER_I2C->CTLW0 | EUSCI_B_CTLW0_TR | EUSCI_B_CTLW0_TXSTT;
+}
+
+static void _expanderEnd(int changed)
+{
+    int which = _expanderCurrent;
+    uint32_t wait_ms;
+
+    _expanderCurrent = -1;
+
+    if(changed >= 0)
+        _expanderFailures[which] = 0;
+
+    if(changed > 0)
+    {
+        _expanderHeld = _expanderHeld | (1 << which);
+        systimeAlarmStart(&_expanderHoldoff[which], systimeNow() + systimeMsToTicks(EXPANDER_HOLDOFF_MS),
+                          _expanderRelease, (void *)(uintptr_t)which);
+    }
+
+    /* Not read and INT stays low until it is: no edge will come, try again later */
+    else if(changed < 0 && _expanderIntActive(&_expanderRefs[which]))
+    {
+        wait_ms = EXPANDER_RETRY_MS << _expanderFailures[which];
+        if(wait_ms < EXPANDER_RETRY_MAX_MS)
+            _expanderFailures[which]++;
+        else
+            wait_ms = EXPANDER_RETRY_MAX_MS;
+
+        _expanderHeld = _expanderHeld | (1 << which);
+        systimeAlarmStart(&_expanderHoldoff[which], systimeNow() + systimeMsToTicks(wait_ms),
+                          _expanderRelease, (void *)(uintptr_t)which);
+    }
+
+    /* INT still low: an input changed again during the read, its edge came too early */
+    else if(changed == 0 && _expanderIntActive(&_expanderRefs[which]))
+        _expanderPending = _expanderPending | (1 << which);
+
+    _expanderNext();
+}
+
+static int _expanderIntActive(const expander_ref_t *ref)
+{
+    if(ref->port_is_odd)
+        return (ref->odd->IN & ref->int_mask) == 0;
+
+    return (ref->even->IN & ref->int_mask) == 0;
+}
+
+static void _expanderRelease(void *context)
+{
+    int which = (int)(uintptr_t)context;
+    bool state;
+
+    CRITICAL_ENTER(state);
+    _expanderHeld = _expanderHeld & ~(1 << which);
+    _expanderRequest(which);
+    CRITICAL_EXIT(state);
+}
@@ -0,0 +1,93 @@
+/**
+ @file    expander.h
+
+ @brief   Buttons on I2C GPIO expanders, read in one interrupt-driven burst
+
+ The expanders are 16-bit I2C input/output expanders (TCA9555, PCA9555 and
+ compatible) on eUSCI_B1 (P6.4 SDA, P6.5 SCL). Their open-drain INT line is a
+ port pin handed to this module by the port ISR of the button module (see
+ buttonPinHook): its falling edge starts a read of both input registers in a
+ single transaction (register pointer, repeated start, two bytes), driven by
+ the eUSCI_B1 interrupt so that nothing waits for the bus. The inputs that
+ changed are reported as virtual buttons of the button module, so they have
+ the same state, press latch, events and bindings as the other buttons.
+
+ Reading the registers releases INT. After a read that found a change, the
+ edges of the expander are ignored for EXPANDER_HOLDOFF_MS, then the inputs
+ are read again: contact bounces produce at most one more read. A read that
+ is not acknowledged leaves INT low, so no new edge would come: while INT
+ stays low, the read is tried again after EXPANDER_RETRY_MS, with the wait
+ doubled at each new failure (a glitch on the bus, the expander being reset
+ or unplugged).
+
+ Several expanders share the bus, their reads are queued. The decoding of a
+ read is @ref expanderProcess, and the bus is only seen through the eUSCI_B1
+ registers and interrupt, so both can be exercised on the host against a
+ simulated expander.
+
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+*/
+
+// Do not write above this line (except comments)!
+#ifndef EXPANDER_H
+#define EXPANDER_H
+
+/* SECTION 1: Included header files required to compile this file  */
+#include <stdint.h>
+#include "button.h"
+
+
+/* SECTION 2: Public macros                                        */
+
+#define EXPANDER0 0
+
+/**
+ @brief Virtual buttons reported by the inputs of EXPANDER0, after the touch pads
+*/
+#define EXPANDER_FIRST_BUTTON  BUTTON_VIRTUAL(6)
+#define EXPANDER_NUM_BUTTONS   16
+
+/**
+ @brief Time after a change during which the INT edges are ignored, in milliseconds
+*/
+#define EXPANDER_HOLDOFF_MS  10
+
+/**
+ @brief Wait before reading again an expander whose INT is still low after a
+ failed read, in milliseconds: doubled at each new failure, up to the maximum
+*/
+#define EXPANDER_RETRY_MS      2
+#define EXPANDER_RETRY_MAX_MS  256
+
+/**
+ @brief Clock of the I2C bus
+*/
+#define EXPANDER_I2C_HZ      400000
+
+
+/* SECTION 3: Public types                                         */
+
+
+/* SECTION 4: Public variables :: declarations, extern mandatory   */
+
+
+/* SECTION 5: Public functions :: declarations, extern optional
+   Rule exception (callbacks)  :: declarations, extern recommended */
+
+void expandersInit(void); //Initialization function, reads every expander once (call after buttonsInit)
+
+int expandersGetNum(void); //Get the number of expanders
+
+int expanderUpdate(int which_expander); //Request a read of the inputs, without waiting for it
+
+int expanderProcess(int which_expander, uint16_t inputs); //Decode the input registers (port 1 in the high byte) and report the changes, returns how many buttons changed
+
+uint32_t expanderReads(int which_expander); //Number of completed reads (0 if invalid)
+
+uint32_t expanderErrors(int which_expander); //Number of reads not acknowledged by the expander (0 if invalid)
+
+
+#endif //EXPANDER_H
+// Do not write below this line!
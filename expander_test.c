@@ -0,0 +1,388 @@
+/**
+ @file    expander_test.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Host test of the buttons on I2C GPIO expanders
+
+ Built by host/Makefile. A TCA9555 is modeled on the registers of eUSCI_B1,
+ one bus step (about a byte at 400 kHz) every TEST_STEP_US: it acknowledges
+ its address, or not when the test injects a failure, takes the register
+ pointer, sends its two input registers and keeps its INT line (P4.6) low
+ while the inputs differ from the ones last read. The test checks the reads
+ and the holdoff, and that a read not acknowledged is tried again, with a
+ growing wait, for as long as INT stays low.
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "expander.h"
+#include "button.h"
+#include "defer.h"
+#include "persist.h"
+#include "systime.h"
+#include "sim.h"
+
+/* The whole file belongs to the host build (see host/Makefile) */
+#ifdef BENCH_HOST
+
+
+/* SECTION 2: Private macros                                       */
+
+#define TEST_ADDRESS     0x20      //Expander 0 (see expander.c)
+#define TEST_FIRST       EXPANDER_FIRST_BUTTON  //Button of its input 0
+#define TEST_STEP_US     25        //Bus step of the model
+#define TEST_MAX_TRIES   32        //Address phases recorded
+
+/**
+ @brief Bus phases of the model
+*/
+#define TEST_BUS_IDLE    0
+#define TEST_BUS_WRITE   1         //Addressed as a receiver of the pointer
+#define TEST_BUS_READ    2         //Addressed as a transmitter of the inputs
+
+
+/* SECTION 3: Private types                                        */
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+static uint16_t _testInputs = 0xFFFF;   /**< Levels of the inputs (1 released, pull-ups) */
+static uint16_t _testLatched = 0xFFFF;  /**< Inputs last read: INT is low while they differ */
+static int _testNacks = 0;              /**< Address phases not to acknowledge */
+static int _testPresent = 1;            /**< Flag (0/1): the expander answers at all */
+
+static int _testBus = TEST_BUS_IDLE;
+static int _testPointer = -1;           /**< Register pointer written */
+static int _testSent = 0;               /**< Bytes sent in the current read */
+static int _testBadPointer = 0;         /**< Reads from another register than the inputs */
+
+static uint64_t _testTries [TEST_MAX_TRIES];  /**< Time of each address phase, in ns */
+static int _testNumTries = 0;
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static void _testStart(void); //Reset the simulation and the modules, the expander idle and answering
+
+static void _testInt(void); //Drive INT from the inputs
+
+static void _testSet(int input, int pressed); //Change an input of the expander
+
+static void _testStep(void); //One step of the bus
+
+static void _testRun(uint32_t us); //Let the time and the bus run
+
+static int _testPressed(void); //Expander button pressed (0..15), -1 if none, -2 if several
+
+static uint32_t _testGapMs(int try); //Time between an address phase and the one before, in ms
+
+static void _testReads(void);
+
+static void _testGlitch(void);
+
+static void _testBackoff(void);
+
+static void _testReleased(void);
+
+static void _testAbsent(void);
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+int main(void)
+{
+    _testReads();
+    _testGlitch();
+    _testBackoff();
+    _testReleased();
+    _testAbsent();
+
+    return simReport("expander_test");
+}
+
+static void _testStart(void)
+{
+    _testInputs = 0xFFFF;
+    _testLatched = 0xFFFF;
+    _testNacks = 0;
+    _testPresent = 1;
+    _testBus = TEST_BUS_IDLE;
+    _testPointer = -1;
+    _testBadPointer = 0;
+    _testNumTries = 0;
+
+    persistInvalidate();
+    simReset();
+    deferInit();
+    systimeInit();
+    buttonsInit();
+    expandersInit();
+    Interrupt_enableMaster();
+
+    /* The read of the initialization */
+    _testRun(1000);
+}
+
+static void _testInt(void)
+{
+    simPinSet(4, BIT6, _testInputs == _testLatched);
+}
+
+static void _testSet(int input, int pressed)
+{
+    if(pressed)
+        _testInputs = _testInputs & ~(1 << input);
+    else
+        _testInputs = _testInputs | (1 << input);
+
+    _testInt();
+}
+
+static void _testStep(void)
+{
+    EUSCI_B_Type *bus = EUSCI_B1;
+    int ack;
+
+    /* Sending the inputs, port 0 first; the stop follows the byte that was being received */
+    if(_testBus == TEST_BUS_READ)
+    {
+        simEusciReceive(1, (_testSent == 0) ? (_testInputs & 0xFF) : (_testInputs >> 8));
+        _testSent++;
+
+        if(_testSent == 2)
+        {
+            _testLatched = _testInputs;
+            _testInt();
+        }
+
+        if((bus->CTLW0 & EUSCI_B_CTLW0_TXSTP) && _testSent >= 2)
+        {
+            bus->CTLW0 = bus->CTLW0 & ~EUSCI_B_CTLW0_TXSTP;
+            _testBus = TEST_BUS_IDLE;
+            bus->IFG = bus->IFG | EUSCI_B_IFG_STPIFG;
+            simServe();
+        }
+        return;
+    }
+
+    /* Stop after a failure */
+    if(bus->CTLW0 & EUSCI_B_CTLW0_TXSTP)
+    {
+        bus->CTLW0 = bus->CTLW0 & ~EUSCI_B_CTLW0_TXSTP;
+        _testBus = TEST_BUS_IDLE;
+        bus->IFG = bus->IFG | EUSCI_B_IFG_STPIFG;
+        simServe();
+        return;
+    }
+
+    if((bus->CTLW0 & EUSCI_B_CTLW0_TXSTT) == 0)
+        return;
+
+    /* Address phase, first or repeated start */
+    bus->CTLW0 = bus->CTLW0 & ~EUSCI_B_CTLW0_TXSTT;
+
+    if(bus->CTLW0 & EUSCI_B_CTLW0_TR)
+    {
+        if(_testNumTries < TEST_MAX_TRIES)
+            _testTries[_testNumTries] = simNowNs();
+        _testNumTries++;
+    }
+
+    ack = _testPresent && bus->I2CSA == TEST_ADDRESS;
+    if(ack && _testNacks > 0 && (bus->CTLW0 & EUSCI_B_CTLW0_TR))
+    {
+        _testNacks--;
+        ack = 0;
+    }
+
+    if(!ack)
+    {
+        _testBus = TEST_BUS_IDLE;
+        bus->IFG = bus->IFG | EUSCI_B_IFG_NACKIFG;
+        simServe();
+        return;
+    }
+
+    if(bus->CTLW0 & EUSCI_B_CTLW0_TR)
+    {
+        /* The pointer written to TXBUF, then TXIFG0 again as it is shifted out */
+        _testBus = TEST_BUS_WRITE;
+        bus->TXBUF = 0xFFFF;
+        bus->IFG = bus->IFG | EUSCI_B_IFG_TXIFG0;
+        simServe();
+        _testPointer = bus->TXBUF;
+    }
+
+    else
+    {
+        if(_testBus != TEST_BUS_WRITE || _testPointer != 0)
+            _testBadPointer++;
+
+        _testBus = TEST_BUS_READ;
+        _testSent = 0;
+    }
+}
+
+static void _testRun(uint32_t us)
+{
+    uint32_t t;
+
+    for(t = 0; t < us; t = t + TEST_STEP_US)
+    {
+        simAdvanceUs(TEST_STEP_US);
+        _testStep();
+    }
+}
+
+static int _testPressed(void)
+{
+    int k, pressed = -1;
+
+    for(k = 0; k < 16; k++)
+    {
+        if(buttonState(TEST_FIRST + k) == 1)
+            pressed = (pressed == -1) ? k : -2;
+    }
+
+    return pressed;
+}
+
+static uint32_t _testGapMs(int try)
+{
+    return (uint32_t)((_testTries[try] - _testTries[try - 1]) / 1000000);
+}
+
+static void _testReads(void)
+{
+    _testStart();
+    SIM_CHECK(expanderReads(EXPANDER0) == 1 && expanderErrors(EXPANDER0) == 0);
+    SIM_CHECK(_testPressed() == -1 && (P4->IN & BIT6) != 0);
+
+    /* The INT edge starts a read, which releases INT */
+    _testSet(3, 1);
+    SIM_CHECK((P4->IN & BIT6) == 0);
+    _testRun(500);
+    SIM_CHECK(expanderReads(EXPANDER0) == 2 && _testPressed() == 3);
+    SIM_CHECK((P4->IN & BIT6) != 0);
+
+    /* A bounce during the holdoff is read at its end, in one more read */
+    _testRun(1000);
+    _testSet(3, 0);
+    _testSet(3, 1);
+    _testSet(3, 0);
+    _testRun(3000);
+    SIM_CHECK(expanderReads(EXPANDER0) == 2 && _testPressed() == 3);
+    _testRun(EXPANDER_HOLDOFF_MS * 1000);
+    SIM_CHECK(expanderReads(EXPANDER0) == 3 && _testPressed() == -1);
+
+    /* Two inputs of the other port register */
+    _testRun(EXPANDER_HOLDOFF_MS * 1000);
+    _testSet(12, 1);
+    _testRun(500);
+    SIM_CHECK(_testPressed() == 12 && buttonPressed(TEST_FIRST + 12) == 1);
+
+    SIM_CHECK(_testBadPointer == 0 && expanderErrors(EXPANDER0) == 0);
+}
+
+static void _testGlitch(void)
+{
+    _testStart();
+
+    /* One read lost on the bus: INT stays low, no edge comes, the read is tried again */
+    _testNacks = 1;
+    _testNumTries = 0;
+    _testSet(5, 1);
+    _testRun(1000);
+    SIM_CHECK(expanderErrors(EXPANDER0) == 1 && _testPressed() == -1);
+    SIM_CHECK((P4->IN & BIT6) == 0);
+
+    _testRun(EXPANDER_RETRY_MS * 1000);
+    SIM_CHECK(_testPressed() == 5 && (P4->IN & BIT6) != 0);
+    SIM_CHECK(_testNumTries == 2 && _testGapMs(1) >= EXPANDER_RETRY_MS && _testGapMs(1) <= EXPANDER_RETRY_MS + 1);
+    SIM_CHECK(_testBadPointer == 0);
+}
+
+static void _testBackoff(void)
+{
+    uint32_t wait;
+    int i;
+
+    _testStart();
+
+    /* Six failures in a row: the wait doubles each time */
+    _testNacks = 6;
+    _testNumTries = 0;
+    _testSet(7, 1);
+    _testRun(200000);
+    SIM_CHECK(expanderErrors(EXPANDER0) == 6 && _testPressed() == 7);
+    /* Seven to read it, one more at the end of the holdoff */
+    SIM_CHECK(_testNumTries == 8);
+
+    wait = EXPANDER_RETRY_MS;
+    for(i = 1; i < 7 && i < _testNumTries; i++)
+    {
+        SIM_CHECK(_testGapMs(i) >= wait && _testGapMs(i) <= wait + 1);
+        printf("expander,retry,%d,%u ms\n", i, (unsigned)_testGapMs(i));
+        wait = wait * 2;
+    }
+
+    /* A read that succeeds starts the backoff again */
+    _testRun(EXPANDER_HOLDOFF_MS * 1000);
+    _testNacks = 1;
+    _testNumTries = 0;
+    _testSet(7, 0);
+    _testRun(EXPANDER_RETRY_MS * 1000 + 1000);
+    SIM_CHECK(_testNumTries == 2 && _testGapMs(1) <= EXPANDER_RETRY_MS + 1);
+    SIM_CHECK(_testPressed() == -1);
+}
+
+static void _testReleased(void)
+{
+    _testStart();
+
+    /* INT released before the failed read ends (the input came back): nothing to retry */
+    _testNacks = 1;
+    _testNumTries = 0;
+    _testSet(9, 1);
+    _testSet(9, 0);
+    _testRun(100000);
+    SIM_CHECK(expanderErrors(EXPANDER0) == 1 && _testNumTries == 1);
+    SIM_CHECK(_testPressed() == -1);
+
+    /* The next edge is read as usual */
+    _testSet(9, 1);
+    _testRun(1000);
+    SIM_CHECK(_testPressed() == 9 && _testNumTries == 2);
+}
+
+static void _testAbsent(void)
+{
+    _testStart();
+
+    /* Unplugged with INT held low: tried again at most every EXPANDER_RETRY_MAX_MS */
+    _testPresent = 0;
+    _testNumTries = 0;
+    _testSet(0, 1);
+    _testRun(2000000);
+    SIM_CHECK(_testNumTries >= 8 && _testNumTries <= 8 + (2000 - 510) / EXPANDER_RETRY_MAX_MS + 1);
+    SIM_CHECK(_testGapMs(_testNumTries - 1) >= EXPANDER_RETRY_MAX_MS && _testGapMs(_testNumTries - 1) <= EXPANDER_RETRY_MAX_MS + 1);
+    printf("expander,absent,%d tries in 2 s\n", _testNumTries);
+
+    /* Plugged back: read at the next try */
+    _testPresent = 1;
+    _testRun(EXPANDER_RETRY_MAX_MS * 1000 + 1000);
+    SIM_CHECK(_testPressed() == 0);
+}
+
+#endif //BENCH_HOST
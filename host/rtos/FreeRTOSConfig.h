@@ -0,0 +1,91 @@
+/**
+ @file    FreeRTOSConfig.h
+
+ @brief   Kernel configuration of the host RTOS build (POSIX port), see rtos.h
+
+ Used by "make -C host rtos" only. It meets the requirements of rtos.h but the
+ idle hook, with the loosest interrupt ceiling allowed there (2 << 5), so that
+ rtos_test.c checks that no driver ISR is more urgent. The POSIX port runs each
+ task in a thread whose stack is the task's: the stacks are raised to
+ PTHREAD_STACK_MIN at least. Its only interrupt is the tick (a signal), whose
+ hook injects the edges of rtos_test.c.
+
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+*/
+
+// Do not write above this line (except comments)!
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+/* SECTION 1: Included header files required to compile this file  */
+#include <assert.h>
+#include <stdint.h>
+
+
+/* SECTION 2: Public macros                                        */
+
+#define configUSE_PREEMPTION                     1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION  0
+#define configUSE_IDLE_HOOK                      0   //The simulated sleep is not thread safe
+#define configUSE_TICK_HOOK                      1   //Edges of rtos_test.c, in interrupt context
+#define configTICK_RATE_HZ                       1000
+#define configMAX_PRIORITIES                     5
+#define configMAX_TASK_NAME_LEN                  12
+#define configIDLE_SHOULD_YIELD                  1
+#define configUSE_TASK_NOTIFICATIONS             1
+#define configUSE_MUTEXES                        0
+#define configQUEUE_REGISTRY_SIZE                0
+#define configUSE_TIMERS                         0
+#define configCHECK_FOR_STACK_OVERFLOW           0
+#define configUSE_TRACE_FACILITY                 0
+
+#ifdef TICK_TYPE_WIDTH_32_BITS
+#define configTICK_TYPE_WIDTH_IN_BITS            TICK_TYPE_WIDTH_32_BITS
+#else
+#define configUSE_16_BIT_TICKS                   0
+#endif
+
+/**
+ @brief Every object of rtos.c is static
+*/
+#define configSUPPORT_STATIC_ALLOCATION          1
+#define configSUPPORT_DYNAMIC_ALLOCATION         0
+#define configSTACK_DEPTH_TYPE                   uint32_t
+
+/**
+ @brief Stacks in words of StackType_t (8 bytes on a 64-bit host)
+*/
+#define configMINIMAL_STACK_SIZE                 4096
+#define RTOS_DEFER_STACK_WORDS                   4096
+#define RTOS_APP_STACK_WORDS                     4096
+
+/**
+ @brief Interrupt ceiling: not used by the POSIX port, checked by the drivers (see rtos.h)
+*/
+#define configKERNEL_INTERRUPT_PRIORITY          (7 << 5)
+#define configMAX_SYSCALL_INTERRUPT_PRIORITY     (2 << 5)
+
+#define INCLUDE_vTaskDelay                       1
+#define INCLUDE_xTaskGetSchedulerState           1
+#define INCLUDE_xTaskGetCurrentTaskHandle        1
+#define INCLUDE_xTaskGetIdleTaskHandle           1
+
+/**
+ @brief The ISRs run in the tick handler, which switches the task at its end when
+ they woke a more urgent one (the FromISR functions mark the yield as pending):
+ switching from within the handler would suspend its thread in the signal
+*/
+#define RTOS_YIELD_FROM_ISR(woken)               ((void)(woken))
+
+/**
+ @brief Latency bound of rtos.h for a thread switch of the host, below one tick
+*/
+#define RTOS_LATENCY_BOUND_US                    1000
+
+#define configASSERT(x)                          assert(x)
+
+
+#endif //FREERTOS_CONFIG_H
+// Do not write below this line!
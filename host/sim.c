@@ -0,0 +1,1159 @@
+/**
+ @file    sim.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Simulated msp432p401r for the host build: clock, interrupts, ports and DMA
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include <ti/devices/msp432p4xx/driverlib/driverlib.h>
+#include "sim.h"
+
+/* The whole file belongs to the host build (see host/Makefile) */
+#ifdef BENCH_HOST
+
+#include <string.h>
+
+
+/* SECTION 2: Private macros                                       */
+
+/**
+ @brief Priority (upper 3 bits of the NVIC byte) of the code running outside handlers
+*/
+#define SIM_THREAD_PRIORITY  8
+
+#define SIM_DMA_CHANNELS     8
+
+/**
+ @brief Fields of the DMA control word: element size, increments and arbitration
+*/
+#define SIM_DMA_SIZE(ctl)     (1u << (((ctl) >> 28) & 0x3))
+#define SIM_DMA_SRC_INC(ctl)  ((((ctl) >> 26) & 0x3) == 3 ? 0 : 1u << (((ctl) >> 26) & 0x3))
+#define SIM_DMA_DST_INC(ctl)  ((((ctl) >> 30) & 0x3) == 3 ? 0 : 1u << (((ctl) >> 30) & 0x3))
+#define SIM_DMA_ARB(ctl)      (1u << (((ctl) >> 14) & 0xF))
+
+#define SIM_MAX_SINKS         4
+
+
+/* SECTION 3: Private types                                        */
+
+/**
+ @brief Primary or alternate structure of a DMA channel
+*/
+struct sim_dma_struct_s {
+   uint32_t control;    /**< Size, increments and arbitration    */
+   uint32_t mode;       /**< UDMA_MODE_x, STOP once completed    */
+   uint8_t *src;        /**< Next element read                   */
+   uint8_t *dst;        /**< Next element written                */
+   uint32_t remaining;  /**< Elements left                       */
+};
+
+/**
+ @brief Short alias "sim_dma_struct_t" for the data type "struct sim_dma_struct_s"
+*/
+typedef struct sim_dma_struct_s sim_dma_struct_t;
+
+/**
+ @brief DMA channel
+*/
+struct sim_dma_channel_s {
+   sim_dma_struct_t structs[2];  /**< Primary and alternate         */
+   uint8_t alternate;            /**< Structure in use (0/1)        */
+   uint8_t enabled;              /**< Flag (0/1)                    */
+};
+
+/**
+ @brief Short alias "sim_dma_channel_t" for the data type "struct sim_dma_channel_s"
+*/
+typedef struct sim_dma_channel_s sim_dma_channel_t;
+
+/**
+ @brief Register written by a DMA channel and its observer
+*/
+struct sim_sink_entry_s {
+   const volatile void *reg;
+   sim_sink_t sink;
+};
+
+/**
+ @brief Short alias "sim_sink_entry_t" for the data type "struct sim_sink_entry_s"
+*/
+typedef struct sim_sink_entry_s sim_sink_entry_t;
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+DIO_PORT_Odd_Interruptable_Type simP1, simP2, simP3, simP4, simP5, simP6, simP7;
+PMAP_COMMON_Type simPmap;
+PMAP_REGISTER_Type simP2map, simP3map, simP7map;
+Timer_A_Type simTa0, simTa1, simTa2, simTa3;
+Timer32_Type simT32;
+CS_Type simCs;
+SYSCTL_Type simSysctl;
+RSTCTL_Type simRstctl;
+ADC14_Type simAdc14;
+CAPTIO_Type simCaptio0, simCaptio1;
+EUSCI_A_Type simEusciA0;
+EUSCI_B_Type simEusciB0, simEusciB1, simEusciB2, simEusciB3;
+SCB_Type simScb;
+DWT_Type simDwt;
+CoreDebug_Type simCoreDebug;
+
+uint32_t SystemCoreClock = 12000000;
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+static uint64_t _simTicks = 0;        /**< ACLK ticks since the reset                              */
+static uint64_t _simPhase = 0;        /**< Time into the current tick, in cycles * SIM_ACLK_HZ     */
+static uint32_t _simPrescale [4];     /**< ACLK ticks counted towards the divider of each Timer_A  */
+static uint32_t _simT32Left = 0;      /**< Cycles to the next expiry of Timer32 1, 0 if stopped    */
+
+static uint8_t _simEnabled [NUM_INTERRUPTS];
+static uint8_t _simPriority [NUM_INTERRUPTS];   /**< NVIC priority byte                  */
+static uint8_t _simPended [NUM_INTERRUPTS];     /**< Pended by software                  */
+static uint32_t _simCount [NUM_INTERRUPTS];     /**< Handler runs                        */
+static uint32_t _simPrimask = 0;
+static uint32_t _simBasepri = 0;
+static int _simActive = SIM_THREAD_PRIORITY;     /**< Priority of the running code        */
+static uint32_t _simStalls = 0;
+
+static sim_dma_channel_t _simDma [SIM_DMA_CHANNELS];
+static uint32_t _simDmaStatus = 0;               /**< Completions not acknowledged yet    */
+static sim_sink_entry_t _simSinks [SIM_MAX_SINKS];
+
+static uint16_t _simRx [5];                      /**< Last byte received by eUSCI_A0, B0 to B3 */
+
+static int _simChecks = 0;
+static int _simFailures = 0;
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static void _simTick(void); //One ACLK tick: count the timers clocked from ACLK
+
+static void _simTimerTick(Timer_A_Type *timer, uint32_t *prescale); //Count a Timer_A by one ACLK tick
+
+static uint32_t _simTimerLeft(Timer_A_Type *timer, uint32_t *prescale); //Cycles until a Timer_A clocked from SMCLK sets a flag (TACLR applied first), 0 if not counting
+
+static void _simTimerCount(Timer_A_Type *timer, uint32_t *prescale, uint32_t cycles); //Count a Timer_A clocked from SMCLK, never past its next flag
+
+static void _simCapture(int port, uint8_t rising, uint8_t falling); //Edges of the CCIxA pins of TIMER_A2: capture the counter
+
+static uint16_t _simTimerIv(Timer_A_Type *timer); //Read TAxIV: highest priority enabled flag, cleared
+
+static uint16_t _simTa0Iv(void);
+static uint16_t _simTa1Iv(void);
+static uint16_t _simTa2Iv(void);
+static uint16_t _simTa3Iv(void);
+
+static uint16_t _simEusciA0Rx(void); //RXBUF reads: the byte received, RXIFG cleared
+static uint16_t _simEusciB0Rx(void);
+static uint16_t _simEusciB1Rx(void);
+static uint16_t _simEusciB2Rx(void);
+static uint16_t _simEusciB3Rx(void);
+
+static int _simRaised(int int_num); //Interrupt request of a source, as seen by the NVIC
+
+static int _simNext(int ignore_primask); //Most urgent interrupt allowed to preempt the running code, -1 if none
+
+static void _simRun(int int_num); //Run a handler at its priority
+
+static DIO_PORT_Odd_Interruptable_Type *_simPort(int port); //Port 1..7, 0 if invalid
+
+static void _simDmaWrite(uint8_t *dst, uint32_t value, uint32_t size); //Write an element, seen by the sinks
+
+/* Handlers of the modules; the tests link the modules they need */
+extern void PendSV_Handler(void) __attribute__((weak));
+extern void TA0_N_IRQHandler(void) __attribute__((weak));
+extern void TA2_0_IRQHandler(void) __attribute__((weak));
+extern void TA2_N_IRQHandler(void) __attribute__((weak));
+extern void EUSCIB1_IRQHandler(void) __attribute__((weak));
+extern void T32_INT1_IRQHandler(void) __attribute__((weak));
+extern void DMA_INT0_IRQHandler(void) __attribute__((weak));
+extern void PORT1_IRQHandler(void) __attribute__((weak));
+extern void PORT2_IRQHandler(void) __attribute__((weak));
+extern void PORT3_IRQHandler(void) __attribute__((weak));
+extern void PORT4_IRQHandler(void) __attribute__((weak));
+extern void PORT5_IRQHandler(void) __attribute__((weak));
+extern void PORT6_IRQHandler(void) __attribute__((weak));
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+void simReset(void)
+{
+    DIO_PORT_Odd_Interruptable_Type *ports [7] = { P1, P2, P3, P4, P5, P6, P7 };
+    int i;
+
+    memset(&simPmap, 0, sizeof(simPmap));
+    memset(&simP2map, 0, sizeof(simP2map));
+    memset(&simP3map, 0, sizeof(simP3map));
+    memset(&simP7map, 0, sizeof(simP7map));
+    memset(&simTa0, 0, sizeof(simTa0));
+    memset(&simTa1, 0, sizeof(simTa1));
+    memset(&simTa2, 0, sizeof(simTa2));
+    memset(&simTa3, 0, sizeof(simTa3));
+    memset(&simT32, 0, sizeof(simT32));
+    memset(&simCs, 0, sizeof(simCs));
+    memset(&simSysctl, 0, sizeof(simSysctl));
+    memset(&simRstctl, 0, sizeof(simRstctl));
+    memset(&simAdc14, 0, sizeof(simAdc14));
+    memset(&simCaptio0, 0, sizeof(simCaptio0));
+    memset(&simCaptio1, 0, sizeof(simCaptio1));
+    memset(&simEusciA0, 0, sizeof(simEusciA0));
+    memset(&simEusciB0, 0, sizeof(simEusciB0));
+    memset(&simEusciB1, 0, sizeof(simEusciB1));
+    memset(&simEusciB2, 0, sizeof(simEusciB2));
+    memset(&simEusciB3, 0, sizeof(simEusciB3));
+    memset(&simScb, 0, sizeof(simScb));
+    memset(&simDwt, 0, sizeof(simDwt));
+    memset(&simCoreDebug, 0, sizeof(simCoreDebug));
+
+    simTa0.IV_READ = _simTa0Iv;
+    simTa1.IV_READ = _simTa1Iv;
+    simTa2.IV_READ = _simTa2Iv;
+    simTa3.IV_READ = _simTa3Iv;
+    simEusciA0.RXBUF_READ = _simEusciA0Rx;
+    simEusciB0.RXBUF_READ = _simEusciB0Rx;
+    simEusciB1.RXBUF_READ = _simEusciB1Rx;
+    simEusciB2.RXBUF_READ = _simEusciB2Rx;
+    simEusciB3.RXBUF_READ = _simEusciB3Rx;
+    memset(_simRx, 0, sizeof(_simRx));
+
+    /* Buttons idle high through their pull-ups; the UART is ready to send */
+    for(i = 0; i < 7; i++)
+    {
+        memset(ports[i], 0, sizeof(*ports[i]));
+        *(volatile uint8_t *)&ports[i]->IN = 0xFF;
+    }
+    simEusciA0.IFG = EUSCI_A_IFG_TXIFG;
+
+    SystemCoreClock = 12000000;
+    _simTicks = 0;
+    _simPhase = 0;
+    memset(_simPrescale, 0, sizeof(_simPrescale));
+    _simT32Left = 0;
+
+    memset(_simEnabled, 0, sizeof(_simEnabled));
+    memset(_simPriority, 0, sizeof(_simPriority));
+    memset(_simPended, 0, sizeof(_simPended));
+    memset(_simCount, 0, sizeof(_simCount));
+    _simPrimask = 0;
+    _simBasepri = 0;
+    _simActive = SIM_THREAD_PRIORITY;
+    _simStalls = 0;
+
+    memset(_simDma, 0, sizeof(_simDma));
+    _simDmaStatus = 0;
+    memset(_simSinks, 0, sizeof(_simSinks));
+}
+
+void simAdvanceCycles(uint32_t cycles)
+{
+    Timer_A_Type *timers [4] = { &simTa0, &simTa1, &simTa2, &simTa3 };
+    uint32_t step, left;
+    int i;
+
+    while(cycles > 0)
+    {
+        /* Timer32 1, periodic on MCLK: stop at each of its expiries */
+        step = cycles;
+        if(!(simT32.CONTROL & TIMER32_CONTROL_ENABLE))
+            _simT32Left = 0;
+        else
+        {
+            if(_simT32Left == 0)
+                _simT32Left = simT32.LOAD + 1;
+            if(_simT32Left < step)
+                step = _simT32Left;
+        }
+
+        /* Timers clocked from SMCLK: stop at each flag they set */
+        for(i = 0; i < 4; i++)
+        {
+            left = _simTimerLeft(timers[i], &_simPrescale[i]);
+            if(left != 0 && left < step)
+                step = left;
+        }
+        cycles -= step;
+
+        for(i = 0; i < 4; i++)
+            _simTimerCount(timers[i], &_simPrescale[i], step);
+
+        simDwt.CYCCNT = simDwt.CYCCNT + step;
+        _simPhase += (uint64_t)step * SIM_ACLK_HZ;
+
+        while(_simPhase >= SystemCoreClock)
+        {
+            _simPhase -= SystemCoreClock;
+            _simTick();
+            simServe();
+        }
+
+        if(_simT32Left != 0 && (_simT32Left -= step) == 0)
+        {
+            _simT32Left = simT32.LOAD + 1;
+            *(volatile uint32_t *)&simT32.RIS = 1;
+            simT32.INTCLR = SIM_T32_PENDING;
+        }
+
+        simServe();
+    }
+}
+
+void simAdvanceUs(uint32_t us)
+{
+    uint64_t cycles = (uint64_t)us * SystemCoreClock / 1000000;
+
+    while(cycles > 0x40000000)
+    {
+        simAdvanceCycles(0x40000000);
+        cycles -= 0x40000000;
+    }
+    simAdvanceCycles((uint32_t)cycles);
+}
+
+void simAdvanceTicks(uint32_t ticks)
+{
+    while(ticks-- > 0)
+    {
+        /* Whole cycles up to the end of the tick */
+        simAdvanceCycles((uint32_t)((SystemCoreClock - _simPhase + SIM_ACLK_HZ - 1) / SIM_ACLK_HZ));
+    }
+}
+
+uint64_t simTicks(void)
+{
+    return _simTicks;
+}
+
+uint64_t simNowNs(void)
+{
+    return _simTicks * 1000000000u / SIM_ACLK_HZ
+         + _simPhase * 1000000000u / ((uint64_t)SIM_ACLK_HZ * SystemCoreClock);
+}
+
+uint32_t simCycles(void)
+{
+    uint32_t now = simDwt.CYCCNT;
+
+    simAdvanceCycles(SIM_CYCLES_PER_READ);
+
+    return now;
+}
+
+void simServe(void)
+{
+    int next;
+
+    while((next = _simNext(0)) >= 0)
+        _simRun(next);
+}
+
+uint32_t simIsrCount(int int_num)
+{
+    if(int_num < 0 || int_num > NUM_INTERRUPTS-1)
+        return 0;
+
+    return _simCount[int_num];
+}
+
+uint32_t simStalls(void)
+{
+    return _simStalls;
+}
+
+int simPriority(void)
+{
+    return _simActive;
+}
+
+void simPinSet(int port, uint8_t mask, int level)
+{
+    DIO_PORT_Odd_Interruptable_Type *p = _simPort(port);
+    uint8_t in, rising, falling;
+
+    if(p == 0)
+        return;
+
+    in = level ? (p->IN | mask) : (p->IN & ~mask);
+    rising = in & ~p->IN;
+    falling = p->IN & ~in;
+    *(volatile uint8_t *)&p->IN = in;
+
+    /* IES set selects the falling edge */
+    p->IFG = p->IFG | (rising & ~p->IES) | (falling & p->IES);
+
+    _simCapture(port, rising, falling);
+
+    simServe();
+}
+
+int simDmaRequest(int channel)
+{
+    sim_dma_channel_t *dma;
+    sim_dma_struct_t *s;
+    uint32_t n, i, size, value;
+
+    if(channel < 0 || channel > SIM_DMA_CHANNELS-1 || !_simDma[channel].enabled)
+        return 0;
+
+    dma = &_simDma[channel];
+    s = &dma->structs[dma->alternate];
+    if(s->mode == UDMA_MODE_STOP)
+    {
+        dma->enabled = 0;
+        return 0;
+    }
+
+    n = SIM_DMA_ARB(s->control);
+    if(n > s->remaining)
+        n = s->remaining;
+
+    size = SIM_DMA_SIZE(s->control);
+    for(i = 0; i < n; i++)
+    {
+        value = 0;
+        memcpy(&value, s->src, size);
+        _simDmaWrite(s->dst, value, size);
+        s->src += SIM_DMA_SRC_INC(s->control);
+        s->dst += SIM_DMA_DST_INC(s->control);
+    }
+    s->remaining -= n;
+
+    if(s->remaining == 0)
+    {
+        /* Ping-pong goes on with the other structure unless it is stopped */
+        if(s->mode == UDMA_MODE_PINGPONG && dma->structs[!dma->alternate].mode != UDMA_MODE_STOP)
+            dma->alternate = !dma->alternate;
+        else
+            dma->enabled = 0;
+
+        s->mode = UDMA_MODE_STOP;
+        _simDmaStatus |= 1u << channel;
+        simServe();
+    }
+
+    return n;
+}
+
+int simDmaRun(int channel)
+{
+    int n, total = 0;
+
+    while((n = simDmaRequest(channel)) > 0)
+        total += n;
+
+    return total;
+}
+
+uint32_t simDmaControl(int channel, int alternate)
+{
+    if(channel < 0 || channel > SIM_DMA_CHANNELS-1)
+        return 0;
+
+    return _simDma[channel].structs[alternate != 0].control;
+}
+
+void simDmaSink(const volatile void *reg, sim_sink_t sink)
+{
+    int i;
+
+    for(i = 0; i < SIM_MAX_SINKS; i++)
+    {
+        if(_simSinks[i].reg == reg || (sink != 0 && _simSinks[i].sink == 0))
+        {
+            _simSinks[i].reg = (sink != 0) ? reg : 0;
+            _simSinks[i].sink = sink;
+            return;
+        }
+    }
+}
+
+int simCheck(int ok, const char *what, const char *file, int line)
+{
+    _simChecks++;
+
+    if(!ok)
+    {
+        _simFailures++;
+        printf("%s:%d: check failed: %s\n", file, line, what);
+    }
+
+    return ok;
+}
+
+int simReport(const char *name)
+{
+    printf("%s: %d checks, %d failed\n", name, _simChecks, _simFailures);
+
+    return _simFailures != 0;
+}
+
+static void _simTick(void)
+{
+    _simTicks++;
+
+    _simTimerTick(&simTa0, &_simPrescale[0]);
+    _simTimerTick(&simTa1, &_simPrescale[1]);
+    _simTimerTick(&simTa2, &_simPrescale[2]);
+    _simTimerTick(&simTa3, &_simPrescale[3]);
+}
+
+static void _simTimerTick(Timer_A_Type *timer, uint32_t *prescale)
+{
+    uint32_t divider;
+    int i;
+
+    if(timer->CTL & TIMER_A_CTL_CLR)
+    {
+        timer->CTL = timer->CTL & ~TIMER_A_CTL_CLR;
+        timer->R = 0;
+        *prescale = 0;
+    }
+
+    if((timer->CTL & TIMER_A_CTL_MC_MASK) == TIMER_A_CTL_MC__STOP
+       || (timer->CTL & TIMER_A_CTL_SSEL_MASK) != TIMER_A_CTL_SSEL__ACLK)
+        return;
+
+    divider = (1u << ((timer->CTL & TIMER_A_CTL_ID_MASK) >> TIMER_A_CTL_ID_OFS))
+            * ((timer->EX0 & TIMER_A_EX0_IDEX_MASK) + 1);
+    if(++(*prescale) < divider)
+        return;
+    *prescale = 0;
+
+    if((timer->CTL & TIMER_A_CTL_MC_MASK) == TIMER_A_CTL_MC__UP && timer->R >= timer->CCR[0])
+    {
+        timer->R = 0;
+        timer->CTL = timer->CTL | TIMER_A_CTL_IFG;
+    }
+
+    else
+    {
+        timer->R = timer->R + 1;
+        if(timer->R == 0)
+            timer->CTL = timer->CTL | TIMER_A_CTL_IFG;
+    }
+
+    for(i = 0; i < 7; i++)
+    {
+        if((timer->CCTL[i] & TIMER_A_CCTLN_CAP) == 0 && timer->R == timer->CCR[i])
+            timer->CCTL[i] = timer->CCTL[i] | TIMER_A_CCTLN_CCIFG;
+    }
+}
+
+static uint32_t _simTimerLeft(Timer_A_Type *timer, uint32_t *prescale)
+{
+    uint32_t divider, counts, distance;
+    int i;
+
+    if((timer->CTL & TIMER_A_CTL_MC_MASK) == TIMER_A_CTL_MC__STOP
+       || (timer->CTL & TIMER_A_CTL_SSEL_MASK) != TIMER_A_CTL_SSEL__SMCLK)
+        return 0;
+
+    if(timer->CTL & TIMER_A_CTL_CLR)
+    {
+        timer->CTL = timer->CTL & ~TIMER_A_CTL_CLR;
+        timer->R = 0;
+        *prescale = 0;
+    }
+
+    /* Counts to the wrap, then to each compare value */
+    if((timer->CTL & TIMER_A_CTL_MC_MASK) == TIMER_A_CTL_MC__UP)
+        counts = (timer->R >= timer->CCR[0]) ? 1 : timer->CCR[0] - timer->R + 1;
+    else
+        counts = 0x10000 - timer->R;
+
+    for(i = 0; i < 7; i++)
+    {
+        if(timer->CCTL[i] & TIMER_A_CCTLN_CAP)
+            continue;
+
+        distance = (uint16_t)(timer->CCR[i] - timer->R);
+        if(distance == 0)
+            distance = 0x10000;
+        if(distance < counts)
+            counts = distance;
+    }
+
+    divider = (1u << ((timer->CTL & TIMER_A_CTL_ID_MASK) >> TIMER_A_CTL_ID_OFS))
+            * ((timer->EX0 & TIMER_A_EX0_IDEX_MASK) + 1);
+
+    return counts * divider - *prescale;
+}
+
+static void _simTimerCount(Timer_A_Type *timer, uint32_t *prescale, uint32_t cycles)
+{
+    uint32_t divider, counts, r;
+    int i;
+
+    if((timer->CTL & TIMER_A_CTL_MC_MASK) == TIMER_A_CTL_MC__STOP
+       || (timer->CTL & TIMER_A_CTL_SSEL_MASK) != TIMER_A_CTL_SSEL__SMCLK)
+        return;
+
+    divider = (1u << ((timer->CTL & TIMER_A_CTL_ID_MASK) >> TIMER_A_CTL_ID_OFS))
+            * ((timer->EX0 & TIMER_A_EX0_IDEX_MASK) + 1);
+    *prescale += cycles;
+    counts = *prescale / divider;
+    *prescale = *prescale % divider;
+    if(counts == 0)
+        return;
+
+    /* The step ends at the next flag at the latest (see _simTimerLeft) */
+    r = timer->R + counts;
+    if((timer->CTL & TIMER_A_CTL_MC_MASK) == TIMER_A_CTL_MC__UP && r > timer->CCR[0])
+        r = 0x10000;
+    if(r >= 0x10000)
+    {
+        r = 0;
+        timer->CTL = timer->CTL | TIMER_A_CTL_IFG;
+    }
+    timer->R = (uint16_t)r;
+
+    for(i = 0; i < 7; i++)
+    {
+        if((timer->CCTL[i] & TIMER_A_CCTLN_CAP) == 0 && timer->R == timer->CCR[i])
+            timer->CCTL[i] = timer->CCTL[i] | TIMER_A_CCTLN_CCIFG;
+    }
+}
+
+static void _simCapture(int port, uint8_t rising, uint8_t falling)
+{
+    static const uint8_t pin_port [4] = { 5, 5, 6, 6 };
+    static const uint8_t pin_mask [4] = { BIT6, BIT7, BIT6, BIT7 };
+    DIO_PORT_Odd_Interruptable_Type *p = _simPort(port);
+    uint16_t cctl, cm;
+    int i;
+
+    for(i = 0; i < 4; i++)
+    {
+        if(port != pin_port[i] || (p->SEL0 & pin_mask[i]) == 0 || (p->SEL1 & pin_mask[i]) != 0)
+            continue;
+
+        cctl = simTa2.CCTL[i+1];
+        if((cctl & TIMER_A_CCTLN_CAP) == 0 || (cctl & TIMER_A_CCTLN_CCIS_MASK) != TIMER_A_CCTLN_CCIS__CCIA)
+            continue;
+
+        cm = cctl & TIMER_A_CCTLN_CM_MASK;
+        if(((rising & pin_mask[i]) && (cm & TIMER_A_CCTLN_CM__RISING))
+           || ((falling & pin_mask[i]) && (cm & TIMER_A_CCTLN_CM__FALLING)))
+        {
+            /* A capture not read yet is overwritten */
+            if(cctl & TIMER_A_CCTLN_CCIFG)
+                cctl = cctl | TIMER_A_CCTLN_COV;
+            simTa2.CCR[i+1] = simTa2.R;
+            simTa2.CCTL[i+1] = cctl | TIMER_A_CCTLN_CCIFG;
+        }
+    }
+}
+
+static uint16_t _simTimerIv(Timer_A_Type *timer)
+{
+    const uint16_t ccie_ccifg = TIMER_A_CCTLN_CCIE | TIMER_A_CCTLN_CCIFG;
+    int i;
+
+    for(i = 1; i < 7; i++)
+    {
+        if((timer->CCTL[i] & ccie_ccifg) == ccie_ccifg)
+        {
+            timer->CCTL[i] = timer->CCTL[i] & ~TIMER_A_CCTLN_CCIFG;
+            return 2 * i;
+        }
+    }
+
+    if((timer->CTL & (TIMER_A_CTL_IE | TIMER_A_CTL_IFG)) == (TIMER_A_CTL_IE | TIMER_A_CTL_IFG))
+    {
+        timer->CTL = timer->CTL & ~TIMER_A_CTL_IFG;
+        return 0x0E;
+    }
+
+    return 0;
+}
+
+void simEusciReceive(int instance, uint8_t value)
+{
+    EUSCI_B_Type *eusci [4] = { &simEusciB0, &simEusciB1, &simEusciB2, &simEusciB3 };
+
+    if(instance < 0 || instance > 3)
+        return;
+
+    _simRx[instance + 1] = value;
+    eusci[instance]->IFG = eusci[instance]->IFG | EUSCI_B_IFG_RXIFG0;
+
+    simServe();
+}
+
+static uint16_t _simEusciA0Rx(void)
+{
+    simEusciA0.IFG = simEusciA0.IFG & ~EUSCI_A_IFG_RXIFG;
+    return _simRx[0];
+}
+
+static uint16_t _simEusciB0Rx(void)
+{
+    simEusciB0.IFG = simEusciB0.IFG & ~EUSCI_B_IFG_RXIFG0;
+    return _simRx[1];
+}
+
+static uint16_t _simEusciB1Rx(void)
+{
+    simEusciB1.IFG = simEusciB1.IFG & ~EUSCI_B_IFG_RXIFG0;
+    return _simRx[2];
+}
+
+static uint16_t _simEusciB2Rx(void)
+{
+    simEusciB2.IFG = simEusciB2.IFG & ~EUSCI_B_IFG_RXIFG0;
+    return _simRx[3];
+}
+
+static uint16_t _simEusciB3Rx(void)
+{
+    simEusciB3.IFG = simEusciB3.IFG & ~EUSCI_B_IFG_RXIFG0;
+    return _simRx[4];
+}
+
+static uint16_t _simTa0Iv(void)
+{
+    return _simTimerIv(&simTa0);
+}
+
+static uint16_t _simTa1Iv(void)
+{
+    return _simTimerIv(&simTa1);
+}
+
+static uint16_t _simTa2Iv(void)
+{
+    return _simTimerIv(&simTa2);
+}
+
+static uint16_t _simTa3Iv(void)
+{
+    return _simTimerIv(&simTa3);
+}
+
+static int _simRaised(int int_num)
+{
+    const uint16_t ccie_ccifg = TIMER_A_CCTLN_CCIE | TIMER_A_CCTLN_CCIFG;
+    Timer_A_Type *timer;
+    int i;
+
+    if(_simPended[int_num])
+        return 1;
+
+    switch(int_num)
+    {
+    case FAULT_PENDSV:
+        return (simScb.ICSR & SCB_ICSR_PENDSVSET_Msk) != 0;
+    case INT_TA0_0:
+    case INT_TA2_0:
+        timer = (int_num == INT_TA0_0) ? &simTa0 : &simTa2;
+        return (timer->CCTL[0] & ccie_ccifg) == ccie_ccifg;
+    case INT_TA0_N:
+    case INT_TA2_N:
+        timer = (int_num == INT_TA0_N) ? &simTa0 : &simTa2;
+        for(i = 1; i < 7; i++)
+        {
+            if((timer->CCTL[i] & ccie_ccifg) == ccie_ccifg)
+                return 1;
+        }
+        return (timer->CTL & (TIMER_A_CTL_IE | TIMER_A_CTL_IFG)) == (TIMER_A_CTL_IE | TIMER_A_CTL_IFG);
+    case INT_EUSCIB1:
+        return (simEusciB1.IFG & simEusciB1.IE) != 0;
+    case INT_T32_INT1:
+        return simT32.INTCLR == SIM_T32_PENDING && (simT32.CONTROL & TIMER32_CONTROL_IE) != 0;
+    case INT_DMA_INT0:
+        return _simDmaStatus != 0;
+    case INT_PORT1:
+    case INT_PORT2:
+    case INT_PORT3:
+    case INT_PORT4:
+    case INT_PORT5:
+    case INT_PORT6:
+        return (_simPort(int_num - INT_PORT1 + 1)->IFG & _simPort(int_num - INT_PORT1 + 1)->IE) != 0;
+    default:
+        return 0;
+    }
+}
+
+static int _simNext(int ignore_primask)
+{
+    int i, priority, best = -1, best_priority = SIM_THREAD_PRIORITY;
+
+    if(_simPrimask && !ignore_primask)
+        return -1;
+
+    for(i = 0; i < NUM_INTERRUPTS; i++)
+    {
+        /* PendSV has no enable bit */
+        if((!_simEnabled[i] && i != FAULT_PENDSV) || !_simRaised(i))
+            continue;
+
+        priority = _simPriority[i] >> 5;
+        if(priority >= _simActive || priority >= best_priority)
+            continue;
+        if(_simBasepri != 0 && priority >= (int)(_simBasepri >> 5))
+            continue;
+
+        best = i;
+        best_priority = priority;
+    }
+
+    return best;
+}
+
+static void _simRun(int int_num)
+{
+    void (*handler)(void) = 0;
+    uint32_t vectactive;
+    int active;
+
+    switch(int_num)
+    {
+    case FAULT_PENDSV:  handler = PendSV_Handler; break;
+    case INT_TA0_N:     handler = TA0_N_IRQHandler; break;
+    case INT_TA2_0:     handler = TA2_0_IRQHandler; break;
+    case INT_TA2_N:     handler = TA2_N_IRQHandler; break;
+    case INT_EUSCIB1:   handler = EUSCIB1_IRQHandler; break;
+    case INT_T32_INT1:  handler = T32_INT1_IRQHandler; break;
+    case INT_DMA_INT0:  handler = DMA_INT0_IRQHandler; break;
+    case INT_PORT1:     handler = PORT1_IRQHandler; break;
+    case INT_PORT2:     handler = PORT2_IRQHandler; break;
+    case INT_PORT3:     handler = PORT3_IRQHandler; break;
+    case INT_PORT4:     handler = PORT4_IRQHandler; break;
+    case INT_PORT5:     handler = PORT5_IRQHandler; break;
+    case INT_PORT6:     handler = PORT6_IRQHandler; break;
+    default:            break;
+    }
+
+    /* Entering the handler clears the software pending state */
+    _simPended[int_num] = 0;
+    if(int_num == FAULT_PENDSV)
+        simScb.ICSR = simScb.ICSR & ~SCB_ICSR_PENDSVSET_Msk;
+
+    /* The flag of CCR0 is cleared as its handler is entered */
+    if(int_num == INT_TA2_0 && handler != 0)
+        simTa2.CCTL[0] = simTa2.CCTL[0] & ~TIMER_A_CCTLN_CCIFG;
+
+    if(handler == 0)
+    {
+        /* No module linked for it: the request stays, but the source is muted */
+        _simEnabled[int_num] = 0;
+        return;
+    }
+
+    active = _simActive;
+    vectactive = simScb.ICSR & SCB_ICSR_VECTACTIVE_Msk;
+    _simActive = _simPriority[int_num] >> 5;
+    simScb.ICSR = (simScb.ICSR & ~SCB_ICSR_VECTACTIVE_Msk) | int_num;
+    _simCount[int_num]++;
+
+    handler();
+
+    simScb.ICSR = (simScb.ICSR & ~SCB_ICSR_VECTACTIVE_Msk) | vectactive;
+    _simActive = active;
+}
+
+static DIO_PORT_Odd_Interruptable_Type *_simPort(int port)
+{
+    switch(port)
+    {
+    case 1: return P1;
+    case 2: return P2;
+    case 3: return P3;
+    case 4: return P4;
+    case 5: return P5;
+    case 6: return P6;
+    case 7: return P7;
+    default: return 0;
+    }
+}
+
+static void _simDmaWrite(uint8_t *dst, uint32_t value, uint32_t size)
+{
+    int i;
+
+    memcpy(dst, &value, size);
+
+    for(i = 0; i < SIM_MAX_SINKS; i++)
+    {
+        if(_simSinks[i].sink != 0 && _simSinks[i].reg == dst)
+            _simSinks[i].sink(value);
+    }
+}
+
+/* Interrupt controller */
+
+void Interrupt_enableMaster(void)
+{
+    _simPrimask = 0;
+    simServe();
+}
+
+bool Interrupt_disableMaster(void)
+{
+    bool masked = _simPrimask != 0;
+
+    _simPrimask = 1;
+
+    return masked;
+}
+
+void Interrupt_enableInterrupt(uint32_t interruptNumber)
+{
+    _simEnabled[interruptNumber] = 1;
+    simServe();
+}
+
+void Interrupt_disableInterrupt(uint32_t interruptNumber)
+{
+    _simEnabled[interruptNumber] = 0;
+}
+
+bool Interrupt_isEnabled(uint32_t interruptNumber)
+{
+    return _simEnabled[interruptNumber] != 0;
+}
+
+void Interrupt_setPriority(uint32_t interruptNumber, uint8_t priority)
+{
+    _simPriority[interruptNumber] = priority & 0xE0;
+}
+
+uint8_t Interrupt_getPriority(uint32_t interruptNumber)
+{
+    return _simPriority[interruptNumber];
+}
+
+void Interrupt_pendInterrupt(uint32_t interruptNumber)
+{
+    _simPended[interruptNumber] = 1;
+    simServe();
+}
+
+void Interrupt_unpendInterrupt(uint32_t interruptNumber)
+{
+    _simPended[interruptNumber] = 0;
+    if(interruptNumber == FAULT_PENDSV)
+        simScb.ICSR = simScb.ICSR & ~SCB_ICSR_PENDSVSET_Msk;
+}
+
+uint32_t __get_MSP(void)
+{
+    return 0;
+}
+
+uint32_t __get_PRIMASK(void)
+{
+    return _simPrimask;
+}
+
+void __set_PRIMASK(uint32_t primask)
+{
+    _simPrimask = primask & 1;
+    simServe();
+}
+
+uint32_t __get_BASEPRI(void)
+{
+    return _simBasepri;
+}
+
+void __set_BASEPRI(uint32_t basepri)
+{
+    _simBasepri = basepri & 0xE0;
+    simServe();
+}
+
+void __set_BASEPRI_MAX(uint32_t basepri)
+{
+    basepri = basepri & 0xE0;
+    if(basepri != 0 && (_simBasepri == 0 || basepri < _simBasepri))
+        _simBasepri = basepri;
+}
+
+void __disable_irq(void)
+{
+    _simPrimask = 1;
+}
+
+void __enable_irq(void)
+{
+    Interrupt_enableMaster();
+}
+
+void __DSB(void)
+{
+}
+
+void __ISB(void)
+{
+}
+
+void __NOP(void)
+{
+    simAdvanceCycles(1);
+}
+
+void __WFI(void)
+{
+    uint32_t ticks = 0;
+
+    /* Woken up by an enabled interrupt more urgent than the running code, even
+       if PRIMASK keeps it from being served (not if BASEPRI does); the cycle
+       counter stops meanwhile */
+    while(_simNext(1) < 0)
+    {
+        if(++ticks > SIM_SLEEP_LIMIT)
+        {
+            _simStalls++;
+            break;
+        }
+
+        _simPhase = 0;
+        _simTick();
+    }
+
+    simServe();
+}
+
+/* DMA controller */
+
+void DMA_enableModule(void)
+{
+}
+
+void DMA_setControlBase(void *controlTable)
+{
+    (void)controlTable;
+}
+
+void DMA_assignChannel(uint32_t mapping)
+{
+    (void)mapping;
+}
+
+void DMA_enableChannelAttribute(uint32_t channelNum, uint32_t attr)
+{
+    if(attr & UDMA_ATTR_ALTSELECT)
+        _simDma[channelNum & 0x1F].alternate = 1;
+}
+
+void DMA_disableChannelAttribute(uint32_t channelNum, uint32_t attr)
+{
+    if(attr & UDMA_ATTR_ALTSELECT)
+        _simDma[channelNum & 0x1F].alternate = 0;
+}
+
+void DMA_setChannelControl(uint32_t channelStructIndex, uint32_t control)
+{
+    _simDma[channelStructIndex & 0x1F].structs[(channelStructIndex & UDMA_ALT_SELECT) != 0].control = control;
+}
+
+void DMA_setChannelTransfer(uint32_t channelStructIndex, uint32_t mode, void *srcAddr, void *dstAddr, uint32_t transferSize)
+{
+    sim_dma_struct_t *s = &_simDma[channelStructIndex & 0x1F].structs[(channelStructIndex & UDMA_ALT_SELECT) != 0];
+
+    s->mode = mode;
+    s->src = srcAddr;
+    s->dst = dstAddr;
+    s->remaining = transferSize;
+}
+
+void DMA_enableChannel(uint32_t channelNum)
+{
+    _simDma[channelNum & 0x1F].enabled = 1;
+}
+
+void DMA_disableChannel(uint32_t channelNum)
+{
+    _simDma[channelNum & 0x1F].enabled = 0;
+}
+
+bool DMA_isChannelEnabled(uint32_t channelNum)
+{
+    return _simDma[channelNum & 0x1F].enabled != 0;
+}
+
+void DMA_requestSoftwareTransfer(uint32_t channel)
+{
+    /* The peripheral requests the rest: see simDmaRequest */
+    (void)channel;
+}
+
+uint32_t DMA_getInterruptStatus(void)
+{
+    return _simDmaStatus;
+}
+
+void DMA_clearInterruptFlag(uint32_t intChannel)
+{
+    _simDmaStatus &= ~(1u << (intChannel & 0x1F));
+}
+
+/* Clock system and power control */
+
+uint32_t CS_getMCLK(void)
+{
+    return SystemCoreClock;
+}
+
+uint32_t CS_getSMCLK(void)
+{
+    return SystemCoreClock;
+}
+
+void CS_setDCOCenteredFrequency(uint32_t dcoFreq)
+{
+    static const uint32_t hz [6] = { 1500000, 3000000, 6000000, 12000000, 24000000, 48000000 };
+
+    if(dcoFreq < 6)
+        SystemCoreClock = hz[dcoFreq];
+    if(_simPhase >= SystemCoreClock)
+        _simPhase = 0;
+}
+
+bool PCM_setCoreVoltageLevel(uint_fast8_t voltageLevel)
+{
+    (void)voltageLevel;
+    return true;
+}
+
+bool FlashCtl_setWaitState(uint32_t bank, uint32_t waitState)
+{
+    (void)bank;
+    (void)waitState;
+    return true;
+}
+
+bool PCM_gotoLPM0(void)
+{
+    __WFI();
+    return true;
+}
+
+bool PCM_gotoLPM3(void)
+{
+    __WFI();
+    return true;
+}
+
+void MAP_WDT_A_holdTimer(void)
+{
+}
+
+void SystemCoreClockUpdate(void)
+{
+}
+
+#endif //BENCH_HOST
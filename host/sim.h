@@ -0,0 +1,132 @@
+/**
+ @file    sim.h
+
+ @brief   Simulated msp432p401r for the host build: clock, interrupts, ports and DMA
+
+ The modules are compiled unchanged against the register blocks declared by
+ the simulated msp.h, and this layer makes those registers behave:
+ - Time is counted in ACLK ticks (32768 Hz) plus the MCLK cycles within the
+   tick, at SystemCoreClock. The CPU advances it by running (the DWT cycle
+   counter counts, each read of CYCLES_NOW costs SIM_CYCLES_PER_READ cycles)
+   or by sleeping (PCM_gotoLPMx, the counter stops). The Timer_A blocks clocked
+   from ACLK count, reach their compare values and wrap, setting their flags;
+   the ones clocked from SMCLK (MCLK here) do the same over the cycles the CPU
+   runs, as in LPM3. The channels of TIMER_A2 in capture mode copy the counter
+   on the selected edges of their CCIxA pin (P5.6, P5.7, P6.6 and P6.7 for
+   CCR1 to CCR4, in their primary function).
+   Timer32 1 counts the MCLK cycles the CPU runs (not the ones it sleeps) and
+   expires periodically; any write to INTCLR acknowledges it.
+ - The interrupt controller keeps the enable bit and the priority of each
+   interrupt, PRIMASK and BASEPRI. Whenever the state changes (an interrupt
+   unmasked, a flag raised, time advancing) the pending interrupts more urgent
+   than the running code are served, nesting by priority as on the target.
+   PendSV is pended through SCB->ICSR and served last, as deferPost expects.
+ - Port inputs are driven by @ref simPinSet: an edge in the direction selected
+   by IES sets IFG. Writing IFG from the code raises the interrupt as well.
+ - A DMA channel moves data when the peripheral requests it (@ref simDmaRequest),
+   honoring the size, the increments and the arbitration of its control word,
+   the basic and ping-pong modes, and raises DMA_INT0 at the end of each
+   structure. What a channel writes to a register can be seen by a sink.
+
+ Peripherals driven by the modules through several registers (the I2C bus of
+ the expanders, the shift register chain, the strip) are modeled by the tests
+ that need them, on top of these functions; @ref simEusciReceive hands them
+ the bytes an eUSCI_B receives.
+
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+*/
+
+// Do not write above this line (except comments)!
+#ifndef SIM_H
+#define SIM_H
+
+/* SECTION 1: Included header files required to compile this file  */
+#include <stdint.h>
+#include <stdio.h>
+
+
+/* SECTION 2: Public macros                                        */
+
+/**
+ @brief Frequency of ACLK (REFOCLK), the time base of the simulation
+*/
+#define SIM_ACLK_HZ           32768
+
+/**
+ @brief Cycles taken by each read of the cycle counter, so that spinning on it advances the time
+*/
+#define SIM_CYCLES_PER_READ   4
+
+/**
+ @brief Longest sleep without an interrupt to wake the CPU up, in ACLK ticks (60 s)
+*/
+#define SIM_SLEEP_LIMIT       (60 * SIM_ACLK_HZ)
+
+/**
+ @brief Value of TIMER32_1->INTCLR while its interrupt is requested (write-only on the target)
+*/
+#define SIM_T32_PENDING       0xA5A5A5A5u
+
+/**
+ @brief Check of a test: counts and reports the failures, the test goes on
+*/
+#define SIM_CHECK(cond)       simCheck((cond) != 0, #cond, __FILE__, __LINE__)
+
+
+/* SECTION 3: Public types                                         */
+
+/**
+ @brief Function receiving each value a DMA channel writes to a register
+*/
+typedef void (*sim_sink_t)(uint32_t value);
+
+
+/* SECTION 4: Public variables :: declarations, extern mandatory   */
+
+
+/* SECTION 5: Public functions :: declarations, extern optional
+   Rule exception (callbacks)  :: declarations, extern recommended */
+
+void simReset(void); //Registers, clock and interrupt controller as after a reset, MCLK at 12 MHz, inputs high
+
+void simAdvanceCycles(uint32_t cycles); //Let the CPU run for some MCLK cycles, serving the interrupts that fall due
+
+void simAdvanceUs(uint32_t us); //Let the CPU run for some microseconds
+
+void simAdvanceTicks(uint32_t ticks); //Let the CPU run for some ACLK ticks
+
+uint64_t simTicks(void); //ACLK ticks since the reset
+
+uint64_t simNowNs(void); //Time since the reset, in nanoseconds
+
+uint32_t simCycles(void); //Read the cycle counter (CYCLES_NOW), which costs SIM_CYCLES_PER_READ cycles
+
+void simServe(void); //Serve the pending interrupts allowed to run
+
+uint32_t simIsrCount(int int_num); //Times a handler (INT_x, FAULT_PENDSV) has run since the reset
+
+uint32_t simStalls(void); //Sleeps that no interrupt ended within SIM_SLEEP_LIMIT
+
+int simPriority(void); //Priority (0..7) of the handler running, 8 in thread mode
+
+void simPinSet(int port, uint8_t mask, int level); //Drive input pins of a port (1..7) high (1) or low (0)
+
+int simDmaRequest(int channel); //Request of the peripheral of a channel: one arbitration burst, items moved
+
+int simDmaRun(int channel); //Request until the channel stops (end of the last structure), items moved
+
+uint32_t simDmaControl(int channel, int alternate); //Control word of the primary (0) or alternate (1) structure of a channel
+
+void simDmaSink(const volatile void *reg, sim_sink_t sink); //Call sink for each value a channel writes to reg (0 to remove)
+
+void simEusciReceive(int instance, uint8_t value); //A byte received by eUSCI_Bx (0..3): RXBUF and RXIFG0 set, reading RXBUF clears RXIFG0
+
+int simCheck(int ok, const char *what, const char *file, int line); //Account a check, use SIM_CHECK
+
+int simReport(const char *name); //Print the summary of a test, exit status of its main function
+
+
+#endif //SIM_H
+// Do not write below this line!
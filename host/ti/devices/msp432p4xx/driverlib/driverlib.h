@@ -0,0 +1,169 @@
+/**
+ @file    driverlib.h
+
+ @brief   Simulated driverlib subset for the host build
+
+ Declares the driverlib functions and constants used by the modules, with the
+ values of the SDK. The functions are implemented by sim.c on top of its
+ interrupt controller, clock and DMA models.
+
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+*/
+
+// Do not write above this line (except comments)!
+#ifndef SIM_DRIVERLIB_H
+#define SIM_DRIVERLIB_H
+
+/* SECTION 1: Included header files required to compile this file  */
+#include <ti/devices/msp432p4xx/inc/msp.h>
+
+
+/* SECTION 2: Public macros                                        */
+
+/**
+ @brief Exception and interrupt numbers (interrupt.h)
+*/
+#define FAULT_PENDSV   14
+#define FAULT_SYSTICK  15
+#define INT_PSS        16
+#define INT_TA0_0      24
+#define INT_TA0_N      25
+#define INT_TA1_0      26
+#define INT_TA1_N      27
+#define INT_TA2_0      28
+#define INT_TA2_N      29
+#define INT_TA3_0      30
+#define INT_TA3_N      31
+#define INT_EUSCIA0    32
+#define INT_EUSCIB0    36
+#define INT_EUSCIB1    37
+#define INT_EUSCIB2    38
+#define INT_EUSCIB3    39
+#define INT_ADC14      40
+#define INT_T32_INT1   41
+#define INT_DMA_INT0   50
+#define INT_PORT1      51
+#define INT_PORT2      52
+#define INT_PORT3      53
+#define INT_PORT4      54
+#define INT_PORT5      55
+#define INT_PORT6      56
+
+#define NUM_INTERRUPTS 64
+
+/**
+ @brief DMA channel sources, control and modes (dma.h)
+*/
+#define DMA_CHANNEL_0          0
+#define DMA_CH0_EUSCIA0TX      0x01000000
+#define DMA_CH4_EUSCIB2TX0     0x01000004
+#define DMA_CH6_EUSCIB3TX0     0x01000006
+#define DMA_CH7_ADC14          0x07000007
+
+#define UDMA_PRI_SELECT        0x00000000
+#define UDMA_ALT_SELECT        0x00000020
+
+#define UDMA_ATTR_USEBURST       0x00000001
+#define UDMA_ATTR_ALTSELECT      0x00000002
+#define UDMA_ATTR_HIGH_PRIORITY  0x00000004
+#define UDMA_ATTR_REQMASK        0x00000008
+
+#define UDMA_SIZE_8            0x00000000
+#define UDMA_SIZE_16           0x11000000
+#define UDMA_SIZE_32           0x22000000
+#define UDMA_SRC_INC_8         0x00000000
+#define UDMA_SRC_INC_16        0x04000000
+#define UDMA_SRC_INC_32        0x08000000
+#define UDMA_SRC_INC_NONE      0x0C000000
+#define UDMA_DST_INC_8         0x00000000
+#define UDMA_DST_INC_16        0x40000000
+#define UDMA_DST_INC_32        0x80000000
+#define UDMA_DST_INC_NONE      0xC0000000
+#define UDMA_ARB_1             0x00000000
+#define UDMA_ARB_2             0x00004000
+#define UDMA_ARB_4             0x00008000
+#define UDMA_ARB_8             0x0000C000
+#define UDMA_ARB_16            0x00010000
+
+#define UDMA_MODE_STOP         0x00000000
+#define UDMA_MODE_BASIC        0x00000001
+#define UDMA_MODE_AUTO         0x00000002
+#define UDMA_MODE_PINGPONG     0x00000003
+
+/**
+ @brief Clock system, power control and flash (cs.h, pcm.h, flash.h)
+*/
+#define CS_DCO_FREQUENCY_1_5   0
+#define CS_DCO_FREQUENCY_3     1
+#define CS_DCO_FREQUENCY_6     2
+#define CS_DCO_FREQUENCY_12    3
+#define CS_DCO_FREQUENCY_24    4
+#define CS_DCO_FREQUENCY_48    5
+
+#define PCM_VCORE0             0
+#define PCM_VCORE1             1
+
+#define FLASH_BANK0            0
+#define FLASH_BANK1            1
+
+
+/* SECTION 3: Public types                                         */
+
+/**
+ @brief Channel control structure of the DMA controller
+*/
+typedef struct {
+   volatile void *srcEndAddr;
+   volatile void *dstEndAddr;
+   volatile uint32_t control;
+   volatile uint32_t spare;
+} DMA_ControlTable;
+
+
+/* SECTION 4: Public variables :: declarations, extern mandatory   */
+
+
+/* SECTION 5: Public functions :: declarations, extern optional
+   Rule exception (callbacks)  :: declarations, extern recommended */
+
+void Interrupt_enableMaster(void);
+bool Interrupt_disableMaster(void);
+void Interrupt_enableInterrupt(uint32_t interruptNumber);
+void Interrupt_disableInterrupt(uint32_t interruptNumber);
+bool Interrupt_isEnabled(uint32_t interruptNumber);
+void Interrupt_setPriority(uint32_t interruptNumber, uint8_t priority);
+uint8_t Interrupt_getPriority(uint32_t interruptNumber);
+void Interrupt_pendInterrupt(uint32_t interruptNumber);
+void Interrupt_unpendInterrupt(uint32_t interruptNumber);
+
+void DMA_enableModule(void);
+void DMA_setControlBase(void *controlTable);
+void DMA_assignChannel(uint32_t mapping);
+void DMA_enableChannelAttribute(uint32_t channelNum, uint32_t attr);
+void DMA_disableChannelAttribute(uint32_t channelNum, uint32_t attr);
+void DMA_setChannelControl(uint32_t channelStructIndex, uint32_t control);
+void DMA_setChannelTransfer(uint32_t channelStructIndex, uint32_t mode, void *srcAddr, void *dstAddr, uint32_t transferSize);
+void DMA_enableChannel(uint32_t channelNum);
+void DMA_disableChannel(uint32_t channelNum);
+bool DMA_isChannelEnabled(uint32_t channelNum);
+void DMA_requestSoftwareTransfer(uint32_t channel);
+uint32_t DMA_getInterruptStatus(void);
+void DMA_clearInterruptFlag(uint32_t intChannel);
+
+uint32_t CS_getMCLK(void);
+uint32_t CS_getSMCLK(void);
+void CS_setDCOCenteredFrequency(uint32_t dcoFreq);
+bool PCM_setCoreVoltageLevel(uint_fast8_t voltageLevel);
+bool FlashCtl_setWaitState(uint32_t bank, uint32_t waitState);
+bool PCM_gotoLPM0(void);
+bool PCM_gotoLPM3(void);
+
+void MAP_WDT_A_holdTimer(void);
+
+void SystemCoreClockUpdate(void);
+
+
+#endif //SIM_DRIVERLIB_H
+// Do not write below this line!
@@ -0,0 +1,422 @@
+/**
+ @file    msp.h
+
+ @brief   Simulated msp432p401r registers for the host build
+
+ Stands for the device header of the SDK when the modules are compiled on the
+ host (see host/Makefile). Only the registers and bit fields used by the
+ modules are declared, with the names and values of the SDK; the register
+ blocks are plain variables defined in sim.c, and sim.c gives them the
+ behavior the modules rely on (counters, interrupt flags, DMA).
+
+ Three registers cannot be plain memory:
+ - TAxIV clears the flag it reports when read. Its member is a function of the
+   simulated timer, and IV is a macro calling it, so TIMER_Ax->IV keeps its syntax.
+ - UCxRXBUF clears the receive flag when read: RXBUF is a macro calling a
+   function of the simulated eUSCI in the same way.
+ - The DWT cycle counter advances with the simulated clock: CYCLES_NOW (see
+   common.h) is defined here to read it through sim.c.
+
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+*/
+
+// Do not write above this line (except comments)!
+#ifndef SIM_MSP_H
+#define SIM_MSP_H
+
+/* SECTION 1: Included header files required to compile this file  */
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/* SECTION 2: Public macros                                        */
+
+#define __I   volatile const
+#define __O   volatile
+#define __IO  volatile
+
+#define BIT0  (0x01)
+#define BIT1  (0x02)
+#define BIT2  (0x04)
+#define BIT3  (0x08)
+#define BIT4  (0x10)
+#define BIT5  (0x20)
+#define BIT6  (0x40)
+#define BIT7  (0x80)
+#define BIT(x) (1u << (x))
+
+#define SRAM_BASE  0x20000000u
+
+/**
+ @brief Digital I/O
+*/
+#define P1  (&simP1)
+#define P2  (&simP2)
+#define P3  (&simP3)
+#define P4  (&simP4)
+#define P5  (&simP5)
+#define P6  (&simP6)
+#define P7  (&simP7)
+
+/**
+ @brief Port mapping controller
+*/
+#define PMAP   (&simPmap)
+#define P2MAP  (&simP2map)
+#define P3MAP  (&simP3map)
+#define P7MAP  (&simP7map)
+
+#define PMAP_KEYID_VAL   0x2D52
+#define PMAP_CTL_PRECFG  0x0002
+#define PMAP_UCB2CLK     13
+#define PMAP_UCB2SIMO    14
+#define PMAP_TA1CCR1A    23
+
+/**
+ @brief Timer_A
+*/
+#define TIMER_A0  (&simTa0)
+#define TIMER_A1  (&simTa1)
+#define TIMER_A2  (&simTa2)
+#define TIMER_A3  (&simTa3)
+
+#define IV        IV_READ()
+
+#define TIMER_A_CTL_IFG             0x0001
+#define TIMER_A_CTL_IE              0x0002
+#define TIMER_A_CTL_CLR             0x0004
+#define TIMER_A_CTL_MC__STOP        0x0000
+#define TIMER_A_CTL_MC__UP          0x0010
+#define TIMER_A_CTL_MC__CONTINUOUS  0x0020
+#define TIMER_A_CTL_MC_MASK         0x0030
+#define TIMER_A_CTL_ID__1           0x0000
+#define TIMER_A_CTL_ID__8           0x00C0
+#define TIMER_A_CTL_ID_MASK         0x00C0
+#define TIMER_A_CTL_ID_OFS          6
+#define TIMER_A_CTL_SSEL__ACLK      0x0100
+#define TIMER_A_CTL_SSEL__SMCLK     0x0200
+#define TIMER_A_CTL_SSEL__INCLK     0x0300
+#define TIMER_A_CTL_SSEL_MASK       0x0300
+
+#define TIMER_A_CCTLN_CCIFG         0x0001
+#define TIMER_A_CCTLN_COV           0x0002
+#define TIMER_A_CCTLN_OUT           0x0004
+#define TIMER_A_CCTLN_CCI           0x0008
+#define TIMER_A_CCTLN_CCIE          0x0010
+#define TIMER_A_CCTLN_OUTMOD_0      0x0000
+#define TIMER_A_CCTLN_OUTMOD_7      0x00E0
+#define TIMER_A_CCTLN_CAP           0x0100
+#define TIMER_A_CCTLN_SCS           0x0800
+#define TIMER_A_CCTLN_CCIS__CCIA    0x0000
+#define TIMER_A_CCTLN_CCIS_MASK     0x3000
+#define TIMER_A_CCTLN_CM__RISING    0x4000
+#define TIMER_A_CCTLN_CM__FALLING   0x8000
+#define TIMER_A_CCTLN_CM__BOTH      0xC000
+#define TIMER_A_CCTLN_CM_MASK       0xC000
+
+#define TIMER_A_EX0_IDEX_MASK       0x0007
+
+/**
+ @brief Timer32
+*/
+#define TIMER32_1  (&simT32)
+
+#define TIMER32_CONTROL_ONESHOT     0x01
+#define TIMER32_CONTROL_SIZE        0x02
+#define TIMER32_CONTROL_PRESCALE_0  0x00
+#define TIMER32_CONTROL_IE          0x20
+#define TIMER32_CONTROL_MODE        0x40
+#define TIMER32_CONTROL_ENABLE      0x80
+
+/**
+ @brief Clock system
+*/
+#define CS  (&simCs)
+
+#define CS_KEY_VAL             0x0000695A
+#define CS_CTL1_SELA_MASK      0x00000700
+#define CS_CTL1_SELA__REFOCLK  0x00000200
+#define CS_CTL1_DIVA_MASK      0x07000000
+#define CS_CLKEN_REFOFSEL      0x00008000
+
+/**
+ @brief SRAM control and reset controller
+*/
+#define SYSCTL  (&simSysctl)
+#define RSTCTL  (&simRstctl)
+
+#define SYSCTL_SRAM_BANKEN_BNK1_EN  0x00000002
+#define SYSCTL_SRAM_BANKEN_BNK3_EN  0x00000008
+#define SYSCTL_SRAM_BANKEN_BNK7_EN  0x00000080
+#define SYSCTL_SRAM_BANKEN_SRAM_RDY 0x00010000
+
+/**
+ @brief ADC14
+*/
+#define ADC14  (&simAdc14)
+
+#define ADC14_CTL0_SC          0x00000001
+#define ADC14_CTL0_ENC         0x00000002
+#define ADC14_CTL0_ON          0x00000010
+#define ADC14_CTL0_MSC         0x00000080
+#define ADC14_CTL0_SHT0__192   0x00000700
+#define ADC14_CTL0_CONSEQ_3    0x00060000
+#define ADC14_CTL0_SSEL__ACLK  0x00200000
+#define ADC14_CTL0_SHP         0x04000000
+#define ADC14_CTL1_RES__14BIT  0x00000030
+#define ADC14_MCTLN_INCH_MASK  0x0000001F
+#define ADC14_MCTLN_EOS        0x00000080
+#define ADC14_MCTLN_VRSEL_0    0x00000000
+
+/**
+ @brief Capacitive touch I/O
+*/
+#define CAPTIO0  (&simCaptio0)
+#define CAPTIO1  (&simCaptio1)
+
+#define CAPTIO_CTL_PISEL_OFS   1
+#define CAPTIO_CTL_POSEL_OFS   4
+#define CAPTIO_CTL_EN          0x0100
+
+/**
+ @brief eUSCI_A (UART) and eUSCI_B (SPI, I2C)
+*/
+#define EUSCI_A0  (&simEusciA0)
+#define EUSCI_B0  (&simEusciB0)
+#define EUSCI_B1  (&simEusciB1)
+#define EUSCI_B2  (&simEusciB2)
+#define EUSCI_B3  (&simEusciB3)
+
+#define RXBUF     RXBUF_READ()
+
+#define EUSCI_A_CTLW0_SWRST        0x0001
+#define EUSCI_A_CTLW0_SSEL__SMCLK  0x0080
+#define EUSCI_A_MCTLW_OS16         0x0001
+#define EUSCI_A_MCTLW_BRF_OFS      4
+#define EUSCI_A_IFG_RXIFG          0x0001
+#define EUSCI_A_IFG_TXIFG          0x0002
+
+#define EUSCI_B_CTLW0_SWRST        0x0001
+#define EUSCI_B_CTLW0_TXSTT        0x0002
+#define EUSCI_B_CTLW0_TXSTP        0x0004
+#define EUSCI_B_CTLW0_TR           0x0010
+#define EUSCI_B_CTLW0_SSEL__SMCLK  0x00C0
+#define EUSCI_B_CTLW0_SYNC         0x0100
+#define EUSCI_B_CTLW0_MODE_3       0x0600
+#define EUSCI_B_CTLW0_MST          0x0800
+#define EUSCI_B_CTLW0_MSB          0x2000
+#define EUSCI_B_CTLW0_CKPH         0x8000
+#define EUSCI_B_STATW_SPI_BUSY     0x0001
+#define EUSCI_B_IE_RXIE0           0x0001
+#define EUSCI_B_IE_TXIE0           0x0002
+#define EUSCI_B_IE_STPIE           0x0008
+#define EUSCI_B_IE_NACKIE          0x0020
+#define EUSCI_B_IFG_RXIFG0         0x0001
+#define EUSCI_B_IFG_TXIFG0         0x0002
+#define EUSCI_B_IFG_STPIFG         0x0008
+#define EUSCI_B_IFG_NACKIFG        0x0020
+
+/**
+ @brief Core peripherals
+*/
+#define SCB        (&simScb)
+#define DWT        (&simDwt)
+#define CoreDebug  (&simCoreDebug)
+
+#define SCB_ICSR_VECTACTIVE_Msk     0x000001FFu
+#define SCB_ICSR_PENDSVSET_Msk      0x10000000u
+#define SCB_SCR_SLEEPONEXIT_Msk     0x00000002u
+#define SCB_SCR_SLEEPDEEP_Msk       0x00000004u
+#define DWT_CTRL_CYCCNTENA_Msk      0x00000001u
+#define CoreDebug_DEMCR_TRCENA_Msk  0x01000000u
+
+/**
+ @brief Cycle counter of common.h, advancing the simulated clock as it is read
+*/
+#define CYCLES_NOW()  simCycles()
+
+
+/* SECTION 3: Public types                                         */
+
+typedef struct {
+   __I  uint8_t IN;
+   __IO uint8_t OUT;
+   __IO uint8_t DIR;
+   __IO uint8_t REN;
+   __IO uint8_t DS;
+   __IO uint8_t SEL0;
+   __IO uint8_t SEL1;
+   __IO uint8_t SELC;
+   __IO uint8_t IES;
+   __IO uint8_t IE;
+   __IO uint8_t IFG;
+} DIO_PORT_Odd_Interruptable_Type;
+
+typedef DIO_PORT_Odd_Interruptable_Type DIO_PORT_Even_Interruptable_Type;
+
+typedef struct {
+   __IO uint16_t KEYID;
+   __IO uint16_t CTL;
+} PMAP_COMMON_Type;
+
+typedef struct {
+   __IO uint8_t PMAP_REGISTER[8];
+} PMAP_REGISTER_Type;
+
+typedef struct {
+   __IO uint16_t CTL;
+   __IO uint16_t CCTL[7];
+   __IO uint16_t R;
+   __IO uint16_t CCR[7];
+   __IO uint16_t EX0;
+   uint16_t (*IV_READ)(void);  /**< TAxIV, see the file description */
+} Timer_A_Type;
+
+typedef struct {
+   __IO uint32_t LOAD;
+   __I  uint32_t VALUE;
+   __IO uint32_t CONTROL;
+   __O  uint32_t INTCLR;
+   __I  uint32_t RIS;
+   __I  uint32_t MIS;
+   __IO uint32_t BGLOAD;
+} Timer32_Type;
+
+typedef struct {
+   __IO uint32_t KEY;
+   __IO uint32_t CTL0;
+   __IO uint32_t CTL1;
+   __IO uint32_t CLKEN;
+   __IO uint32_t IFG;
+   __IO uint32_t CLRIFG;
+} CS_Type;
+
+typedef struct {
+   __IO uint32_t SRAM_BANKEN;
+   __IO uint32_t SRAM_BANKRET;
+} SYSCTL_Type;
+
+typedef struct {
+   __I  uint32_t HARDRESET_STAT;
+   __IO uint32_t HARDRESET_CLR;
+   __I  uint32_t SOFTRESET_STAT;
+   __IO uint32_t SOFTRESET_CLR;
+   __I  uint32_t PSSRESET_STAT;
+   __IO uint32_t PSSRESET_CLR;
+   __I  uint32_t PCMRESET_STAT;
+   __IO uint32_t PCMRESET_CLR;
+   __I  uint32_t PINRESET_STAT;
+   __IO uint32_t PINRESET_CLR;
+   __I  uint32_t REBOOTRESET_STAT;
+   __IO uint32_t REBOOTRESET_CLR;
+   __I  uint32_t CSRESET_STAT;
+   __IO uint32_t CSRESET_CLR;
+} RSTCTL_Type;
+
+typedef struct {
+   __IO uint32_t CTL0;
+   __IO uint32_t CTL1;
+   __IO uint32_t LO0;
+   __IO uint32_t HI0;
+   __IO uint32_t LO1;
+   __IO uint32_t HI1;
+   __IO uint32_t MCTL[32];
+   __IO uint32_t MEM[32];
+   __IO uint32_t IER0;
+   __IO uint32_t IER1;
+   __I  uint32_t IFGR0;
+   __I  uint32_t IFGR1;
+   __O  uint32_t CLRIFGR0;
+   __IO uint32_t CLRIFGR1;
+} ADC14_Type;
+
+typedef struct {
+   __IO uint16_t CTL;
+} CAPTIO_Type;
+
+typedef struct {
+   __IO uint16_t CTLW0;
+   __IO uint16_t CTLW1;
+   __IO uint16_t BRW;
+   __IO uint16_t MCTLW;
+   __IO uint16_t STATW;
+   uint16_t (*RXBUF_READ)(void); /**< UCAxRXBUF, see the file description */
+   __IO uint16_t TXBUF;
+   __IO uint16_t IE;
+   __IO uint16_t IFG;
+} EUSCI_A_Type;
+
+typedef struct {
+   __IO uint16_t CTLW0;
+   __IO uint16_t CTLW1;
+   __IO uint16_t BRW;
+   __IO uint16_t STATW;
+   __IO uint16_t TBCNT;
+   uint16_t (*RXBUF_READ)(void); /**< UCBxRXBUF, see the file description */
+   __IO uint16_t TXBUF;
+   __IO uint16_t I2COA0;
+   __IO uint16_t I2CSA;
+   __IO uint16_t IE;
+   __IO uint16_t IFG;
+} EUSCI_B_Type;
+
+typedef struct {
+   __IO uint32_t ICSR;
+   __IO uint32_t SCR;
+   __IO uint32_t CPACR;
+} SCB_Type;
+
+typedef struct {
+   __IO uint32_t CTRL;
+   __IO uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct {
+   __IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+
+/* SECTION 4: Public variables :: declarations, extern mandatory   */
+
+extern DIO_PORT_Odd_Interruptable_Type simP1, simP2, simP3, simP4, simP5, simP6, simP7;
+extern PMAP_COMMON_Type simPmap;
+extern PMAP_REGISTER_Type simP2map, simP3map, simP7map;
+extern Timer_A_Type simTa0, simTa1, simTa2, simTa3;
+extern Timer32_Type simT32;
+extern CS_Type simCs;
+extern SYSCTL_Type simSysctl;
+extern RSTCTL_Type simRstctl;
+extern ADC14_Type simAdc14;
+extern CAPTIO_Type simCaptio0, simCaptio1;
+extern EUSCI_A_Type simEusciA0;
+extern EUSCI_B_Type simEusciB0, simEusciB1, simEusciB2, simEusciB3;
+extern SCB_Type simScb;
+extern DWT_Type simDwt;
+extern CoreDebug_Type simCoreDebug;
+
+extern uint32_t SystemCoreClock;
+
+
+/* SECTION 5: Public functions :: declarations, extern optional
+   Rule exception (callbacks)  :: declarations, extern recommended */
+
+uint32_t simCycles(void); //Cycle counter, see sim.h
+
+uint32_t __get_MSP(void);
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t primask);
+uint32_t __get_BASEPRI(void);
+void __set_BASEPRI(uint32_t basepri);
+void __set_BASEPRI_MAX(uint32_t basepri);
+void __disable_irq(void);
+void __enable_irq(void);
+void __DSB(void);
+void __ISB(void);
+void __NOP(void);
+void __WFI(void);
+
+
+#endif //SIM_MSP_H
+// Do not write below this line!
@@ -0,0 +1,363 @@
+/**
+ @file    inputtrace.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Record and replay of the port interrupt activity seen by the button module
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "inputtrace.h"
+#include "defer.h"
+#ifdef INPUTTRACE_HOST
+#include "sim.h"
+#endif
+
+
+/* SECTION 2: Private macros                                       */
+
+#define INPUTTRACE_IDLE    0
+#define INPUTTRACE_RECORD  1
+#define INPUTTRACE_REPLAY  2
+
+/**
+ @brief Write the IN register of a simulated port (host builds only)
+*/
+#ifdef INPUTTRACE_HOST
+#define INPUTTRACE_SET_IN(port, value)  (*(volatile uint8_t *)&((port)->IN) = (value))
+#else
+#define INPUTTRACE_SET_IN(port, value)  ((void)(value))
+#endif
+
+/**
+ @brief Let some cycles elapse on a simulated CPU (host builds only), instead of spinning
+*/
+#ifdef INPUTTRACE_HOST
+#define INPUTTRACE_ADVANCE(cycles)  simAdvanceCycles(cycles)
+#endif
+
+/**
+ @brief Callbacks observed during a replay and not matched yet with a recorded one, at most
+*/
+#define INPUTTRACE_PENDING  16
+
+
+/* SECTION 3: Private types                                        */
+
+/**
+ @brief Callback observed during a replay, waiting for its record
+*/
+struct inputtrace_pending_s {
+   uint32_t index;   /**< Port record being replayed when it was observed */
+   uint8_t  button;  /**< Button reported                                 */
+};
+
+/**
+ @brief Short alias "inputtrace_pending_t" for the data type "struct inputtrace_pending_s"
+*/
+typedef struct inputtrace_pending_s inputtrace_pending_t;
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+static volatile uint8_t _inputtraceMode = INPUTTRACE_IDLE;
+
+static inputtrace_header_t *_inputtraceBuffer = 0;    /**< Trace being recorded               */
+static uint32_t _inputtraceCapacity = 0;              /**< Records that fit in the buffer     */
+
+static uint32_t _inputtraceIndex = 0;                 /**< Port record being replayed         */
+static inputtrace_result_t *_inputtraceResult = 0;    /**< Result of the replay in progress   */
+
+static inputtrace_pending_t _inputtracePending [INPUTTRACE_PENDING]; /**< Observed callbacks, oldest first */
+static uint8_t _inputtracePendingHead = 0;
+static uint8_t _inputtracePendingCount = 0;
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static int _inputtraceInject(int port, uint8_t in, uint8_t ifg); //Raise the flags of a port and run its ISR
+
+static void _inputtraceDiverge(uint32_t index); //Account for a divergence at a record
+
+static void _inputtraceMatch(uint32_t index, uint8_t button); //Match a callback record with the oldest callback observed
+
+static void _inputtraceWait(uint32_t since, uint32_t cycles); //Wait until some cycles have elapsed since a cycle count, serving interrupts
+
+extern void PORT1_IRQHandler(void);
+extern void PORT2_IRQHandler(void);
+extern void PORT3_IRQHandler(void);
+extern void PORT4_IRQHandler(void);
+extern void PORT5_IRQHandler(void);
+extern void PORT6_IRQHandler(void);
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+int inputtraceRecordStart(inputtrace_header_t *trace, uint32_t capacity)
+{
+    if(trace == 0 || capacity == 0 || _inputtraceMode != INPUTTRACE_IDLE)
+        return -1;
+
+    trace->magic = INPUTTRACE_MAGIC;
+    trace->version = INPUTTRACE_VERSION;
+    trace->record_size = sizeof(inputtrace_record_t);
+    trace->clock_hz = SystemCoreClock;
+    trace->count = 0;
+
+    _inputtraceBuffer = trace;
+    _inputtraceCapacity = capacity;
+    _inputtraceMode = INPUTTRACE_RECORD;
+
+    return 1;
+}
+
+uint32_t inputtraceRecordStop(void)
+{
+    if(_inputtraceMode != INPUTTRACE_RECORD)
+        return 0;
+
+    _inputtraceMode = INPUTTRACE_IDLE;
+
+    return _inputtraceBuffer->count;
+}
+
+void inputtracePort(int port, uint8_t in, uint8_t ifg)
+{
+    inputtrace_record_t *record;
+    bool state;
+
+    if(_inputtraceMode != INPUTTRACE_RECORD)
+        return;
+
+    CRITICAL_ENTER(state);
+
+    if(_inputtraceBuffer->count < _inputtraceCapacity)
+    {
+        record = (inputtrace_record_t *)(_inputtraceBuffer + 1) + _inputtraceBuffer->count;
+        record->time = CYCLES_NOW();
+        record->kind = INPUTTRACE_KIND_PORT;
+        record->id = port;
+        record->in = in;
+        record->ifg = ifg;
+        _inputtraceBuffer->count++;
+    }
+
+    CRITICAL_EXIT(state);
+}
+
+void inputtraceCallback(int which_button)
+{
+    inputtrace_record_t *record;
+    bool state;
+
+    if(_inputtraceMode == INPUTTRACE_RECORD)
+    {
+        CRITICAL_ENTER(state);
+
+        if(_inputtraceBuffer->count < _inputtraceCapacity)
+        {
+            record = (inputtrace_record_t *)(_inputtraceBuffer + 1) + _inputtraceBuffer->count;
+            record->time = CYCLES_NOW();
+            record->kind = INPUTTRACE_KIND_CALLBACK;
+            record->id = which_button;
+            record->in = 0;
+            record->ifg = 0;
+            _inputtraceBuffer->count++;
+        }
+
+        CRITICAL_EXIT(state);
+    }
+
+    else if(_inputtraceMode == INPUTTRACE_REPLAY)
+    {
+        _inputtraceResult->callbacks++;
+
+        /* Its record may come after further port records: kept until the replay reaches it */
+        if(_inputtracePendingCount == INPUTTRACE_PENDING)
+        {
+            _inputtraceDiverge(_inputtraceIndex);
+        }
+
+        else
+        {
+            _inputtracePending[(_inputtracePendingHead + _inputtracePendingCount) % INPUTTRACE_PENDING].index = _inputtraceIndex;
+            _inputtracePending[(_inputtracePendingHead + _inputtracePendingCount) % INPUTTRACE_PENDING].button = which_button;
+            _inputtracePendingCount++;
+        }
+    }
+}
+
+int inputtraceReplay(const inputtrace_header_t *trace, inputtrace_result_t *result)
+{
+    const inputtrace_record_t *records;
+    uint32_t i, start, cycles, previous, gap;
+    bool state;
+
+    if(trace == 0 || result == 0 || trace->magic != INPUTTRACE_MAGIC
+       || trace->record_size != sizeof(inputtrace_record_t) || _inputtraceMode != INPUTTRACE_IDLE)
+        return -1;
+
+    records = (const inputtrace_record_t *)(trace + 1);
+
+    result->events = 0;
+    result->callbacks = 0;
+    result->divergences = 0;
+    result->first_divergence = -1;
+    result->cycles_total = 0;
+    result->cycles_min = 0xFFFFFFFF;
+    result->cycles_max = 0;
+    result->events_per_second = 0;
+
+    _inputtraceIndex = 0;
+    _inputtracePendingHead = 0;
+    _inputtracePendingCount = 0;
+    _inputtraceResult = result;
+    _inputtraceMode = INPUTTRACE_REPLAY;
+
+    previous = (trace->count > 0) ? records[0].time : 0;
+    start = CYCLES_NOW();
+    for(i = 0; i < trace->count; i++)
+    {
+        if(records[i].kind != INPUTTRACE_KIND_PORT)
+        {
+            /* The callbacks of the port records replayed so far have run */
+            _inputtraceMatch(i, records[i].id);
+            continue;
+        }
+
+        _inputtraceIndex = i;
+
+        /* The time recorded since the previous port interrupt elapses first, with
+           interrupts enabled, so that the alarms of the modules (holdoffs,
+           debouncing) fall due between the same events as when recording */
+        gap = records[i].time - previous;
+        if(trace->clock_hz != 0)
+            gap = (uint32_t)(((uint64_t)gap * SystemCoreClock) / trace->clock_hz);
+        _inputtraceWait(start, gap);
+        previous = records[i].time;
+
+        /* The real interrupt must not run instead of the direct call */
+        CRITICAL_ENTER(state);
+        start = CYCLES_NOW();
+        if(_inputtraceInject(records[i].id, records[i].in, records[i].ifg) < 0)
+            _inputtraceDiverge(i);
+        deferRun(); //Callbacks deferred by the ISR, PendSV cannot run here
+        cycles = CYCLES_NOW() - start;
+        CRITICAL_EXIT(state);
+
+        result->events++;
+        result->cycles_total += cycles;
+        if(cycles < result->cycles_min)
+            result->cycles_min = cycles;
+        if(cycles > result->cycles_max)
+            result->cycles_max = cycles;
+    }
+
+    /* Callbacks observed that the trace does not hold */
+    while(_inputtracePendingCount > 0)
+    {
+        _inputtraceDiverge(_inputtracePending[_inputtracePendingHead].index);
+        _inputtracePendingHead = (_inputtracePendingHead + 1) % INPUTTRACE_PENDING;
+        _inputtracePendingCount--;
+    }
+
+    _inputtraceMode = INPUTTRACE_IDLE;
+
+    if(result->events == 0)
+        result->cycles_min = 0;
+
+    if(result->cycles_total != 0)
+        result->events_per_second = (uint32_t)(((uint64_t)result->events * SystemCoreClock) / result->cycles_total);
+
+    return result->divergences == 0;
+}
+
+static int _inputtraceInject(int port, uint8_t in, uint8_t ifg)
+{
+    switch(port)
+    {
+    case 1:
+        INPUTTRACE_SET_IN(P1, in);
+        P1->IFG = P1->IFG | ifg;
+        PORT1_IRQHandler();
+        break;
+    case 2:
+        INPUTTRACE_SET_IN(P2, in);
+        P2->IFG = P2->IFG | ifg;
+        PORT2_IRQHandler();
+        break;
+    case 3:
+        INPUTTRACE_SET_IN(P3, in);
+        P3->IFG = P3->IFG | ifg;
+        PORT3_IRQHandler();
+        break;
+    case 4:
+        INPUTTRACE_SET_IN(P4, in);
+        P4->IFG = P4->IFG | ifg;
+        PORT4_IRQHandler();
+        break;
+    case 5:
+        INPUTTRACE_SET_IN(P5, in);
+        P5->IFG = P5->IFG | ifg;
+        PORT5_IRQHandler();
+        break;
+    case 6:
+        INPUTTRACE_SET_IN(P6, in);
+        P6->IFG = P6->IFG | ifg;
+        PORT6_IRQHandler();
+        break;
+    default:
+        return -1;
+    }
+
+    return 1;
+}
+
+static void _inputtraceDiverge(uint32_t index)
+{
+    if(_inputtraceResult->divergences == 0)
+        _inputtraceResult->first_divergence = index;
+
+    _inputtraceResult->divergences++;
+}
+
+static void _inputtraceMatch(uint32_t index, uint8_t button)
+{
+    /* Recorded callback that did not run */
+    if(_inputtracePendingCount == 0)
+    {
+        _inputtraceDiverge(index);
+        return;
+    }
+
+    if(_inputtracePending[_inputtracePendingHead].button != button)
+        _inputtraceDiverge(index);
+
+    _inputtracePendingHead = (_inputtracePendingHead + 1) % INPUTTRACE_PENDING;
+    _inputtracePendingCount--;
+}
+
+static void _inputtraceWait(uint32_t since, uint32_t cycles)
+{
+    uint32_t elapsed = CYCLES_NOW() - since;
+
+    if(elapsed >= cycles)
+        return;
+
+#ifdef INPUTTRACE_ADVANCE
+    INPUTTRACE_ADVANCE(cycles - elapsed);
+#else
+    while(CYCLES_NOW() - since < cycles);
+#endif
+}
@@ -0,0 +1,129 @@
+/**
+ @file    inputtrace.h
+
+ @brief   Record and replay of the port interrupt activity seen by the button module
+
+ A trace is a @ref inputtrace_header_t followed by fixed-size records. Port records
+ hold the IN and acknowledged IFG values of a port at each port interrupt; callback
+ records hold the button reported to the application, when its callback runs.
+ The callbacks are deferred (see defer.h), so a burst of port interrupts is
+ recorded before the callbacks it raised. All the fields are little endian, as
+ stored by the target.
+
+ The recorder runs on the target and writes into a RAM buffer that can be read with
+ the debugger. The replayer feeds the port records back through the real
+ PORTx_IRQHandler functions and checks the callbacks against the recorded ones,
+ in sequence: each callback record is matched with the oldest callback observed
+ and not matched yet (up to INPUTTRACE_PENDING of them).
+ Before each port record it lets the recorded time elapse (scaled to the current
+ clock), serving the other interrupts, so that time-based behavior such as the
+ holdoffs of the button module is reproduced.
+ On the target only IFG can be written; on the host, with the simulated ports of
+ host/sim.c, defining INPUTTRACE_HOST also restores IN before each interrupt and
+ advances the simulated time instead of spinning (see inputtrace_test.c, which
+ also replays trace files).
+
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+*/
+
+// Do not write above this line (except comments)!
+#ifndef INPUTTRACE_H
+#define INPUTTRACE_H
+
+/* SECTION 1: Included header files required to compile this file  */
+#include <stdint.h>
+
+
+/* SECTION 2: Public macros                                        */
+
+/**
+ @brief Set to 1 to compile the recording hooks into the button module
+ (--define=INPUTTRACE_ENABLED=1 in a debug build configuration); off by default,
+ when nothing is recorded
+*/
+#ifndef INPUTTRACE_ENABLED
+#define INPUTTRACE_ENABLED     0
+#endif
+
+#define INPUTTRACE_MAGIC       0x43525442u //"BTRC"
+#define INPUTTRACE_VERSION     1
+
+#define INPUTTRACE_KIND_PORT      0 //Port interrupt: port (1..6), IN, acknowledged IFG
+#define INPUTTRACE_KIND_CALLBACK  1 //Button callback: button index
+
+
+/* SECTION 3: Public types                                         */
+
+/**
+ @brief Trace file header
+*/
+struct inputtrace_header_s {
+   uint32_t magic;        /**< @ref INPUTTRACE_MAGIC                          */
+   uint16_t version;      /**< @ref INPUTTRACE_VERSION                        */
+   uint16_t record_size;  /**< sizeof(inputtrace_record_t)                    */
+   uint32_t clock_hz;     /**< Frequency of the record timestamps (MCLK)      */
+   uint32_t count;        /**< Number of records following the header         */
+};
+
+/**
+ @brief Short alias "inputtrace_header_t" for the data type "struct inputtrace_header_s"
+*/
+typedef struct inputtrace_header_s inputtrace_header_t;
+
+/**
+ @brief Trace record (8 bytes)
+*/
+struct inputtrace_record_s {
+   uint32_t time;   /**< Cycle counter at the event (wraps around)               */
+   uint8_t  kind;   /**< @ref INPUTTRACE_KIND_PORT or @ref INPUTTRACE_KIND_CALLBACK */
+   uint8_t  id;     /**< Port number (1..6) or button index                      */
+   uint8_t  in;     /**< Port IN register (port records only)                    */
+   uint8_t  ifg;    /**< Acknowledged port flags (port records only)             */
+};
+
+/**
+ @brief Short alias "inputtrace_record_t" for the data type "struct inputtrace_record_s"
+*/
+typedef struct inputtrace_record_s inputtrace_record_t;
+
+/**
+ @brief Outcome of a replay
+*/
+struct inputtrace_result_s {
+   uint32_t events;            /**< Port records replayed                                  */
+   uint32_t callbacks;         /**< Callbacks observed                                     */
+   uint32_t divergences;       /**< Missing, extra or different callbacks                  */
+   int32_t  first_divergence;  /**< Index of the first divergent record, -1 if none        */
+   uint32_t cycles_total;      /**< Cycles spent in the interrupt handlers                 */
+   uint32_t cycles_min;        /**< Cheapest handler invocation                            */
+   uint32_t cycles_max;        /**< Most expensive handler invocation                      */
+   uint32_t events_per_second; /**< Throughput at the current clock                        */
+};
+
+/**
+ @brief Short alias "inputtrace_result_t" for the data type "struct inputtrace_result_s"
+*/
+typedef struct inputtrace_result_s inputtrace_result_t;
+
+
+/* SECTION 4: Public variables :: declarations, extern mandatory   */
+
+
+/* SECTION 5: Public functions :: declarations, extern optional
+   Rule exception (callbacks)  :: declarations, extern recommended */
+
+int inputtraceRecordStart(inputtrace_header_t *trace, uint32_t capacity); //Start recording into a buffer holding a header and capacity records
+
+uint32_t inputtraceRecordStop(void); //Stop recording, returns the number of records stored
+
+int inputtraceReplay(const inputtrace_header_t *trace, inputtrace_result_t *result); //Replay a trace through the port ISRs
+
+void inputtracePort(int port, uint8_t in, uint8_t ifg); //Hook: port interrupt acknowledged
+
+void inputtraceCallback(int which_button); //Hook: callback about to be called for a button
+
+
+#endif //INPUTTRACE_H
+// Do not write below this line!
@@ -0,0 +1,300 @@
+/**
+ @file    inputtrace_test.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Host test and replayer of the input traces
+
+ Built by host/Makefile. Without arguments, bouncing presses of the two
+ interrupt-driven buttons are recorded on the simulated ports, and the trace is
+ replayed after a reset: the callbacks must match, which needs the holdoff
+ alarms of the button module to fall due between the same edges. The same
+ trace with its timestamps squeezed together must diverge instead. Presses of
+ both buttons served by the same interrupt burst record both port interrupts
+ before both callbacks, which the replay must match in sequence.
+
+ With a file argument (a trace read from the target memory, header and
+ records as stored there) the trace is replayed and the result printed:
+   build/inputtrace_test trace.bin
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "inputtrace.h"
+#include "button.h"
+#include "defer.h"
+#include "persist.h"
+#include "systime.h"
+#include "sim.h"
+
+/* The whole file belongs to the host build (see host/Makefile) */
+#ifdef BENCH_HOST
+
+
+/* SECTION 2: Private macros                                       */
+
+#define TEST_CAPACITY  1024  //Records of the trace buffer
+#define TEST_PRESSES   8
+
+/**
+ @brief Storm protection given to BUTTON1 and BUTTON2, whose holdoff swallows the bounces
+*/
+#define TEST_HOLDOFF_MS  20
+#define TEST_RATE_LIMIT  20
+
+
+/* SECTION 3: Private types                                        */
+
+/**
+ @brief Trace buffer, laid out as in the target memory
+*/
+struct test_trace_s {
+   inputtrace_header_t header;
+   inputtrace_record_t records[TEST_CAPACITY];
+};
+
+/**
+ @brief Short alias "test_trace_t" for the data type "struct test_trace_s"
+*/
+typedef struct test_trace_s test_trace_t;
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+static test_trace_t _testTrace;
+static test_trace_t _testSqueezed;
+static uint32_t _testCallbacks [BUTTON_NUM_PINS];   /**< Callbacks of each digital button */
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static void _testStart(int protect); //Reset the simulation and the modules, as after a cold reset, with storm protection if protect
+
+static void _testPress(int port, uint8_t mask, int bounces); //Bouncing press and release of an active-low button
+
+static void _testRecordAndReplay(void);
+
+static void _testBurst(void);
+
+static int _testReplayFile(const char *path); //Replay a trace file, exit status
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+int main(int argc, char *argv[])
+{
+    if(argc > 1)
+        return _testReplayFile(argv[1]);
+
+    _testRecordAndReplay();
+    _testBurst();
+
+    return simReport("inputtrace_test");
+}
+
+void buttonCallback(int which_button)
+{
+    if(which_button >= 0 && which_button < BUTTON_NUM_PINS)
+        _testCallbacks[which_button]++;
+}
+
+static void _testStart(int protect)
+{
+    int i;
+
+    persistInvalidate();
+    simReset();
+    deferInit();
+    systimeInit();
+    buttonsInit();
+    Interrupt_enableMaster();
+
+    if(protect)
+    {
+        buttonStormSet(BUTTON1, TEST_HOLDOFF_MS, TEST_RATE_LIMIT);
+        buttonStormSet(BUTTON2, TEST_HOLDOFF_MS, TEST_RATE_LIMIT);
+    }
+
+    for(i = 0; i < BUTTON_NUM_PINS; i++)
+        _testCallbacks[i] = 0;
+}
+
+static void _testPress(int port, uint8_t mask, int bounces)
+{
+    int i;
+
+    /* Contact bounce well within the holdoff, then held and released */
+    for(i = 0; i < bounces; i++)
+    {
+        simPinSet(port, mask, 0);
+        simAdvanceUs(150);
+        simPinSet(port, mask, 1);
+        simAdvanceUs(150);
+    }
+
+    simPinSet(port, mask, 0);
+    simAdvanceUs(80000);
+    simPinSet(port, mask, 1);
+    simAdvanceUs(120000);
+}
+
+static void _testRecordAndReplay(void)
+{
+    inputtrace_result_t result;
+    uint32_t count, i;
+    uint32_t recorded[BUTTON_NUM_PINS];
+
+    /* Record: BUTTON1 (P1.4) and BUTTON2 (P5.1), with bounces */
+    _testStart(1);
+    SIM_CHECK(inputtraceRecordStart(&_testTrace.header, TEST_CAPACITY) == 1);
+    for(i = 0; i < TEST_PRESSES; i++)
+        _testPress((i & 1) ? 5 : 1, (i & 1) ? BIT1 : BIT4, 3);
+    count = inputtraceRecordStop();
+
+    for(i = 0; i < BUTTON_NUM_PINS; i++)
+        recorded[i] = _testCallbacks[i];
+
+    /* The bounces fall in the holdoff: one port record and one callback per press */
+    SIM_CHECK(count == 2 * TEST_PRESSES);
+    SIM_CHECK(recorded[BUTTON1] == TEST_PRESSES / 2 && recorded[BUTTON2] == TEST_PRESSES / 2);
+    SIM_CHECK(_testTrace.header.clock_hz == SystemCoreClock);
+
+    /* Replay after a reset: same callbacks, in the same order */
+    _testStart(1);
+    SIM_CHECK(inputtraceReplay(&_testTrace.header, &result) == 1);
+    SIM_CHECK(result.divergences == 0 && result.first_divergence == -1);
+    SIM_CHECK(result.callbacks == TEST_PRESSES);
+    SIM_CHECK(_testCallbacks[BUTTON1] == recorded[BUTTON1] && _testCallbacks[BUTTON2] == recorded[BUTTON2]);
+    SIM_CHECK(result.cycles_min <= result.cycles_max && result.cycles_total > 0);
+
+    /* At twice the recording clock: the gaps are scaled, same outcome */
+    _testStart(1);
+    CS_setDCOCenteredFrequency(CS_DCO_FREQUENCY_24);
+    SystemCoreClockUpdate();
+    SIM_CHECK(inputtraceReplay(&_testTrace.header, &result) == 1);
+    SIM_CHECK(result.divergences == 0);
+
+    /* The same events without the time between them: the holdoffs swallow presses */
+    _testSqueezed = _testTrace;
+    for(i = 0; i < count; i++)
+        _testSqueezed.records[i].time = _testTrace.records[0].time + i;
+
+    _testStart(1);
+    SIM_CHECK(inputtraceReplay(&_testSqueezed.header, &result) == 0);
+    SIM_CHECK(result.divergences > 0 && result.callbacks < TEST_PRESSES);
+
+    /* Invalid traces */
+    _testSqueezed.header.magic = 0;
+    SIM_CHECK(inputtraceReplay(&_testSqueezed.header, &result) == -1);
+    SIM_CHECK(inputtraceReplay(0, &result) == -1);
+}
+
+static void _testBurst(void)
+{
+    inputtrace_result_t result;
+    inputtrace_record_t swap;
+    const inputtrace_record_t *records = _testTrace.records;
+    uint32_t count;
+
+    /* Both edges pending together: the port ISRs run before the deferred callbacks */
+    _testStart(0);
+    SIM_CHECK(inputtraceRecordStart(&_testTrace.header, TEST_CAPACITY) == 1);
+    Interrupt_disableMaster();
+    simPinSet(1, BIT4, 0);
+    simPinSet(5, BIT1, 0);
+    Interrupt_enableMaster();
+    simAdvanceUs(1000);
+    simPinSet(1, BIT4, 1);
+    simPinSet(5, BIT1, 1);
+    simAdvanceUs(1000);
+    count = inputtraceRecordStop();
+
+    SIM_CHECK(count == 4);
+    SIM_CHECK(records[0].kind == INPUTTRACE_KIND_PORT && records[1].kind == INPUTTRACE_KIND_PORT);
+    SIM_CHECK(records[2].kind == INPUTTRACE_KIND_CALLBACK && records[2].id == BUTTON1);
+    SIM_CHECK(records[3].kind == INPUTTRACE_KIND_CALLBACK && records[3].id == BUTTON2);
+
+    /* Each callback record matches the callback of its own port record */
+    _testStart(0);
+    SIM_CHECK(inputtraceReplay(&_testTrace.header, &result) == 1);
+    SIM_CHECK(result.events == 2 && result.callbacks == 2 && result.divergences == 0);
+
+    /* Callbacks recorded in the other order */
+    swap = _testTrace.records[2];
+    _testTrace.records[2] = _testTrace.records[3];
+    _testTrace.records[3] = swap;
+    _testStart(0);
+    SIM_CHECK(inputtraceReplay(&_testTrace.header, &result) == 0);
+    SIM_CHECK(result.divergences == 2 && result.first_divergence == 2);
+
+    _testTrace.records[3] = _testTrace.records[2];
+    _testTrace.records[2] = swap;
+
+    /* A callback the trace does not hold: reported at the port record that raised it */
+    _testTrace.header.count = 3;
+    _testStart(0);
+    SIM_CHECK(inputtraceReplay(&_testTrace.header, &result) == 0);
+    SIM_CHECK(result.divergences == 1 && result.first_divergence == 1);
+
+    /* A recorded callback that does not run: the second port record raises nothing */
+    _testTrace.header.count = 4;
+    _testTrace.records[1].ifg = 0;
+    _testStart(0);
+    SIM_CHECK(inputtraceReplay(&_testTrace.header, &result) == 0);
+    SIM_CHECK(result.divergences == 1 && result.first_divergence == 3);
+}
+
+static int _testReplayFile(const char *path)
+{
+    inputtrace_result_t result;
+    FILE *file;
+    size_t size;
+    int outcome;
+
+    file = fopen(path, "rb");
+    if(file == 0)
+    {
+        printf("inputtrace_test: cannot open %s\n", path);
+        return 2;
+    }
+
+    size = fread(&_testTrace, 1, sizeof(_testTrace), file);
+    fclose(file);
+
+    if(size < sizeof(inputtrace_header_t)
+       || _testTrace.header.count > (size - sizeof(inputtrace_header_t)) / sizeof(inputtrace_record_t))
+    {
+        printf("inputtrace_test: %s is truncated or larger than %d records\n", path, TEST_CAPACITY);
+        return 2;
+    }
+
+    /* Default settings of the target: no storm protection */
+    _testStart(0);
+    outcome = inputtraceReplay(&_testTrace.header, &result);
+    if(outcome < 0)
+    {
+        printf("inputtrace_test: %s is not a trace of this version\n", path);
+        return 2;
+    }
+
+    printf("events %u, callbacks %u, divergences %u (first at record %d)\n",
+           (unsigned)result.events, (unsigned)result.callbacks,
+           (unsigned)result.divergences, (int)result.first_divergence);
+    printf("handler cycles: total %u, min %u, max %u, %u events/s at %u Hz\n",
+           (unsigned)result.cycles_total, (unsigned)result.cycles_min, (unsigned)result.cycles_max,
+           (unsigned)result.events_per_second, (unsigned)SystemCoreClock);
+
+    return outcome == 1 ? 0 : 1;
+}
+
+#endif //BENCH_HOST
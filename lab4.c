@@ -9,29 +9,98 @@
 #include <ti/devices/msp432p4xx/driverlib/driverlib.h>
 #include "led.h"
 #include "button.h"
+#include "systime.h"
+#include "bootprof.h"
+#include "energy.h"
+#include "defer.h"
+#include "ladder.h"
+#include "captouch.h"
+#include "delay.h"
+#include "trace.h"
+#include "encoder.h"
+#include "strip.h"
+#include "binding.h"
+#include "expander.h"
+#include "profile.h"
+#include "rtos.h"
+#include "cpuload.h"
 
-/** @todo
- Add the definition of button module callback function (buttonCallback) in order
- to incorporate the application reaction to interrupt-driven buttons BUTTON1 and BUTTON2
+/* The benchmark build (see bench.h) has its own main function */
+#ifndef BENCHMARK_BUILD
+
+/**
+ The application reaction to the interrupt-driven buttons BUTTON1 and BUTTON2 is
+ bound to the LEDs, and applied by the port ISR once the bindings are compiled
+ */
+
+static const binding_rule_t _bindings [] = {
+     { .button = BUTTON1, .event = BUTTON_EVENT_PRESS, .led = LED2_RED,   .action = BINDING_ACTION_TOGGLE },
+     { .button = BUTTON2, .event = BUTTON_EVENT_PRESS, .led = LED2_GREEN, .action = BINDING_ACTION_TOGGLE },
+     { .button = BUTTON2, .event = BUTTON_EVENT_PRESS, .led = LED2_BLUE,  .action = BINDING_ACTION_TOGGLE }
+};
+
+/**
+ Period of the superloop: in between it sleeps (delayMs, through powerSleep),
+ so that the idle time shows in cpuloadGet
  */
+#define LAB4_POLL_MS  10
+
+static void _superloop(void *arg); //Application loop, a task in the RTOS build
 
 int main(void) {
-    volatile uint32_t i;
-    int n, l, res;
+    int n, l;
+
+    bootprofStamp(BOOT_STAGE_MAIN);
 
     /* Stop Watchdog  */
     MAP_WDT_A_holdTimer();
 
-   	/* Initialize the led and button modules */
+   	/* Initialize the time base, the led and button modules */
+    deferInit();
+#ifdef RTOS_BUILD
+    rtosInit();
+#endif
+    traceInit();
+    systimeInit();
+    cpuloadInit();
+    energyInit();
     ledsInit();
+    bootprofStamp(BOOT_STAGE_LEDS);
     buttonsInit();
+    ladderInit();
+    captouchInit();
+    encodersInit();
+    expandersInit();
+    stripInit();
+    bindingsInit(_bindings, sizeof(_bindings) / sizeof(binding_rule_t));
+    profileInit();
+    bootprofStamp(BOOT_STAGE_BUTTONS);
 	
 	/* Enable interrupts in the application  */
 	Interrupt_enableMaster();
+	bootprofStamp(BOOT_STAGE_READY);
+
+#if PROFILE_AT_BOOT
+	/* Sample where the CPU time goes, see tools/profile_symbolize.py */
+	profileStart(PROFILE_DEFAULT_HZ);
+#endif
+
+#ifdef RTOS_BUILD
+	rtosRun(_superloop);
+#else
+	_superloop(0);
+#endif
+}
+
+static void _superloop(void *arg) {
+    int res;
    	
 	/* Superloop: react to polling-based buttons */
     while (1)
     {
+		/* Send the trace records written since the last pass, if the UART is free */
+		traceDrain();
+
 		res = buttonState(BUTTON0);
 		if (res < 0) {
 			while(1);
@@ -51,26 +120,17 @@ int main(void) {
 				ledToggle(LED1_RED);
 				ledToggle(LED1_GREEN);
 				ledToggle(LED1_BLUE);
-				for (i = 20000; i > 0; i--);
+				delayMs(20);
 				res = buttonPressed(BUTTON3);
 				if (res < 0) {
 					while(1);
 				}
 			} while (res == 0);
 		}
-    }
-}
 
-void buttonCallback(int which_button)
-{
-    if(which_button == 1)
-    {
-        ledToggle(LED2_RED);
-    }
-
-    else if(which_button == 2)
-    {
-        ledToggle(LED2_GREEN);
-        ledToggle(LED2_BLUE);
+		/* Nothing to do until the next poll */
+		delayMs(LAB4_POLL_MS);
     }
 }
+
+#endif //BENCHMARK_BUILD
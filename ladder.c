@@ -0,0 +1,238 @@
+/**
+ @file    ladder.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Resistor-ladder buttons sampled by ADC14 through DMA
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "ladder.h"
+#include "button.h"
+#include "dma.h"
+
+
+/* SECTION 2: Private macros                                       */
+
+/**
+ @brief Number of entries in the @sa _ladderRefs array
+ @note This value is automatically calculated , do not edit. It must not exceed
+ the DMA arbitration size (8), so that one request moves the whole sequence
+*/
+#define NUM_LADDERS (sizeof(_ladderRefs) / sizeof(analog_ref_t))
+
+/**
+ @brief Compile-time check: the ladder buttons must be virtual buttons
+*/
+typedef char _ladderButtonsCheck [(LADDER_FIRST_BUTTON + LADDER_NUM_BUTTONS <= BUTTON_VIRTUAL(BUTTON_NUM_VIRTUAL)) ? 1 : -1];
+
+/**
+ @brief DMA channel and trigger source of ADC14
+*/
+#define LADDER_DMA_CHANNEL  7
+#define LADDER_DMA_SOURCE   DMA_CH7_ADC14
+
+/**
+ @brief Decoding table of the ladder on P6.0: 0, 1/4, 1/2 and 3/4 of AVCC when pressed,
+ AVCC (pull-up) when released, with 14-bit results
+*/
+static const uint16_t _ladderThresholds0 [] = { 2048, 6144, 10240, 14336 };
+
+/**
+@brief Private array of references for the ladders on the board
+*/
+static const analog_ref_t _ladderRefs [] = {
+     { .mask = BIT0 , .port_is_odd = 0, .even = P6 , // P6 .0 (A15)
+       .adc_input = 15,
+       .first_button = LADDER_FIRST_BUTTON ,          // All the ladder buttons
+       .num_buttons = LADDER_NUM_BUTTONS ,
+       .thresholds = _ladderThresholds0
+     }
+};
+
+
+/* SECTION 3: Private types                                        */
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+/**
+ @brief Sample buffers: one is written by the DMA while the other is decoded
+*/
+static uint16_t _ladderSamples [2][NUM_LADDERS];
+
+static uint8_t _ladderFilling = 0;              /**< Buffer being written by the DMA */
+
+static volatile uint32_t _ladderSequences = 0;  /**< Sequences decoded               */
+
+/**
+ @brief Decoding state of each ladder: 0 when released, k+1 when button k is pressed
+*/
+static uint8_t _ladderCandidate [NUM_LADDERS];  /**< Last decoded state                 */
+static uint8_t _ladderCount [NUM_LADDERS];      /**< Consecutive decodes of the candidate */
+static uint8_t _ladderStable [NUM_LADDERS];     /**< State reported to the button module */
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static int _ladderDecode(const analog_ref_t *ref, uint16_t sample); //State of a ladder (0 or k+1) for a sample
+
+static void _ladderArm(void); //Point the DMA channel at the buffer to fill next
+
+static void _ladderDone(int channel, void *context); //DMA completion: swap buffers and decode
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+void ladderInit(void)
+{
+    int i, k;
+
+    for(i = 0; i < NUM_LADDERS; i++)
+    {
+        /* Start from the state of the buttons, which may survive a warm reset */
+        _ladderStable[i] = 0;
+        for(k = 0; k < _ladderRefs[i].num_buttons; k++)
+        {
+            if(buttonState(_ladderRefs[i].first_button + k) == 1)
+                _ladderStable[i] = k + 1;
+        }
+        _ladderCandidate[i] = _ladderStable[i];
+        _ladderCount[i] = 0;
+
+        /* Tertiary module function: analog input */
+        if(_ladderRefs[i].port_is_odd)
+        {
+            _ladderRefs[i].odd->SEL0 = _ladderRefs[i].odd->SEL0 | _ladderRefs[i].mask;
+            _ladderRefs[i].odd->SEL1 = _ladderRefs[i].odd->SEL1 | _ladderRefs[i].mask;
+        }
+
+        else
+        {
+            _ladderRefs[i].even->SEL0 = _ladderRefs[i].even->SEL0 | _ladderRefs[i].mask;
+            _ladderRefs[i].even->SEL1 = _ladderRefs[i].even->SEL1 | _ladderRefs[i].mask;
+        }
+    }
+
+    /* One conversion memory per ladder, AVCC reference, end of sequence on the last */
+    ADC14->CTL0 = ADC14->CTL0 & ~ADC14_CTL0_ENC;
+    ADC14->CTL0 = ADC14_CTL0_ON | ADC14_CTL0_SHP | ADC14_CTL0_MSC | ADC14_CTL0_CONSEQ_3
+                | ADC14_CTL0_SSEL__ACLK | ADC14_CTL0_SHT0__192;
+    ADC14->CTL1 = ADC14_CTL1_RES__14BIT;
+    ADC14->IER0 = 0;
+
+    for(i = 0; i < NUM_LADDERS; i++)
+    {
+        ADC14->MCTL[i] = ADC14_MCTLN_VRSEL_0 | (_ladderRefs[i].adc_input & ADC14_MCTLN_INCH_MASK);
+    }
+    ADC14->MCTL[NUM_LADDERS-1] = ADC14->MCTL[NUM_LADDERS-1] | ADC14_MCTLN_EOS;
+
+    /* The end of sequence requests one transfer burst of NUM_LADDERS results: the
+       MEM registers are 32 bits apart, the low half of each one is moved */
+    dmaInit();
+    DMA_assignChannel(LADDER_DMA_SOURCE);
+    DMA_disableChannelAttribute(LADDER_DMA_SOURCE, UDMA_ATTR_ALTSELECT | UDMA_ATTR_USEBURST
+                                                 | UDMA_ATTR_HIGH_PRIORITY | UDMA_ATTR_REQMASK);
+    DMA_setChannelControl(UDMA_PRI_SELECT | LADDER_DMA_SOURCE,
+                          UDMA_SIZE_16 | UDMA_SRC_INC_32 | UDMA_DST_INC_16 | UDMA_ARB_8);
+
+    _ladderFilling = 0;
+    _ladderSequences = 0;
+    _ladderArm();
+
+    DMA_clearInterruptFlag(LADDER_DMA_CHANNEL);
+    dmaChannelCallback(LADDER_DMA_CHANNEL, _ladderDone, 0);
+
+    ADC14->CTL0 = ADC14->CTL0 | ADC14_CTL0_ENC | ADC14_CTL0_SC;
+}
+
+int ladderProcess(const uint16_t *samples)
+{
+    const analog_ref_t *ref;
+    int i, decoded, changes;
+
+    if(samples == 0)
+        return -1;
+
+    changes = 0;
+
+    /* One comparison per button at most: bounded by the number of virtual buttons */
+    for(i = 0; i < NUM_LADDERS; i++)
+    {
+        ref = &_ladderRefs[i];
+        decoded = _ladderDecode(ref, samples[i]);
+
+        if(decoded != _ladderCandidate[i])
+        {
+            _ladderCandidate[i] = decoded;
+            _ladderCount[i] = 0;
+        }
+
+        if(_ladderCount[i] < LADDER_DEBOUNCE_SAMPLES)
+            _ladderCount[i]++;
+
+        if(_ladderCount[i] < LADDER_DEBOUNCE_SAMPLES || decoded == _ladderStable[i])
+            continue;
+
+        /* A ladder sees one button at a time: release the old one, then press the new one */
+        if(_ladderStable[i] != 0)
+            buttonReportState(ref->first_button + _ladderStable[i] - 1, 0);
+
+        if(decoded != 0)
+            buttonReportState(ref->first_button + decoded - 1, 1);
+
+        _ladderStable[i] = decoded;
+        changes++;
+    }
+
+    return changes;
+}
+
+uint32_t ladderSequences(void)
+{
+    return _ladderSequences;
+}
+
+static int _ladderDecode(const analog_ref_t *ref, uint16_t sample)
+{
+    int k;
+
+    for(k = 0; k < ref->num_buttons; k++)
+    {
+        if(sample < ref->thresholds[k])
+            return k + 1;
+    }
+
+    return 0;
+}
+
+static void _ladderArm(void)
+{
+    DMA_setChannelTransfer(UDMA_PRI_SELECT | LADDER_DMA_SOURCE, UDMA_MODE_BASIC,
+                           (void *)&ADC14->MEM[0], _ladderSamples[_ladderFilling], NUM_LADDERS);
+    DMA_enableChannel(LADDER_DMA_CHANNEL);
+}
+
+static void _ladderDone(int channel, void *context)
+{
+    uint8_t full;
+
+    /* Re-arm first: the next end of sequence is one full sequence away */
+    full = _ladderFilling;
+    _ladderFilling = full ^ 1;
+    _ladderArm();
+
+    _ladderSequences++;
+    ladderProcess(_ladderSamples[full]);
+}
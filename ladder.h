@@ -0,0 +1,61 @@
+/**
+ @file    ladder.h
+
+ @brief   Resistor-ladder buttons sampled by ADC14 through DMA
+
+ Every ladder pin is converted by ADC14 in repeat-sequence mode, clocked from
+ ACLK so that the sequence repeats on its own. At the end of each sequence the
+ DMA copies the conversion results into one of two RAM buffers; the DMA
+ completion only swaps the buffers and decodes the full one, so no CPU time is
+ spent per conversion. Decoded presses and releases are reported as the
+ virtual buttons of the button module.
+
+ With one ladder a sequence takes 192 + 16 ACLK cycles (about 160 per second);
+ each additional ladder makes it that much longer.
+
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+*/
+
+// Do not write above this line (except comments)!
+#ifndef LADDER_H
+#define LADDER_H
+
+/* SECTION 1: Included header files required to compile this file  */
+#include <stdint.h>
+#include "button.h"
+
+
+/* SECTION 2: Public macros                                        */
+
+/**
+ @brief Consecutive equal decodes needed to accept a new ladder state
+*/
+#define LADDER_DEBOUNCE_SAMPLES  3
+
+/**
+ @brief Virtual buttons reported by the ladder on P6.0, in increasing voltage order
+*/
+#define LADDER_FIRST_BUTTON  BUTTON_VIRTUAL(0)
+#define LADDER_NUM_BUTTONS   4
+
+
+/* SECTION 3: Public types                                         */
+
+
+/* SECTION 4: Public variables :: declarations, extern mandatory   */
+
+
+/* SECTION 5: Public functions :: declarations, extern optional
+   Rule exception (callbacks)  :: declarations, extern recommended */
+
+void ladderInit(void); //Initialization function, starts the sampling (call after buttonsInit)
+
+int ladderProcess(const uint16_t *samples); //Decode one sample per ladder and report the changes, returns how many ladders changed
+
+uint32_t ladderSequences(void); //Number of sample sequences decoded since ladderInit
+
+
+#endif //LADDER_H
+// Do not write below this line!
@@ -0,0 +1,174 @@
+/**
+ @file    ladder_test.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Host test of the resistor ladder decoder
+
+ Built by host/Makefile. Conversion results are placed in the ADC14 memory
+ registers and moved by the simulated DMA channel at each end of sequence, as
+ on the target; the test follows traces of samples through the decoding
+ thresholds and the debouncing to the virtual buttons.
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "ladder.h"
+#include "button.h"
+#include "defer.h"
+#include "persist.h"
+#include "systime.h"
+#include "sim.h"
+
+/* The whole file belongs to the host build (see host/Makefile) */
+#ifdef BENCH_HOST
+
+
+/* SECTION 2: Private macros                                       */
+
+#define TEST_DMA_CHANNEL  7         //Channel of ADC14 (see ladder.c)
+#define TEST_RELEASED     16383     //Full scale: pull-up, no button pressed
+#define TEST_BUTTON(k)    (LADDER_FIRST_BUTTON + (k))  //Button k of the ladder
+
+
+/* SECTION 3: Private types                                        */
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static void _testStart(void); //Reset the simulation and the modules, as after a cold reset
+
+static void _testSequence(uint16_t sample, int times); //End of some sequences converting a sample
+
+static int _testPressed(void); //Ladder button pressed (TEST_BUTTON(k)), -1 if none, -2 if several
+
+static void _testDma(void);
+
+static void _testDebounce(void);
+
+static void _testThresholds(void);
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+int main(void)
+{
+    _testDma();
+    _testDebounce();
+    _testThresholds();
+
+    return simReport("ladder_test");
+}
+
+static void _testStart(void)
+{
+    persistInvalidate();
+    simReset();
+    deferInit();
+    systimeInit();
+    buttonsInit();
+    ladderInit();
+    Interrupt_enableMaster();
+}
+
+static void _testSequence(uint16_t sample, int times)
+{
+    while(times-- > 0)
+    {
+        ADC14->MEM[0] = sample;
+        simDmaRequest(TEST_DMA_CHANNEL);
+    }
+}
+
+static int _testPressed(void)
+{
+    int k, pressed = -1;
+
+    for(k = TEST_BUTTON(0); k < TEST_BUTTON(LADDER_NUM_BUTTONS); k++)
+    {
+        if(buttonState(k) == 1)
+            pressed = (pressed == -1) ? k : -2;
+    }
+
+    return pressed;
+}
+
+static void _testDma(void)
+{
+    uint32_t control;
+
+    _testStart();
+
+    /* 16-bit items from MEM registers 32 bits apart into a packed buffer */
+    control = simDmaControl(TEST_DMA_CHANNEL, 0);
+    SIM_CHECK((control & (UDMA_SIZE_16 | UDMA_SIZE_32)) == UDMA_SIZE_16);
+    SIM_CHECK((control & UDMA_SRC_INC_NONE) == UDMA_SRC_INC_32);
+    SIM_CHECK((control & UDMA_DST_INC_NONE) == UDMA_DST_INC_16);
+
+    /* Each end of sequence is one burst, decoded and re-armed */
+    _testSequence(TEST_RELEASED, 5);
+    SIM_CHECK(ladderSequences() == 5);
+    SIM_CHECK(simIsrCount(INT_DMA_INT0) == 5);
+    SIM_CHECK(_testPressed() == -1);
+}
+
+static void _testDebounce(void)
+{
+    _testStart();
+
+    /* Accepted after LADDER_DEBOUNCE_SAMPLES equal decodes */
+    _testSequence(4000, LADDER_DEBOUNCE_SAMPLES - 1);
+    SIM_CHECK(_testPressed() == -1);
+    _testSequence(4000, 1);
+    SIM_CHECK(_testPressed() == TEST_BUTTON(1));
+
+    /* A single different sample restarts the count */
+    _testSequence(9000, 1);
+    _testSequence(4000, 1);
+    _testSequence(9000, LADDER_DEBOUNCE_SAMPLES - 1);
+    SIM_CHECK(_testPressed() == TEST_BUTTON(1));
+
+    /* Sliding to another button: the old one is released as the new one is pressed */
+    _testSequence(9000, 1);
+    SIM_CHECK(_testPressed() == TEST_BUTTON(2));
+
+    /* Noise around the released level does not press anything */
+    _testSequence(TEST_RELEASED, LADDER_DEBOUNCE_SAMPLES);
+    _testSequence(15000, 2);
+    _testSequence(1000, 2);
+    _testSequence(15000, 2);
+    SIM_CHECK(_testPressed() == -1);
+
+    SIM_CHECK(ladderProcess(0) == -1);
+}
+
+static void _testThresholds(void)
+{
+    static const uint16_t samples [] = { 0, 2047, 2048, 6143, 6144, 10239, 10240, 14335, 14336 };
+    static const int expected [] = { TEST_BUTTON(0), TEST_BUTTON(0), TEST_BUTTON(1), TEST_BUTTON(1), TEST_BUTTON(2), TEST_BUTTON(2), TEST_BUTTON(3), TEST_BUTTON(3), -1 };
+    int i;
+
+    _testStart();
+
+    /* Each side of each threshold */
+    for(i = 0; i < sizeof(samples) / sizeof(samples[0]); i++)
+    {
+        _testSequence(samples[i], LADDER_DEBOUNCE_SAMPLES);
+        SIM_CHECK(_testPressed() == expected[i]);
+    }
+}
+
+#endif //BENCH_HOST
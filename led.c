@@ -11,6 +11,12 @@
 /* SECTION 1: Included header files to compile this file           */
 #include "common.h"
 #include "led.h"
+#include "energy.h"
+#include "systime.h"
+#include "persist.h"
+#include "defer.h"
+#include "trace.h"
+#include "shiftreg.h"
 
 
 /* SECTION 2: Private macros                                       */
@@ -20,6 +26,32 @@
 */
 #define NUM_LEDS (sizeof(_ledPinRefs)/sizeof(output_ref_t))
 
+/**
+ @brief LEDs on the shift register chain, after the ones on pins (LED index NUM_LEDS is output 0)
+*/
+#if LED_SHIFTREG
+#define NUM_CHAIN_LEDS SHIFTREG_NUM_OUTPUTS
+#else
+#define NUM_CHAIN_LEDS 0
+#endif
+
+/**
+ @brief Timer driving the blinking LEDs, in up mode from ACLK/8 (4096 Hz): CCR0 sets the
+ period shared by all of them, CCR1 to CCR4 the on time of each one
+ @remark Its outputs reach the LEDs through the port mapping controller
+*/
+#define LED_BLINK_TIMER  TIMER_A1
+#define LED_BLINK_HZ     4096
+#define LED_BLINK_CCRS   5
+
+/**
+ @brief Pin of a port output written through its bit-band alias
+ @remark Host builds simulate the ports in plain memory, without alias
+*/
+#if LED_BITBAND && !defined(BENCH_HOST)
+#define LED_BITBAND_WRITE(out, pin, value)  (BITBAND_PERI((out), (pin)) = (value))
+#endif
+
 
 /* SECTION 3: Private types                                        */
 
@@ -38,7 +70,7 @@
  accommodate a different number of LEDs in the board, 
  or LEDs located at different pins/ports.
 */
-static output_ref_t _ledPinRefs [] = {
+static const output_ref_t _ledPinRefs [] = {
                                       {. mask = BIT0 , . port_is_odd = 1, .odd = P1}, // LED0 P1 .0
                                       {. mask = BIT0 , . port_is_odd = 0, . even = P2}, // LED1_RED P2 .0
                                       {. mask = BIT1 , . port_is_odd = 0, . even = P2}, // LED1_GREEN P2 .1
@@ -48,14 +80,122 @@ static output_ref_t _ledPinRefs [] = {
                                       {. mask = BIT6 , . port_is_odd = 1, .odd = P5} // LED2_BLUE P5 .6
 };
 
+/**
+ @brief Compile-time check: LED_NUM_PINS (led.h) must count the entries of @ref _ledPinRefs
+*/
+typedef char _ledNumPinsCheck [(NUM_LEDS == LED_NUM_PINS) ? 1 : -1];
+
+/**
+ @brief Private array of the ports used by the LEDs, built by @ref ledsInit
+ @remark The mask of each entry contains all the LED pins of that port
+*/
+static output_ref_t _ledPorts [NUM_LEDS];
+
+/**
+ @brief Number of valid entries in @ref _ledPorts
+*/
+static uint8_t _ledNumPorts = 0;
+
+/**
+ @brief Index in @ref _ledPorts of the port of each LED
+*/
+static uint8_t _ledPortOf [NUM_LEDS];
+
+/**
+ @brief Shadow frame: requested state of the LED pins of each port in @ref _ledPorts
+*/
+static uint8_t _ledFrame [NUM_LEDS];
+
+/**
+ @brief State of the LED pins of each port last written to the hardware
+*/
+static uint8_t _ledCommitted [NUM_LEDS];
+
+/**
+ @brief Pins of each port written since the bookkeeping (persistence, energy) last ran,
+ and flag (0/1) of the bookkeeping being posted to the deferred work
+*/
+static volatile uint8_t _ledChanged [NUM_LEDS];
+static volatile uint8_t _ledAccountPosted = 0;
+
+/**
+ @brief Flag (0/1): changes stay in the shadow frame until @ref ledCommit
+*/
+static uint8_t _ledDeferred = 0;
+
+/**
+ @brief Flag (0/1): the chain image changed in deferred mode, sent by @ref ledCommit
+*/
+static volatile uint8_t _ledChainPending = 0;
+
+/**
+ @brief Period of the automatic commit, in ticks (0 if disabled)
+*/
+static systime_t _ledCommitPeriod = 0;
+
+/**
+ @brief Deadline of the next automatic commit
+*/
+static systime_t _ledCommitNext = 0;
+
+/**
+ @brief Alarm used for the automatic commit
+*/
+static systime_alarm_t _ledCommitAlarm;
+
+/**
+ @brief Channel of @ref LED_BLINK_TIMER blinking each LED (0 if none)
+*/
+static uint8_t _ledBlinkCcr [NUM_LEDS];
+
+/**
+ @brief Period of @ref LED_BLINK_TIMER, in timer ticks (0 while stopped)
+*/
+static uint32_t _ledBlinkPeriod = 0;
+
+/**
+ @brief On and off times of the LEDs blinking by timer wakeups, in systime ticks
+ (0 if the LED is not blinking that way)
+*/
+static systime_t _ledBlinkOn [NUM_LEDS];
+static systime_t _ledBlinkOff [NUM_LEDS];
+
+/**
+ @brief Deadline of the next change and alarm of the LEDs blinking by timer wakeups
+*/
+static systime_t _ledBlinkNext [NUM_LEDS];
+static systime_alarm_t _ledBlinkAlarm [NUM_LEDS];
+
 /* SECTION 6: Private functions :: declarations, static mandatory
    Rule exception (ISRs)        :: declarations, no static         */
 
-static void _ledInitOdd(DIO_PORT_Odd_Interruptable_Type *port, uint8_t mask); //Initialization function for a single LED connected to an odd port (P1, P3, etc.)
+static void _ledInitOdd(DIO_PORT_Odd_Interruptable_Type *port, uint8_t mask, uint8_t initial); //Initialization function for the LEDs connected to an odd port (P1, P3, etc.)
+
+static void _ledInitEven(DIO_PORT_Even_Interruptable_Type *port, uint8_t mask, uint8_t initial); //Initialization function for the LEDs connected to an even port (P2, P4, etc.)
+
+static void _ledInit(const output_ref_t *port, uint8_t initial); //Initialization function for the LEDs of a port
+
+static int _ledPortLookup(const output_ref_t *pin); //Find or add the entry of @ref _ledPorts for the port of a pin
+
+static void _ledFlushPort(int port, uint8_t pins); //Write the shadow frame of some pins of a port to the hardware, if it changed
+
+static void _ledAccount(int arg); //Deferred work: save the committed state and account the changed pins
+
+static int _ledUpdate(int which_led, uint8_t set, uint8_t clear, uint8_t toggle); //Change the shadow frame of a LED and flush it unless deferred
+
+static int _ledChainUpdate(int which_led, int action); //Change a LED of the chain image and send it unless deferred
 
-static void _ledInitEven(DIO_PORT_Even_Interruptable_Type *port, uint8_t mask); //Initialization function for a single LED connected to an even port (P2, P4, etc.)
+static void _ledCommitTick(void *context); //Alarm callback of the automatic commit
 
-static void _ledInit(output_ref_t *pin); //Initialization function for a single LED
+static volatile uint8_t *_ledPmapOf(const output_ref_t *pin); //Port mapping registers of the port of a pin, 0 if not mappable
+
+static int _ledBlinkHardware(int which_led, uint32_t ticks, uint32_t duty); //Route a timer output to a LED, -1 if not possible
+
+static void _ledBlinkStop(int which_led); //Stop blinking a LED, which keeps its state in the shadow frame
+
+static void _ledBlinkWrite(int which_led, uint8_t set, uint8_t toggle); //Change a blinking LED and write its pin now, even in deferred mode
+
+static void _ledBlinkTick(void *context); //Alarm callback of the LEDs blinking by timer wakeups
 
 /* SECTION 7: Private functions :: definitions, static mandatory
    Rule exception (ISRs)        :: definitions, no static 
@@ -63,96 +203,550 @@ static void _ledInit(output_ref_t *pin); //Initialization function for a single
    Function definitions (private & public) written in any order    */
 void ledsInit(void)
 {
+    uint8_t saved[NUM_LEDS];
     uint16_t j;
+    int port, warm;
+
+    /* Group the pins per port, so that each register is written once */
+    _ledNumPorts = 0;
     for(j = 0; j < NUM_LEDS; j++)
     {
-        _ledInit( &(_ledPinRefs[j]) );
-        ledOff(j);
+        port = _ledPortLookup( &(_ledPinRefs[j]) );
+        _ledPorts[port].mask = _ledPorts[port].mask | _ledPinRefs[j].mask;
+        _ledPortOf[j] = port;
+    }
+
+    /* Warm reset: the LEDs come back as they were, without going off first */
+    warm = 0;
+#if LED_PERSIST
+    warm = (persistLoad(PERSIST_SLOT_LEDS, saved, _ledNumPorts) > 0);
+#endif
+
+    for(j = 0; j < _ledNumPorts; j++)
+    {
+        _ledFrame[j] = warm ? (saved[j] & _ledPorts[j].mask) : 0;
+        _ledCommitted[j] = _ledFrame[j];
+        _ledChanged[j] = 0;
+        _ledInit( &(_ledPorts[j]) , _ledFrame[j] );
+    }
+    _ledAccountPosted = 0;
+
+#if ENERGY_ACCOUNTING
+    for(j = 0; j < NUM_LEDS && warm; j++)
+    {
+        if(_ledFrame[_ledPortOf[j]] & _ledPinRefs[j].mask)
+            energyLedSet(j, 1);
     }
+#endif
+
+#if LED_SHIFTREG
+    /* The chain is not persisted, it starts off */
+    _ledChainPending = 0;
+    shiftregInit();
+#endif
 }
 
 int ledsGetNum(void)
 {
-    return NUM_LEDS;
+    return NUM_LEDS + NUM_CHAIN_LEDS;
 }
 
 int ledOn(int which_led)
 {
-    if(which_led < 0 || which_led > NUM_LEDS-1)
+    if(which_led < 0 || which_led > NUM_LEDS + NUM_CHAIN_LEDS - 1)
         return -1;
 
+    if(which_led >= NUM_LEDS)
+        return _ledChainUpdate(which_led, SHIFTREG_OP_ON);
 
-    if(_ledPinRefs[which_led].port_is_odd)
-        _ledPinRefs[which_led].odd->OUT =  _ledPinRefs[which_led].odd->OUT | _ledPinRefs[which_led].mask;
+    _ledBlinkStop(which_led);
+    return _ledUpdate(which_led, _ledPinRefs[which_led].mask, 0, 0);
+}
 
-    else
-        _ledPinRefs[which_led].even->OUT =  _ledPinRefs[which_led].even->OUT | _ledPinRefs[which_led].mask;  //in this case it won't be used but in the future it could be
 
-    return 1;
+int ledOff(int which_led) //Switch a LED off
+{
+    if(which_led < 0 || which_led > NUM_LEDS + NUM_CHAIN_LEDS - 1)
+            return -1;
+
+    if(which_led >= NUM_LEDS)
+        return _ledChainUpdate(which_led, SHIFTREG_OP_OFF);
+
+    _ledBlinkStop(which_led);
+    return _ledUpdate(which_led, 0, _ledPinRefs[which_led].mask, 0);
 }
 
+int ledToggle(int which_led) //Toggle a LED
+{
+    if(which_led < 0 || which_led > NUM_LEDS + NUM_CHAIN_LEDS - 1)
+        return -1;
+
+    if(which_led >= NUM_LEDS)
+        return _ledChainUpdate(which_led, SHIFTREG_OP_TOGGLE);
 
-int ledOff(int which_led) //Switch a LED on
+    _ledBlinkStop(which_led);
+    return _ledUpdate(which_led, 0, 0, _ledPinRefs[which_led].mask);
+}
+
+int ledGet(int which_led) //Retrieve the status of a LED
 {
-    if(which_led < 0 || which_led > NUM_LEDS-1)
-            return -1;
+    if(which_led < 0 || which_led > NUM_LEDS + NUM_CHAIN_LEDS - 1)
+        return -1;
 
-    if(_ledPinRefs[which_led].port_is_odd)
-            _ledPinRefs[which_led].odd->OUT =  _ledPinRefs[which_led].odd->OUT & ~(_ledPinRefs[which_led].mask);
+#if LED_SHIFTREG
+    if(which_led >= NUM_LEDS)
+        return shiftregGet(which_led - NUM_LEDS);
+#endif
 
-        else
-            _ledPinRefs[which_led].even->OUT =  _ledPinRefs[which_led].even->OUT & ~(_ledPinRefs[which_led].mask);  //in this case it won't be used but in the future it could be
+    /* The shadow frame holds the requested state, no peripheral read needed */
+    return (_ledFrame[_ledPortOf[which_led]] & _ledPinRefs[which_led].mask) == _ledPinRefs[which_led].mask;
+}
+
+void ledSetDeferred(int enable)
+{
+    _ledDeferred = (enable != 0);
+
+    if(!_ledDeferred)
+        ledCommit();
+}
+
+int ledCommit(void)
+{
+    int port;
+    bool state;
+
+    /* One section per port, so that the interrupts wait for a single flush at most */
+    for(port = 0; port < _ledNumPorts; port++)
+    {
+        CRITICAL_ENTER(state);
+        _ledFlushPort(port, 0xFF);
+        CRITICAL_EXIT(state);
+    }
+
+#if LED_SHIFTREG
+    /* All the chain changes since the last commit in one transfer */
+    if(_ledChainPending)
+    {
+        _ledChainPending = 0;
+        shiftregFlush();
+    }
+#endif
 
     return 1;
 }
 
-int ledToggle(int which_led) //Toggle a LED
+int ledCommitEvery(uint32_t period_ms)
+{
+    _ledCommitPeriod = systimeMsToTicks(period_ms);
+
+    if(_ledCommitPeriod == 0)
+        return systimeAlarmCancel(&_ledCommitAlarm);
+
+    _ledCommitNext = systimeNow() + _ledCommitPeriod;
+    return systimeAlarmStart(&_ledCommitAlarm, _ledCommitNext, _ledCommitTick, 0);
+}
+
+int ledBlink(int which_led, uint32_t period_ms, uint32_t duty)
 {
-    if(which_led < 0 || which_led > NUM_LEDS-1)
+    uint32_t ticks;
+
+    if(which_led < 0 || which_led > NUM_LEDS-1 || duty > 100)
         return -1;
 
-    if(ledGet(which_led))
-        ledOff(which_led);
+    _ledBlinkStop(which_led);
+
+    if(period_ms == 0 || duty == 0)
+        return _ledUpdate(which_led, 0, _ledPinRefs[which_led].mask, 0);
+
+    if(duty == 100)
+        return _ledUpdate(which_led, _ledPinRefs[which_led].mask, 0, 0);
+
+    ticks = (uint32_t)(((uint64_t)period_ms * LED_BLINK_HZ) / 1000);
+    if(ticks >= 2 && ticks <= 0x10000 && _ledBlinkHardware(which_led, ticks, duty) > 0)
+        return 1;
+
+    /* Fallback: the CPU wakes up at each change */
+    _ledBlinkOn[which_led] = systimeMsToTicks(period_ms * duty / 100);
+    _ledBlinkOff[which_led] = systimeMsToTicks(period_ms) - _ledBlinkOn[which_led];
+    if(_ledBlinkOn[which_led] == 0 || _ledBlinkOff[which_led] == 0)
+    {
+        _ledBlinkOn[which_led] = 0;
+        return -1;
+    }
+
+    _ledBlinkWrite(which_led, _ledPinRefs[which_led].mask, 0);
+    _ledBlinkNext[which_led] = systimeNow() + _ledBlinkOn[which_led];
+    systimeAlarmStart(&_ledBlinkAlarm[which_led], _ledBlinkNext[which_led], _ledBlinkTick, (void *)(uintptr_t)which_led);
+
+    return 2;
+}
+
+int ledOpAdd(led_op_t *op, int which_led, int action)
+{
+    uint8_t mask;
 
+    if(op == 0 || which_led < 0 || which_led > NUM_LEDS-1 || action < LED_OP_ON || action > LED_OP_TOGGLE)
+        return -1;
+
+    /* One operation writes a single port */
+    if((op->set | op->clear | op->toggle) != 0 && op->port != _ledPortOf[which_led])
+        return 0;
+
+    mask = _ledPinRefs[which_led].mask;
+    op->port = _ledPortOf[which_led];
+    op->set = (action == LED_OP_ON) ? (op->set | mask) : (op->set & ~mask);
+    op->clear = (action == LED_OP_OFF) ? (op->clear | mask) : (op->clear & ~mask);
+    op->toggle = (action == LED_OP_TOGGLE) ? (op->toggle | mask) : (op->toggle & ~mask);
+
+    return 1;
+}
+
+void ledOpApply(const led_op_t *op)
+{
+    int port = op->port;
+    bool state;
+
+    CRITICAL_ENTER(state);
+
+    /* Written at once, whatever the deferred mode: only the pins of the operation */
+    _ledFrame[port] = ((_ledFrame[port] | op->set) & ~op->clear) ^ op->toggle;
+    _ledFlushPort(port, op->set | op->clear | op->toggle);
+
+    CRITICAL_EXIT(state);
+}
+
+static int _ledUpdate(int which_led, uint8_t set, uint8_t clear, uint8_t toggle)
+{
+    int port;
+    bool state;
+
+    TRACE(TRACE_EV_LED_UPDATE, which_led, set | (clear << 8) | (toggle << 16));
+
+    port = _ledPortOf[which_led];
+
+    CRITICAL_ENTER(state);
+
+    _ledFrame[port] = ((_ledFrame[port] | set) & ~clear) ^ toggle;
+
+    if(!_ledDeferred)
+        _ledFlushPort(port, 0xFF);
+
+    CRITICAL_EXIT(state);
+
+    return 1;
+}
+
+static int _ledChainUpdate(int which_led, int action)
+{
+#if LED_SHIFTREG
+    TRACE(TRACE_EV_LED_UPDATE, which_led, action);
+
+    shiftregSet(which_led - NUM_LEDS, action);
+
+    /* A transfer in progress takes the changes made meanwhile when it ends */
+    if(_ledDeferred)
+        _ledChainPending = 1;
     else
-        ledOn(which_led);
+        shiftregFlush();
 
     return 1;
+#else
+    return -1;
+#endif
 }
 
-int ledGet(int which_led) //Retrieve the status of a LED
+static void _ledFlushPort(int port, uint8_t pins)
+{
+    uint8_t changed;
+#ifdef LED_BITBAND_WRITE
+    int j;
+#endif
+
+    changed = (_ledFrame[port] ^ _ledCommitted[port]) & pins;
+    if(changed == 0)
+        return;
+
+#ifdef LED_BITBAND_WRITE
+    /* A single pin (the usual case) is one store to its bit-band alias */
+    if((changed & (changed - 1)) == 0)
+    {
+        j = 31 - __CLZ(changed);
+        if(_ledPorts[port].port_is_odd)
+            LED_BITBAND_WRITE(_ledPorts[port].odd->OUT, j, (_ledFrame[port] >> j) & 1);
+        else
+            LED_BITBAND_WRITE(_ledPorts[port].even->OUT, j, (_ledFrame[port] >> j) & 1);
+    }
+
+    else
+#endif
+    /* Single read-modify-write of the port for all its pending changes */
+    if(_ledPorts[port].port_is_odd)
+        _ledPorts[port].odd->OUT = (_ledPorts[port].odd->OUT & ~changed) | (_ledFrame[port] & changed);
+
+    else
+        _ledPorts[port].even->OUT = (_ledPorts[port].even->OUT & ~changed) | (_ledFrame[port] & changed);
+
+    _ledCommitted[port] = _ledCommitted[port] ^ changed;
+
+    TRACE(TRACE_EV_LED_FLUSH, port, (_ledFrame[port] << 8) | changed);
+
+#if LED_PERSIST || ENERGY_ACCOUNTING
+    /* The bookkeeping waits for the deferred work, so that a binding applied in an
+       ISR only writes the port; one item covers the flushes made until it runs */
+    _ledChanged[port] = _ledChanged[port] | changed;
+    if(!_ledAccountPosted)
+        _ledAccountPosted = (deferPost(_ledAccount, 0) > 0);
+#endif
+}
+
+static void _ledAccount(int arg)
+{
+    uint8_t changed [NUM_LEDS];
+    uint8_t committed [NUM_LEDS];
+    int port;
+    bool state;
+#if ENERGY_ACCOUNTING
+    int j;
+#endif
+
+    CRITICAL_ENTER(state);
+
+    _ledAccountPosted = 0;
+    for(port = 0; port < _ledNumPorts; port++)
+    {
+        changed[port] = _ledChanged[port];
+        committed[port] = _ledCommitted[port];
+        _ledChanged[port] = 0;
+    }
+
+    CRITICAL_EXIT(state);
+
+#if LED_PERSIST
+    persistStore(PERSIST_SLOT_LEDS, committed, _ledNumPorts);
+#endif
+
+#if ENERGY_ACCOUNTING
+    for(j = 0; j < NUM_LEDS; j++)
+    {
+        if((changed[_ledPortOf[j]] & _ledPinRefs[j].mask) != 0 && _ledBlinkCcr[j] == 0)
+            energyLedSet(j, (committed[_ledPortOf[j]] & _ledPinRefs[j].mask) != 0);
+    }
+#endif
+}
+
+static void _ledCommitTick(void *context)
+{
+    ledCommit();
+
+    /* Re-armed from the previous deadline, so the period does not drift */
+    if(_ledCommitPeriod != 0)
+    {
+        _ledCommitNext = _ledCommitNext + _ledCommitPeriod;
+        systimeAlarmStart(&_ledCommitAlarm, _ledCommitNext, _ledCommitTick, 0);
+    }
+}
+
+
+static volatile uint8_t *_ledPmapOf(const output_ref_t *pin)
+{
+    if(!pin->port_is_odd && pin->even == P2)
+        return (volatile uint8_t *)P2MAP;
+
+    if(pin->port_is_odd && pin->odd == P3)
+        return (volatile uint8_t *)P3MAP;
+
+    if(pin->port_is_odd && pin->odd == P7)
+        return (volatile uint8_t *)P7MAP;
+
+    return 0;
+}
+
+static int _ledBlinkHardware(int which_led, uint32_t ticks, uint32_t duty)
 {
-    if(which_led < 0 || which_led > NUM_LEDS-1)
+    const output_ref_t *pin = &_ledPinRefs[which_led];
+    volatile uint8_t *pmap;
+    uint8_t used, ccr, bit;
+    int j;
+    bool state;
+
+    pmap = _ledPmapOf(pin);
+    if(pmap == 0)
         return -1;
 
-    if(_ledPinRefs[which_led].port_is_odd)
-        return (_ledPinRefs[which_led].odd->OUT & _ledPinRefs[which_led].mask) == _ledPinRefs[which_led].mask;
+    CRITICAL_ENTER(state);
+
+    /* All the channels share the period of the timer */
+    used = 0;
+    for(j = 0; j < NUM_LEDS; j++)
+        used = used | (1 << _ledBlinkCcr[j]);
+
+    if(_ledBlinkPeriod != 0 && _ledBlinkPeriod != ticks)
+    {
+        CRITICAL_EXIT(state);
+        return -1;
+    }
+
+    for(ccr = 1; ccr < LED_BLINK_CCRS && (used & (1 << ccr)) != 0; ccr++);
+    if(ccr == LED_BLINK_CCRS)
+    {
+        CRITICAL_EXIT(state);
+        return -1;
+    }
+
+    if(_ledBlinkPeriod == 0)
+    {
+        LED_BLINK_TIMER->CTL = TIMER_A_CTL_SSEL__ACLK | TIMER_A_CTL_ID__8 | TIMER_A_CTL_MC__STOP | TIMER_A_CTL_CLR;
+        LED_BLINK_TIMER->CCR[0] = ticks - 1;
+        LED_BLINK_TIMER->CTL = TIMER_A_CTL_SSEL__ACLK | TIMER_A_CTL_ID__8 | TIMER_A_CTL_MC__UP;
+        _ledBlinkPeriod = ticks;
+    }
+
+    /* Reset/set: on from the start of the period until the compare value */
+    LED_BLINK_TIMER->CCR[ccr] = ticks * duty / 100;
+    LED_BLINK_TIMER->CCTL[ccr] = TIMER_A_CCTLN_OUTMOD_7;
+    _ledBlinkCcr[which_led] = ccr;
+
+#if ENERGY_ACCOUNTING
+    /* The CPU does not see the changes of the timer output: account its duty */
+    energyLedDuty(which_led, duty);
+#endif
+
+    for (bit=0; (pin->mask >> bit) > 1 ; bit++);
+
+    PMAP->KEYID = PMAP_KEYID_VAL;
+    PMAP->CTL = PMAP->CTL | PMAP_CTL_PRECFG;
+    pmap[bit] = PMAP_TA1CCR1A + ccr - 1;
+    PMAP->KEYID = 0;
+
+    if(pin->port_is_odd)
+    {
+        pin->odd->SEL1 = pin->odd->SEL1 & ~(pin->mask);
+        pin->odd->SEL0 = pin->odd->SEL0 | pin->mask;
+    }
 
     else
-        return (_ledPinRefs[which_led].even->OUT & _ledPinRefs[which_led].mask) == _ledPinRefs[which_led].mask;  //in this case it won't be used but in the future it could be
+    {
+        pin->even->SEL1 = pin->even->SEL1 & ~(pin->mask);
+        pin->even->SEL0 = pin->even->SEL0 | pin->mask;
+    }
+
+    CRITICAL_EXIT(state);
 
+    return 1;
 }
 
+static void _ledBlinkStop(int which_led)
+{
+    const output_ref_t *pin = &_ledPinRefs[which_led];
+    uint8_t ccr;
+    int j;
+    bool state;
+
+    if(_ledBlinkOn[which_led] != 0)
+    {
+        _ledBlinkOn[which_led] = 0;
+        systimeAlarmCancel(&_ledBlinkAlarm[which_led]);
+    }
+
+    ccr = _ledBlinkCcr[which_led];
+    if(ccr == 0)
+        return;
 
-static void _ledInitOdd(DIO_PORT_Odd_Interruptable_Type *port, uint8_t mask) //Initialization function for a single LED connected to an odd port (P1, P3, etc.)
+    CRITICAL_ENTER(state);
+
+    /* Back to the port output, which holds the state of the shadow frame */
+    if(pin->port_is_odd)
+        pin->odd->SEL0 = pin->odd->SEL0 & ~(pin->mask);
+    else
+        pin->even->SEL0 = pin->even->SEL0 & ~(pin->mask);
+
+    LED_BLINK_TIMER->CCTL[ccr] = TIMER_A_CCTLN_OUTMOD_0;
+    _ledBlinkCcr[which_led] = 0;
+
+#if ENERGY_ACCOUNTING
+    energyLedSet(which_led, (_ledCommitted[_ledPortOf[which_led]] & pin->mask) != 0);
+#endif
+
+    for(j = 0; j < NUM_LEDS && _ledBlinkCcr[j] == 0; j++);
+    if(j == NUM_LEDS)
+    {
+        LED_BLINK_TIMER->CTL = TIMER_A_CTL_MC__STOP;
+        _ledBlinkPeriod = 0;
+    }
+
+    CRITICAL_EXIT(state);
+}
+
+static void _ledBlinkWrite(int which_led, uint8_t set, uint8_t toggle)
+{
+    led_op_t op = {0};
+
+    /* The blinking is not held back by the deferred mode: only this pin is written,
+       the other pending changes of the port still wait for the commit */
+    op.port = _ledPortOf[which_led];
+    op.set = set;
+    op.toggle = toggle;
+    ledOpApply(&op);
+}
+
+static void _ledBlinkTick(void *context)
 {
+    int which_led = (int)(uintptr_t)context;
+
+    if(_ledBlinkOn[which_led] == 0)
+        return;
+
+    _ledBlinkWrite(which_led, 0, _ledPinRefs[which_led].mask);
+
+    /* Re-armed from the previous deadline, so the period does not drift */
+    if(ledGet(which_led))
+        _ledBlinkNext[which_led] = _ledBlinkNext[which_led] + _ledBlinkOn[which_led];
+    else
+        _ledBlinkNext[which_led] = _ledBlinkNext[which_led] + _ledBlinkOff[which_led];
+
+    systimeAlarmStart(&_ledBlinkAlarm[which_led], _ledBlinkNext[which_led], _ledBlinkTick, context);
+}
+
+
+static void _ledInitOdd(DIO_PORT_Odd_Interruptable_Type *port, uint8_t mask, uint8_t initial) //Initialization function for the LEDs connected to an odd port (P1, P3, etc.)
+{
+    port->OUT = (port->OUT & ~mask) | (initial & mask); //LEDs in their initial state before the pins become outputs
     port->SEL0 = port->SEL0 & ~mask;
     port->SEL1 = port->SEL1 & ~mask;
     port->DIR = port->DIR | mask;
 }
 
-static void _ledInitEven(DIO_PORT_Even_Interruptable_Type *port, uint8_t mask) //Initialization function for a single LED connected to an even port (P2, P4, etc.)
+static void _ledInitEven(DIO_PORT_Even_Interruptable_Type *port, uint8_t mask, uint8_t initial) //Initialization function for the LEDs connected to an even port (P2, P4, etc.)
 {
+    port->OUT = (port->OUT & ~mask) | (initial & mask); //LEDs in their initial state before the pins become outputs
     port->SEL0 = port->SEL0 & ~mask;
     port->SEL1 = port->SEL1 & ~mask;
     port->DIR = port->DIR | mask;
 }
 
-static void _ledInit(output_ref_t *pin) //Initialization function for a single LED
+static void _ledInit(const output_ref_t *port, uint8_t initial) //Initialization function for the LEDs of a port
 {
-    if(pin->port_is_odd)
-        _ledInitOdd(pin->odd , pin->mask);
+    if(port->port_is_odd)
+        _ledInitOdd(port->odd , port->mask, initial);
 
     else
-        _ledInitEven(pin->even , pin->mask);
+        _ledInitEven(port->even , port->mask, initial);
+}
+
+static int _ledPortLookup(const output_ref_t *pin)
+{
+    int i;
+
+    for(i = 0; i < _ledNumPorts; i++)
+    {
+        if(_ledPorts[i].port_is_odd == pin->port_is_odd && _ledPorts[i].odd == pin->odd)
+            return i;
+    }
+
+    _ledPorts[i].mask = 0;
+    _ledPorts[i].port_is_odd = pin->port_is_odd;
+    _ledPorts[i].odd = pin->odd; //Same storage as the even pointer
+    _ledNumPorts++;
+
+    return i;
 }
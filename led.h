@@ -13,10 +13,27 @@
 #define LED_H
 
 /* SECTION 1: Included header files required to compile this file  */
+#include <stdint.h>
 
 
 /* SECTION 2: Public macros                                        */
 
+/**
+ @brief Set to 1 to keep the committed LED state across warm resets (see persist.h)
+*/
+#define LED_PERSIST 1
+
+/**
+ @brief Set to 1 to drive the LEDs of the shift register chain (see shiftreg.h)
+*/
+#define LED_SHIFTREG 1
+
+/**
+ @brief Set to 1 to write a single changed pin through the bit-band alias of its
+ port output register: one store instead of a read-modify-write, atomic on its own
+*/
+#define LED_BITBAND 1
+
 #define LED0        0
 #define LED1_RED    1
 #define LED1_GREEN  2
@@ -25,9 +42,41 @@
 #define LED2_GREEN  5
 #define LED2_BLUE   6
 
+/**
+ @brief Number of LEDs on pins, the ones above (checked against the pin table of led.c)
+*/
+#define LED_NUM_PINS  7
+
+/**
+ @brief LEDs of the shift register chain (n from 0 to SHIFTREG_NUM_OUTPUTS - 1), after the LEDs on pins
+*/
+#define LED_CHAIN(n)  (LED_NUM_PINS + (n))
+
+#define LED_OP_ON      0
+#define LED_OP_OFF     1
+#define LED_OP_TOGGLE  2
+
 
 /* SECTION 3: Public types                                         */
 
+/**
+ @brief Change of some LEDs of the same port, prepared by @ref ledOpAdd so that
+ @ref ledOpApply writes it with a single access to the port (zero-initialize it first).
+ As for every LED change, saving the state (LED_PERSIST) and accounting its
+ energy follow in the deferred work (see defer.h)
+*/
+struct led_op_s {
+   uint8_t port;    /**< Port of the LEDs (internal index) */
+   uint8_t set;     /**< Pins switched on                  */
+   uint8_t clear;   /**< Pins switched off                 */
+   uint8_t toggle;  /**< Pins toggled                      */
+};
+
+/**
+ @brief Short alias "led_op_t" for the data type "struct led_op_s"
+*/
+typedef struct led_op_s led_op_t;
+
 
 /* SECTION 4: Public variables :: declarations, extern mandatory   */
 
@@ -35,18 +84,30 @@
 /* SECTION 5: Public functions :: declarations, extern optional
    Rule exception (callbacks)  :: declarations, extern recommended */
 
-void ledsInit(void); //Initialization function
+void ledsInit(void); //Initialization function, after deferInit
 
 int ledsGetNum(void); //Retrieve the number of LEDs in the system
 
 int ledOn(int which_led); //Switch a LED on
 
-int ledOff(int which_led); //Switch a LED on
+int ledOff(int which_led); //Switch a LED off
 
 int ledToggle(int which_led); //Toggle a LED
 
 int ledGet(int which_led); //Retrieve the status of a LED
 
+void ledSetDeferred(int enable); //Deferred mode (1): LED changes are kept in a shadow frame until committed
+
+int ledCommit(void); //Write the pending LED changes, at most one write per port
+
+int ledCommitEvery(uint32_t period_ms); //Commit automatically every period (0 to stop)
+
+int ledBlink(int which_led, uint32_t period_ms, uint32_t duty); //Blink a LED on a pin (duty in %, period 0 to stop), 1 if done by a timer output, 2 by timer wakeups (writing the pin at each change, even in deferred mode)
+
+int ledOpAdd(led_op_t *op, int which_led, int action); //Add a LED on a pin to an operation (LED_OP_x), after ledsInit, 0 if it is on another port
+
+void ledOpApply(const led_op_t *op); //Write an operation now, even in deferred mode, callable from any context (not for blinking LEDs)
+
 
 
 #endif //LED_H
@@ -74,6 +74,7 @@ MEMORY
 /*                                                                           */
 /* --heap_size=1024                                                          */
 /* --stack_size=512                                                          */
+/* (stackmonHighWater in stackmon.h reports how much of it is really used) */
 /* --library=rtsv7M4_T_le_eabi.lib                                           */
 
 /* Section allocation in memory */
@@ -82,7 +83,8 @@ SECTIONS
 {
 #ifndef gen_crc_table
     .intvecs:   > 0x00000000
-    .text   :   > MAIN
+    /* __TEXT_START and __TEXT_END bound the range binned by profile.c      */
+    .text   :   > MAIN, RUN_START(__TEXT_START), RUN_END(__TEXT_END)
     .const  :   > MAIN
     .cinit  :   > MAIN
     .pinit  :   > MAIN
@@ -100,7 +102,7 @@ SECTIONS
     .bslArea      : > 0x00202000
 #else
     .intvecs:   > 0x00000000, crc_table(crc_table_for_intvecs)
-    .text   :   > MAIN, crc_table(crc_table_for_text)
+    .text   :   > MAIN, crc_table(crc_table_for_text), RUN_START(__TEXT_START), RUN_END(__TEXT_END)
     .const  :   > MAIN, crc_table(crc_table_for_const)
     .cinit  :   > MAIN, crc_table(crc_table_for_cinit)
     .pinit  :   > MAIN, crc_table(crc_table_for_pinit)
@@ -121,10 +123,17 @@ SECTIONS
 #endif
 
     .vtable :   > 0x20000000
-    .data   :   > SRAM_DATA
-    .bss    :   > SRAM_DATA
-    .sysmem :   > SRAM_DATA
-    .stack  :   > SRAM_DATA (HIGH)
+
+    /* RAM sections are kept contiguous and low, with the stack last, so that */
+    /* SystemInit only needs to enable the SRAM banks up to __STACK_END       */
+    GROUP   :   > SRAM_DATA
+    {
+        .data
+        .bss
+        .TI.noinit
+        .sysmem
+        .stack
+    }
 
 #ifdef  __TI_COMPILER_VERSION__
 #if     __TI_COMPILER_VERSION__ >= 15009000
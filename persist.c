@@ -0,0 +1,136 @@
+/**
+ @file    persist.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Small state records kept across warm resets
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "persist.h"
+
+
+/* SECTION 2: Private macros                                       */
+
+#define PERSIST_MAGIC  0x50455253u //"PERS"
+
+
+/* SECTION 3: Private types                                        */
+
+/**
+ @brief Record stored in a slot
+*/
+struct persist_slot_s {
+   uint32_t magic;                      /**< @ref PERSIST_MAGIC when written     */
+   uint16_t size;                       /**< Bytes of data used                  */
+   uint16_t checksum;                   /**< Fletcher-16 of slot, size and data  */
+   uint8_t  data[PERSIST_SLOT_SIZE];    /**< Record                              */
+};
+
+/**
+ @brief Short alias "persist_slot_t" for the data type "struct persist_slot_s"
+*/
+typedef struct persist_slot_s persist_slot_t;
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+/**
+ @brief Records of every slot
+ @remark Not initialized by .cinit: must survive the reset
+*/
+#pragma NOINIT(_persistSlots)
+#ifdef BENCH_HOST
+__attribute__((section("persist_noinit"))) //Apart on the host, where the tests corrupt it as a power loss would
+#endif
+static persist_slot_t _persistSlots[PERSIST_NUM_SLOTS];
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static uint16_t _persistChecksum(int slot, uint16_t size, const uint8_t *data); //Checksum of a record
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+int persistStore(int slot, const void *data, uint16_t size)
+{
+    persist_slot_t *record;
+    uint16_t i;
+    bool state;
+
+    if(slot < 0 || slot > PERSIST_NUM_SLOTS-1 || data == 0 || size > PERSIST_SLOT_SIZE)
+        return -1;
+
+    record = &_persistSlots[slot];
+
+    /* A reset in the middle leaves a record that fails the checksum */
+    CRITICAL_ENTER(state);
+
+    for(i = 0; i < size; i++)
+        record->data[i] = ((const uint8_t *)data)[i];
+
+    record->size = size;
+    record->checksum = _persistChecksum(slot, size, record->data);
+    record->magic = PERSIST_MAGIC;
+
+    CRITICAL_EXIT(state);
+
+    return 1;
+}
+
+int persistLoad(int slot, void *data, uint16_t size)
+{
+    const persist_slot_t *record;
+    uint16_t i;
+
+    if(slot < 0 || slot > PERSIST_NUM_SLOTS-1 || data == 0 || size > PERSIST_SLOT_SIZE)
+        return -1;
+
+    record = &_persistSlots[slot];
+
+    if(record->magic != PERSIST_MAGIC || record->size != size
+       || record->checksum != _persistChecksum(slot, size, record->data))
+        return 0;
+
+    for(i = 0; i < size; i++)
+        ((uint8_t *)data)[i] = record->data[i];
+
+    return 1;
+}
+
+void persistInvalidate(void)
+{
+    int slot;
+
+    for(slot = 0; slot < PERSIST_NUM_SLOTS; slot++)
+        _persistSlots[slot].magic = 0;
+}
+
+static uint16_t _persistChecksum(int slot, uint16_t size, const uint8_t *data)
+{
+    uint16_t sum1, sum2, i;
+
+    /* The slot and size are part of the sum, so records cannot be swapped */
+    sum1 = (uint16_t)(slot + 1);
+    sum2 = size;
+
+    for(i = 0; i < size; i++)
+    {
+        sum1 = (sum1 + data[i]) % 255;
+        sum2 = (sum2 + sum1) % 255;
+    }
+
+    return (sum2 << 8) | sum1;
+}
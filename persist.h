@@ -0,0 +1,55 @@
+/**
+ @file    persist.h
+
+ @brief   Small state records kept across warm resets
+
+ Each slot lives in a no-init SRAM section, which the C initialization routine
+ leaves alone and which keeps its content through watchdog, software and pin
+ resets. A slot is only restored if its magic number, size and checksum match,
+ so after a power loss (random SRAM content) every load fails and the modules
+ fall back to their cold initialization.
+
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+*/
+
+// Do not write above this line (except comments)!
+#ifndef PERSIST_H
+#define PERSIST_H
+
+/* SECTION 1: Included header files required to compile this file  */
+#include <stdint.h>
+
+
+/* SECTION 2: Public macros                                        */
+
+#define PERSIST_SLOT_LEDS     0 //Committed LED frame (led.c)
+#define PERSIST_SLOT_BUTTONS  1 //State of the virtual buttons (button.c)
+
+#define PERSIST_NUM_SLOTS     2
+
+/**
+ @brief Maximum size of the record stored in a slot, in bytes
+*/
+#define PERSIST_SLOT_SIZE     12
+
+
+/* SECTION 3: Public types                                         */
+
+
+/* SECTION 4: Public variables :: declarations, extern mandatory   */
+
+
+/* SECTION 5: Public functions :: declarations, extern optional
+   Rule exception (callbacks)  :: declarations, extern recommended */
+
+int persistStore(int slot, const void *data, uint16_t size); //Save a record, callable from any context
+
+int persistLoad(int slot, void *data, uint16_t size); //Restore a record: 1 if valid, 0 if not (cold start), -1 if invalid arguments
+
+void persistInvalidate(void); //Discard every record, so that the next reset is a cold one
+
+
+#endif //PERSIST_H
+// Do not write below this line!
@@ -0,0 +1,247 @@
+/**
+ @file    persist_test.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Host test of the records kept across warm resets
+
+ Built by host/Makefile. The host keeps the no-init records in a section of
+ their own (see persist.c), which survives simReset as the SRAM survives a
+ warm reset; the test fills it with random bytes for a power loss and flips
+ single bytes for a reset in the middle of a write. The LED frame and the
+ virtual buttons must come back after a warm reset, and the cold
+ initialization must run whenever a record does not validate.
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "persist.h"
+#include "led.h"
+#include "button.h"
+#include "defer.h"
+#include "systime.h"
+#include "sim.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* The whole file belongs to the host build (see host/Makefile) */
+#ifdef BENCH_HOST
+
+
+/* SECTION 2: Private macros                                       */
+
+#define TEST_POWER_LOSSES  1000  //Random contents of the section tried
+
+
+/* SECTION 3: Private types                                        */
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+extern uint8_t __start_persist_noinit[]; //Bounds of the section, defined by the host linker
+extern uint8_t __stop_persist_noinit[];
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static void _testReset(void); //Reset the simulation and the modules, the records stay (warm reset)
+
+static void _testPowerLoss(void); //Fill the records with random bytes
+
+static void _testRecords(void);
+
+static void _testCorruption(void);
+
+static void _testLeds(void);
+
+static void _testButtons(void);
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+int main(void)
+{
+    srand(39);
+
+    _testRecords();
+    _testCorruption();
+    _testLeds();
+    _testButtons();
+
+    return simReport("persist_test");
+}
+
+static void _testReset(void)
+{
+    simReset();
+    deferInit();
+    systimeInit();
+    buttonsInit();
+    ledsInit();
+    Interrupt_enableMaster();
+}
+
+static void _testPowerLoss(void)
+{
+    uint8_t *p;
+
+    for(p = __start_persist_noinit; p < __stop_persist_noinit; p++)
+        *p = (uint8_t)rand();
+}
+
+static void _testRecords(void)
+{
+    uint8_t data[PERSIST_SLOT_SIZE], read[PERSIST_SLOT_SIZE + 1];
+    int i;
+
+    persistInvalidate();
+    for(i = 0; i < PERSIST_SLOT_SIZE; i++)
+        data[i] = (uint8_t)(3 * i + 1);
+
+    /* Nothing stored yet */
+    SIM_CHECK(persistLoad(PERSIST_SLOT_LEDS, read, 4) == 0);
+
+    /* Stored and read back, sizes from 0 to the maximum */
+    for(i = 0; i <= PERSIST_SLOT_SIZE; i++)
+    {
+        SIM_CHECK(persistStore(PERSIST_SLOT_LEDS, data, i) == 1);
+        memset(read, 0, sizeof(read));
+        SIM_CHECK(persistLoad(PERSIST_SLOT_LEDS, read, i) == 1);
+        SIM_CHECK(memcmp(read, data, i) == 0);
+    }
+
+    /* A record is only read back with its own size, from its own slot */
+    SIM_CHECK(persistLoad(PERSIST_SLOT_LEDS, read, PERSIST_SLOT_SIZE - 1) == 0);
+    SIM_CHECK(persistLoad(PERSIST_SLOT_BUTTONS, read, PERSIST_SLOT_SIZE) == 0);
+
+    /* Discarded */
+    persistInvalidate();
+    SIM_CHECK(persistLoad(PERSIST_SLOT_LEDS, read, PERSIST_SLOT_SIZE) == 0);
+
+    /* Invalid arguments */
+    SIM_CHECK(persistStore(-1, data, 1) == -1);
+    SIM_CHECK(persistStore(PERSIST_NUM_SLOTS, data, 1) == -1);
+    SIM_CHECK(persistStore(PERSIST_SLOT_LEDS, 0, 1) == -1);
+    SIM_CHECK(persistStore(PERSIST_SLOT_LEDS, data, PERSIST_SLOT_SIZE + 1) == -1);
+    SIM_CHECK(persistLoad(PERSIST_NUM_SLOTS, read, 1) == -1);
+    SIM_CHECK(persistLoad(PERSIST_SLOT_LEDS, read, PERSIST_SLOT_SIZE + 1) == -1);
+}
+
+static void _testCorruption(void)
+{
+    uint8_t data[PERSIST_SLOT_SIZE], read[PERSIST_SLOT_SIZE];
+    size_t size, i;
+    int n, bit, loads;
+
+    size = (size_t)(__stop_persist_noinit - __start_persist_noinit);
+    SIM_CHECK(size > 0);
+
+    /* Power loss: random content never validates */
+    loads = 0;
+    for(n = 0; n < TEST_POWER_LOSSES; n++)
+    {
+        _testPowerLoss();
+        loads += (persistLoad(PERSIST_SLOT_LEDS, read, 1) != 0);
+        loads += (persistLoad(PERSIST_SLOT_BUTTONS, read, 8) != 0);
+    }
+    SIM_CHECK(loads == 0);
+
+    /* Any single flipped bit of a record (torn write, SRAM upset) is caught */
+    for(i = 0; i < PERSIST_SLOT_SIZE; i++)
+        data[i] = (uint8_t)rand();
+
+    loads = 0;
+    for(i = 0; i < size; i++)
+    {
+        for(bit = 0; bit < 8; bit++)
+        {
+            persistInvalidate();
+            persistStore(PERSIST_SLOT_LEDS, data, PERSIST_SLOT_SIZE);
+            persistStore(PERSIST_SLOT_BUTTONS, data, PERSIST_SLOT_SIZE);
+
+            __start_persist_noinit[i] ^= (uint8_t)(1 << bit);
+            n = persistLoad(PERSIST_SLOT_LEDS, read, PERSIST_SLOT_SIZE)
+                + persistLoad(PERSIST_SLOT_BUTTONS, read, PERSIST_SLOT_SIZE);
+
+            /* One of the two records is hit, unless the bit is padding */
+            loads += (n == 2);
+            SIM_CHECK(n >= 1);
+        }
+    }
+
+    /* No padding in the records: every bit counts */
+    SIM_CHECK(loads == 0);
+}
+
+static void _testLeds(void)
+{
+    /* Cold start: every LED off */
+    persistInvalidate();
+    _testReset();
+    SIM_CHECK(ledGet(0) == 0 && (P1->OUT & BIT0) == 0 && (P1->DIR & BIT0) != 0);
+
+    ledOn(0);
+    ledOn(3);
+    ledOn(6);
+
+    /* Warm reset: the LEDs come back on, pins driven from the start */
+    _testReset();
+    SIM_CHECK(ledGet(0) == 1 && ledGet(3) == 1 && ledGet(6) == 1);
+    SIM_CHECK(ledGet(1) == 0 && ledGet(2) == 0 && ledGet(4) == 0 && ledGet(5) == 0);
+    SIM_CHECK((P1->OUT & BIT0) != 0 && (P2->OUT & (BIT0 | BIT1 | BIT2 | BIT4 | BIT6)) == BIT2 && (P5->OUT & BIT6) != 0);
+    SIM_CHECK((P1->DIR & BIT0) != 0 && (P2->DIR & BIT2) != 0 && (P5->DIR & BIT6) != 0);
+
+    /* Changes after the reset are kept too */
+    ledOff(3);
+    _testReset();
+    SIM_CHECK(ledGet(0) == 1 && ledGet(3) == 0 && ledGet(6) == 1);
+
+    /* Power loss: back to the cold start */
+    _testPowerLoss();
+    _testReset();
+    SIM_CHECK(ledGet(0) == 0 && ledGet(6) == 0 && (P1->OUT & BIT0) == 0 && (P5->OUT & BIT6) == 0);
+}
+
+static void _testButtons(void)
+{
+    /* Cold start */
+    persistInvalidate();
+    _testReset();
+    SIM_CHECK(buttonState(BUTTON_VIRTUAL(0)) == 0 && buttonPressed(BUTTON_VIRTUAL(0)) == 0);
+
+    /* A press not read yet and a button held down */
+    buttonReportState(BUTTON_VIRTUAL(0), 1);
+    buttonReportState(BUTTON_VIRTUAL(0), 0);
+    buttonReportState(BUTTON_VIRTUAL(1), 1);
+    simServe();
+
+    /* Warm reset: both are still there */
+    _testReset();
+    SIM_CHECK(buttonState(BUTTON_VIRTUAL(0)) == 0 && buttonPressed(BUTTON_VIRTUAL(0)) == 1);
+    SIM_CHECK(buttonState(BUTTON_VIRTUAL(1)) == 1 && buttonPressed(BUTTON_VIRTUAL(1)) == 1);
+    SIM_CHECK(buttonPressed(BUTTON_VIRTUAL(0)) == 0);
+
+    /* The presses read are forgotten with the next change saved */
+    buttonReportState(BUTTON_VIRTUAL(1), 0);
+    _testReset();
+    SIM_CHECK(buttonState(BUTTON_VIRTUAL(1)) == 0 && buttonPressed(BUTTON_VIRTUAL(0)) == 0);
+
+    /* Power loss */
+    buttonReportState(BUTTON_VIRTUAL(2), 1);
+    _testPowerLoss();
+    _testReset();
+    SIM_CHECK(buttonState(BUTTON_VIRTUAL(2)) == 0 && buttonPressed(BUTTON_VIRTUAL(2)) == 0);
+}
+
+#endif //BENCH_HOST
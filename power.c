@@ -0,0 +1,82 @@
+/**
+ @file    power.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   CPU idle path and low-power modes for the msp432p401r Launchpad board
+
+ Every wait of the application should go through @ref powerSleep, so that the
+ time spent in each mode can be accounted for.
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "power.h"
+#include "energy.h"
+#include "cpuload.h"
+
+
+/* SECTION 2: Private macros                                       */
+
+
+/* SECTION 3: Private types                                        */
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+/**
+ @brief Mode the CPU is in, as seen by the idle path
+*/
+static volatile int _powerMode = POWER_MODE_ACTIVE;
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+int powerSleep(int mode)
+{
+    if(mode < POWER_MODE_LPM0 || mode > POWER_NUM_MODES-1)
+        return -1;
+
+    _powerMode = mode;
+#if ENERGY_ACCOUNTING
+    energyCpuMode(mode);
+#endif
+#if CPULOAD_ENABLED
+    cpuloadIdleEnter();
+#endif
+
+    /* The ISR that wakes the CPU up is accounted as part of the sleep time */
+    if(mode == POWER_MODE_LPM3)
+        PCM_gotoLPM3();
+
+    else
+        PCM_gotoLPM0();
+
+#if CPULOAD_ENABLED
+    cpuloadIdleExit();
+#endif
+    _powerMode = POWER_MODE_ACTIVE;
+#if ENERGY_ACCOUNTING
+    energyCpuMode(POWER_MODE_ACTIVE);
+#endif
+
+    return 1;
+}
+
+int powerMode(void)
+{
+    return _powerMode;
+}
@@ -0,0 +1,42 @@
+/**
+ @file    power.h
+
+ @brief   CPU idle path and low-power modes for the msp432p401r Launchpad board
+
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+*/
+
+// Do not write above this line (except comments)!
+#ifndef POWER_H
+#define POWER_H
+
+/* SECTION 1: Included header files required to compile this file  */
+
+
+/* SECTION 2: Public macros                                        */
+
+#define POWER_MODE_ACTIVE  0 //CPU running
+#define POWER_MODE_LPM0    1 //CPU stopped, all clocks running
+#define POWER_MODE_LPM3    2 //CPU stopped, only ACLK (and the systime time base) running
+
+#define POWER_NUM_MODES    3
+
+
+/* SECTION 3: Public types                                         */
+
+
+/* SECTION 4: Public variables :: declarations, extern mandatory   */
+
+
+/* SECTION 5: Public functions :: declarations, extern optional
+   Rule exception (callbacks)  :: declarations, extern recommended */
+
+int powerSleep(int mode); //Idle path: sleep in a low-power mode until the next interrupt
+
+int powerMode(void); //Retrieve the current CPU mode
+
+
+#endif //POWER_H
+// Do not write below this line!
@@ -0,0 +1,247 @@
+/**
+ @file    profile.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Statistical profiler sampling the program counter from a timer interrupt
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "profile.h"
+
+
+/* SECTION 2: Private macros                                       */
+
+/**
+ @brief Sampling timer (MCLK, not divided, periodic) and its priority
+*/
+#define PROFILE_TIMER      TIMER32_1
+#define PROFILE_INT_NUM    INT_T32_INT1
+#define PROFILE_PRIORITY   0x00 //Above every other interrupt, so that they are sampled too
+
+/**
+ @brief Program counter in the exception stack frame (r0-r3, r12, lr, pc, xpsr),
+ at the same place when the FPU registers are stacked as well
+*/
+#define PROFILE_FRAME_PC   6
+
+/**
+ @brief Range of the .text section, defined by the linker command file
+*/
+#ifndef BENCH_HOST
+#define PROFILE_TEXT_START ((uint32_t)&__TEXT_START)
+#define PROFILE_TEXT_END   ((uint32_t)&__TEXT_END)
+#else
+#define PROFILE_TEXT_START 0
+#define PROFILE_TEXT_END   PROFILE_NUM_BINS
+#endif
+
+
+/* SECTION 3: Private types                                        */
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+#ifdef BENCH_HOST
+uint32_t profileHostFrame[8];
+#endif
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+#ifndef BENCH_HOST
+extern uint8_t __TEXT_START;
+extern uint8_t __TEXT_END;
+#endif
+
+static profile_log_t _profileLog;   /**< Histogram, saved by the debugger    */
+static uint32_t _profileSpan = 0;   /**< text_end - text_start, cached       */
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static void _profileClear(void); //Clear the bins and the counters
+
+static void _profileHold(void); //Mask the sampler, which CRITICAL_ENTER leaves running in the RTOS build
+
+static void _profileRelease(void); //Unmask the sampler if sampling
+
+void _profileSample(const uint32_t *frame); //Timer handler body, with the stack frame of the interrupted context
+
+void T32_INT1_IRQHandler(void);
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+void profileInit(void)
+{
+    _profileLog.header.magic = PROFILE_MAGIC;
+    _profileLog.header.version = PROFILE_VERSION;
+    _profileLog.header.num_bins = PROFILE_NUM_BINS;
+
+    profileStop();
+    profileSetRange(PROFILE_TEXT_START, PROFILE_TEXT_END);
+}
+
+int profileSetRange(uint32_t start, uint32_t end)
+{
+    uint32_t shift = 0;
+    bool state;
+
+    if(end <= start)
+        return -1;
+
+    /* Smallest power of two bin that covers the range with the bins available */
+    while(((end - start - 1) >> shift) > PROFILE_NUM_BINS-1)
+        shift++;
+
+    CRITICAL_ENTER(state);
+    _profileHold();
+
+    _profileLog.header.text_start = start;
+    _profileLog.header.text_end = end;
+    _profileLog.header.bin_shift = shift;
+    _profileSpan = end - start;
+    _profileClear();
+
+    _profileRelease();
+    CRITICAL_EXIT(state);
+
+    return shift;
+}
+
+int profileStart(uint32_t rate_hz)
+{
+    if(rate_hz < 1 || rate_hz > PROFILE_MAX_HZ)
+        return -1;
+
+    PROFILE_TIMER->CONTROL = 0;
+    PROFILE_TIMER->INTCLR = 0;
+    PROFILE_TIMER->LOAD = CS_getMCLK() / rate_hz - 1;
+    _profileLog.header.rate_hz = rate_hz;
+
+    Interrupt_setPriority(PROFILE_INT_NUM, PROFILE_PRIORITY);
+    Interrupt_enableInterrupt(PROFILE_INT_NUM);
+
+    PROFILE_TIMER->CONTROL = TIMER32_CONTROL_SIZE | TIMER32_CONTROL_MODE | TIMER32_CONTROL_PRESCALE_0
+                           | TIMER32_CONTROL_IE | TIMER32_CONTROL_ENABLE;
+
+    return 1;
+}
+
+void profileStop(void)
+{
+    PROFILE_TIMER->CONTROL = 0;
+    PROFILE_TIMER->INTCLR = 0;
+    Interrupt_disableInterrupt(PROFILE_INT_NUM);
+
+    _profileLog.header.rate_hz = 0;
+}
+
+void profileReset(void)
+{
+    bool state;
+
+    CRITICAL_ENTER(state);
+    _profileHold();
+    _profileClear();
+    _profileRelease();
+    CRITICAL_EXIT(state);
+}
+
+void profileRecord(uint32_t pc)
+{
+    /* Below the start wraps around to a large offset */
+    uint32_t offset = pc - _profileLog.header.text_start;
+    uint16_t *bin;
+
+    _profileLog.header.samples++;
+
+    if(offset >= _profileSpan)
+    {
+        _profileLog.header.outside++;
+        return;
+    }
+
+    bin = &_profileLog.bins[offset >> _profileLog.header.bin_shift];
+
+    if(*bin == 0xFFFF)
+        _profileLog.header.saturated++;
+    else
+        *bin = *bin + 1;
+}
+
+uint32_t profileSamples(void)
+{
+    return _profileLog.header.samples;
+}
+
+const profile_log_t *profileLog(void)
+{
+    return &_profileLog;
+}
+
+static void _profileClear(void)
+{
+    int i;
+
+    for(i = 0; i < PROFILE_NUM_BINS; i++)
+        _profileLog.bins[i] = 0;
+
+    _profileLog.header.samples = 0;
+    _profileLog.header.outside = 0;
+    _profileLog.header.saturated = 0;
+}
+
+static void _profileHold(void)
+{
+    /* Priority 0 is above the BASEPRI of CRITICAL_ENTER under the RTOS */
+    Interrupt_disableInterrupt(PROFILE_INT_NUM);
+    __DSB();
+    __ISB();
+}
+
+static void _profileRelease(void)
+{
+    /* A period that ended meanwhile stays pending and is sampled now */
+    if(_profileLog.header.rate_hz != 0)
+        Interrupt_enableInterrupt(PROFILE_INT_NUM);
+}
+
+void _profileSample(const uint32_t *frame)
+{
+    PROFILE_TIMER->INTCLR = 0;
+
+    profileRecord(frame[PROFILE_FRAME_PC]);
+}
+
+/* The frame is on the process stack if bit 2 of EXC_RETURN is set (thread mode
+   with PSP, e.g. under an RTOS), on the main stack otherwise. The veneer keeps
+   EXC_RETURN in lr, so _profileSample returns from the exception itself. */
+#ifndef BENCH_HOST
+__asm("        .thumb");
+__asm("        .sect \".text:T32_INT1_IRQHandler\"");
+__asm("        .global T32_INT1_IRQHandler");
+__asm("        .global _profileSample");
+__asm("        .thumbfunc T32_INT1_IRQHandler");
+__asm("T32_INT1_IRQHandler: .asmfunc");
+__asm("        TST     lr, #4");
+__asm("        ITE     EQ");
+__asm("        MRSEQ   r0, MSP");
+__asm("        MRSNE   r0, PSP");
+__asm("        B       _profileSample");
+__asm("        .endasmfunc");
+#else
+void T32_INT1_IRQHandler(void)
+{
+    _profileSample(profileHostFrame);
+}
+#endif
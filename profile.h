@@ -0,0 +1,130 @@
+/**
+ @file    profile.h
+
+ @brief   Statistical profiler sampling the program counter from a timer interrupt
+
+ Timer32 1 interrupts the CPU at a chosen rate with the highest priority, and its
+ handler reads the program counter stacked by the exception entry of whatever it
+ interrupted: thread code, or an ISR of lower priority. The address is binned in a
+ histogram of 16-bit counters covering the .text section, the bin size being the
+ smallest power of two that fits the whole section in PROFILE_NUM_BINS bins.
+ Addresses outside .text (ROM driverlib, code in RAM) are only counted.
+
+ The histogram is read with the debugger, saving the memory of the symbol
+ _profileLog (sizeof(profile_log_t) bytes), and tools/profile_symbolize.py
+ turns it into samples per function using the linker map of the build in
+ Debug/. The binning is @ref profileRecord, which the handler calls with the
+ stacked PC, so it can be fed with synthetic addresses on the host.
+
+ Sampling is started by the application with @ref profileStart; lab4 does it at
+ boot only when built with PROFILE_AT_BOOT set. A sample costs about 40
+ cycles, so the overhead is bounded by the rate: at PROFILE_MAX_HZ and 48 MHz
+ it is under 1% of the CPU. The code running with
+ interrupts masked (CRITICAL_ENTER) cannot be sampled: its time is charged to
+ the instruction that unmasks them. The time spent sleeping is charged to the
+ instruction after the WFI of powerSleep.
+
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+*/
+
+// Do not write above this line (except comments)!
+#ifndef PROFILE_H
+#define PROFILE_H
+
+/* SECTION 1: Included header files required to compile this file  */
+#include <stdint.h>
+
+
+/* SECTION 2: Public macros                                        */
+
+/**
+ @brief Bins of the histogram (2 bytes each)
+*/
+#define PROFILE_NUM_BINS      2048
+
+/**
+ @brief Sampling rate by default, and the highest one accepted, in Hz
+*/
+#define PROFILE_DEFAULT_HZ    1000
+#define PROFILE_MAX_HZ        10000
+
+/**
+ @brief Set to 1 (or define it on the command line) to sample from boot at PROFILE_DEFAULT_HZ
+*/
+#ifndef PROFILE_AT_BOOT
+#define PROFILE_AT_BOOT       0
+#endif
+
+#define PROFILE_MAGIC         0x464F5250u //"PROF"
+#define PROFILE_VERSION       1
+
+
+/* SECTION 3: Public types                                         */
+
+/**
+ @brief Header of the histogram. All the fields are little endian.
+ Bin i counts the samples in [text_start + (i << bin_shift), text_start + ((i+1) << bin_shift)).
+*/
+struct profile_header_s {
+   uint32_t magic;       /**< @ref PROFILE_MAGIC                              */
+   uint16_t version;     /**< @ref PROFILE_VERSION                            */
+   uint16_t num_bins;    /**< @ref PROFILE_NUM_BINS                           */
+   uint32_t text_start;  /**< First address of the range binned               */
+   uint32_t text_end;    /**< Address following the range binned              */
+   uint32_t bin_shift;   /**< Bin size is 1 << bin_shift bytes                */
+   uint32_t rate_hz;     /**< Sampling rate, 0 while stopped                  */
+   uint32_t samples;     /**< Samples taken, inside the range or not          */
+   uint32_t outside;     /**< Samples with the PC outside the range           */
+   uint32_t saturated;   /**< Samples lost because their bin was full         */
+};
+
+/**
+ @brief Short alias "profile_header_t" for the data type "struct profile_header_s"
+*/
+typedef struct profile_header_s profile_header_t;
+
+/**
+ @brief Whole histogram as seen by the debugger
+*/
+struct profile_log_s {
+   profile_header_t header;          /**< Range, rate and counters  */
+   uint16_t bins[PROFILE_NUM_BINS];  /**< Samples per bin           */
+};
+
+/**
+ @brief Short alias "profile_log_t" for the data type "struct profile_log_s"
+*/
+typedef struct profile_log_s profile_log_t;
+
+
+/* SECTION 4: Public variables :: declarations, extern mandatory   */
+
+#ifdef BENCH_HOST
+extern uint32_t profileHostFrame[8]; //Stands for the exception frame of the sampled context in a host build
+#endif
+
+
+/* SECTION 5: Public functions :: declarations, extern optional
+   Rule exception (callbacks)  :: declarations, extern recommended */
+
+void profileInit(void); //Initialization function: bin the .text section, sampling stopped
+
+int profileSetRange(uint32_t start, uint32_t end); //Bin another address range, clearing the histogram: bin shift, -1 if invalid
+
+int profileStart(uint32_t rate_hz); //Start sampling at a rate (1..PROFILE_MAX_HZ), -1 if invalid
+
+void profileStop(void); //Stop sampling, the histogram is kept
+
+void profileReset(void); //Clear the histogram and the counters
+
+void profileRecord(uint32_t pc); //Count a sample, called by the timer handler
+
+uint32_t profileSamples(void); //Samples taken since the last reset
+
+const profile_log_t *profileLog(void); //Histogram, e.g. to be sent by the application
+
+
+#endif //PROFILE_H
+// Do not write below this line!
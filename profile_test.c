@@ -0,0 +1,193 @@
+/**
+ @file    profile_test.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Host test of the statistical profiler
+
+ Built by host/Makefile. The binning is fed with synthetic addresses, then
+ the sampler runs on the simulated Timer32, the handler taking the program
+ counter from profileHostFrame as it would from the stacked exception frame.
+ The test checks the rate, stopping, and that clearing the histogram while
+ sampling neither races the sampler nor loses the sample that was due.
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "profile.h"
+#include "sim.h"
+
+/* The whole file belongs to the host build (see host/Makefile) */
+#ifdef BENCH_HOST
+
+
+/* SECTION 2: Private macros                                       */
+
+#define TEST_START     0x00001000u   //Range binned by the tests
+#define TEST_END       0x0000AC40u   //40000 bytes: 32-byte bins
+#define TEST_SHIFT     5
+#define TEST_FRAME_PC  6             //Index of the PC in the exception frame
+
+
+/* SECTION 3: Private types                                        */
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static void _testStart(void); //Reset the simulation and the profiler, sampling stopped
+
+static uint16_t _testBin(uint32_t pc); //Samples in the bin of an address of the test range
+
+static void _testBinning(void);
+
+static void _testSampling(void);
+
+static void _testClear(void);
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+int main(void)
+{
+    _testBinning();
+    _testSampling();
+    _testClear();
+
+    return simReport("profile_test");
+}
+
+static void _testStart(void)
+{
+    simReset();
+    profileInit();
+    profileSetRange(TEST_START, TEST_END);
+    profileHostFrame[TEST_FRAME_PC] = TEST_START;
+    Interrupt_enableMaster();
+}
+
+static uint16_t _testBin(uint32_t pc)
+{
+    return profileLog()->bins[(pc - TEST_START) >> TEST_SHIFT];
+}
+
+static void _testBinning(void)
+{
+    const profile_log_t *log;
+    uint32_t i;
+
+    _testStart();
+    log = profileLog();
+    SIM_CHECK(log->header.magic == PROFILE_MAGIC && log->header.num_bins == PROFILE_NUM_BINS);
+    SIM_CHECK(log->header.rate_hz == 0 && profileSamples() == 0);
+
+    /* Smallest power of two bin covering the range */
+    SIM_CHECK(log->header.bin_shift == TEST_SHIFT);
+    SIM_CHECK(profileSetRange(0, PROFILE_NUM_BINS) == 0);
+    SIM_CHECK(profileSetRange(0, PROFILE_NUM_BINS + 1) == 1);
+    SIM_CHECK(profileSetRange(TEST_START, TEST_START) == -1);
+    SIM_CHECK(profileSetRange(TEST_START, TEST_END) == TEST_SHIFT);
+
+    /* Both ends of the range, and just outside */
+    profileRecord(TEST_START);
+    profileRecord(TEST_START + 31);
+    profileRecord(TEST_START + 32);
+    profileRecord(TEST_END - 1);
+    profileRecord(TEST_END);
+    profileRecord(TEST_START - 1);
+    SIM_CHECK(_testBin(TEST_START) == 2 && _testBin(TEST_START + 32) == 1 && _testBin(TEST_END - 1) == 1);
+    SIM_CHECK(profileSamples() == 6 && log->header.outside == 2);
+
+    /* A full bin counts the samples it loses */
+    for(i = 0; i < 0xFFFF + 3; i++)
+        profileRecord(TEST_START + 100);
+    SIM_CHECK(_testBin(TEST_START + 100) == 0xFFFF && log->header.saturated == 3);
+
+    profileReset();
+    SIM_CHECK(profileSamples() == 0 && log->header.saturated == 0 && _testBin(TEST_START) == 0);
+}
+
+static void _testSampling(void)
+{
+    const profile_log_t *log;
+    uint32_t samples;
+
+    _testStart();
+    log = profileLog();
+
+    SIM_CHECK(profileStart(0) == -1 && profileStart(PROFILE_MAX_HZ + 1) == -1);
+    SIM_CHECK(Interrupt_isEnabled(INT_T32_INT1) == 0);
+
+    /* One sample per period, in the bin of the interrupted code, above every interrupt */
+    profileHostFrame[TEST_FRAME_PC] = TEST_START + 0x1234;
+    SIM_CHECK(profileStart(PROFILE_DEFAULT_HZ) == 1);
+    SIM_CHECK(TIMER32_1->LOAD == SystemCoreClock / PROFILE_DEFAULT_HZ - 1 && Interrupt_getPriority(INT_T32_INT1) == 0);
+    simAdvanceUs(1000000);
+    samples = profileSamples();
+    SIM_CHECK(samples >= PROFILE_DEFAULT_HZ - 1 && samples <= PROFILE_DEFAULT_HZ);
+    SIM_CHECK(_testBin(TEST_START + 0x1234) == samples && log->header.rate_hz == PROFILE_DEFAULT_HZ);
+
+    /* Code moved elsewhere */
+    profileHostFrame[TEST_FRAME_PC] = TEST_START + 0x40;
+    simAdvanceUs(500000);
+    SIM_CHECK(_testBin(TEST_START + 0x40) >= PROFILE_DEFAULT_HZ / 2 - 1 && _testBin(TEST_START + 0x40) <= PROFILE_DEFAULT_HZ / 2);
+
+    /* Stopped: the histogram is kept */
+    profileStop();
+    samples = profileSamples();
+    simAdvanceUs(100000);
+    SIM_CHECK(profileSamples() == samples && log->header.rate_hz == 0);
+    SIM_CHECK(Interrupt_isEnabled(INT_T32_INT1) == 0);
+}
+
+static void _testClear(void)
+{
+    bool state;
+
+    _testStart();
+
+    /* Cleared while sampling: the sampler goes on */
+    profileStart(PROFILE_MAX_HZ);
+    simAdvanceUs(10000);
+    SIM_CHECK(profileSamples() >= 99);
+    profileReset();
+    SIM_CHECK(profileSamples() == 0 && Interrupt_isEnabled(INT_T32_INT1) == 1);
+    simAdvanceUs(10000);
+    SIM_CHECK(profileSamples() >= 99 && profileSamples() <= 100);
+
+    /* A period ending during the clear is sampled once it is over, in the new histogram */
+    state = Interrupt_disableMaster();
+    simAdvanceUs(100);
+    profileReset();
+    SIM_CHECK(profileSamples() == 0);
+    if(!state)
+        Interrupt_enableMaster();
+    SIM_CHECK(profileSamples() == 1 && _testBin(TEST_START) == 1);
+
+    /* Same across a new range */
+    state = Interrupt_disableMaster();
+    simAdvanceUs(100);
+    SIM_CHECK(profileSetRange(TEST_START, TEST_START + PROFILE_NUM_BINS) == 0);
+    if(!state)
+        Interrupt_enableMaster();
+    SIM_CHECK(profileSamples() == 1 && profileLog()->bins[0] == 1);
+
+    /* Stopped: clearing does not enable the sampler */
+    profileStop();
+    profileReset();
+    SIM_CHECK(Interrupt_isEnabled(INT_T32_INT1) == 0);
+}
+
+#endif //BENCH_HOST
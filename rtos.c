@@ -0,0 +1,359 @@
+/**
+ @file    rtos.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Optional integration of the drivers with FreeRTOS: button events to tasks
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "rtos.h"
+
+/* The whole module belongs to the RTOS build configuration */
+#ifdef RTOS_BUILD
+
+#include "queue.h"
+#include "defer.h"
+#include "button.h"
+#include "power.h"
+#ifdef BENCH_HOST
+#include <time.h>
+#endif
+
+
+/* SECTION 2: Private macros                                       */
+
+/**
+ @brief Time base of the latencies: cycle counter on the target, nanoseconds on the host
+*/
+#ifdef BENCH_HOST
+#define RTOS_NOW()  _rtosNanoseconds()
+#else
+#define RTOS_NOW()  CYCLES_NOW()
+#endif
+
+/**
+ @brief Context switch requested at the end of an ISR; the host configuration may
+ leave it to the tick of the POSIX port, its only interrupt (see rtos.h)
+*/
+#ifndef RTOS_YIELD_FROM_ISR
+#define RTOS_YIELD_FROM_ISR(woken)  portYIELD_FROM_ISR(woken)
+#endif
+
+
+/* SECTION 3: Private types                                        */
+
+/**
+ @brief Task notified of the presses of some buttons
+*/
+struct rtos_waiter_s {
+   TaskHandle_t task;     /**< Task to notify                   */
+   uint32_t     buttons;  /**< Buttons followed (bit BUTTONx)   */
+};
+
+/**
+ @brief Short alias "rtos_waiter_t" for the data type "struct rtos_waiter_s"
+*/
+typedef struct rtos_waiter_s rtos_waiter_t;
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+static StaticTask_t _rtosDeferTcb;
+static StackType_t _rtosDeferStack [RTOS_DEFER_STACK_WORDS];
+static TaskHandle_t _rtosDeferTask = 0;
+
+static StaticTask_t _rtosAppTcb;
+static StackType_t _rtosAppStack [RTOS_APP_STACK_WORDS];
+
+static StaticTask_t _rtosIdleTcb;
+static StackType_t _rtosIdleStack [configMINIMAL_STACK_SIZE];
+
+#if configUSE_TIMERS
+static StaticTask_t _rtosTimerTcb;
+static StackType_t _rtosTimerStack [configTIMER_TASK_STACK_DEPTH];
+#endif
+
+static StaticQueue_t _rtosQueueControl;
+static uint8_t _rtosQueueStorage [RTOS_QUEUE_LENGTH * sizeof(rtos_button_event_t)];
+static QueueHandle_t _rtosQueue = 0;
+static volatile uint32_t _rtosQueueButtons = 0;   /**< Buttons sent to the queue (bit BUTTONx) */
+
+static rtos_waiter_t _rtosWaiters [RTOS_MAX_WAITERS];
+static volatile uint8_t _rtosNumWaiters = 0;
+
+static volatile uint32_t _rtosStamp [32];         /**< Time of the last press of each button   */
+
+static rtos_latency_t _rtosLatency;
+static uint32_t _rtosTicksPerUs = 1;              /**< RTOS_NOW() units per microsecond       */
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static void _rtosDeferTaskFn(void *arg); //Run the deferred work each time deferPost signals it
+
+static void _rtosLatencyAdd(uint32_t stamp); //Account the latency of an event received now
+
+#ifdef BENCH_HOST
+static uint32_t _rtosNanoseconds(void); //Monotonic clock of the host, wrapping around
+#endif
+
+void vApplicationGetIdleTaskMemory(StaticTask_t **tcb, StackType_t **stack, uint32_t *stack_words);
+
+#if configUSE_TIMERS
+void vApplicationGetTimerTaskMemory(StaticTask_t **tcb, StackType_t **stack, uint32_t *stack_words);
+#endif
+
+#if configUSE_IDLE_HOOK
+void vApplicationIdleHook(void);
+#endif
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+void rtosInit(void)
+{
+    int i;
+
+    /* The interrupts left at the reset priority (0) would not be masked by the
+       critical sections: move them to the most urgent one allowed to use the API */
+    for(i = INT_PSS; i <= INT_PORT6; i++)
+    {
+        if(Interrupt_getPriority(i) < configMAX_SYSCALL_INTERRUPT_PRIORITY)
+            Interrupt_setPriority(i, configMAX_SYSCALL_INTERRUPT_PRIORITY);
+    }
+
+#ifdef BENCH_HOST
+    _rtosTicksPerUs = 1000;
+#else
+    _rtosTicksPerUs = CS_getMCLK() / 1000000;
+#endif
+
+    _rtosLatency.count = 0;
+    _rtosLatency.min_us = UINT32_MAX;
+    _rtosLatency.max_us = 0;
+    _rtosLatency.total_us = 0;
+    _rtosLatency.late = 0;
+    _rtosLatency.dropped = 0;
+
+    _rtosNumWaiters = 0;
+    _rtosQueueButtons = 0;
+    _rtosQueue = xQueueCreateStatic(RTOS_QUEUE_LENGTH, sizeof(rtos_button_event_t),
+                                    _rtosQueueStorage, &_rtosQueueControl);
+
+    _rtosDeferTask = xTaskCreateStatic(_rtosDeferTaskFn, "defer", RTOS_DEFER_STACK_WORDS, 0,
+                                       RTOS_DEFER_PRIORITY, _rtosDeferStack, &_rtosDeferTcb);
+}
+
+void rtosRun(TaskFunction_t app)
+{
+    xTaskCreateStatic(app, "app", RTOS_APP_STACK_WORDS, 0, RTOS_APP_PRIORITY, _rtosAppStack, &_rtosAppTcb);
+
+    vTaskStartScheduler();
+
+    /* Only reached if the idle task could not be created */
+    while(1);
+}
+
+int rtosButtonNotify(uint32_t buttons)
+{
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    int i;
+    bool state;
+
+    CRITICAL_ENTER(state);
+
+    for(i = 0; i < _rtosNumWaiters; i++)
+    {
+        if(_rtosWaiters[i].task == task)
+            break;
+    }
+
+    if(i == RTOS_MAX_WAITERS)
+    {
+        CRITICAL_EXIT(state);
+        return -1;
+    }
+
+    _rtosWaiters[i].task = task;
+    _rtosWaiters[i].buttons = buttons;
+    if(i == _rtosNumWaiters)
+        _rtosNumWaiters++;
+
+    CRITICAL_EXIT(state);
+
+    return 1;
+}
+
+uint32_t rtosButtonTake(uint32_t timeout_ms)
+{
+    uint32_t buttons = 0;
+    int i;
+
+    if(xTaskNotifyWait(0, UINT32_MAX, &buttons, pdMS_TO_TICKS(timeout_ms)) != pdTRUE)
+        return 0;
+
+    for(i = 0; i < 32; i++)
+    {
+        if(buttons & (1u << i))
+            _rtosLatencyAdd(_rtosStamp[i]);
+    }
+
+    return buttons;
+}
+
+void rtosButtonQueue(uint32_t buttons)
+{
+    _rtosQueueButtons = buttons;
+}
+
+int rtosButtonWait(rtos_button_event_t *ev, uint32_t timeout_ms)
+{
+    if(ev == 0 || _rtosQueue == 0)
+        return -1;
+
+    if(xQueueReceive(_rtosQueue, ev, pdMS_TO_TICKS(timeout_ms)) != pdTRUE)
+        return 0;
+
+    _rtosLatencyAdd(ev->stamp);
+
+    return 1;
+}
+
+int rtosLatency(rtos_latency_t *stats)
+{
+    bool state;
+
+    if(stats == 0)
+        return -1;
+
+    CRITICAL_ENTER(state);
+    *stats = _rtosLatency;
+    CRITICAL_EXIT(state);
+
+    return 1;
+}
+
+void rtosButtonEvent(int which_button, int event)
+{
+    BaseType_t woken = pdFALSE;
+    rtos_button_event_t ev;
+    uint32_t bit;
+    int i;
+
+    if(which_button < 0 || which_button > 31)
+        return;
+
+    bit = 1u << which_button;
+    ev.button = which_button;
+    ev.event = event;
+    ev.stamp = RTOS_NOW();
+
+    if((_rtosQueueButtons & bit) && _rtosQueue != 0)
+    {
+        if(xQueueSendFromISR(_rtosQueue, &ev, &woken) != pdTRUE)
+            _rtosLatency.dropped++;
+    }
+
+    if(event == BUTTON_EVENT_PRESS)
+    {
+        /* Presses not taken yet are merged: the latency counts from the last one */
+        _rtosStamp[which_button] = ev.stamp;
+
+        for(i = 0; i < _rtosNumWaiters; i++)
+        {
+            if(_rtosWaiters[i].buttons & bit)
+                xTaskNotifyFromISR(_rtosWaiters[i].task, bit, eSetBits, &woken);
+        }
+    }
+
+    RTOS_YIELD_FROM_ISR(woken);
+}
+
+void rtosDeferSignal(void)
+{
+    BaseType_t woken = pdFALSE;
+
+    if(_rtosDeferTask == 0)
+        return;
+
+    vTaskNotifyGiveFromISR(_rtosDeferTask, &woken);
+    RTOS_YIELD_FROM_ISR(woken);
+}
+
+static void _rtosDeferTaskFn(void *arg)
+{
+    while(1)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        deferRun();
+    }
+}
+
+static void _rtosLatencyAdd(uint32_t stamp)
+{
+    uint32_t us;
+    bool state;
+
+    us = (RTOS_NOW() - stamp) / _rtosTicksPerUs;
+
+    CRITICAL_ENTER(state);
+
+    _rtosLatency.count++;
+    _rtosLatency.total_us += us;
+    if(us < _rtosLatency.min_us)
+        _rtosLatency.min_us = us;
+    if(us > _rtosLatency.max_us)
+        _rtosLatency.max_us = us;
+    if(us > RTOS_LATENCY_BOUND_US)
+        _rtosLatency.late++;
+
+    CRITICAL_EXIT(state);
+}
+
+#ifdef BENCH_HOST
+static uint32_t _rtosNanoseconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec);
+}
+#endif
+
+void vApplicationGetIdleTaskMemory(StaticTask_t **tcb, StackType_t **stack, uint32_t *stack_words)
+{
+    *tcb = &_rtosIdleTcb;
+    *stack = _rtosIdleStack;
+    *stack_words = configMINIMAL_STACK_SIZE;
+}
+
+#if configUSE_IDLE_HOOK
+void vApplicationIdleHook(void)
+{
+    /* No task ready: sleep until the next interrupt (the tick at the latest) */
+    powerSleep(POWER_MODE_LPM0);
+}
+#endif
+
+#if configUSE_TIMERS
+void vApplicationGetTimerTaskMemory(StaticTask_t **tcb, StackType_t **stack, uint32_t *stack_words)
+{
+    *tcb = &_rtosTimerTcb;
+    *stack = _rtosTimerStack;
+    *stack_words = configTIMER_TASK_STACK_DEPTH;
+}
+#endif
+
+#endif //RTOS_BUILD
@@ -0,0 +1,172 @@
+/**
+ @file    rtos.h
+
+ @brief   Optional integration of the drivers with FreeRTOS: button events to tasks
+
+ The layer is built with RTOS_BUILD defined (--define=RTOS_BUILD in a dedicated
+ build configuration, as BENCHMARK_BUILD), with the FreeRTOS kernel sources and
+ a FreeRTOSConfig.h in the include path. The configuration must provide:
+ - configSUPPORT_STATIC_ALLOCATION 1, every object here being static,
+   configSTACK_DEPTH_TYPE uint32_t (the size given back by the task memory
+   callbacks, as from V11), and INCLUDE_vTaskDelay and
+   INCLUDE_xTaskGetSchedulerState 1;
+ - configMAX_SYSCALL_INTERRUPT_PRIORITY at most (2 << 5), the priority of the
+   port ISRs, the encoders, the expanders and the capture timer of the buttons
+   included: the ISRs of the drivers call the FromISR functions. @ref rtosInit moves the interrupts still at
+   priority 0 to it, so the modules initialized afterwards keep it unless they
+   choose their own, and buttonPinHook refuses a more urgent one; the profiler
+   (priority 0, set when started) does not use the API and is never masked;
+ - xPortPendSVHandler, xPortSysTickHandler and vPortSVCHandler defined as
+   PendSV_Handler, SysTick_Handler and SVC_Handler, the names of the vector table.
+ - configUSE_IDLE_HOOK 1, so that the idle task sleeps through powerSleep and
+   the idle time shows in cpuloadGet (see cpuload.h).
+
+ In this build:
+ - PendSV belongs to the kernel. The deferred work of defer.h (button
+   subscribers and buttonCallback) runs in a task at RTOS_DEFER_PRIORITY, woken
+   by deferPost, so it can use the whole FreeRTOS API.
+ - The port ISRs signal tasks directly, before the deferred work runs: a task
+   registered with @ref rtosButtonNotify gets the presses as bits of its
+   notification value (index 0), and the buttons selected with
+   @ref rtosButtonQueue have all their events sent to a queue.
+ - CRITICAL_ENTER raises BASEPRI to configMAX_SYSCALL_INTERRUPT_PRIORITY instead
+   of masking every interrupt (see common.h), which also keeps the scheduler
+   out of the LED and button sections.
+ - The delays of delay.h from DELAY_SLEEP_US on block the task (vTaskDelay)
+   for their whole kernel ticks instead of sleeping, then spin on the time base
+   for the rest (less than one kernel tick), and spin before the scheduler starts.
+
+ Each event carries the time of its ISR. The time until a task receives it is
+ accumulated by @ref rtosLatency: it is the ISR exit plus one context switch
+ (a few microseconds) for the highest priority waiting task, and the events
+ above RTOS_LATENCY_BOUND_US are counted.
+
+ Host builds (BENCH_HOST with RTOS_BUILD) run against the POSIX port of the
+ kernel, the time being the monotonic clock; host/rtos/FreeRTOSConfig.h sets
+ the stacks (RTOS_x_STACK_WORDS may be defined there) to what a thread needs
+ and the latency bound of a thread switch. Its only interrupt is the tick, from
+ whose hook the test injects the edges: the ISRs leave the context switch to
+ the end of the tick (RTOS_YIELD_FROM_ISR), as PendSV does on the target.
+
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+*/
+
+// Do not write above this line (except comments)!
+#ifndef RTOS_H
+#define RTOS_H
+
+/* SECTION 1: Included header files required to compile this file  */
+#include <stdint.h>
+#ifdef RTOS_BUILD
+#include "FreeRTOS.h"
+#include "task.h"
+#endif
+
+
+/* SECTION 2: Public macros                                        */
+
+#ifdef RTOS_BUILD
+
+/**
+ @brief Priority and stack (words) of the task running the deferred work
+*/
+#define RTOS_DEFER_PRIORITY     (configMAX_PRIORITIES - 1)
+#ifndef RTOS_DEFER_STACK_WORDS
+#define RTOS_DEFER_STACK_WORDS  256
+#endif
+
+/**
+ @brief Priority and stack (words) of the application task started by @ref rtosRun
+*/
+#define RTOS_APP_PRIORITY       (tskIDLE_PRIORITY + 1)
+#ifndef RTOS_APP_STACK_WORDS
+#define RTOS_APP_STACK_WORDS    256
+#endif
+
+/**
+ @brief Events held by the button queue, and tasks notified at most
+*/
+#define RTOS_QUEUE_LENGTH       16
+#define RTOS_MAX_WAITERS        4
+
+/**
+ @brief Event-to-task latency above which an event is counted as late, in microseconds
+*/
+#ifndef RTOS_LATENCY_BOUND_US
+#define RTOS_LATENCY_BOUND_US   50
+#endif
+
+#endif //RTOS_BUILD
+
+
+/* SECTION 3: Public types                                         */
+
+#ifdef RTOS_BUILD
+
+/**
+ @brief Button event received from the queue
+*/
+struct rtos_button_event_s {
+   uint8_t  button;  /**< Button (BUTTONx), also virtual         */
+   uint8_t  event;   /**< Event (BUTTON_EVENT_x)                 */
+   uint32_t stamp;   /**< Time of the ISR (internal time base)   */
+};
+
+/**
+ @brief Short alias "rtos_button_event_t" for the data type "struct rtos_button_event_s"
+*/
+typedef struct rtos_button_event_s rtos_button_event_t;
+
+/**
+ @brief Event-to-task latency, in microseconds
+*/
+struct rtos_latency_s {
+   uint32_t count;       /**< Events received by a task               */
+   uint32_t min_us;      /**< Shortest latency                         */
+   uint32_t max_us;      /**< Longest latency                          */
+   uint32_t total_us;    /**< Sum of the latencies, for the average    */
+   uint32_t late;        /**< Events above RTOS_LATENCY_BOUND_US       */
+   uint32_t dropped;     /**< Events lost because the queue was full   */
+};
+
+/**
+ @brief Short alias "rtos_latency_t" for the data type "struct rtos_latency_s"
+*/
+typedef struct rtos_latency_s rtos_latency_t;
+
+#endif //RTOS_BUILD
+
+
+/* SECTION 4: Public variables :: declarations, extern mandatory   */
+
+
+/* SECTION 5: Public functions :: declarations, extern optional
+   Rule exception (callbacks)  :: declarations, extern recommended */
+
+#ifdef RTOS_BUILD
+
+void rtosInit(void); //Initialization function: create the deferred work task and the button queue (after deferInit)
+
+void rtosRun(TaskFunction_t app); //Create the application task and start the scheduler, never returns
+
+int rtosButtonNotify(uint32_t buttons); //Notify the calling task of the presses of some buttons (bit BUTTONx), -1 if no room
+
+uint32_t rtosButtonTake(uint32_t timeout_ms); //Wait for a notification: buttons pressed since the last one, 0 on timeout
+
+void rtosButtonQueue(uint32_t buttons); //Select the buttons (bit BUTTONx) whose events are sent to the queue
+
+int rtosButtonWait(rtos_button_event_t *ev, uint32_t timeout_ms); //Receive the next event of the queue: 1, 0 on timeout, -1 if invalid
+
+int rtosLatency(rtos_latency_t *stats); //Retrieve the event-to-task latencies since the initialization, -1 if invalid
+
+void rtosButtonEvent(int which_button, int event); //Signal an event to the tasks, called by the button module in its ISR
+
+void rtosDeferSignal(void); //Wake up the deferred work task, called by deferPost
+
+#endif //RTOS_BUILD
+
+
+#endif //RTOS_H
+// Do not write below this line!
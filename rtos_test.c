@@ -0,0 +1,249 @@
+/**
+ @file    rtos_test.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Host test of the FreeRTOS layer: interrupt ceiling and button events to tasks
+
+ Built by "make -C host rtos", with every module compiled with RTOS_BUILD
+ against the POSIX port of the kernel and host/rtos/FreeRTOSConfig.h, whose
+ ceiling is the loosest rtos.h allows. Before the scheduler starts, the test
+ checks that every driver interrupt enabled by the initialization is within
+ the ceiling (the profiler's apart) and that buttonPinHook refuses a more
+ urgent one. Then the application task queues edges of the simulated pins,
+ which the tick hook applies, in interrupt context, while the idle task runs
+ (every task blocked, none in the middle of a simulator call): BUTTON2 and the
+ encoder share PORT5, BUTTON1 is on PORT1, and the events must reach the
+ queue, the notifications and the deferred work task within
+ RTOS_LATENCY_BOUND_US.
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "rtos.h"
+#include "button.h"
+#include "encoder.h"
+#include "expander.h"
+#include "defer.h"
+#include "persist.h"
+#include "systime.h"
+#include "sim.h"
+#include <stdlib.h>
+
+/* The whole file belongs to the host RTOS build (see host/Makefile) */
+#if defined(BENCH_HOST) && defined(RTOS_BUILD)
+
+
+/* SECTION 2: Private macros                                       */
+
+#define TEST_WAIT_MS    100   //Longest wait of a task for an event
+#define TEST_NUM_EDGES  16    //Edges queued for the tick hook at most
+
+
+/* SECTION 3: Private types                                        */
+
+/**
+ @brief Edge of a simulated pin, applied by the tick hook
+*/
+struct test_edge_s {
+   uint8_t  port;     /**< Port (1 to 6)                          */
+   uint8_t  mask;     /**< Pins changed                           */
+   uint8_t  value;    /**< New level of the pins (0/1)            */
+   uint32_t gap_us;   /**< Simulated time elapsed before the edge */
+};
+
+/**
+ @brief Short alias "test_edge_t" for the data type "struct test_edge_s"
+*/
+typedef struct test_edge_s test_edge_t;
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+static volatile int _testCallbacks = 0;  /**< Presses seen by buttonCallback, in the deferred work task */
+
+static test_edge_t _testEdges [TEST_NUM_EDGES];
+static volatile uint32_t _testEdgeHead = 0;  /**< Next edge applied by the tick hook */
+static volatile uint32_t _testEdgeTail = 0;  /**< Next free entry                     */
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static void _testHook(int port, uint8_t in, uint8_t flags, void *context); //Pin hook of another module
+
+static void _testCeiling(void); //Priorities of the driver interrupts, before the scheduler starts
+
+static void _testApp(void *arg); //Application task: events to the tasks
+
+static void _testEdge(int port, uint8_t mask, uint8_t value, uint32_t gap_us); //Queue an edge for the tick hook
+
+static void _testEdgesWait(void); //Block until the tick hook has applied every queued edge
+
+static void _testTurn(int detents); //Turn the encoder clockwise by some detents
+
+void buttonCallback(int which_button);
+
+void vApplicationTickHook(void);
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+int main(void)
+{
+    persistInvalidate();
+    simReset();
+    deferInit();
+    rtosInit();
+    systimeInit();
+    buttonsInit();
+    encodersInit();
+    expandersInit();
+    Interrupt_enableMaster();
+
+    _testCeiling();
+
+    /* Never returns: the application task reports and exits */
+    rtosRun(_testApp);
+
+    return 1;
+}
+
+void buttonCallback(int which_button)
+{
+    _testCallbacks++;
+}
+
+static void _testHook(int port, uint8_t in, uint8_t flags, void *context)
+{
+}
+
+static void _testCeiling(void)
+{
+    int i;
+
+    /* Every interrupt the drivers enabled may call the FromISR API */
+    for(i = INT_PSS; i <= INT_PORT6; i++)
+    {
+        if(i != INT_T32_INT1 && Interrupt_isEnabled(i))
+            SIM_CHECK(Interrupt_getPriority(i) >= configMAX_SYSCALL_INTERRUPT_PRIORITY);
+    }
+    SIM_CHECK(Interrupt_isEnabled(INT_PORT5) && Interrupt_getPriority(INT_PORT5) == configMAX_SYSCALL_INTERRUPT_PRIORITY);
+    SIM_CHECK(Interrupt_isEnabled(INT_PORT4));
+
+    /* A pin hook above the ceiling is refused, at the ceiling accepted */
+    SIM_CHECK(buttonPinHook(6, BIT0, (configMAX_SYSCALL_INTERRUPT_PRIORITY >> 5) - 1, _testHook, 0) == -1);
+    SIM_CHECK(Interrupt_isEnabled(INT_PORT6) == 0);
+    SIM_CHECK(buttonPinHook(6, BIT0, configMAX_SYSCALL_INTERRUPT_PRIORITY >> 5, _testHook, 0) == 1);
+    SIM_CHECK(Interrupt_getPriority(INT_PORT6) == configMAX_SYSCALL_INTERRUPT_PRIORITY);
+    SIM_CHECK(buttonPinHook(6, 0, configMAX_SYSCALL_INTERRUPT_PRIORITY >> 5, _testHook, 0) == 1);
+}
+
+static void _testEdge(int port, uint8_t mask, uint8_t value, uint32_t gap_us)
+{
+    test_edge_t *edge;
+
+    taskENTER_CRITICAL();
+
+    SIM_CHECK(_testEdgeTail - _testEdgeHead < TEST_NUM_EDGES);
+    edge = &_testEdges[_testEdgeTail % TEST_NUM_EDGES];
+    edge->port = port;
+    edge->mask = mask;
+    edge->value = value;
+    edge->gap_us = gap_us;
+    _testEdgeTail++;
+
+    taskEXIT_CRITICAL();
+}
+
+static void _testEdgesWait(void)
+{
+    while(_testEdgeHead != _testEdgeTail)
+        vTaskDelay(1);
+}
+
+void vApplicationTickHook(void)
+{
+    const test_edge_t *edge;
+
+    /* Only while every task is blocked: none of them is in the simulator */
+    if(xTaskGetCurrentTaskHandle() != xTaskGetIdleTaskHandle())
+        return;
+
+    /* The ISRs run here, in the tick interrupt; the woken tasks run at its end */
+    while(_testEdgeHead != _testEdgeTail)
+    {
+        edge = &_testEdges[_testEdgeHead % TEST_NUM_EDGES];
+        simAdvanceUs(edge->gap_us);
+        simPinSet(edge->port, edge->mask, edge->value);
+        _testEdgeHead++;
+    }
+}
+
+static void _testTurn(int detents)
+{
+    /* Clockwise from rest (both contacts high): 11 -> 01 -> 00 -> 10 -> 11 */
+    while(detents-- > 0)
+    {
+        _testEdge(5, BIT4, 0, 500);
+        _testEdge(5, BIT5, 0, 500);
+        _testEdge(5, BIT4, 1, 500);
+        _testEdge(5, BIT5, 1, 500);
+    }
+    _testEdgesWait();
+}
+
+static void _testApp(void *arg)
+{
+    rtos_button_event_t ev;
+    rtos_latency_t stats;
+    uint32_t buttons;
+    int callbacks;
+
+    /* BUTTON2 to the queue, BUTTON1 by notification */
+    rtosButtonQueue(1u << BUTTON2);
+    SIM_CHECK(rtosButtonNotify(1u << BUTTON1) == 1);
+    callbacks = _testCallbacks;
+
+    _testEdge(5, BIT1, 0, 0);
+    SIM_CHECK(rtosButtonWait(&ev, TEST_WAIT_MS) == 1);
+    SIM_CHECK(ev.button == BUTTON2 && ev.event == BUTTON_EVENT_PRESS);
+    SIM_CHECK(rtosButtonWait(&ev, 0) == 0);
+
+    _testEdge(1, BIT4, 0, 0);
+    buttons = rtosButtonTake(TEST_WAIT_MS);
+    SIM_CHECK(buttons == (1u << BUTTON1));
+
+    /* The deferred work task ran buttonCallback for both presses */
+    vTaskDelay(pdMS_TO_TICKS(10));
+    SIM_CHECK(_testCallbacks == callbacks + 2);
+
+    /* The encoder on the port of BUTTON2, button held: both served by the same ISR */
+    _testTurn(3);
+    SIM_CHECK(encoderPosition(ENCODER0) == 3 && encoderErrors(ENCODER0) == 0);
+    SIM_CHECK(buttonState(BUTTON2) == 1);
+    SIM_CHECK(rtosButtonWait(&ev, 0) == 0);
+
+    /* Released after 100 ms, then 100 ms more without any pin changed */
+    _testEdge(5, BIT1, 1, 100000);
+    _testEdge(1, BIT4, 1, 0);
+    _testEdge(1, 0, 0, 100000);
+    _testEdgesWait();
+
+    SIM_CHECK(rtosLatency(&stats) == 1 && stats.count == 2 && stats.dropped == 0);
+    printf("rtos,latency,%u..%u us,late %u\n", (unsigned)stats.min_us, (unsigned)stats.max_us, (unsigned)stats.late);
+    SIM_CHECK(stats.late == 0 && stats.max_us <= RTOS_LATENCY_BOUND_US);
+
+    exit(simReport("rtos_test"));
+}
+
+#endif //BENCH_HOST && RTOS_BUILD
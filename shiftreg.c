@@ -0,0 +1,203 @@
+/**
+ @file    shiftreg.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   LEDs on a chain of 74HC595 shift registers, refreshed by SPI and DMA
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "shiftreg.h"
+#include "dma.h"
+
+
+/* SECTION 2: Private macros                                       */
+
+/**
+ @brief SPI peripheral, pins and DMA channel
+*/
+#define SHIFTREG_SPI          EUSCI_B2
+#define SHIFTREG_PORT         P3
+#define SHIFTREG_CLK_PIN      0        //P3.0, remapped to UCB2CLK
+#define SHIFTREG_SIMO_PIN     6        //P3.6, UCB2SIMO
+#define SHIFTREG_LATCH        BIT7     //P3.7, GPIO
+#define SHIFTREG_DMA_CHANNEL  4
+#define SHIFTREG_DMA_SOURCE   DMA_CH4_EUSCIB2TX0
+
+
+/* SECTION 3: Private types                                        */
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+static volatile uint8_t _shiftregImage [SHIFTREG_NUM_CHIPS];   /**< State of the outputs, register 0 first */
+static uint8_t _shiftregSent [SHIFTREG_NUM_CHIPS];             /**< Copy being sent, last register first  */
+
+static volatile uint8_t _shiftregBusy = 0;    /**< Flag (0/1) set while a transfer runs          */
+static volatile uint8_t _shiftregDirty = 0;   /**< Flag (0/1): the image changed since the copy  */
+static volatile uint32_t _shiftregTransfers = 0;
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static void _shiftregStart(void); //Copy the image and send it, interrupts masked
+
+static void _shiftregDone(int channel, void *context); //DMA completion: latch, then send again if changed
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+void shiftregInit(void)
+{
+    uint32_t i, n;
+
+    for(i = 0; i < SHIFTREG_NUM_CHIPS; i++)
+        _shiftregImage[i] = 0;
+
+    _shiftregBusy = 0;
+    _shiftregDirty = 0;
+    _shiftregTransfers = 0;
+
+    /* SPI master, MSB first, data changed on the falling edge for the rising SRCLK */
+    SHIFTREG_SPI->CTLW0 = EUSCI_B_CTLW0_SWRST;
+    SHIFTREG_SPI->CTLW0 = EUSCI_B_CTLW0_SWRST | EUSCI_B_CTLW0_MST | EUSCI_B_CTLW0_SYNC
+                        | EUSCI_B_CTLW0_MSB | EUSCI_B_CTLW0_CKPH | EUSCI_B_CTLW0_SSEL__SMCLK;
+    n = (CS_getSMCLK() + SHIFTREG_SPI_HZ - 1) / SHIFTREG_SPI_HZ;
+    SHIFTREG_SPI->BRW = n > 0 ? n : 1;
+
+    /* P3.5, the default clock pin, is BUTTON3: the clock goes to P3.0 */
+    PMAP->KEYID = PMAP_KEYID_VAL;
+    PMAP->CTL = PMAP->CTL | PMAP_CTL_PRECFG;
+    P3MAP->PMAP_REGISTER[SHIFTREG_CLK_PIN] = PMAP_UCB2CLK;
+    P3MAP->PMAP_REGISTER[SHIFTREG_SIMO_PIN] = PMAP_UCB2SIMO;
+    PMAP->KEYID = 0;
+
+    SHIFTREG_PORT->SEL1 = SHIFTREG_PORT->SEL1 & ~((1 << SHIFTREG_CLK_PIN) | (1 << SHIFTREG_SIMO_PIN) | SHIFTREG_LATCH);
+    SHIFTREG_PORT->SEL0 = (SHIFTREG_PORT->SEL0 | (1 << SHIFTREG_CLK_PIN) | (1 << SHIFTREG_SIMO_PIN)) & ~SHIFTREG_LATCH;
+    SHIFTREG_PORT->OUT = SHIFTREG_PORT->OUT & ~SHIFTREG_LATCH;
+    SHIFTREG_PORT->DIR = SHIFTREG_PORT->DIR | SHIFTREG_LATCH;
+    SHIFTREG_SPI->CTLW0 = SHIFTREG_SPI->CTLW0 & ~EUSCI_B_CTLW0_SWRST;
+
+    dmaInit();
+    DMA_assignChannel(SHIFTREG_DMA_SOURCE);
+    DMA_disableChannelAttribute(SHIFTREG_DMA_SOURCE, UDMA_ATTR_ALTSELECT | UDMA_ATTR_USEBURST
+                                                   | UDMA_ATTR_HIGH_PRIORITY | UDMA_ATTR_REQMASK);
+    DMA_setChannelControl(UDMA_PRI_SELECT | SHIFTREG_DMA_SOURCE,
+                          UDMA_SIZE_8 | UDMA_SRC_INC_8 | UDMA_DST_INC_NONE | UDMA_ARB_1);
+    DMA_clearInterruptFlag(SHIFTREG_DMA_CHANNEL);
+    dmaChannelCallback(SHIFTREG_DMA_CHANNEL, _shiftregDone, 0);
+
+    /* The registers power up with random outputs */
+    shiftregFlush();
+}
+
+int shiftregSet(int which_output, int action)
+{
+    uint8_t mask;
+    int chip;
+    bool state;
+
+    if(which_output < 0 || which_output > SHIFTREG_NUM_OUTPUTS-1 || action < SHIFTREG_OP_ON || action > SHIFTREG_OP_TOGGLE)
+        return -1;
+
+    chip = which_output >> 3;
+    mask = 1 << (which_output & 0x07);
+
+    CRITICAL_ENTER(state);
+
+    if(action == SHIFTREG_OP_ON)
+        _shiftregImage[chip] = _shiftregImage[chip] | mask;
+    else if(action == SHIFTREG_OP_OFF)
+        _shiftregImage[chip] = _shiftregImage[chip] & ~mask;
+    else
+        _shiftregImage[chip] = _shiftregImage[chip] ^ mask;
+
+    CRITICAL_EXIT(state);
+
+    return 1;
+}
+
+int shiftregGet(int which_output)
+{
+    if(which_output < 0 || which_output > SHIFTREG_NUM_OUTPUTS-1)
+        return -1;
+
+    return (_shiftregImage[which_output >> 3] >> (which_output & 0x07)) & 1;
+}
+
+int shiftregFlush(void)
+{
+    bool state;
+
+    CRITICAL_ENTER(state);
+
+    /* Changes made during a transfer are sent together once it ends */
+    if(_shiftregBusy)
+    {
+        _shiftregDirty = 1;
+        CRITICAL_EXIT(state);
+        return 0;
+    }
+
+    _shiftregStart();
+
+    CRITICAL_EXIT(state);
+
+    return 1;
+}
+
+int shiftregBusy(void)
+{
+    return _shiftregBusy;
+}
+
+uint32_t shiftregTransfers(void)
+{
+    return _shiftregTransfers;
+}
+
+static void _shiftregStart(void)
+{
+    int i;
+
+    /* The first byte sent ends in the last register of the chain */
+    for(i = 0; i < SHIFTREG_NUM_CHIPS; i++)
+        _shiftregSent[i] = _shiftregImage[SHIFTREG_NUM_CHIPS - 1 - i];
+
+    _shiftregBusy = 1;
+    _shiftregDirty = 0;
+
+    DMA_setChannelTransfer(UDMA_PRI_SELECT | SHIFTREG_DMA_SOURCE, UDMA_MODE_BASIC,
+                           _shiftregSent, (void *)&SHIFTREG_SPI->TXBUF, SHIFTREG_NUM_CHIPS);
+    DMA_enableChannel(SHIFTREG_DMA_CHANNEL);
+
+    /* TXIFG is already set while idle: the first byte is requested by software */
+    DMA_requestSoftwareTransfer(SHIFTREG_DMA_CHANNEL);
+}
+
+static void _shiftregDone(int channel, void *context)
+{
+    /* The last byte left TXBUF: wait for it to be shifted out (8 SPI clocks) */
+    while(SHIFTREG_SPI->STATW & EUSCI_B_STATW_SPI_BUSY);
+
+    SHIFTREG_PORT->OUT = SHIFTREG_PORT->OUT | SHIFTREG_LATCH;
+    SHIFTREG_PORT->OUT = SHIFTREG_PORT->OUT & ~SHIFTREG_LATCH;
+
+    _shiftregTransfers++;
+
+    if(_shiftregDirty)
+        _shiftregStart();
+    else
+        _shiftregBusy = 0;
+}
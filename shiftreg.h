@@ -0,0 +1,75 @@
+/**
+ @file    shiftreg.h
+
+ @brief   LEDs on a chain of 74HC595 shift registers, refreshed by SPI and DMA
+
+ The outputs of the chain are bits of an image in RAM: output k is the bit
+ k % 8 (Qn) of register k / 8, register 0 being the one wired to the MCU. The
+ image is shifted out by eUSCI_B2 as SPI master (SIMO on P3.6, clock remapped
+ to P3.0, BUTTON3 keeping P3.5), its DMA channel (4) sending the whole chain
+ with one interrupt, which then pulses the latch (RCLK on P3.7).
+
+ Changing outputs only changes the image. A flush starts a transfer of a copy
+ of the image, or, while one is running, marks the image for another transfer
+ when it ends: all the changes made meanwhile cost a single transfer. The
+ LED module (see led.h) presents the outputs as the LEDs after the MCU pins,
+ flushed at each change or at each commit in deferred mode.
+
+ At 8 MHz the 16 bytes of 128 outputs take 16 us, with no CPU time but the
+ final interrupt.
+
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+*/
+
+// Do not write above this line (except comments)!
+#ifndef SHIFTREG_H
+#define SHIFTREG_H
+
+/* SECTION 1: Included header files required to compile this file  */
+#include <stdint.h>
+
+
+/* SECTION 2: Public macros                                        */
+
+/**
+ @brief Shift registers of the chain, 8 outputs each
+*/
+#define SHIFTREG_NUM_CHIPS    16
+#define SHIFTREG_NUM_OUTPUTS  (SHIFTREG_NUM_CHIPS * 8)
+
+/**
+ @brief SPI clock (at most SMCLK)
+*/
+#define SHIFTREG_SPI_HZ       8000000
+
+#define SHIFTREG_OP_ON      0
+#define SHIFTREG_OP_OFF     1
+#define SHIFTREG_OP_TOGGLE  2
+
+
+/* SECTION 3: Public types                                         */
+
+
+/* SECTION 4: Public variables :: declarations, extern mandatory   */
+
+
+/* SECTION 5: Public functions :: declarations, extern optional
+   Rule exception (callbacks)  :: declarations, extern recommended */
+
+void shiftregInit(void); //Initialization function, all the outputs off
+
+int shiftregSet(int which_output, int action); //Change an output of the image (SHIFTREG_OP_x), callable from any context
+
+int shiftregGet(int which_output); //Retrieve the state of an output in the image
+
+int shiftregFlush(void); //Send the image: 1 if started, 0 if sent after the current transfer
+
+int shiftregBusy(void); //1 while a transfer is running, 0 otherwise
+
+uint32_t shiftregTransfers(void); //Transfers completed since the initialization
+
+
+#endif //SHIFTREG_H
+// Do not write below this line!
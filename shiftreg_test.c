@@ -0,0 +1,271 @@
+/**
+ @file    shiftreg_test.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Host test of the LEDs on the 74HC595 chain
+
+ Built by host/Makefile. A chain of SHIFTREG_NUM_CHIPS 74HC595 is modeled on
+ the bytes the DMA writes to the SPI transmit buffer: each byte is shifted in
+ MSB first, the bits leaving register 0 entering register 1 and so on, and the
+ outputs take the shift registers when the transfer ends (the latch pulse of
+ the completion interrupt). The DMA is stepped one byte at a time, so the test
+ also changes the image in the middle of a transfer.
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "shiftreg.h"
+#include "led.h"
+#include "dma.h"
+#include "defer.h"
+#include "persist.h"
+#include "systime.h"
+#include "sim.h"
+
+/* The whole file belongs to the host build (see host/Makefile) */
+#ifdef BENCH_HOST
+
+
+/* SECTION 2: Private macros                                       */
+
+#define TEST_DMA_CHANNEL  4     //Channel of eUSCI_B2 TX (see shiftreg.c)
+#define TEST_LATCH        BIT7  //P3.7
+
+
+/* SECTION 3: Private types                                        */
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+static uint8_t _testShift [SHIFTREG_NUM_CHIPS];     /**< Shift registers of the chain, register 0 first */
+static uint8_t _testOutputs [SHIFTREG_NUM_CHIPS];   /**< Latched outputs */
+static uint32_t _testBytes = 0;                     /**< Bytes written to TXBUF */
+static uint32_t _testLatches = 0;
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static void _testSink(uint32_t value); //Shift a byte written to TXBUF into the chain
+
+static void _testStart(void); //Reset the simulation and the driver, the chain full of garbage
+
+static int _testStep(void); //Let the DMA move one byte, latch if the transfer ended; returns the bytes moved
+
+static void _testRun(void); //Let the DMA run until the chain is idle
+
+static int _testOutput(int which_output); //State of a latched output
+
+static int _testMatches(void); //1 if every latched output equals the image
+
+static void _testInit(void);
+
+static void _testChain(void);
+
+static void _testCoalesce(void);
+
+static void _testLeds(void);
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+int main(void)
+{
+    _testInit();
+    _testChain();
+    _testCoalesce();
+    _testLeds();
+
+    return simReport("shiftreg_test");
+}
+
+static void _testSink(uint32_t value)
+{
+    int i;
+
+    /* Register 0 takes the new byte, every register passes its byte on */
+    for(i = SHIFTREG_NUM_CHIPS - 1; i > 0; i--)
+        _testShift[i] = _testShift[i - 1];
+    _testShift[0] = (uint8_t)value;
+
+    _testBytes++;
+}
+
+static void _testStart(void)
+{
+    int i;
+
+    for(i = 0; i < SHIFTREG_NUM_CHIPS; i++)
+    {
+        _testShift[i] = 0xA5;
+        _testOutputs[i] = 0x5A;
+    }
+    _testBytes = 0;
+    _testLatches = 0;
+
+    simReset();
+    shiftregInit();
+    simDmaSink(&EUSCI_B2->TXBUF, _testSink);
+    Interrupt_enableMaster();
+}
+
+static int _testStep(void)
+{
+    uint32_t transfers = shiftregTransfers();
+    int n, i;
+
+    n = simDmaRequest(TEST_DMA_CHANNEL);
+
+    /* The completion interrupt pulsed the latch */
+    if(shiftregTransfers() != transfers)
+    {
+        for(i = 0; i < SHIFTREG_NUM_CHIPS; i++)
+            _testOutputs[i] = _testShift[i];
+        _testLatches++;
+    }
+
+    return n;
+}
+
+static void _testRun(void)
+{
+    while(_testStep() > 0);
+}
+
+static int _testOutput(int which_output)
+{
+    return (_testOutputs[which_output >> 3] >> (which_output & 0x07)) & 1;
+}
+
+static int _testMatches(void)
+{
+    int k;
+
+    for(k = 0; k < SHIFTREG_NUM_OUTPUTS; k++)
+    {
+        if(_testOutput(k) != shiftregGet(k))
+            return 0;
+    }
+
+    return 1;
+}
+
+static void _testInit(void)
+{
+    _testStart();
+
+    /* The outputs power up with random values: cleared by the initialization */
+    SIM_CHECK(shiftregBusy() == 1);
+    _testRun();
+    SIM_CHECK(shiftregBusy() == 0 && shiftregTransfers() == 1 && _testLatches == 1);
+    SIM_CHECK(_testBytes == SHIFTREG_NUM_CHIPS && _testMatches());
+    SIM_CHECK(_testOutputs[0] == 0 && _testOutputs[SHIFTREG_NUM_CHIPS - 1] == 0);
+
+    /* Clock remapped to P3.0, P3.5 left to BUTTON3, latch low between pulses */
+    SIM_CHECK(P3MAP->PMAP_REGISTER[0] == PMAP_UCB2CLK && P3MAP->PMAP_REGISTER[6] == PMAP_UCB2SIMO);
+    SIM_CHECK((P3->SEL0 & BIT5) == 0 && (P3->DIR & TEST_LATCH) != 0 && (P3->OUT & TEST_LATCH) == 0);
+    SIM_CHECK(EUSCI_B2->BRW == (SystemCoreClock + SHIFTREG_SPI_HZ - 1) / SHIFTREG_SPI_HZ);
+}
+
+static void _testChain(void)
+{
+    int k;
+
+    _testStart();
+    _testRun();
+
+    /* Every output reaches its own pin: first and last of the chain, and a pattern */
+    for(k = 0; k < SHIFTREG_NUM_OUTPUTS; k++)
+    {
+        if(k % 3 == 0 || k == 1 || k == SHIFTREG_NUM_OUTPUTS - 1)
+            shiftregSet(k, SHIFTREG_OP_ON);
+    }
+    SIM_CHECK(shiftregFlush() == 1);
+    _testRun();
+    SIM_CHECK(_testMatches() && _testOutput(0) == 1 && _testOutput(1) == 1 && _testOutput(2) == 0);
+    SIM_CHECK(_testOutput(SHIFTREG_NUM_OUTPUTS - 1) == 1 && _testOutput(SHIFTREG_NUM_OUTPUTS - 3) == 0);
+
+    /* Toggle and off */
+    for(k = 0; k < SHIFTREG_NUM_OUTPUTS; k++)
+        shiftregSet(k, SHIFTREG_OP_TOGGLE);
+    shiftregSet(2, SHIFTREG_OP_OFF);
+    shiftregFlush();
+    _testRun();
+    SIM_CHECK(_testMatches() && _testOutput(0) == 0 && _testOutput(2) == 0 && _testOutput(4) == 1);
+    SIM_CHECK(shiftregTransfers() == 3 && _testBytes == 3 * SHIFTREG_NUM_CHIPS);
+
+    /* Changes alone do not touch the outputs */
+    shiftregSet(4, SHIFTREG_OP_OFF);
+    SIM_CHECK(shiftregGet(4) == 0 && _testOutput(4) == 1 && shiftregBusy() == 0);
+
+    SIM_CHECK(shiftregSet(-1, SHIFTREG_OP_ON) == -1);
+    SIM_CHECK(shiftregSet(SHIFTREG_NUM_OUTPUTS, SHIFTREG_OP_ON) == -1);
+    SIM_CHECK(shiftregSet(0, SHIFTREG_OP_TOGGLE + 1) == -1);
+    SIM_CHECK(shiftregGet(SHIFTREG_NUM_OUTPUTS) == -1);
+}
+
+static void _testCoalesce(void)
+{
+    int i;
+
+    _testStart();
+    _testRun();
+
+    /* Half the chain sent when the image changes: the copy being sent is not affected */
+    shiftregSet(10, SHIFTREG_OP_ON);
+    SIM_CHECK(shiftregFlush() == 1);
+    for(i = 0; i < SHIFTREG_NUM_CHIPS / 2; i++)
+        _testStep();
+    SIM_CHECK(shiftregBusy() == 1);
+
+    /* Three flushes during the transfer: one more transfer only */
+    shiftregSet(20, SHIFTREG_OP_ON);
+    SIM_CHECK(shiftregFlush() == 0);
+    shiftregSet(30, SHIFTREG_OP_ON);
+    SIM_CHECK(shiftregFlush() == 0);
+    shiftregSet(10, SHIFTREG_OP_OFF);
+    SIM_CHECK(shiftregFlush() == 0);
+
+    for(i = 0; i < SHIFTREG_NUM_CHIPS / 2; i++)
+        _testStep();
+    SIM_CHECK(_testLatches == 2 && _testOutput(10) == 1 && _testOutput(20) == 0);
+    SIM_CHECK(shiftregBusy() == 1);
+
+    _testRun();
+    SIM_CHECK(_testLatches == 3 && shiftregTransfers() == 3 && shiftregBusy() == 0);
+    SIM_CHECK(_testMatches() && _testOutput(10) == 0 && _testOutput(20) == 1 && _testOutput(30) == 1);
+    SIM_CHECK(_testBytes == 3 * SHIFTREG_NUM_CHIPS);
+}
+
+static void _testLeds(void)
+{
+    persistInvalidate();
+    simReset();
+    deferInit();
+    systimeInit();
+    ledsInit();
+    simDmaSink(&EUSCI_B2->TXBUF, _testSink);
+    Interrupt_enableMaster();
+    _testLatches = 0;
+    _testRun();
+
+    /* The LEDs after the pins are the outputs of the chain */
+    SIM_CHECK(ledsGetNum() == LED_NUM_PINS + SHIFTREG_NUM_OUTPUTS);
+    SIM_CHECK(ledOn(LED_CHAIN(0)) == 1 && ledOn(LED_CHAIN(SHIFTREG_NUM_OUTPUTS - 1)) == 1);
+    _testRun();
+    SIM_CHECK(_testOutput(0) == 1 && _testOutput(SHIFTREG_NUM_OUTPUTS - 1) == 1 && _testMatches());
+    SIM_CHECK(ledGet(LED_CHAIN(0)) == 1 && ledGet(LED_CHAIN(1)) == 0);
+    SIM_CHECK(ledOn(LED_CHAIN(SHIFTREG_NUM_OUTPUTS)) == -1);
+}
+
+#endif //BENCH_HOST
@@ -0,0 +1,187 @@
+/**
+ @file    stackmon.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Stack high-water mark and stack depth used by each ISR
+
+ @remark stackmonPaint runs before the C initialization routine, so it must not
+ depend on initialized data.
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "stackmon.h"
+
+
+/* SECTION 2: Private macros                                       */
+
+/**
+ @brief Bounds of .stack, from the linker (the stack grows down from the end),
+ and the stack pointer of the function using it (its own frame above)
+*/
+#ifndef BENCH_HOST
+#define STACKMON_BASE  (&__stack)
+#define STACKMON_END   (&__STACK_END)
+#define STACKMON_SP()  ((uint32_t *)__get_MSP())
+#else
+#define STACKMON_BASE  (&stackmonHostStack[0])
+#define STACKMON_END   (&stackmonHostStack[STACKMON_HOST_WORDS])
+#define STACKMON_SP()  stackmonHostSp
+#endif
+
+#define STACKMON_WINDOW_WORDS  (STACKMON_ISR_WINDOW / 4)
+#define STACKMON_GUARD_WORDS   (STACKMON_GUARD / 4)
+
+
+/* SECTION 3: Private types                                        */
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+#ifdef BENCH_HOST
+uint32_t stackmonHostStack[STACKMON_HOST_WORDS];
+uint32_t *stackmonHostSp = &stackmonHostStack[STACKMON_HOST_WORDS];
+#endif
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+#ifndef BENCH_HOST
+extern uint32_t __stack;
+extern uint32_t __STACK_END;
+#endif
+
+static uint32_t *_stackmonDeepest = 0;            /**< Lowest word found used before a window was painted again */
+static int32_t _stackmonIsrMax [STACKMON_NUM_ISRS];
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static uint32_t *_stackmonWindow(uint32_t *sp); //Bottom of the window below a stack pointer
+
+static uint32_t *_stackmonFirstUsed(uint32_t *from, uint32_t *to); //First word not painted in [from, to), to if none
+
+static uint32_t *_stackmonPaintEnd(uint32_t *sp); //End of what the calling function may paint: below its frame and the guard, at most sp
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+void stackmonPaint(void)
+{
+    uint32_t *word, *end;
+
+    /* Below this function's frame nothing is live yet. The loop is written out:
+       the frame of a call (stackmonFill) would lie in the words it paints */
+    end = _stackmonPaintEnd(STACKMON_END);
+    for(word = STACKMON_BASE; word < end; word++)
+        *word = STACKMON_PATTERN;
+}
+
+int32_t stackmonSize(void)
+{
+    return (int32_t)((STACKMON_END - STACKMON_BASE) * 4);
+}
+
+int32_t stackmonHighWater(void)
+{
+    uint32_t *deepest;
+
+    deepest = _stackmonFirstUsed(STACKMON_BASE, STACKMON_END);
+
+    if(_stackmonDeepest != 0 && _stackmonDeepest < deepest)
+        deepest = _stackmonDeepest;
+
+    return (int32_t)((STACKMON_END - deepest) * 4);
+}
+
+int32_t stackmonIsrMax(int which_isr)
+{
+    if(which_isr < 0 || which_isr > STACKMON_NUM_ISRS-1)
+        return -1;
+
+    return _stackmonIsrMax[which_isr];
+}
+
+uint32_t *stackmonIsrEnter(uint32_t *sp)
+{
+    uint32_t *bottom, *used, *end;
+
+    /* What the window hides is part of the high-water mark: keep it first */
+    bottom = _stackmonWindow(sp);
+    used = _stackmonFirstUsed(bottom, sp);
+
+    if(used < sp && (_stackmonDeepest == 0 || used < _stackmonDeepest))
+        _stackmonDeepest = used;
+
+    /* The caller's sp is above this function's frame: paint below the frame only,
+       calling nothing meanwhile */
+    end = _stackmonPaintEnd(sp);
+    while(used < end)
+        *used++ = STACKMON_PATTERN;
+
+    return sp;
+}
+
+void stackmonIsrExit(int which_isr, uint32_t *sp)
+{
+    uint32_t *used;
+    int32_t depth;
+
+    used = _stackmonFirstUsed(_stackmonWindow(sp), sp);
+    depth = (int32_t)((sp - used) * 4);
+
+    if(used < sp && (_stackmonDeepest == 0 || used < _stackmonDeepest))
+        _stackmonDeepest = used;
+
+    if(which_isr >= 0 && which_isr < STACKMON_NUM_ISRS && depth > _stackmonIsrMax[which_isr])
+        _stackmonIsrMax[which_isr] = depth;
+}
+
+void stackmonFill(uint32_t *from, uint32_t *to)
+{
+    while(from < to)
+        *from++ = STACKMON_PATTERN;
+}
+
+int32_t stackmonUnused(const uint32_t *from, const uint32_t *to)
+{
+    return (int32_t)((_stackmonFirstUsed((uint32_t *)from, (uint32_t *)to) - from) * 4);
+}
+
+static uint32_t *_stackmonWindow(uint32_t *sp)
+{
+    if(sp - STACKMON_BASE < STACKMON_WINDOW_WORDS)
+        return STACKMON_BASE;
+
+    return sp - STACKMON_WINDOW_WORDS;
+}
+
+static uint32_t *_stackmonFirstUsed(uint32_t *from, uint32_t *to)
+{
+    while(from < to && *from == STACKMON_PATTERN)
+        from++;
+
+    return from;
+}
+
+static uint32_t *_stackmonPaintEnd(uint32_t *sp)
+{
+    uint32_t *own;
+
+    /* Inlined by the compiler or not, the stack pointer read here is at most the caller's */
+    own = STACKMON_SP();
+    if(own - STACKMON_BASE < STACKMON_GUARD_WORDS)
+        return STACKMON_BASE;
+
+    own = own - STACKMON_GUARD_WORDS;
+
+    return (own < sp) ? own : sp;
+}
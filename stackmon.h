@@ -0,0 +1,128 @@
+/**
+ @file    stackmon.h
+
+ @brief   Stack high-water mark and stack depth used by each ISR
+
+ The reset handler fills the free part of .stack with a known pattern before
+ the C initialization routine runs. The words that no longer hold it have been
+ used: scanning from the bottom of the stack gives the deepest point ever
+ reached, so the --stack_size of the project can be cut down to it plus a margin.
+
+ The ISRs instrumented with STACKMON_ISR_ENTER/STACKMON_ISR_EXIT also report
+ their own depth: the entry paints again the STACKMON_ISR_WINDOW bytes below the
+ stack pointer (keeping the deepest point seen so far), and the exit finds how
+ far down the handler, its callbacks and the ISRs nested in it wrote. The
+ depth is counted from the stack pointer in the body of the handler, so the
+ exception frame (32 bytes, 104 with the FPU context) and the registers saved
+ by the prologue come on top.
+
+ Painting never reaches the frame of the painting function: stackmonPaint and
+ stackmonIsrEnter stop STACKMON_GUARD bytes below their own stack pointer, and
+ call nothing while they paint. The frame of stackmonIsrEnter and the guard are
+ therefore the smallest depth an ISR can show. The pair costs about 2 cycles per word of the
+ window; unless the build sets STACKMON_ISR_ENABLED to 1 the macros disappear.
+
+ The scans work on any region of words (stackmonFill, stackmonUnused), so
+ they can be checked on the host over a simulated stack.
+
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+*/
+
+// Do not write above this line (except comments)!
+#ifndef STACKMON_H
+#define STACKMON_H
+
+/* SECTION 1: Included header files required to compile this file  */
+#include <stdint.h>
+
+
+/* SECTION 2: Public macros                                        */
+
+/**
+ @brief Set to 1 to measure the ISRs (--define=STACKMON_ISR_ENABLED=1 in a debug
+ build configuration, as BENCHMARK_BUILD); off by default
+*/
+#ifndef STACKMON_ISR_ENABLED
+#define STACKMON_ISR_ENABLED  0
+#endif
+
+/**
+ @brief Bytes painted below the stack pointer at the entry of an ISR, the largest depth it can measure
+*/
+#define STACKMON_ISR_WINDOW   256
+
+/**
+ @brief Bytes left unpainted below the stack pointer of the painting function
+*/
+#define STACKMON_GUARD        16
+
+#define STACKMON_PATTERN      0xDEADBEEFu
+
+/**
+ @brief Instrumented ISRs
+*/
+#define STACKMON_ISR_PORT1    0
+#define STACKMON_ISR_PORT2    1
+#define STACKMON_ISR_PORT3    2
+#define STACKMON_ISR_PORT4    3
+#define STACKMON_ISR_PORT5    4
+#define STACKMON_ISR_PORT6    5
+#define STACKMON_ISR_SYSTIME  6 //TA0_N_IRQHandler, with the alarm callbacks
+#define STACKMON_ISR_DMA      7 //DMA_INT0_IRQHandler, with the completion callbacks
+#define STACKMON_ISR_CAPTURE  8 //TA2_0_IRQHandler and TA2_N_IRQHandler, the captured button edges
+
+#define STACKMON_NUM_ISRS     9
+
+/**
+ @brief First and last statement of an instrumented ISR (no return in between),
+ left out of host builds, which pass simulated stack pointers to the functions
+*/
+#if STACKMON_ISR_ENABLED && !defined(BENCH_HOST)
+#define STACKMON_ISR_ENTER(id)  uint32_t *_stackmonSp = stackmonIsrEnter((uint32_t *)__get_MSP())
+#define STACKMON_ISR_EXIT(id)   stackmonIsrExit((id), _stackmonSp)
+#else
+#define STACKMON_ISR_ENTER(id)
+#define STACKMON_ISR_EXIT(id)   ((void)0)
+#endif
+
+/**
+ @brief Words of the simulated stack of a host build
+*/
+#define STACKMON_HOST_WORDS   128
+
+
+/* SECTION 3: Public types                                         */
+
+
+/* SECTION 4: Public variables :: declarations, extern mandatory   */
+
+#ifdef BENCH_HOST
+extern uint32_t stackmonHostStack[STACKMON_HOST_WORDS]; //Stands for .stack in a host build
+extern uint32_t *stackmonHostSp; //Stands for the stack pointer of the stackmon functions in a host build
+#endif
+
+
+/* SECTION 5: Public functions :: declarations, extern optional
+   Rule exception (callbacks)  :: declarations, extern recommended */
+
+void stackmonPaint(void); //Paint the stack below the frame of this function, called from the reset handler
+
+int32_t stackmonSize(void); //Bytes reserved for the stack
+
+int32_t stackmonHighWater(void); //Bytes of stack used at most since the reset
+
+int32_t stackmonIsrMax(int which_isr); //Bytes of stack used at most by an ISR (STACKMON_ISR_x), -1 if invalid
+
+uint32_t *stackmonIsrEnter(uint32_t *sp); //Paint the window below the stack pointer and this function's frame, use STACKMON_ISR_ENTER
+
+void stackmonIsrExit(int which_isr, uint32_t *sp); //Measure the window painted at the entry, use STACKMON_ISR_EXIT
+
+void stackmonFill(uint32_t *from, uint32_t *to); //Paint the words in [from, to)
+
+int32_t stackmonUnused(const uint32_t *from, const uint32_t *to); //Bytes still painted from the bottom of [from, to)
+
+
+#endif //STACKMON_H
+// Do not write below this line!
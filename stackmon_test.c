@@ -0,0 +1,179 @@
+/**
+ @file    stackmon_test.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Host test of the stack high-water mark and of the ISR depths
+
+ Built by host/Makefile. The stack is stackmonHostStack, and the stack
+ pointer the stackmon functions would read is stackmonHostSp: the test lays
+ out the frames a call would leave on it (the reset handler, an ISR calling
+ stackmonIsrEnter) and checks that painting never writes into them, that the
+ depths measured by the ISR pair are those written by the handler body, and
+ that the high-water mark keeps what a repainted window hid.
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "stackmon.h"
+#include "sim.h"
+
+/* The whole file belongs to the host build (see host/Makefile) */
+#ifdef BENCH_HOST
+
+
+/* SECTION 2: Private macros                                       */
+
+#define TEST_GUARD_WORDS  (STACKMON_GUARD / 4)
+#define TEST_FRAME        0x12345678u   //Value of the words of a live frame
+#define TEST_USED         0x00000000u   //Value written by a handler body
+
+
+/* SECTION 3: Private types                                        */
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static void _testWrite(int from, int to, uint32_t value); //Write a value in the words [from, to) of the stack
+
+static int _testHolds(int from, int to, uint32_t value); //1 if the words [from, to) of the stack hold a value
+
+static void _testRegions(void);
+
+static void _testPaint(void);
+
+static void _testIsr(void);
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+int main(void)
+{
+    _testRegions();
+    _testPaint();
+    _testIsr();
+
+    return simReport("stackmon_test");
+}
+
+static void _testWrite(int from, int to, uint32_t value)
+{
+    while(from < to)
+        stackmonHostStack[from++] = value;
+}
+
+static int _testHolds(int from, int to, uint32_t value)
+{
+    while(from < to)
+    {
+        if(stackmonHostStack[from++] != value)
+            return 0;
+    }
+
+    return 1;
+}
+
+static void _testRegions(void)
+{
+    uint32_t words [16];
+
+    stackmonFill(&words[0], &words[16]);
+    SIM_CHECK(stackmonUnused(&words[0], &words[16]) == 64);
+    words[9] = TEST_USED;
+    SIM_CHECK(stackmonUnused(&words[0], &words[16]) == 36);
+    words[0] = TEST_USED;
+    SIM_CHECK(stackmonUnused(&words[0], &words[16]) == 0);
+    SIM_CHECK(stackmonUnused(&words[4], &words[4]) == 0);
+}
+
+static void _testPaint(void)
+{
+    /* Reset handler: its frame in the top 8 words, the stack pointer below it */
+    _testWrite(0, STACKMON_HOST_WORDS, TEST_USED);
+    _testWrite(STACKMON_HOST_WORDS - 8, STACKMON_HOST_WORDS, TEST_FRAME);
+    stackmonHostSp = &stackmonHostStack[STACKMON_HOST_WORDS - 8];
+    stackmonPaint();
+
+    /* Painted up to the guard below the frame, the frame intact */
+    SIM_CHECK(_testHolds(0, STACKMON_HOST_WORDS - 8 - TEST_GUARD_WORDS, STACKMON_PATTERN));
+    SIM_CHECK(_testHolds(STACKMON_HOST_WORDS - 8 - TEST_GUARD_WORDS, STACKMON_HOST_WORDS - 8, TEST_USED));
+    SIM_CHECK(_testHolds(STACKMON_HOST_WORDS - 8, STACKMON_HOST_WORDS, TEST_FRAME));
+    SIM_CHECK(stackmonSize() == STACKMON_HOST_WORDS * 4);
+    SIM_CHECK(stackmonHighWater() == (8 + TEST_GUARD_WORDS) * 4);
+
+    /* The application goes 20 words deeper */
+    _testWrite(STACKMON_HOST_WORDS - 40, STACKMON_HOST_WORDS - 8, TEST_USED);
+    SIM_CHECK(stackmonHighWater() == 40 * 4);
+
+    /* Stack pointer too close to the bottom: nothing painted */
+    _testWrite(0, 4, TEST_USED);
+    stackmonHostSp = &stackmonHostStack[2];
+    stackmonPaint();
+    SIM_CHECK(_testHolds(0, 4, TEST_USED));
+    _testWrite(0, 4, STACKMON_PATTERN);
+}
+
+static void _testIsr(void)
+{
+    uint32_t *sp, *taken;
+    int top, own;
+
+    /* An ISR body at word 80; stackmonIsrEnter saved 6 words below it */
+    top = 80;
+    own = top - 6;
+    sp = &stackmonHostStack[top];
+    _testWrite(own, top, TEST_FRAME);
+    stackmonHostSp = &stackmonHostStack[own];
+
+    /* Some earlier code went down to word 50, inside the window */
+    _testWrite(50, own, TEST_USED);
+    taken = stackmonIsrEnter(sp);
+    SIM_CHECK(taken == sp);
+
+    /* The frame of the entry is not painted over; the window is, below the guard */
+    SIM_CHECK(_testHolds(own, top, TEST_FRAME));
+    SIM_CHECK(_testHolds(50, own - TEST_GUARD_WORDS, STACKMON_PATTERN));
+    SIM_CHECK(stackmonHighWater() == (STACKMON_HOST_WORDS - 50) * 4);
+
+    /* The body and its callbacks go 24 words down */
+    _testWrite(top - 24, top, TEST_USED);
+    stackmonIsrExit(STACKMON_ISR_PORT1, sp);
+    SIM_CHECK(stackmonIsrMax(STACKMON_ISR_PORT1) == 24 * 4);
+
+    /* A shallow body: the depth is at most the frame of the entry and the guard */
+    _testWrite(own, top, TEST_FRAME);
+    stackmonIsrEnter(sp);
+    stackmonIsrExit(STACKMON_ISR_SYSTIME, sp);
+    SIM_CHECK(stackmonIsrMax(STACKMON_ISR_SYSTIME) <= (6 + TEST_GUARD_WORDS) * 4);
+    SIM_CHECK(stackmonIsrMax(STACKMON_ISR_SYSTIME) >= 6 * 4);
+    SIM_CHECK(stackmonIsrMax(STACKMON_ISR_PORT1) == 24 * 4);
+
+    /* A nested ISR goes deeper than the window: the depth saturates at it,
+       the high-water mark goes to the bottom */
+    _testWrite(own, top, TEST_FRAME);
+    stackmonIsrEnter(sp);
+    _testWrite(0, top, TEST_USED);
+    stackmonIsrExit(STACKMON_ISR_DMA, sp);
+    SIM_CHECK(stackmonIsrMax(STACKMON_ISR_DMA) == STACKMON_ISR_WINDOW);
+    SIM_CHECK(stackmonHighWater() == STACKMON_HOST_WORDS * 4);
+
+    SIM_CHECK(stackmonIsrMax(-1) == -1 && stackmonIsrMax(STACKMON_NUM_ISRS) == -1);
+    SIM_CHECK(stackmonIsrMax(STACKMON_ISR_PORT6) == 0);
+
+    stackmonHostSp = &stackmonHostStack[STACKMON_HOST_WORDS];
+}
+
+#endif //BENCH_HOST
@@ -0,0 +1,372 @@
+/**
+ @file    strip.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Addressable RGB LED strip (WS2812 one-wire protocol) driven by SPI and DMA
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "strip.h"
+#include "dma.h"
+
+
+/* SECTION 2: Private macros                                       */
+
+/**
+ @brief SPI peripheral, pin and DMA channel (channel 0 belongs to the trace UART, see trace.c)
+*/
+#define STRIP_SPI          EUSCI_B3
+#define STRIP_PORT         P6
+#define STRIP_PIN          BIT6
+#define STRIP_DMA_CHANNEL  6
+#define STRIP_DMA_SOURCE   DMA_CH6_EUSCIB3TX0
+
+/**
+ @brief Items of one DMA transfer
+*/
+#define STRIP_DMA_CHUNK    1024
+
+/**
+ @brief Size of an SPI buffer, and DMA transfers to send it
+*/
+#define STRIP_BUFFER_BYTES (STRIP_NUM_PIXELS * STRIP_BYTES_PER_PIXEL + STRIP_RESET_BYTES)
+#define STRIP_NUM_CHUNKS   ((STRIP_BUFFER_BYTES + STRIP_DMA_CHUNK - 1) / STRIP_DMA_CHUNK)
+
+
+/* SECTION 3: Private types                                        */
+
+/**
+ @brief Pixel of the frame buffer
+*/
+struct strip_pixel_s {
+   uint8_t red;
+   uint8_t green;
+   uint8_t blue;
+};
+
+/**
+ @brief Short alias "strip_pixel_t" for the data type "struct strip_pixel_s"
+*/
+typedef struct strip_pixel_s strip_pixel_t;
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+/**
+ @brief SPI code of each nibble: 110 for a 1 bit, 100 for a 0 bit, MSB first
+*/
+static const uint16_t _stripNibble [16] = {
+     0x924, 0x926, 0x934, 0x936, 0x9A4, 0x9A6, 0x9B4, 0x9B6,
+     0xD24, 0xD26, 0xD34, 0xD36, 0xDA4, 0xDA6, 0xDB4, 0xDB6
+};
+
+static strip_pixel_t _stripPixels [STRIP_NUM_PIXELS];   /**< Frame buffer          */
+
+static uint8_t _stripBuffer [2][STRIP_BUFFER_BYTES];    /**< Encoded SPI buffers   */
+
+/**
+ @brief Pixels changed since each SPI buffer was last encoded: [first, last)
+*/
+static uint16_t _stripDirtyFirst [2];
+static uint16_t _stripDirtyLast [2];
+
+static uint8_t _stripLevel [256];                      /**< Value sent for each color value */
+static uint8_t _stripBrightness = 255;
+
+static volatile uint8_t _stripFront = 0;    /**< SPI buffer being sent, or last sent */
+static volatile uint8_t _stripBusy = 0;     /**< Flag (0/1) set while a frame is sent */
+static volatile uint8_t _stripReady = 0;    /**< Flag (0/1): the other buffer waits to be sent */
+static uint16_t _stripOffset = 0;           /**< Next byte of the front buffer to hand to the DMA */
+static uint8_t _stripChunk = 0;             /**< Transfers of the frame completed        */
+
+static uint32_t _stripEncoded = 0;
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static void _stripLevels(void); //Fill the table of sent values from the brightness
+
+static void _stripDirty(int first, int last); //Mark pixels [first, last) as changed for both buffers
+
+static void _stripEncode(int buffer); //Encode the changed pixels into an SPI buffer
+
+static void _stripStart(void); //Start sending the front buffer
+
+static void _stripArm(uint32_t select); //Hand the next chunk of the front buffer to a DMA structure
+
+static void _stripDone(int channel, void *context); //DMA completion of a chunk
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+void stripInit(void)
+{
+    uint32_t i, n;
+
+    for(i = 0; i < STRIP_NUM_PIXELS; i++)
+    {
+        _stripPixels[i].red = 0;
+        _stripPixels[i].green = 0;
+        _stripPixels[i].blue = 0;
+    }
+
+    /* The latch time at the end of both buffers is never rewritten */
+    for(i = STRIP_NUM_PIXELS * STRIP_BYTES_PER_PIXEL; i < STRIP_BUFFER_BYTES; i++)
+    {
+        _stripBuffer[0][i] = 0;
+        _stripBuffer[1][i] = 0;
+    }
+
+    _stripBrightness = 255;
+    _stripLevels();
+    _stripDirtyFirst[0] = _stripDirtyFirst[1] = STRIP_NUM_PIXELS;
+    _stripDirtyLast[0] = _stripDirtyLast[1] = 0;
+    _stripDirty(0, STRIP_NUM_PIXELS);
+    _stripFront = 0;
+    _stripBusy = 0;
+    _stripReady = 0;
+    _stripEncoded = 0;
+
+    /* SPI master, MSB first, only SIMO is used */
+    STRIP_SPI->CTLW0 = EUSCI_B_CTLW0_SWRST;
+    STRIP_SPI->CTLW0 = EUSCI_B_CTLW0_SWRST | EUSCI_B_CTLW0_MST | EUSCI_B_CTLW0_SYNC
+                     | EUSCI_B_CTLW0_MSB | EUSCI_B_CTLW0_SSEL__SMCLK;
+    n = (CS_getSMCLK() + STRIP_SPI_HZ / 2) / STRIP_SPI_HZ;
+    STRIP_SPI->BRW = n > 0 ? n : 1;
+    STRIP_PORT->SEL0 = STRIP_PORT->SEL0 & ~STRIP_PIN; //Secondary function, the primary one is TA2.3
+    STRIP_PORT->SEL1 = STRIP_PORT->SEL1 | STRIP_PIN;
+    STRIP_SPI->CTLW0 = STRIP_SPI->CTLW0 & ~EUSCI_B_CTLW0_SWRST;
+
+    dmaInit();
+    DMA_assignChannel(STRIP_DMA_SOURCE);
+    DMA_disableChannelAttribute(STRIP_DMA_SOURCE, UDMA_ATTR_ALTSELECT | UDMA_ATTR_USEBURST
+                                                | UDMA_ATTR_HIGH_PRIORITY | UDMA_ATTR_REQMASK);
+    DMA_setChannelControl(UDMA_PRI_SELECT | STRIP_DMA_SOURCE,
+                          UDMA_SIZE_8 | UDMA_SRC_INC_8 | UDMA_DST_INC_NONE | UDMA_ARB_1);
+    DMA_setChannelControl(UDMA_ALT_SELECT | STRIP_DMA_SOURCE,
+                          UDMA_SIZE_8 | UDMA_SRC_INC_8 | UDMA_DST_INC_NONE | UDMA_ARB_1);
+    DMA_clearInterruptFlag(STRIP_DMA_CHANNEL);
+    dmaChannelCallback(STRIP_DMA_CHANNEL, _stripDone, 0);
+}
+
+int stripGetNum(void)
+{
+    return STRIP_NUM_PIXELS;
+}
+
+int stripSetPixel(int which_pixel, uint8_t red, uint8_t green, uint8_t blue)
+{
+    strip_pixel_t *pixel;
+
+    if(which_pixel < 0 || which_pixel > STRIP_NUM_PIXELS-1)
+        return -1;
+
+    pixel = &_stripPixels[which_pixel];
+    if(pixel->red == red && pixel->green == green && pixel->blue == blue)
+        return 1;
+
+    pixel->red = red;
+    pixel->green = green;
+    pixel->blue = blue;
+    _stripDirty(which_pixel, which_pixel + 1);
+
+    return 1;
+}
+
+int stripFill(int first_pixel, int num_pixels, uint8_t red, uint8_t green, uint8_t blue)
+{
+    int i;
+
+    if(first_pixel < 0 || num_pixels < 0 || first_pixel + num_pixels > STRIP_NUM_PIXELS)
+        return -1;
+
+    for(i = first_pixel; i < first_pixel + num_pixels; i++)
+    {
+        _stripPixels[i].red = red;
+        _stripPixels[i].green = green;
+        _stripPixels[i].blue = blue;
+    }
+    _stripDirty(first_pixel, first_pixel + num_pixels);
+
+    return 1;
+}
+
+int stripSetBrightness(uint8_t level)
+{
+    if(level == _stripBrightness)
+        return 1;
+
+    _stripBrightness = level;
+    _stripLevels();
+    _stripDirty(0, STRIP_NUM_PIXELS);
+
+    return 1;
+}
+
+int stripShow(void)
+{
+    int back;
+    bool state;
+
+    /* The back buffer cannot be taken by the DMA completion while it is encoded */
+    CRITICAL_ENTER(state);
+    _stripReady = 0;
+    back = _stripFront ^ 1;
+    CRITICAL_EXIT(state);
+
+    _stripEncode(back);
+
+    CRITICAL_ENTER(state);
+
+    if(_stripBusy)
+    {
+        _stripReady = 1;
+        CRITICAL_EXIT(state);
+        return 0;
+    }
+
+    _stripFront = back;
+    _stripBusy = 1;
+    CRITICAL_EXIT(state);
+
+    _stripStart();
+
+    return 1;
+}
+
+int stripBusy(void)
+{
+    return _stripBusy;
+}
+
+uint32_t stripEncodedPixels(void)
+{
+    return _stripEncoded;
+}
+
+static void _stripLevels(void)
+{
+    uint32_t value, level;
+
+    for(value = 0; value < 256; value++)
+    {
+#if STRIP_GAMMA
+        /* Mean of value^2 and value^3 (normalized): gamma about 2.5, integer only */
+        level = value * value * (255 + value) / (2 * 255 * 255);
+#else
+        level = value;
+#endif
+        _stripLevel[value] = (level * _stripBrightness + 127) / 255;
+    }
+}
+
+static void _stripDirty(int first, int last)
+{
+    int buffer;
+
+    for(buffer = 0; buffer < 2; buffer++)
+    {
+        if(first < _stripDirtyFirst[buffer])
+            _stripDirtyFirst[buffer] = first;
+        if(last > _stripDirtyLast[buffer])
+            _stripDirtyLast[buffer] = last;
+    }
+}
+
+static void _stripEncode(int buffer)
+{
+    const strip_pixel_t *pixel;
+    uint8_t *out;
+    uint8_t color[3];
+    uint32_t code;
+    int i, c;
+
+    out = &_stripBuffer[buffer][_stripDirtyFirst[buffer] * STRIP_BYTES_PER_PIXEL];
+
+    for(i = _stripDirtyFirst[buffer]; i < _stripDirtyLast[buffer]; i++)
+    {
+        /* Sent in green, red, blue order */
+        pixel = &_stripPixels[i];
+        color[0] = _stripLevel[pixel->green];
+        color[1] = _stripLevel[pixel->red];
+        color[2] = _stripLevel[pixel->blue];
+
+        for(c = 0; c < 3; c++)
+        {
+            code = ((uint32_t)_stripNibble[color[c] >> 4] << 12) | _stripNibble[color[c] & 0x0F];
+            out[0] = code >> 16;
+            out[1] = code >> 8;
+            out[2] = code;
+            out = out + 3;
+        }
+
+        _stripEncoded++;
+    }
+
+    _stripDirtyFirst[buffer] = STRIP_NUM_PIXELS;
+    _stripDirtyLast[buffer] = 0;
+}
+
+static void _stripStart(void)
+{
+    /* Ping-pong: the primary and alternate structures take turns */
+    _stripOffset = 0;
+    _stripChunk = 0;
+
+    _stripArm(UDMA_PRI_SELECT);
+    if(_stripOffset < STRIP_BUFFER_BYTES)
+        _stripArm(UDMA_ALT_SELECT);
+
+    DMA_enableChannel(STRIP_DMA_CHANNEL);
+
+    /* TXIFG is already set while idle: the first byte is requested by software */
+    DMA_requestSoftwareTransfer(STRIP_DMA_CHANNEL);
+}
+
+static void _stripArm(uint32_t select)
+{
+    uint32_t size;
+
+    size = STRIP_BUFFER_BYTES - _stripOffset;
+    if(size > STRIP_DMA_CHUNK)
+        size = STRIP_DMA_CHUNK;
+
+    DMA_setChannelTransfer(select | STRIP_DMA_SOURCE, UDMA_MODE_PINGPONG,
+                           &_stripBuffer[_stripFront][_stripOffset], (void *)&STRIP_SPI->TXBUF, size);
+    _stripOffset = _stripOffset + size;
+}
+
+static void _stripDone(int channel, void *context)
+{
+    /* Chunks complete in order, even ones on the primary structure: the one
+       just freed takes the chunk after the one the controller switched to */
+    if(_stripOffset < STRIP_BUFFER_BYTES)
+        _stripArm((_stripChunk & 1) ? UDMA_ALT_SELECT : UDMA_PRI_SELECT);
+
+    _stripChunk++;
+    if(_stripChunk < STRIP_NUM_CHUNKS)
+        return;
+
+    /* Frame over: the other buffer may be waiting */
+    if(_stripReady)
+    {
+        _stripReady = 0;
+        _stripFront = _stripFront ^ 1;
+        _stripStart();
+    }
+
+    else
+        _stripBusy = 0;
+}
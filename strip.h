@@ -0,0 +1,85 @@
+/**
+ @file    strip.h
+
+ @brief   Addressable RGB LED strip (WS2812 one-wire protocol) driven by SPI and DMA
+
+ The one-wire bit timing is produced by the SIMO line of eUSCI_B3 (P6.6): each
+ bit of a pixel becomes three SPI bits, 110 for a 1 and 100 for a 0, so an SPI
+ clock of 2.4 MHz gives the nominal 1.25 us bit. The clock is divided from
+ SMCLK, which at 12 MHz (see system_msp432p401r.c) gives it exactly.
+
+ The application writes a frame buffer of pixels; @ref stripShow encodes it into
+ one of two SPI buffers, the one not being sent, and the DMA sends it with no
+ CPU involvement except one interrupt per 1024 bytes. Each SPI buffer keeps
+ the range of pixels changed since it was last encoded, and only that range is
+ encoded again. The brightness and gamma correction are applied while encoding,
+ through a table.
+
+ The frame buffer functions must be called from the main loop only.
+
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+*/
+
+// Do not write above this line (except comments)!
+#ifndef STRIP_H
+#define STRIP_H
+
+/* SECTION 1: Included header files required to compile this file  */
+#include <stdint.h>
+
+
+/* SECTION 2: Public macros                                        */
+
+/**
+ @brief Number of pixels of the strip
+*/
+#define STRIP_NUM_PIXELS    300
+
+/**
+ @brief Set to 0 to send the color values linearly (brightness is still applied)
+*/
+#define STRIP_GAMMA         1
+
+/**
+ @brief SPI clock, three SPI bits per strip bit
+*/
+#define STRIP_SPI_HZ        2400000
+
+/**
+ @brief Bytes of SPI data per pixel (24 bits, 3 SPI bits each) and low time
+ appended to every frame to latch it (320 us at 2.4 MHz)
+*/
+#define STRIP_BYTES_PER_PIXEL  9
+#define STRIP_RESET_BYTES      96
+
+
+/* SECTION 3: Public types                                         */
+
+
+/* SECTION 4: Public variables :: declarations, extern mandatory   */
+
+
+/* SECTION 5: Public functions :: declarations, extern optional
+   Rule exception (callbacks)  :: declarations, extern recommended */
+
+void stripInit(void); //Initialization function, all the pixels off
+
+int stripGetNum(void); //Get the number of pixels
+
+int stripSetPixel(int which_pixel, uint8_t red, uint8_t green, uint8_t blue); //Change a pixel of the frame buffer
+
+int stripFill(int first_pixel, int num_pixels, uint8_t red, uint8_t green, uint8_t blue); //Change a range of pixels of the frame buffer
+
+int stripSetBrightness(uint8_t level); //Scale every color by level/255 from the next frame
+
+int stripShow(void); //Send the frame buffer: 1 if started, 0 if sent after the current frame
+
+int stripBusy(void); //1 while a frame is being sent, 0 otherwise
+
+uint32_t stripEncodedPixels(void); //Pixels encoded since the initialization
+
+
+#endif //STRIP_H
+// Do not write below this line!
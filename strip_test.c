@@ -0,0 +1,364 @@
+/**
+ @file    strip_test.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Host test of the LED strip driver
+
+ Built by host/Makefile. Every byte the DMA writes to the SPI transmit buffer
+ is collected and decoded back as a strip would: three SPI bits per strip bit
+ (100 or 110, anything else is an error), 24 bits per pixel in green, red, blue
+ order, then the low latch time. The decoded frames are compared with the frame
+ buffer through the gamma and brightness, and the dirty tracking is checked
+ with the count of pixels encoded.
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "strip.h"
+#include "dma.h"
+#include "sim.h"
+
+/* The whole file belongs to the host build (see host/Makefile) */
+#ifdef BENCH_HOST
+
+
+/* SECTION 2: Private macros                                       */
+
+#define TEST_DMA_CHANNEL  6     //Channel of eUSCI_B3 TX (see strip.c)
+#define TEST_NUM_CHUNKS   3     //DMA transfers of 1024 bytes per frame
+
+#define TEST_PIXEL_BYTES  (STRIP_NUM_PIXELS * STRIP_BYTES_PER_PIXEL)
+#define TEST_FRAME_BYTES  (TEST_PIXEL_BYTES + STRIP_RESET_BYTES)
+#define TEST_MAX_FRAMES   3
+
+
+/* SECTION 3: Private types                                        */
+
+/**
+ @brief Pixel decoded from the bitstream
+*/
+struct test_pixel_s {
+   uint8_t red;
+   uint8_t green;
+   uint8_t blue;
+};
+
+/**
+ @brief Short alias "test_pixel_t" for the data type "struct test_pixel_s"
+*/
+typedef struct test_pixel_s test_pixel_t;
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+static uint8_t _testStream [TEST_MAX_FRAMES * TEST_FRAME_BYTES];   /**< Bytes written to TXBUF */
+static uint32_t _testStreamed = 0;
+
+static test_pixel_t _testFrame [STRIP_NUM_PIXELS];  /**< Last frame decoded */
+
+/**
+ @brief Color values with their gamma corrected level at full brightness
+*/
+static const uint8_t _testValues [5] = { 0, 64, 128, 200, 255 };
+static const uint8_t _testLevels [5] = { 0, 10, 48, 139, 255 };
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static void _testSink(uint32_t value); //Collect a byte written to TXBUF
+
+static void _testStart(void); //Reset the simulation and the driver
+
+static int _testDecode(int frame); //Decode a frame of the stream into _testFrame, -1 if the coding is wrong
+
+static int _testPattern(int pixel, int c); //Index in _testValues of a color of a pixel of the test pattern
+
+static int _testMatches(int shift, int scale); //1 if _testFrame shows the pattern (shifted by some pixels, levels scaled by scale/255)
+
+static void _testSetPattern(int shift); //Write the pattern, shifted by some pixels, to the frame buffer
+
+static void _testTiming(void);
+
+static void _testFrames(void);
+
+static void _testDirty(void);
+
+static void _testDoubleBuffer(void);
+
+static void _testBrightness(void);
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+int main(void)
+{
+    _testTiming();
+    _testFrames();
+    _testDirty();
+    _testDoubleBuffer();
+    _testBrightness();
+
+    return simReport("strip_test");
+}
+
+static void _testSink(uint32_t value)
+{
+    if(_testStreamed < sizeof(_testStream))
+        _testStream[_testStreamed] = (uint8_t)value;
+    _testStreamed++;
+}
+
+static void _testStart(void)
+{
+    simReset();
+    stripInit();
+    simDmaSink(&EUSCI_B3->TXBUF, _testSink);
+    Interrupt_enableMaster();
+
+    _testStreamed = 0;
+}
+
+static int _testDecode(int frame)
+{
+    const uint8_t *stream = &_testStream[frame * TEST_FRAME_BYTES];
+    uint32_t bit, code, value;
+    uint8_t color[3];
+    int i, c, k;
+
+    for(i = 0; i < STRIP_NUM_PIXELS; i++)
+    {
+        for(c = 0; c < 3; c++)
+        {
+            value = 0;
+            for(k = 0; k < 8; k++)
+            {
+                /* Strip bit n of the frame: SPI bits 3n to 3n+2, MSB first */
+                bit = ((i * 3 + c) * 8 + k) * 3;
+                code = (((stream[bit / 8] << 8) | stream[bit / 8 + 1]) >> (13 - bit % 8)) & 0x7;
+                if(code != 0x4 && code != 0x6)
+                    return -1;
+
+                value = (value << 1) | (code == 0x6);
+            }
+            color[c] = (uint8_t)value;
+        }
+
+        _testFrame[i].green = color[0];
+        _testFrame[i].red = color[1];
+        _testFrame[i].blue = color[2];
+    }
+
+    /* Latch: the line stays low */
+    for(i = TEST_PIXEL_BYTES; i < TEST_FRAME_BYTES; i++)
+    {
+        if(stream[i] != 0)
+            return -1;
+    }
+
+    return 1;
+}
+
+static int _testPattern(int pixel, int c)
+{
+    return (pixel * 7 + c * 3) % 5;
+}
+
+static int _testMatches(int shift, int scale)
+{
+    int i, p;
+
+    for(i = 0; i < STRIP_NUM_PIXELS; i++)
+    {
+        p = (i + shift) % STRIP_NUM_PIXELS;
+        if(_testFrame[i].red != (_testLevels[_testPattern(p, 0)] * scale + 127) / 255
+           || _testFrame[i].green != (_testLevels[_testPattern(p, 1)] * scale + 127) / 255
+           || _testFrame[i].blue != (_testLevels[_testPattern(p, 2)] * scale + 127) / 255)
+            return 0;
+    }
+
+    return 1;
+}
+
+static void _testSetPattern(int shift)
+{
+    int i, p;
+
+    for(i = 0; i < STRIP_NUM_PIXELS; i++)
+    {
+        p = (i + shift) % STRIP_NUM_PIXELS;
+        stripSetPixel(i, _testValues[_testPattern(p, 0)], _testValues[_testPattern(p, 1)],
+                      _testValues[_testPattern(p, 2)]);
+    }
+}
+
+static void _testTiming(void)
+{
+    uint32_t spi_hz, t0h_ns, t1h_ns, bit_ns, latch_us;
+
+    _testStart();
+
+    /* Secondary function of P6.6, SPI master clocked from SMCLK (12 MHz) */
+    SIM_CHECK((P6->SEL1 & BIT6) != 0 && (P6->SEL0 & BIT6) == 0);
+    SIM_CHECK((EUSCI_B3->CTLW0 & (EUSCI_B_CTLW0_MST | EUSCI_B_CTLW0_SYNC | EUSCI_B_CTLW0_MSB))
+              == (EUSCI_B_CTLW0_MST | EUSCI_B_CTLW0_SYNC | EUSCI_B_CTLW0_MSB));
+    SIM_CHECK((EUSCI_B3->CTLW0 & EUSCI_B_CTLW0_SWRST) == 0);
+
+    /* WS2812: 0 high 400 ns, 1 high 800 ns, both +-150 ns, bit 1.25 us +-600 ns, latch from 280 us */
+    spi_hz = CS_getSMCLK() / EUSCI_B3->BRW;
+    t0h_ns = 1000000000u / spi_hz;
+    t1h_ns = 2 * t0h_ns;
+    bit_ns = 3 * t0h_ns;
+    latch_us = STRIP_RESET_BYTES * 8 * 1000000u / spi_hz;
+    SIM_CHECK(spi_hz == STRIP_SPI_HZ);
+    SIM_CHECK(t0h_ns >= 250 && t0h_ns <= 550 && t1h_ns >= 650 && t1h_ns <= 950);
+    SIM_CHECK(bit_ns >= 650 && bit_ns <= 1850 && latch_us >= 280);
+
+    /* Bytes to TXBUF, one per request of the peripheral */
+    SIM_CHECK(simDmaControl(TEST_DMA_CHANNEL, 0) == (UDMA_SIZE_8 | UDMA_SRC_INC_8 | UDMA_DST_INC_NONE | UDMA_ARB_1));
+
+    printf("strip,%u Hz,T0H %u ns,T1H %u ns,bit %u ns,latch %u us\n", (unsigned)spi_hz, (unsigned)t0h_ns,
+           (unsigned)t1h_ns, (unsigned)bit_ns, (unsigned)latch_us);
+}
+
+static void _testFrames(void)
+{
+    _testStart();
+
+    /* All off after the initialization */
+    SIM_CHECK(stripShow() == 1 && stripBusy() == 1);
+    SIM_CHECK(simDmaRun(TEST_DMA_CHANNEL) == TEST_FRAME_BYTES);
+    SIM_CHECK(stripBusy() == 0 && _testStreamed == TEST_FRAME_BYTES);
+    SIM_CHECK(_testDecode(0) == 1 && _testFrame[0].green == 0 && _testFrame[STRIP_NUM_PIXELS-1].blue == 0);
+
+    /* The CPU only sees one interrupt per transfer of 1024 bytes */
+    SIM_CHECK(simIsrCount(INT_DMA_INT0) == TEST_NUM_CHUNKS);
+
+    /* Every color value of the pattern on every pixel, through the gamma table */
+    _testSetPattern(0);
+    SIM_CHECK(stripShow() == 1);
+    simDmaRun(TEST_DMA_CHANNEL);
+    SIM_CHECK(_testStreamed == 2 * TEST_FRAME_BYTES);
+    SIM_CHECK(_testDecode(1) == 1 && _testMatches(0, 255) == 1);
+    SIM_CHECK(simIsrCount(INT_DMA_INT0) == 2 * TEST_NUM_CHUNKS);
+
+    /* Invalid arguments */
+    SIM_CHECK(stripSetPixel(STRIP_NUM_PIXELS, 1, 1, 1) == -1 && stripSetPixel(-1, 1, 1, 1) == -1);
+    SIM_CHECK(stripFill(STRIP_NUM_PIXELS - 1, 2, 1, 1, 1) == -1);
+}
+
+static void _testDirty(void)
+{
+    uint32_t encoded;
+
+    _testStart();
+
+    /* The first frame encodes every pixel, for each of the two buffers */
+    _testSetPattern(0);
+    stripShow();
+    simDmaRun(TEST_DMA_CHANNEL);
+    stripShow();
+    simDmaRun(TEST_DMA_CHANNEL);
+    SIM_CHECK(stripEncodedPixels() == 2 * STRIP_NUM_PIXELS);
+
+    /* Nothing changed: nothing encoded, the same frame sent again */
+    encoded = stripEncodedPixels();
+    stripShow();
+    simDmaRun(TEST_DMA_CHANNEL);
+    SIM_CHECK(stripEncodedPixels() == encoded);
+    SIM_CHECK(_testDecode(2) == 1 && _testMatches(0, 255) == 1);
+
+    /* Two pixels changed: each buffer encodes the range between them, once */
+    _testStreamed = 0;
+    stripSetPixel(10, 255, 0, 0);
+    stripSetPixel(20, 0, 0, 255);
+    stripShow();
+    simDmaRun(TEST_DMA_CHANNEL);
+    SIM_CHECK(stripEncodedPixels() == encoded + 11);
+    stripShow();
+    simDmaRun(TEST_DMA_CHANNEL);
+    SIM_CHECK(stripEncodedPixels() == encoded + 22);
+
+    /* Both frames carry the change, the rest of the pattern is intact */
+    SIM_CHECK(_testDecode(0) == 1 && _testFrame[10].red == 255 && _testFrame[20].blue == 255 && _testFrame[20].red == 0);
+    SIM_CHECK(_testDecode(1) == 1 && _testFrame[10].red == 255 && _testFrame[10].green == 0 && _testFrame[20].blue == 255);
+    SIM_CHECK(_testFrame[9].red == _testLevels[_testPattern(9, 0)] && _testFrame[21].green == _testLevels[_testPattern(21, 1)]);
+
+    /* A setting that does not change the pixel does not mark it */
+    stripSetPixel(10, 255, 0, 0);
+    encoded = stripEncodedPixels();
+    stripShow();
+    simDmaRun(TEST_DMA_CHANNEL);
+    SIM_CHECK(stripEncodedPixels() == encoded);
+}
+
+static void _testDoubleBuffer(void)
+{
+    int i;
+
+    _testStart();
+    _testSetPattern(0);
+    stripShow();
+    simDmaRun(TEST_DMA_CHANNEL);
+    _testStreamed = 0;
+
+    /* A new frame while half of the current one is sent: queued behind it */
+    _testSetPattern(1);
+    SIM_CHECK(stripShow() == 1);
+    for(i = 0; i < TEST_FRAME_BYTES / 2; i++)
+        simDmaRequest(TEST_DMA_CHANNEL);
+
+    _testSetPattern(2);
+    SIM_CHECK(stripShow() == 0 && stripBusy() == 1);
+
+    /* The frame being sent is not touched by the encoding of the next one,
+       which follows it with no call from the main loop */
+    simDmaRun(TEST_DMA_CHANNEL);
+    SIM_CHECK(_testStreamed == 2 * TEST_FRAME_BYTES && stripBusy() == 0);
+    SIM_CHECK(_testDecode(0) == 1 && _testMatches(1, 255) == 1);
+    SIM_CHECK(_testDecode(1) == 1 && _testMatches(2, 255) == 1);
+
+    /* Two frames queued while busy: only the last one is sent */
+    _testStreamed = 0;
+    _testSetPattern(3);
+    stripShow();
+    simDmaRequest(TEST_DMA_CHANNEL);
+    _testSetPattern(4);
+    stripShow();
+    _testSetPattern(5);
+    stripShow();
+    simDmaRun(TEST_DMA_CHANNEL);
+    SIM_CHECK(_testStreamed == 2 * TEST_FRAME_BYTES);
+    SIM_CHECK(_testDecode(0) == 1 && _testMatches(3, 255) == 1);
+    SIM_CHECK(_testDecode(1) == 1 && _testMatches(5, 255) == 1);
+}
+
+static void _testBrightness(void)
+{
+    _testStart();
+    _testSetPattern(0);
+
+    /* Scaled after the gamma, every pixel encoded again */
+    SIM_CHECK(stripSetBrightness(128) == 1);
+    stripShow();
+    simDmaRun(TEST_DMA_CHANNEL);
+    SIM_CHECK(_testDecode(0) == 1 && _testMatches(0, 128) == 1);
+
+    stripSetBrightness(0);
+    stripShow();
+    simDmaRun(TEST_DMA_CHANNEL);
+    SIM_CHECK(_testDecode(1) == 1 && _testMatches(0, 0) == 1);
+    SIM_CHECK(stripEncodedPixels() == 2 * STRIP_NUM_PIXELS);
+}
+
+#endif //BENCH_HOST
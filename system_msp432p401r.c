@@ -50,6 +50,8 @@
    #define __HALT_WDT       1
    2. Insert your desired CPU frequency in Hz at:
    #define __SYSTEM_CLOCK   12000000
+      12 MHz is the fastest setting that needs neither a VCORE change nor flash
+      wait states, so it also gives the shortest time from reset to main.
    3. If you prefer the DC-DC power regulator (more efficient at higher
        frequencies), set the __REGULATOR to 1:
    #define __REGULATOR      1
@@ -68,7 +70,7 @@
 //     <12000000> 12 MHz
 //     <24000000> 24 MHz
 //     <48000000> 48 MHz
-#define  __SYSTEM_CLOCK    3000000
+#define  __SYSTEM_CLOCK    12000000
 
 /*--------------------- Power Regulator Configuration -----------------------*/
 //  Power Regulator Mode
@@ -84,6 +86,14 @@
 #define __LFXT             32768
 #define __HFXT             48000000
 
+/*----------------------------------------------------------------------------
+   SRAM bank configuration
+ *---------------------------------------------------------------------------*/
+#define __SRAM_BANK_SIZE   0x2000
+
+/* End of the last RAM section (.stack), provided by the linker              */
+extern unsigned long __STACK_END;
+
 /*----------------------------------------------------------------------------
    Clock Variable definitions
  *---------------------------------------------------------------------------*/
@@ -253,7 +263,7 @@ void SystemCoreClockUpdate(void)
  * Performs the following initialization steps:
  *     1. Enables the FPU
  *     2. Halts the WDT if requested
- *     3. Enables all SRAM banks
+ *     3. Enables the SRAM banks used by the RAM sections
  *     4. Sets up power regulator and VCORE
  *     5. Enable Flash wait states if needed
  *     6. Change MCLK to desired frequency
@@ -271,7 +281,9 @@ void SystemInit(void)
     WDT_A->CTL = WDT_A_CTL_PW | WDT_A_CTL_HOLD;            // Halt the WDT
     #endif
 
-    SYSCTL->SRAM_BANKEN = SYSCTL_SRAM_BANKEN_BNK7_EN;      // Enable all SRAM banks
+    // Enable SRAM banks up to the one holding the end of the stack, the
+    // highest RAM section (enabling bank N also enables banks 0 to N-1)
+    SYSCTL->SRAM_BANKEN = 1UL << ((((uint32_t)&__STACK_END) - 1 - SRAM_BASE) / __SRAM_BANK_SIZE);
 
     #if (__SYSTEM_CLOCK == 1500000)                        // 1.5 MHz
     // Default VCORE is LDO VCORE0 so no change necessary
@@ -0,0 +1,316 @@
+/**
+ @file    systime.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Monotonic system time and one-shot alarms for the msp432p401r Launchpad board
+
+ Overflow handling: instead of counting whole wraps of the 16-bit counter, the ISR
+ counts half periods (an interrupt at 0x0000 from TAIFG and another at 0x8000 from CCR2).
+ The parity of that counter must always match the top bit of the hardware counter, so
+ a reader that sees a mismatch knows the ISR has not run yet for the current half and
+ corrects the value itself. This needs no retries and no interrupt masking, and it is
+ correct even when the reader preempts the timer ISR half-way through its update.
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "systime.h"
+#include "stackmon.h"
+
+
+/* SECTION 2: Private macros                                       */
+
+/**
+ @brief Timer used as time base
+ @remark Changing it also requires renaming @ref TA0_N_IRQHandler and @ref SYSTIME_INT_NUM
+*/
+#define SYSTIME_TIMER      TIMER_A0
+
+/**
+ @brief Interrupt number of the time base (CCR1..CCR6 and TAIFG)
+*/
+#define SYSTIME_INT_NUM    INT_TA0_N
+
+/**
+ @brief Compare channel used to program the earliest alarm
+*/
+#define SYSTIME_CCR_ALARM  1
+
+/**
+ @brief Compare channel fixed at half of the counter range, used for overflow handling
+*/
+#define SYSTIME_CCR_HALF   2
+
+/**
+ @brief Values of the TAxIV register for the sources handled by @ref TA0_N_IRQHandler
+*/
+#define SYSTIME_IV_ALARM   0x02
+#define SYSTIME_IV_HALF    0x04
+#define SYSTIME_IV_WRAP    0x0E
+
+
+/* SECTION 3: Private types                                        */
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+/**
+ @brief Number of half periods (32768 ticks) of the counter handled by the ISR
+*/
+static volatile uint32_t _systimeHalves = 0;
+
+/**
+ @brief Head of the list of armed alarms, sorted by increasing deadline
+*/
+static systime_alarm_t *_systimeAlarms = 0;
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static uint16_t _systimeReadCounter(void); //Read the asynchronous counter safely
+
+static systime_t _systimeExtend(uint32_t halves, uint16_t count); //Build the 64-bit time from the ISR state and the counter
+
+static void _systimeProgram(void); //Program the compare register for the earliest alarm
+
+static void _systimeUnlink(systime_alarm_t *alarm); //Remove an alarm from the list
+
+static void _systimeExpire(void); //Run the callbacks of every expired alarm
+
+void TA0_N_IRQHandler(void);
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+void systimeInit(void)
+{
+    /* ACLK = REFOCLK at 32768 Hz, not divided */
+    CS->KEY = CS_KEY_VAL;
+    CS->CLKEN = CS->CLKEN & ~CS_CLKEN_REFOFSEL;
+    CS->CTL1 = (CS->CTL1 & ~(CS_CTL1_SELA_MASK | CS_CTL1_DIVA_MASK)) | CS_CTL1_SELA__REFOCLK;
+    CS->KEY = 0;
+
+    _systimeHalves = 0;
+    _systimeAlarms = 0;
+
+    SYSTIME_TIMER->CTL = TIMER_A_CTL_MC__STOP | TIMER_A_CTL_CLR;
+    SYSTIME_TIMER->CCTL[SYSTIME_CCR_ALARM] = 0;
+    SYSTIME_TIMER->CCR[SYSTIME_CCR_HALF] = 0x8000;
+    SYSTIME_TIMER->CCTL[SYSTIME_CCR_HALF] = TIMER_A_CCTLN_CCIE;
+
+    Interrupt_enableInterrupt(SYSTIME_INT_NUM);
+
+    SYSTIME_TIMER->CTL = TIMER_A_CTL_SSEL__ACLK | TIMER_A_CTL_ID__1
+                       | TIMER_A_CTL_MC__CONTINUOUS | TIMER_A_CTL_IE;
+}
+
+systime_t systimeNow(void)
+{
+    uint32_t halves;
+
+    halves = _systimeHalves; //Must be read before the counter
+    return _systimeExtend(halves, _systimeReadCounter());
+}
+
+uint64_t systimeNowUs(void)
+{
+    return systimeTicksToUs(systimeNow());
+}
+
+systime_t systimeUsToTicks(uint32_t us)
+{
+    /* 1000000 / 32768 = 15625 / 512 */
+    return ((systime_t)us * 512 + 15624) / 15625;
+}
+
+systime_t systimeMsToTicks(uint32_t ms)
+{
+    return ((systime_t)ms * SYSTIME_TICKS_PER_SECOND + 999) / 1000;
+}
+
+uint64_t systimeTicksToUs(systime_t ticks)
+{
+    return (ticks * 15625) >> 9;
+}
+
+int systimeAlarmStart(systime_alarm_t *alarm, systime_t deadline, systime_callback_t callback, void *context)
+{
+    systime_alarm_t **link;
+    bool state;
+
+    if(alarm == 0 || callback == 0)
+        return -1;
+
+    CRITICAL_ENTER(state);
+
+    if(alarm->armed)
+        _systimeUnlink(alarm);
+
+    alarm->deadline = deadline;
+    alarm->callback = callback;
+    alarm->context = context;
+
+    link = &_systimeAlarms;
+    while(*link != 0 && (*link)->deadline <= deadline)
+        link = &((*link)->next);
+
+    alarm->next = *link;
+    *link = alarm;
+    alarm->armed = 1;
+
+    if(_systimeAlarms == alarm)
+        _systimeProgram();
+
+    CRITICAL_EXIT(state);
+
+    return 1;
+}
+
+int systimeAlarmCancel(systime_alarm_t *alarm)
+{
+    int res;
+    bool state;
+
+    if(alarm == 0)
+        return -1;
+
+    CRITICAL_ENTER(state);
+
+    res = alarm->armed;
+    if(res)
+    {
+        _systimeUnlink(alarm);
+        _systimeProgram();
+    }
+
+    CRITICAL_EXIT(state);
+
+    return res;
+}
+
+int systimeAlarmArmed(const systime_alarm_t *alarm)
+{
+    if(alarm == 0)
+        return -1;
+
+    return alarm->armed;
+}
+
+static uint16_t _systimeReadCounter(void)
+{
+    uint16_t a, b;
+
+    /* The counter runs from ACLK, asynchronous to MCLK: read until two reads agree */
+    a = SYSTIME_TIMER->R;
+    do
+    {
+        b = a;
+        a = SYSTIME_TIMER->R;
+    } while(a != b);
+
+    return a;
+}
+
+static systime_t _systimeExtend(uint32_t halves, uint16_t count)
+{
+    /* The ISR may lag one half period behind the counter, never ahead of it */
+    if((halves & 1) != (count >> 15))
+        halves++;
+
+    return ((systime_t)(halves >> 1) << 16) | count;
+}
+
+static void _systimeProgram(void)
+{
+    if(_systimeAlarms == 0)
+    {
+        SYSTIME_TIMER->CCTL[SYSTIME_CCR_ALARM] = 0;
+        return;
+    }
+
+    /* Only the low 16 bits are compared: if the deadline is further away than one
+       counter period the ISR simply finds nothing expired and waits for the next match */
+    SYSTIME_TIMER->CCR[SYSTIME_CCR_ALARM] = (uint16_t)_systimeAlarms->deadline;
+    SYSTIME_TIMER->CCTL[SYSTIME_CCR_ALARM] = TIMER_A_CCTLN_CCIE;
+
+    /* The counter may have gone past the compare value while it was being written */
+    if(systimeNow() >= _systimeAlarms->deadline)
+        SYSTIME_TIMER->CCTL[SYSTIME_CCR_ALARM] = TIMER_A_CCTLN_CCIE | TIMER_A_CCTLN_CCIFG;
+}
+
+static void _systimeUnlink(systime_alarm_t *alarm)
+{
+    systime_alarm_t **link;
+
+    link = &_systimeAlarms;
+    while(*link != 0 && *link != alarm)
+        link = &((*link)->next);
+
+    if(*link == alarm)
+        *link = alarm->next;
+
+    alarm->next = 0;
+    alarm->armed = 0;
+}
+
+static void _systimeExpire(void)
+{
+    systime_alarm_t *alarm;
+    systime_t now;
+    bool state;
+
+    CRITICAL_ENTER(state);
+
+    now = systimeNow();
+    while(_systimeAlarms != 0 && _systimeAlarms->deadline <= now)
+    {
+        alarm = _systimeAlarms;
+        _systimeAlarms = alarm->next;
+        alarm->next = 0;
+        alarm->armed = 0;
+
+        /* The callback is allowed to re-arm this or any other alarm */
+        CRITICAL_EXIT(state);
+        alarm->callback(alarm->context);
+        CRITICAL_ENTER(state);
+
+        now = systimeNow();
+    }
+
+    _systimeProgram();
+
+    CRITICAL_EXIT(state);
+}
+
+void TA0_N_IRQHandler(void)
+{
+    uint16_t iv;
+    STACKMON_ISR_ENTER(STACKMON_ISR_SYSTIME);
+
+    /* Reading TAxIV clears the highest priority pending flag */
+    while((iv = SYSTIME_TIMER->IV) != 0)
+    {
+        if(iv == SYSTIME_IV_WRAP || iv == SYSTIME_IV_HALF)
+        {
+            _systimeHalves++;
+        }
+
+        else if(iv == SYSTIME_IV_ALARM)
+        {
+            _systimeExpire();
+        }
+    }
+
+    STACKMON_ISR_EXIT(STACKMON_ISR_SYSTIME);
+}
@@ -0,0 +1,92 @@
+/**
+ @file    systime.h
+
+ @brief   Monotonic system time and one-shot alarms for the msp432p401r Launchpad board
+
+ The time base is Timer_A0 running in continuous mode from ACLK (REFOCLK, 32768 Hz),
+ so it keeps counting in LPM3. The 16-bit counter is extended in software to a
+ 64-bit tick count that can be read lock-free from the main loop and from any ISR.
+ Alarms are kept in a deadline-ordered list and only the earliest one is programmed
+ in the compare register, so waiting for an alarm needs no periodic tick. The
+ extension of the counter does take an interrupt at each half of its period (TAIFG
+ at 0x0000, CCR2 at 0x8000): an idle CPU is woken up from LPM3 once per second,
+ whatever the alarms.
+
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+*/
+
+// Do not write above this line (except comments)!
+#ifndef SYSTIME_H
+#define SYSTIME_H
+
+/* SECTION 1: Included header files required to compile this file  */
+#include <stdint.h>
+
+
+/* SECTION 2: Public macros                                        */
+
+/**
+ @brief Frequency of the time base (ACLK sourced from REFOCLK)
+*/
+#define SYSTIME_TICKS_PER_SECOND  32768u
+
+
+/* SECTION 3: Public types                                         */
+
+/**
+ @brief Monotonic time, in ticks of @ref SYSTIME_TICKS_PER_SECOND, since @ref systimeInit
+*/
+typedef uint64_t systime_t;
+
+/**
+ @brief Alarm callback, executed in interrupt context when the alarm expires
+*/
+typedef void (*systime_callback_t)(void *context);
+
+/**
+ @brief One-shot alarm. The storage is provided by the caller, no heap is used.
+ @remarks Fields are private to the systime module, do not modify them while the alarm is armed.
+*/
+struct systime_alarm_s {
+   systime_t                 deadline; /**< Absolute expiration time, in ticks  */
+   systime_callback_t        callback; /**< Function called on expiration       */
+   void                     *context;  /**< Argument passed to the callback     */
+   struct systime_alarm_s   *next;     /**< Next alarm in the deadline list     */
+   uint8_t                   armed;    /**< Flag (0/1) set while in the list    */
+};
+
+/**
+ @brief Short alias "systime_alarm_t" for the data type "struct systime_alarm_s"
+*/
+typedef struct systime_alarm_s systime_alarm_t;
+
+
+/* SECTION 4: Public variables :: declarations, extern mandatory   */
+
+
+/* SECTION 5: Public functions :: declarations, extern optional
+   Rule exception (callbacks)  :: declarations, extern recommended */
+
+void systimeInit(void); //Initialization function
+
+systime_t systimeNow(void); //Current time in ticks, callable from any context
+
+uint64_t systimeNowUs(void); //Current time in microseconds, callable from any context
+
+systime_t systimeUsToTicks(uint32_t us); //Convert a duration in microseconds to ticks (rounded up)
+
+systime_t systimeMsToTicks(uint32_t ms); //Convert a duration in milliseconds to ticks (rounded up)
+
+uint64_t systimeTicksToUs(systime_t ticks); //Convert a number of ticks to microseconds (rounded down)
+
+int systimeAlarmStart(systime_alarm_t *alarm, systime_t deadline, systime_callback_t callback, void *context); //Arm (or re-arm) a one-shot alarm at an absolute deadline
+
+int systimeAlarmCancel(systime_alarm_t *alarm); //Disarm an alarm, returns 1 if it was armed
+
+int systimeAlarmArmed(const systime_alarm_t *alarm); //Determine if an alarm is still pending
+
+
+#endif //SYSTIME_H
+// Do not write below this line!
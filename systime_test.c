@@ -0,0 +1,306 @@
+/**
+ @file    systime_test.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Host test of the time base: half-period extension and alarms across overflows
+
+ Built by host/Makefile. TA0 is counted by the simulated ACLK, so after
+ systimeInit the time must equal the ticks elapsed in the simulation, whatever
+ the state of the ISR: the test checks it tick by tick across 16-bit overflows,
+ with the ISR served at once and with it held back by masked interrupts (the
+ reader then runs before the ISR of the half period, the race the parity scheme
+ solves). Alarms are checked to fire at their exact tick, in deadline order,
+ across overflows and when armed on or past their deadline.
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "systime.h"
+#include "sim.h"
+
+/* The whole file belongs to the host build (see host/Makefile) */
+#ifdef BENCH_HOST
+
+
+/* SECTION 2: Private macros                                       */
+
+#define TEST_PERIOD   0x10000u  //Ticks of a counter period
+#define TEST_ALARMS   6
+
+
+/* SECTION 3: Private types                                        */
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+static systime_alarm_t _testAlarm [TEST_ALARMS];
+static systime_t _testFiredAt [TEST_ALARMS];    /**< Time seen by each callback         */
+static int _testOrder [TEST_ALARMS];            /**< Alarms in the order they fired     */
+static int _testFired = 0;
+static int _testRearms = 0;                     /**< Re-arms left to the periodic alarm */
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static void _testAlarmFired(void *context); //Record the time and order of an alarm
+
+static void _testPeriodic(void *context); //Re-arm itself one period later
+
+static void _testStart(void); //Reset the simulation and the time base
+
+static int _testTrack(uint32_t ticks); //Advance tick by tick, checking the time: mismatches
+
+static void _testExtension(void);
+
+static void _testLaggingIsr(void);
+
+static void _testAlarmsAcrossOverflow(void);
+
+static void _testAlarmsOnDeadline(void);
+
+static void _testAlarmOrderAndCancel(void);
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+int main(void)
+{
+    _testExtension();
+    _testLaggingIsr();
+    _testAlarmsAcrossOverflow();
+    _testAlarmsOnDeadline();
+    _testAlarmOrderAndCancel();
+
+    return simReport("systime_test");
+}
+
+static void _testAlarmFired(void *context)
+{
+    int which = (int)(intptr_t)context;
+
+    _testFiredAt[which] = systimeNow();
+    _testOrder[_testFired++] = which;
+}
+
+static void _testPeriodic(void *context)
+{
+    _testAlarmFired(context);
+
+    if(_testRearms-- > 0)
+        systimeAlarmStart(&_testAlarm[0], _testAlarm[0].deadline + TEST_PERIOD + 3, _testPeriodic, context);
+}
+
+static void _testStart(void)
+{
+    int i;
+
+    simReset();
+    systimeInit();
+
+    for(i = 0; i < TEST_ALARMS; i++)
+    {
+        systimeAlarmCancel(&_testAlarm[i]);
+        _testFiredAt[i] = 0;
+        _testOrder[i] = -1;
+    }
+    _testFired = 0;
+}
+
+static int _testTrack(uint32_t ticks)
+{
+    int errors = 0;
+    systime_t last = systimeNow();
+
+    while(ticks-- > 0)
+    {
+        simAdvanceTicks(1);
+
+        if(systimeNow() != simTicks() || systimeNow() <= last)
+            errors++;
+        last = systimeNow();
+    }
+
+    return errors;
+}
+
+static void _testExtension(void)
+{
+    _testStart();
+    Interrupt_enableMaster();
+
+    /* Three overflows, every tick checked: both half-period interrupts and the wrap */
+    SIM_CHECK(systimeNow() == 0);
+    SIM_CHECK(_testTrack(3 * TEST_PERIOD + 100) == 0);
+    SIM_CHECK(systimeNow() == 3 * TEST_PERIOD + 100);
+    SIM_CHECK(TIMER_A0->R == 100);
+
+    /* One half-period interrupt per 0x8000 ticks, no spurious ones */
+    SIM_CHECK(simIsrCount(INT_TA0_N) == 6);
+
+    SIM_CHECK(systimeNowUs() == systimeTicksToUs(3 * TEST_PERIOD + 100));
+    SIM_CHECK(systimeUsToTicks(1000000) == SYSTIME_TICKS_PER_SECOND);
+    SIM_CHECK(systimeMsToTicks(1) == 33);
+}
+
+static void _testLaggingIsr(void)
+{
+    bool state;
+
+    _testStart();
+    Interrupt_enableMaster();
+    simAdvanceTicks(0x7FF0);
+
+    /* Interrupts masked across the half period: the ISR lags, the readers correct */
+    state = Interrupt_disableMaster();
+    SIM_CHECK(_testTrack(0x20) == 0);
+    SIM_CHECK(simIsrCount(INT_TA0_N) == 0);
+    if(!state)
+        Interrupt_enableMaster();
+    SIM_CHECK(simIsrCount(INT_TA0_N) == 1);
+    SIM_CHECK(systimeNow() == simTicks());
+
+    /* Same across the overflow, held back for almost a half period */
+    simAdvanceTicks(0x8000 - 0x30);
+    state = Interrupt_disableMaster();
+    SIM_CHECK(_testTrack(0x7F00) == 0);
+    SIM_CHECK(simIsrCount(INT_TA0_N) == 1);
+    if(!state)
+        Interrupt_enableMaster();
+    SIM_CHECK(simIsrCount(INT_TA0_N) == 2);
+    SIM_CHECK(_testTrack(0x200) == 0);
+    SIM_CHECK(simIsrCount(INT_TA0_N) == 3);
+
+    /* Afterwards one interrupt per half period again, no spurious ones */
+    simAdvanceTicks(TEST_PERIOD);
+    SIM_CHECK(systimeNow() == simTicks());
+    SIM_CHECK(simIsrCount(INT_TA0_N) == 5);
+}
+
+static void _testAlarmsAcrossOverflow(void)
+{
+    systime_t deadline;
+
+    _testStart();
+    Interrupt_enableMaster();
+    simAdvanceTicks(0xFFF0);
+
+    /* Across the overflow: the compare value is below the counter when armed */
+    deadline = systimeNow() + 0x20;
+    systimeAlarmStart(&_testAlarm[0], deadline, _testAlarmFired, (void *)0);
+    simAdvanceTicks(0x1F);
+    SIM_CHECK(_testFired == 0);
+    simAdvanceTicks(1);
+    SIM_CHECK(_testFired == 1 && _testFiredAt[0] == deadline);
+
+    /* Three periods away: the low 16 bits match twice before the deadline */
+    deadline = systimeNow() + 3 * TEST_PERIOD - 5;
+    systimeAlarmStart(&_testAlarm[1], deadline, _testAlarmFired, (void *)1);
+    simAdvanceTicks(3 * TEST_PERIOD - 6);
+    SIM_CHECK(_testFired == 1);
+    simAdvanceTicks(1);
+    SIM_CHECK(_testFired == 2 && _testFiredAt[1] == deadline);
+
+    /* On the half-period boundary and on the wrap, where two flags are raised together */
+    deadline = (systimeNow() | 0xFFFF) + 1 + 0x8000;
+    systimeAlarmStart(&_testAlarm[2], deadline, _testAlarmFired, (void *)2);
+    systimeAlarmStart(&_testAlarm[3], deadline - 0x8000, _testAlarmFired, (void *)3);
+    simAdvanceTicks((uint32_t)(deadline - systimeNow()));
+    SIM_CHECK(_testFired == 4);
+    SIM_CHECK(_testFiredAt[3] == deadline - 0x8000 && _testFiredAt[2] == deadline);
+    SIM_CHECK(systimeNow() == simTicks());
+
+    /* A periodic alarm re-armed from its callback keeps its phase over overflows */
+    _testRearms = 3;
+    deadline = systimeNow() + 100;
+    systimeAlarmStart(&_testAlarm[0], deadline, _testPeriodic, (void *)0);
+    simAdvanceTicks(4 * (TEST_PERIOD + 3) + 200);
+    SIM_CHECK(_testFired == 8 && _testFiredAt[0] == deadline + 3 * (TEST_PERIOD + 3));
+    SIM_CHECK(systimeAlarmArmed(&_testAlarm[0]) == 0);
+}
+
+static void _testAlarmsOnDeadline(void)
+{
+    bool state;
+    systime_t now;
+
+    _testStart();
+    Interrupt_enableMaster();
+    simAdvanceTicks(1000);
+
+    /* Deadline already passed: the compare cannot match, the flag is raised by software */
+    now = systimeNow();
+    systimeAlarmStart(&_testAlarm[0], now - 10, _testAlarmFired, (void *)0);
+    SIM_CHECK(_testFired == 1 && _testFiredAt[0] == now);
+
+    /* Deadline now, armed with interrupts masked: served as soon as they are unmasked */
+    state = Interrupt_disableMaster();
+    now = systimeNow();
+    systimeAlarmStart(&_testAlarm[1], now, _testAlarmFired, (void *)1);
+    simAdvanceTicks(3);
+    SIM_CHECK(_testFired == 1);
+    if(!state)
+        Interrupt_enableMaster();
+    SIM_CHECK(_testFired == 2 && _testFiredAt[1] == now + 3);
+
+    /* Next tick, while the ISR lags behind the half-period boundary */
+    simAdvanceTicks((uint32_t)(0x8000 - (systimeNow() & 0xFFFF)) - 2);
+    state = Interrupt_disableMaster();
+    simAdvanceTicks(4);
+    now = systimeNow();
+    systimeAlarmStart(&_testAlarm[2], now + 1, _testAlarmFired, (void *)2);
+    if(!state)
+        Interrupt_enableMaster();
+    SIM_CHECK(_testFired == 2);
+    simAdvanceTicks(1);
+    SIM_CHECK(_testFired == 3 && _testFiredAt[2] == now + 1);
+}
+
+static void _testAlarmOrderAndCancel(void)
+{
+    systime_t now;
+    int i;
+
+    _testStart();
+    Interrupt_enableMaster();
+    simAdvanceTicks(0xFF00);
+    now = systimeNow();
+
+    /* Armed out of order, two with the same deadline (served in arming order) */
+    systimeAlarmStart(&_testAlarm[0], now + 0x300, _testAlarmFired, (void *)0);
+    systimeAlarmStart(&_testAlarm[1], now + 0x100, _testAlarmFired, (void *)1);
+    systimeAlarmStart(&_testAlarm[2], now + 0x200, _testAlarmFired, (void *)2);
+    systimeAlarmStart(&_testAlarm[3], now + 0x100, _testAlarmFired, (void *)3);
+    systimeAlarmStart(&_testAlarm[4], now + 0x180, _testAlarmFired, (void *)4);
+    systimeAlarmStart(&_testAlarm[5], now + 0x250, _testAlarmFired, (void *)5);
+
+    /* Cancelled, and moved later while armed */
+    SIM_CHECK(systimeAlarmCancel(&_testAlarm[4]) == 1);
+    SIM_CHECK(systimeAlarmCancel(&_testAlarm[4]) == 0);
+    systimeAlarmStart(&_testAlarm[1], now + 0x280, _testAlarmFired, (void *)1);
+
+    simAdvanceTicks(0x400);
+    SIM_CHECK(_testFired == 5);
+    SIM_CHECK(_testOrder[0] == 3 && _testOrder[1] == 2 && _testOrder[2] == 5);
+    SIM_CHECK(_testOrder[3] == 1 && _testOrder[4] == 0);
+    SIM_CHECK(_testFiredAt[3] == now + 0x100 && _testFiredAt[0] == now + 0x300);
+
+    for(i = 0; i < TEST_ALARMS; i++)
+        SIM_CHECK(systimeAlarmArmed(&_testAlarm[i]) == 0);
+
+    SIM_CHECK(systimeAlarmStart(0, now, _testAlarmFired, 0) == -1);
+    SIM_CHECK(systimeAlarmStart(&_testAlarm[0], now, 0, 0) == -1);
+    SIM_CHECK(systimeAlarmCancel(0) == -1);
+}
+
+#endif //BENCH_HOST
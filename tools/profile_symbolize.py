@@ -0,0 +1,175 @@
+#!/usr/bin/env python3
+"""Symbolizer of the PC-sampling histogram of profile.c.
+
+Reads a memory dump of the symbol _profileLog saved with the debugger, and the
+linker map of the same build, and prints the samples per function:
+
+    python3 profile_symbolize.py dump.bin ../Debug/lab4_Carta.map
+    python3 profile_symbolize.py --bins 20 dump.bin ../Debug/lab4_Carta.map
+
+The functions are the input sections of .text listed in the SECTION ALLOCATION
+MAP (one per function with the default --gen_func_subsections), split by the
+global symbols they contain when the section name does not tell the function
+(assembly files). A bin overlapping several functions is shared among them in
+proportion to the bytes of each one in the bin.
+"""
+
+import argparse
+import bisect
+import re
+import struct
+import sys
+
+PROFILE_MAGIC = 0x464F5250
+PROFILE_VERSION = 1
+
+# Keep in sync with profile_header_t of profile.h
+HEADER = struct.Struct("<IHHIIIIIII")
+
+SECTION_LINE = re.compile(r"^\s+([0-9a-fA-F]{8})\s+([0-9a-fA-F]{8})\s+(.*?)\s*\((\.text[^)]*)\)\s*$")
+SYMBOL_LINE = re.compile(r"^([0-9a-fA-F]{8})\s+(\S+)\s*$")
+
+
+def read_log(data):
+    """Header fields and bins of the first valid histogram found in the data."""
+    magic = struct.pack("<I", PROFILE_MAGIC)
+    pos = data.find(magic)
+    while pos >= 0 and pos + HEADER.size <= len(data):
+        fields = HEADER.unpack_from(data, pos)
+        header = dict(zip(("magic", "version", "num_bins", "text_start", "text_end", "bin_shift",
+                           "rate_hz", "samples", "outside", "saturated"), fields))
+        end = pos + HEADER.size + 2 * header["num_bins"]
+        if header["version"] == PROFILE_VERSION and header["num_bins"] > 0 and end <= len(data):
+            bins = struct.unpack_from("<%dH" % header["num_bins"], data, pos + HEADER.size)
+            return header, bins
+        pos = data.find(magic, pos + 1)
+    return None, None
+
+
+def read_map(text):
+    """Sorted list of (start, end, function, object) covering the functions of .text."""
+    sections = []
+    symbols = []
+    library = ""
+    part = None
+    for line in text.splitlines():
+        if line.startswith("SECTION ALLOCATION MAP"):
+            part = "sections"
+        elif line.startswith("GLOBAL SYMBOLS: SORTED BY Symbol Address"):
+            part = "symbols"
+        elif line.startswith("GLOBAL SYMBOLS") or line.startswith("LINKER GENERATED"):
+            part = None
+        elif part == "sections":
+            match = SECTION_LINE.match(line)
+            if not match:
+                continue
+            start, length = int(match.group(1), 16), int(match.group(2), 16)
+            owner, section = match.group(3), match.group(4)
+            # "lib : member" names a library member, ": member" continues the same library
+            if ":" in owner:
+                lib, member = (s.strip() for s in owner.split(":", 1))
+                library = lib or library
+                owner = "%s(%s)" % (library, member)
+            names = section.split(":")
+            sections.append((start, start + length, names[-1] if len(names) > 1 else None, owner))
+        elif part == "symbols":
+            match = SYMBOL_LINE.match(line)
+            # Thumb functions have bit 0 set, data and absolute symbols do not
+            if match and int(match.group(1), 16) & 1:
+                symbols.append((int(match.group(1), 16) & ~1, match.group(2)))
+
+    # Of the aliases of a function (memcpy, __aeabi_memcpy) keep the plainest name
+    symbols.sort(key=lambda symbol: (symbol[0], len(symbol[1]) - len(symbol[1].lstrip("_")), symbol[1]))
+    addresses = [address for address, _ in symbols]
+    functions = []
+    for start, end, name, owner in sorted(sections):
+        if name is not None or end == start:
+            functions.append((start, end, name or owner, owner))
+            continue
+        inside = symbols[bisect.bisect_left(addresses, start):bisect.bisect_left(addresses, end)]
+        cuts = [(address, symbol) for i, (address, symbol) in enumerate(inside)
+                if i == 0 or address != inside[i - 1][0]]
+        if not cuts or cuts[0][0] != start:
+            cuts.insert(0, (start, owner))
+        for i, (address, symbol) in enumerate(cuts):
+            functions.append((address, cuts[i + 1][0] if i + 1 < len(cuts) else end, symbol, owner))
+    return functions
+
+
+def attribute(header, bins, functions):
+    """Samples per (function, object), fractional where a bin is shared."""
+    starts = [start for start, _, _, _ in functions]
+    size = 1 << header["bin_shift"]
+    totals = {}
+    for i, count in enumerate(bins):
+        if count == 0:
+            continue
+        low = header["text_start"] + i * size
+        high = min(low + size, header["text_end"])
+        shares = []
+        k = max(bisect.bisect_right(starts, low) - 1, 0)
+        while k < len(functions) and functions[k][0] < high:
+            start, end, name, owner = functions[k]
+            overlap = min(end, high) - max(start, low)
+            if overlap > 0:
+                shares.append(((name, owner), overlap))
+            k += 1
+        covered = sum(overlap for _, overlap in shares)
+        if covered < high - low:
+            shares.append((("<no function>", ""), high - low - covered))
+        for key, overlap in shares:
+            totals[key] = totals.get(key, 0.0) + count * overlap / (high - low)
+    return totals
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("dump", help="debugger dump of _profileLog")
+    parser.add_argument("map", help="linker map of the profiled build (Debug/*.map)")
+    parser.add_argument("--bins", type=int, default=0, metavar="N",
+                        help="also print the N bins with the most samples")
+    parser.add_argument("--min", type=float, default=0.0, metavar="PERCENT",
+                        help="hide the functions below this share of the samples")
+    args = parser.parse_args()
+
+    with open(args.dump, "rb") as f:
+        header, bins = read_log(f.read())
+    if header is None:
+        print("no profile histogram found", file=sys.stderr)
+        return 1
+    with open(args.map, "r", errors="replace") as f:
+        functions = read_map(f.read())
+    if not functions:
+        print("no .text input sections found in the map", file=sys.stderr)
+        return 1
+
+    totals = attribute(header, bins, functions)
+    samples = header["samples"] or 1
+    rate = header["rate_hz"]
+    print("%d samples%s, bins of %d bytes over 0x%08x-0x%08x"
+          % (header["samples"], " at %d Hz" % rate if rate else "", 1 << header["bin_shift"],
+             header["text_start"], header["text_end"]))
+    for (name, owner), count in sorted(totals.items(), key=lambda item: -item[1]):
+        share = 100.0 * count / samples
+        if share >= args.min:
+            print("%10.1f %6.2f%%  %-32s %s" % (count, share, name, owner))
+    if header["outside"]:
+        print("%10d %6.2f%%  <outside .text>" % (header["outside"], 100.0 * header["outside"] / samples))
+
+    if args.bins:
+        size = 1 << header["bin_shift"]
+        print("\nhottest bins:")
+        hot = sorted(range(len(bins)), key=lambda i: -bins[i])[:args.bins]
+        for i in hot:
+            if bins[i]:
+                print("  0x%08x-0x%08x %6d" % (header["text_start"] + i * size,
+                                               header["text_start"] + (i + 1) * size, bins[i]))
+
+    if header["saturated"]:
+        print("%d samples lost in full bins: reset the profile more often" % header["saturated"],
+              file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+"""Decoder of the binary event trace of trace.c.
+
+Reads either a memory dump of the symbol _traceLog saved with the debugger, or
+the byte stream captured from the trace UART (115200 8N1), and prints the
+records in order with their time in microseconds:
+
+    python3 trace_decode.py capture.bin
+    python3 trace_decode.py --relative dump.bin
+
+Both inputs are sequences of frames (header followed by records, see trace.h),
+so several dumps or a capture started in the middle of a frame can be mixed.
+"""
+
+import argparse
+import struct
+import sys
+
+TRACE_MAGIC = 0x52545645
+TRACE_VERSION = 1
+
+HEADER = struct.Struct("<IHHIIIIHH")
+RECORD = struct.Struct("<IIII")
+
+# Keep in sync with the TRACE_EV_* macros of trace.h
+EVENTS = {
+    1: "PORT_ISR",
+    2: "BUTTON_EDGE",
+    3: "BUTTON_DISPATCH",
+    4: "BUTTON_DONE",
+    5: "LED_UPDATE",
+    6: "LED_FLUSH",
+}
+TRACE_EV_USER = 0x100
+
+BUTTON_EVENTS = {0: "press", 1: "release"}
+
+
+def describe(event, arg0, arg1):
+    """Human readable arguments of a record."""
+    if event == 1:
+        return "P%d IN=0x%02x IFG=0x%02x" % (arg0, (arg1 >> 8) & 0xFF, arg1 & 0xFF)
+    if event == 2:
+        return "button %d %s%s" % (arg0, BUTTON_EVENTS.get(arg1 & 0xFF, "?"),
+                                   "" if arg1 >> 8 else " (filtered)")
+    if event in (3, 4):
+        return "button %d %s" % (arg0, BUTTON_EVENTS.get(arg1, "?"))
+    if event == 5:
+        return "led %d set=0x%02x clear=0x%02x toggle=0x%02x" % (
+            arg0, arg1 & 0xFF, (arg1 >> 8) & 0xFF, (arg1 >> 16) & 0xFF)
+    if event == 6:
+        return "port %d frame=0x%02x changed=0x%02x" % (arg0, (arg1 >> 8) & 0xFF, arg1 & 0xFF)
+    return "0x%08x 0x%08x" % (arg0, arg1)
+
+
+def frames(data):
+    """Yield (header, records) for every frame found in the data."""
+    magic = struct.pack("<I", TRACE_MAGIC)
+    pos = data.find(magic)
+    while pos >= 0 and pos + HEADER.size <= len(data):
+        fields = HEADER.unpack_from(data, pos)
+        header = dict(zip(("magic", "version", "record_size", "clock_hz", "head",
+                           "count", "lost", "ring", "first"), fields))
+        end = pos + HEADER.size + header["count"] * RECORD.size
+        if (header["version"] != TRACE_VERSION or header["record_size"] != RECORD.size
+                or header["ring"] == 0 or end > len(data)):
+            pos = data.find(magic, pos + 1)
+            continue
+        records = [RECORD.unpack_from(data, pos + HEADER.size + i * RECORD.size)
+                   for i in range(header["count"])]
+        yield header, records
+        pos = data.find(magic, end)
+
+
+def collect(data):
+    """Records by sequence number, clock frequency and records lost on the target."""
+    by_seq = {}
+    clock_hz = 0
+    lost = 0
+    stale = 0
+    for header, records in frames(data):
+        clock_hz = header["clock_hz"] or clock_hz
+        lost = max(lost, header["lost"])
+        head, ring = header["head"], header["ring"]
+        for i, (time, tag, arg0, arg1) in enumerate(records):
+            event = tag & 0xFFFF
+            if event == 0:
+                continue
+            # Full sequence number: the latest one before head ending with these 16 bits
+            seq = head - 1 - ((head - 1 - (tag >> 16)) & 0xFFFF)
+            if seq < 0 or seq < head - ring or seq % ring != (header["first"] + i) % ring:
+                stale += 1
+                continue
+            by_seq[seq] = (time, event, arg0, arg1)
+    return by_seq, clock_hz, lost, stale
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("file", help="debugger dump or UART capture")
+    parser.add_argument("--relative", action="store_true",
+                        help="print the time since the previous record instead of the first one")
+    args = parser.parse_args()
+
+    with open(args.file, "rb") as f:
+        data = f.read()
+
+    by_seq, clock_hz, lost, stale = collect(data)
+    if not by_seq:
+        print("no trace records found", file=sys.stderr)
+        return 1
+
+    cycles_per_us = (clock_hz or 1000000) / 1e6
+    elapsed = 0
+    previous_seq = previous_time = None
+    for seq in sorted(by_seq):
+        time, event, arg0, arg1 = by_seq[seq]
+        if previous_seq is not None and seq != previous_seq + 1:
+            print("--- %d records missing ---" % (seq - previous_seq - 1))
+        # The cycle counter wraps around: accumulate the differences
+        delta = 0 if previous_time is None else (time - previous_time) & 0xFFFFFFFF
+        elapsed += delta
+        name = EVENTS.get(event, "USER+%d" % (event - TRACE_EV_USER)
+                          if event >= TRACE_EV_USER else "EVENT_%d" % event)
+        print("%8d %12.2f us  %-16s %s" % (seq, (delta if args.relative else elapsed) / cycles_per_us,
+                                            name, describe(event, arg0, arg1)))
+        previous_seq, previous_time = seq, time
+
+    print("%d records, %d lost on the target, %d overwritten while sent"
+          % (len(by_seq), lost, stale), file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,230 @@
+/**
+ @file    trace.c
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+
+ @brief   Binary event trace for drivers and application, drained over UART
+*/
+
+// Do not write above this line (except comments)!
+/* SECTION 1: Included header files to compile this file           */
+#include "common.h"
+#include "trace.h"
+#include "dma.h"
+
+
+/* SECTION 2: Private macros                                       */
+
+/**
+ @brief DMA channel and trigger source of the UART transmitter
+*/
+#define TRACE_DMA_CHANNEL  0
+#define TRACE_DMA_SOURCE   DMA_CH0_EUSCIA0TX
+
+/**
+ @brief Records sent in one frame, bounded by the 1024 items of a DMA transfer
+*/
+#define TRACE_FRAME_RECORDS  (1024 / sizeof(trace_record_t))
+
+#define TRACE_DRAIN_IDLE     0
+#define TRACE_DRAIN_HEADER   1 //Sending _traceFrame
+#define TRACE_DRAIN_RECORDS  2 //Sending the records of the frame
+
+
+/* SECTION 3: Private types                                        */
+
+
+/* SECTION 4: Public variables  :: definitions, no extern
+   (must match declarations in header file)                        */
+
+
+/* SECTION 5: Private variables :: definitions, static mandatory
+  (no need to declare, definitions include declarations)           */
+
+/**
+ @brief Ring of records, read as a whole by the debugger
+ @remark header.head is the sequence number of the next record
+*/
+static trace_log_t _traceLog;
+
+static volatile uint8_t _traceEnabled = 1;
+
+static trace_header_t _traceFrame;                /**< Header of the frame being sent      */
+static volatile uint8_t _traceDrainState = TRACE_DRAIN_IDLE;
+static uint32_t _traceSent = 0;                   /**< Sequence number of the next record to send */
+static uint32_t _traceSending = 0;                /**< Records in the frame being sent     */
+
+
+/* SECTION 6: Private functions :: declarations, static mandatory
+   Rule exception (ISRs)        :: declarations, no static         */
+
+static void _traceSend(const void *data, uint32_t size); //Start a DMA transfer to the UART
+
+static void _traceDone(int channel, void *context); //DMA completion: next part of the frame
+
+
+/* SECTION 7: Private functions :: definitions, static mandatory
+   Rule exception (ISRs)        :: definitions, no static
+   Public functions             :: definitions, no extern
+   Function definitions (private & public) written in any order    */
+void traceInit(void)
+{
+    uint32_t n;
+
+    /* Records written before this call are kept */
+    _traceLog.header.magic = TRACE_MAGIC;
+    _traceLog.header.version = TRACE_VERSION;
+    _traceLog.header.record_size = sizeof(trace_record_t);
+    _traceLog.header.clock_hz = SystemCoreClock;
+    _traceLog.header.count = TRACE_NUM_RECORDS;
+    _traceLog.header.lost = 0;
+    _traceLog.header.ring = TRACE_NUM_RECORDS;
+    _traceLog.header.first = 0;
+    _traceSent = 0;
+
+    /* P1.2 (RXD) and P1.3 (TXD): primary module function */
+    P1->SEL0 = P1->SEL0 | (BIT2 | BIT3);
+    P1->SEL1 = P1->SEL1 & ~(BIT2 | BIT3);
+
+    /* 8N1 from SMCLK, oversampling when the clock allows it */
+    EUSCI_A0->CTLW0 = EUSCI_A_CTLW0_SWRST | EUSCI_A_CTLW0_SSEL__SMCLK;
+    n = CS_getSMCLK() / TRACE_UART_BAUD;
+    if(n >= 16)
+    {
+        EUSCI_A0->BRW = n / 16;
+        EUSCI_A0->MCTLW = ((n % 16) << EUSCI_A_MCTLW_BRF_OFS) | EUSCI_A_MCTLW_OS16;
+    }
+
+    else
+    {
+        EUSCI_A0->BRW = n;
+        EUSCI_A0->MCTLW = 0;
+    }
+    EUSCI_A0->CTLW0 = EUSCI_A0->CTLW0 & ~EUSCI_A_CTLW0_SWRST;
+
+    /* One byte per TXIFG */
+    dmaInit();
+    DMA_assignChannel(TRACE_DMA_SOURCE);
+    DMA_disableChannelAttribute(TRACE_DMA_SOURCE, UDMA_ATTR_ALTSELECT | UDMA_ATTR_USEBURST
+                                                | UDMA_ATTR_HIGH_PRIORITY | UDMA_ATTR_REQMASK);
+    DMA_setChannelControl(UDMA_PRI_SELECT | TRACE_DMA_SOURCE,
+                          UDMA_SIZE_8 | UDMA_SRC_INC_8 | UDMA_DST_INC_NONE | UDMA_ARB_1);
+
+    _traceDrainState = TRACE_DRAIN_IDLE;
+    DMA_clearInterruptFlag(TRACE_DMA_CHANNEL);
+    dmaChannelCallback(TRACE_DMA_CHANNEL, _traceDone, 0);
+}
+
+void traceRecord(uint32_t id, uint32_t arg0, uint32_t arg1)
+{
+    trace_record_t *record;
+    uint32_t seq;
+    bool state;
+
+    if(!_traceEnabled)
+        return;
+
+    /* Nested interrupts may trace too: reserve the slot and fill it in one go */
+    CRITICAL_ENTER(state);
+
+    seq = _traceLog.header.head++;
+    record = &_traceLog.records[seq & (TRACE_NUM_RECORDS-1)];
+    record->time = CYCLES_NOW();
+    record->tag = (seq << 16) | (id & 0xFFFF);
+    record->arg0 = arg0;
+    record->arg1 = arg1;
+
+    CRITICAL_EXIT(state);
+}
+
+void traceEnable(int enable)
+{
+    _traceEnabled = (enable != 0);
+}
+
+int traceDrain(void)
+{
+    uint32_t head, first, count;
+    bool state;
+
+    CRITICAL_ENTER(state);
+
+    if(_traceDrainState != TRACE_DRAIN_IDLE)
+    {
+        CRITICAL_EXIT(state);
+        return 0;
+    }
+
+    head = _traceLog.header.head;
+
+    /* Records already overwritten are skipped */
+    if(head - _traceSent > TRACE_NUM_RECORDS)
+    {
+        _traceLog.header.lost = _traceLog.header.lost + (head - _traceSent - TRACE_NUM_RECORDS);
+        _traceSent = head - TRACE_NUM_RECORDS;
+    }
+
+    count = head - _traceSent;
+    if(count == 0)
+    {
+        CRITICAL_EXIT(state);
+        return 0;
+    }
+
+    /* A frame holds contiguous records: stop at the end of the ring */
+    first = _traceSent & (TRACE_NUM_RECORDS-1);
+    if(count > TRACE_NUM_RECORDS - first)
+        count = TRACE_NUM_RECORDS - first;
+    if(count > TRACE_FRAME_RECORDS)
+        count = TRACE_FRAME_RECORDS;
+
+    _traceLog.header.clock_hz = SystemCoreClock;
+    _traceFrame = _traceLog.header;
+    _traceFrame.head = _traceSent + count;
+    _traceFrame.count = count;
+    _traceFrame.first = first;
+
+    _traceSending = count;
+    _traceDrainState = TRACE_DRAIN_HEADER;
+
+    CRITICAL_EXIT(state);
+
+    _traceSend(&_traceFrame, sizeof(_traceFrame));
+
+    return 1;
+}
+
+uint32_t traceLost(void)
+{
+    return _traceLog.header.lost;
+}
+
+static void _traceSend(const void *data, uint32_t size)
+{
+    DMA_setChannelTransfer(UDMA_PRI_SELECT | TRACE_DMA_SOURCE, UDMA_MODE_BASIC,
+                           (void *)data, (void *)&EUSCI_A0->TXBUF, size);
+    DMA_enableChannel(TRACE_DMA_CHANNEL);
+
+    /* TXIFG is already set while idle: the first byte is requested by software,
+       the write to TXBUF clears it and the next ones follow its rising edges */
+    DMA_requestSoftwareTransfer(TRACE_DMA_CHANNEL);
+}
+
+static void _traceDone(int channel, void *context)
+{
+    if(_traceDrainState == TRACE_DRAIN_HEADER)
+    {
+        /* A record overwritten meanwhile is sent anyway, the decoder spots its sequence number */
+        _traceDrainState = TRACE_DRAIN_RECORDS;
+        _traceSend(&_traceLog.records[_traceSent & (TRACE_NUM_RECORDS-1)],
+                   _traceSending * sizeof(trace_record_t));
+        return;
+    }
+
+    _traceSent = _traceSent + _traceSending;
+    _traceDrainState = TRACE_DRAIN_IDLE;
+
+    /* Keep going while records are pending */
+    traceDrain();
+}
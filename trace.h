@@ -0,0 +1,148 @@
+/**
+ @file    trace.h
+
+ @brief   Binary event trace for drivers and application, drained over UART
+
+ Each trace point writes one fixed-size record (event, cycle counter, two
+ arguments) into a RAM ring, overwriting the oldest records when full. The ring
+ can be read in two ways, both decoded by tools/trace_decode.py:
+ - with the debugger, saving the memory of the symbol _traceLog
+   (sizeof(trace_log_t) bytes), also after a crash;
+ - over the eUSCI_A0 backchannel UART of the LaunchPad, by calling
+   @ref traceDrain from the main loop: the DMA sends frames made of a
+   @ref trace_header_t followed by the records not sent yet.
+
+ A trace point costs a function call and four stores with interrupts masked.
+ Unless the build sets TRACE_ENABLED to 1, the TRACE macro and its arguments disappear.
+
+ @author  Roberto Carta
+ @version 1.0
+ @date    19/10/2026
+*/
+
+// Do not write above this line (except comments)!
+#ifndef TRACE_H
+#define TRACE_H
+
+/* SECTION 1: Included header files required to compile this file  */
+#include <stdint.h>
+
+
+/* SECTION 2: Public macros                                        */
+
+/**
+ @brief Set to 1 to compile the trace points (--define=TRACE_ENABLED=1 in a debug
+ build configuration, as BENCHMARK_BUILD); off by default
+*/
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED         0
+#endif
+
+/**
+ @brief Number of records in the ring (power of two, at most 32768)
+*/
+#define TRACE_NUM_RECORDS     256
+
+#define TRACE_MAGIC           0x52545645u //"EVTR"
+#define TRACE_VERSION         1
+
+/**
+ @brief Baud rate of the drain UART (eUSCI_A0, P1.2/P1.3)
+*/
+#define TRACE_UART_BAUD       115200
+
+/**
+ @brief Event identifiers (16 bits, 0 is never written), keep in sync with tools/trace_decode.py
+*/
+#define TRACE_EV_PORT_ISR        1  //Port interrupt: port (1..6), IN << 8 | acknowledged IFG
+#define TRACE_EV_BUTTON_EDGE     2  //Edge seen by _buttonProcessFlags: button, event | admitted << 8
+#define TRACE_EV_BUTTON_DISPATCH 3  //Subscribers and buttonCallback called: button, event
+#define TRACE_EV_BUTTON_DONE     4  //Subscribers and buttonCallback returned: button, event
+#define TRACE_EV_LED_UPDATE      5  //ledOn/Off/Toggle: LED, set | clear << 8 | toggle << 16
+#define TRACE_EV_LED_FLUSH       6  //LED port written: port index, frame << 8 | changed bits
+#define TRACE_EV_USER            0x100 //First identifier free for the application
+
+/**
+ @brief Trace point, removed at compile time when TRACE_ENABLED is 0
+*/
+#if TRACE_ENABLED
+#define TRACE(id, arg0, arg1)  traceRecord((id), (uint32_t)(arg0), (uint32_t)(arg1))
+#else
+#define TRACE(id, arg0, arg1)  ((void)0)
+#endif
+
+
+/* SECTION 3: Public types                                         */
+
+/**
+ @brief Header of a trace frame. All the fields are little endian.
+ Record i of the frame comes from the ring index (first + i) % ring, so it holds
+ a sequence number n with n % ring equal to that index: a record overwritten
+ while being sent has a different one and is discarded by the decoder.
+*/
+struct trace_header_s {
+   uint32_t magic;        /**< @ref TRACE_MAGIC                                       */
+   uint16_t version;      /**< @ref TRACE_VERSION                                     */
+   uint16_t record_size;  /**< sizeof(trace_record_t)                                 */
+   uint32_t clock_hz;     /**< Frequency of the record timestamps (MCLK)              */
+   uint32_t head;         /**< Sequence number following the last record written     */
+   uint32_t count;        /**< Number of records following the header                 */
+   uint32_t lost;         /**< Records overwritten before being drained               */
+   uint16_t ring;         /**< @ref TRACE_NUM_RECORDS                                 */
+   uint16_t first;        /**< Ring index of the first record following the header    */
+};
+
+/**
+ @brief Short alias "trace_header_t" for the data type "struct trace_header_s"
+*/
+typedef struct trace_header_s trace_header_t;
+
+/**
+ @brief Trace record (16 bytes)
+*/
+struct trace_record_s {
+   uint32_t time;   /**< Cycle counter at the event (wraps around)                 */
+   uint32_t tag;    /**< Event identifier, low 16 bits of the sequence number << 16 */
+   uint32_t arg0;   /**< First argument                                           */
+   uint32_t arg1;   /**< Second argument                                          */
+};
+
+/**
+ @brief Short alias "trace_record_t" for the data type "struct trace_record_s"
+*/
+typedef struct trace_record_s trace_record_t;
+
+/**
+ @brief Whole trace as seen by the debugger: a header followed by the ring, the
+ record of sequence number n being at index n % TRACE_NUM_RECORDS
+*/
+struct trace_log_s {
+   trace_header_t header;                      /**< count is TRACE_NUM_RECORDS, first is 0 */
+   trace_record_t records[TRACE_NUM_RECORDS];  /**< Ring of records            */
+};
+
+/**
+ @brief Short alias "trace_log_t" for the data type "struct trace_log_s"
+*/
+typedef struct trace_log_s trace_log_t;
+
+
+/* SECTION 4: Public variables :: declarations, extern mandatory   */
+
+
+/* SECTION 5: Public functions :: declarations, extern optional
+   Rule exception (callbacks)  :: declarations, extern recommended */
+
+void traceInit(void); //Initialization function: set up the ring header and the drain UART
+
+void traceRecord(uint32_t id, uint32_t arg0, uint32_t arg1); //Write a record, callable from any context (use the TRACE macro)
+
+void traceEnable(int enable); //Stop (0) or resume (1) recording, e.g. to freeze the ring after a failure
+
+int traceDrain(void); //Start sending the records not sent yet: 1 if started, 0 if nothing to send or busy
+
+uint32_t traceLost(void); //Records overwritten before being drained
+
+
+#endif //TRACE_H
+// Do not write below this line!